@@ -4,6 +4,7 @@
 #include <string.h>
 #include <string>
 
+#include "compress_writer.h"
 #include "s3key_writer.h"
 #include "writer.h"
 
@@ -43,6 +44,10 @@ class GPWriter : public Writer {
     S3Credential cred;
 
     S3KeyWriter keyWriter;
+    CompressWriter compressWriter;
+
+    // keyWriter, or compressWriter in front of it if the data is gzipped
+    Writer *upstreamWriter;
 
     // it links to itself by default
     // but the pointer here leaves a chance to mock it in unit test
@@ -40,6 +40,9 @@ extern string s3ext_token;
 // HTTP or HTTPS
 extern bool s3ext_encryption;
 
+// gzip the data written to S3 or not
+extern bool s3ext_autocompress;
+
 // debug curl or not
 extern bool s3ext_debug_curl;
 
@@ -1,6 +1,9 @@
 #ifndef INCLUDE_S3KEY_WRITER_H_
 #define INCLUDE_S3KEY_WRITER_H_
 
+#include <pthread.h>
+#include <sys/time.h>
+
 #include "s3common.h"
 #include "s3interface.h"
 #include "s3macros.h"
@@ -16,12 +19,43 @@ using std::string;
 
 class WriterBuffer : public vector<uint8_t> {};
 
-class S3KeyWriter : Writer {
+class S3KeyWriter;
+
+// A part of the key being uploaded by an uploading thread.
+struct UploadPart {
+    UploadPart(S3KeyWriter* writer, uint64_t partNumber)
+        : writer(writer), partNumber(partNumber) {
+    }
+
+    S3KeyWriter* writer;
+    uint64_t partNumber;
+    WriterBuffer data;
+};
+
+// S3KeyWriter uploads a key with a multipart upload. Every chunkSize bytes are
+// uploaded as one part by a thread of their own, at most numOfChunks of them
+// at a time: write() blocks until one finishes when all of them are busy.
+class S3KeyWriter : public Writer {
    public:
-    S3KeyWriter() : s3interface(NULL), chunkSize(0) {
+    S3KeyWriter()
+        : s3interface(NULL),
+          chunkSize(0),
+          numOfChunks(0),
+          activeThreads(0),
+          sharedError(false),
+          uploadedBytes(0),
+          segId(0) {
+        pthread_mutex_init(&this->mutex, NULL);
+        pthread_cond_init(&this->threadFinished, NULL);
     }
     virtual ~S3KeyWriter() {
-        this->close();
+        // close() throws if an upload failed, there is nobody to catch it here.
+        try {
+            this->close();
+        } catch (...) {
+        }
+        pthread_mutex_destroy(&this->mutex);
+        pthread_cond_destroy(&this->threadFinished);
     }
     virtual void open(const WriterParams& params);
 
@@ -37,10 +71,17 @@ class S3KeyWriter : Writer {
         this->s3interface = s3;
     }
 
+    // Called by the uploading thread of the part.
+    void uploadPart(UploadPart* part);
+
    protected:
     void flushBuffer();
     void completeKeyWriting();
 
+    // Wait until at most maxActiveThreads uploading threads are running.
+    void waitForThreads(uint64_t maxActiveThreads);
+    void checkSharedError();
+
     WriterBuffer buffer;
     S3Interface* s3interface;
 
@@ -51,7 +92,20 @@ class S3KeyWriter : Writer {
     vector<string> etagList;
 
     uint64_t chunkSize;
+    uint64_t numOfChunks;  // max number of concurrent uploading threads
     S3Credential cred;
+
+    // Protects the members below, which the uploading threads update.
+    pthread_mutex_t mutex;
+    pthread_cond_t threadFinished;
+    uint64_t activeThreads;
+    bool sharedError;
+    string sharedErrorMessage;
+
+    // Throughput statistics of this segment
+    uint64_t uploadedBytes;
+    uint64_t segId;
+    struct timeval startTime;
 };
 
 #endif /* INCLUDE_S3KEY_WRITER_H_ */
@@ -0,0 +1,104 @@
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+#include <string.h>
+
+#include "compress_writer.h"
+#include "s3log.h"
+#include "s3macros.h"
+
+uint64_t S3_ZIP_COMPRESS_CHUNKSIZE = 1024 * 1024 * 2;
+
+CompressWriter::CompressWriter() : writer(NULL), isClosed(true) {
+    this->out = new char[S3_ZIP_COMPRESS_CHUNKSIZE];
+}
+
+CompressWriter::~CompressWriter() {
+    if (!this->isClosed) {
+        deflateEnd(&this->zstream);
+    }
+    delete[] this->out;
+}
+
+void CompressWriter::setWriter(Writer *writer) {
+    this->writer = writer;
+}
+
+void CompressWriter::open(const WriterParams &params) {
+    CHECK_OR_DIE_MSG(this->writer != NULL, "%s", "writer must not be NULL");
+
+    // allocate deflate state for zlib
+    zstream.zalloc = Z_NULL;
+    zstream.zfree = Z_NULL;
+    zstream.opaque = Z_NULL;
+    zstream.next_in = Z_NULL;
+    zstream.avail_in = 0;
+
+    // 31 is 15 window bits plus 16 to write a gzip header and trailer rather than a zlib wrapper,
+    // so that DecompressReader, and anything else that reads gzip, can read the key back.
+    int ret = deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 31, 8, Z_DEFAULT_STRATEGY);
+    CHECK_OR_DIE_MSG(ret == Z_OK, "%s", "failed to initialize zlib library");
+
+    this->isClosed = false;
+
+    this->writer->open(params);
+}
+
+uint64_t CompressWriter::write(char *buf, uint64_t count) {
+    CHECK_OR_DIE(buf != NULL);
+    CHECK_OR_DIE_MSG(!this->isClosed, "%s", "CompressWriter is not open");
+
+    this->zstream.next_in = (Byte *)buf;
+    this->zstream.avail_in = count;
+
+    // Compress everything given, handing every full output buffer to the underlying writer.
+    while (this->zstream.avail_in > 0) {
+        this->zstream.next_out = (Byte *)this->out;
+        this->zstream.avail_out = S3_ZIP_COMPRESS_CHUNKSIZE;
+
+        int status = deflate(&this->zstream, Z_NO_FLUSH);
+        CHECK_OR_DIE_MSG(status != Z_STREAM_ERROR, "Failed to compress data: %d", status);
+
+        this->flush();
+    }
+
+    return count;
+}
+
+// Write the content of the output buffer to the underlying writer.
+void CompressWriter::flush() {
+    uint64_t compressedLen = S3_ZIP_COMPRESS_CHUNKSIZE - this->zstream.avail_out;
+
+    if (compressedLen > 0) {
+        this->writer->write(this->out, compressedLen);
+    }
+}
+
+// This should be reentrant, has no side effects when called multiple times.
+void CompressWriter::close() {
+    if (this->isClosed) {
+        return;
+    }
+
+    // Write the rest of the deflate stream, and the gzip trailer.
+    int status;
+    do {
+        this->zstream.next_in = Z_NULL;
+        this->zstream.avail_in = 0;
+        this->zstream.next_out = (Byte *)this->out;
+        this->zstream.avail_out = S3_ZIP_COMPRESS_CHUNKSIZE;
+
+        status = deflate(&this->zstream, Z_FINISH);
+        if (status == Z_STREAM_ERROR) {
+            break;
+        }
+
+        this->flush();
+    } while (status != Z_STREAM_END);
+
+    deflateEnd(&this->zstream);
+    this->isClosed = true;
+
+    CHECK_OR_DIE_MSG(status == Z_STREAM_END, "Failed to compress data: %d", status);
+
+    this->writer->close();
+}
@@ -21,6 +21,7 @@ GPWriter::GPWriter(const string& url) {
     string file = replaceSchemaFromURL(url);
     constructWriterParams(file);
     restfulServicePtr = &restfulService;
+    upstreamWriter = &keyWriter;
 }
 
 void GPWriter::constructWriterParams(const string& url) {
@@ -40,15 +41,23 @@ void GPWriter::open(const WriterParams& params) {
     this->s3service.setRESTfulService(this->restfulServicePtr);
     this->params.setKeyUrl(this->genUniqueKeyName(this->params.getKeyUrl()));
     this->keyWriter.setS3interface(&this->s3service);
-    this->keyWriter.open(this->params);
+
+    if (s3ext_autocompress) {
+        this->compressWriter.setWriter(&this->keyWriter);
+        this->upstreamWriter = &this->compressWriter;
+    } else {
+        this->upstreamWriter = &this->keyWriter;
+    }
+
+    this->upstreamWriter->open(this->params);
 }
 
 uint64_t GPWriter::write(char* buf, uint64_t count) {
-    return this->keyWriter.write(buf, count);
+    return this->upstreamWriter->write(buf, count);
 }
 
 void GPWriter::close() {
-    this->keyWriter.close();
+    this->upstreamWriter->close();
 }
 
 string GPWriter::genUniqueKeyName(const string& url) {
@@ -83,6 +92,9 @@ string GPWriter::constructKeyName(const string& url) {
 
     stringstream ss;
     ss << url << s3ext_segid << out_hash_hex + SHA256_DIGEST_STRING_LENGTH - 8 - 1 << ".data";
+    if (s3ext_autocompress) {
+        ss << ".gz";
+    }
 
     return ss.str();
 }
@@ -43,6 +43,7 @@ string s3ext_secret;
 string s3ext_token;
 
 bool s3ext_encryption = true;
+bool s3ext_autocompress = false;
 bool s3ext_debug_curl = false;
 
 int32_t s3ext_segid = -1;
@@ -140,6 +141,9 @@ bool InitConfig(const string& conf_path, const string section = "default") {
     content = s3cfg->Get(section.c_str(), "encryption", "true");
     s3ext_encryption = to_bool(content);
 
+    content = s3cfg->Get(section.c_str(), "autocompress", "false");
+    s3ext_autocompress = to_bool(content);
+
 #ifdef S3_STANDALONE
     s3ext_segid = 0;
     s3ext_segnum = 1;
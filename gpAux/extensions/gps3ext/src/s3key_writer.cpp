@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #define __STDC_FORMAT_MACROS
 #include <inttypes.h>
 
@@ -8,12 +10,19 @@ void S3KeyWriter::open(const WriterParams &params) {
     this->region = params.getRegion();
     this->cred = params.getCred();
     this->chunkSize = params.getChunkSize();
+    this->numOfChunks = std::max(params.getNumOfChunks(), (uint64_t)1);
+    this->segId = params.getSegId();
 
     CHECK_OR_DIE_MSG(this->s3interface != NULL, "%s", "s3interface must not be NULL");
     CHECK_OR_DIE_MSG(this->chunkSize > 0, "%s", "chunkSize must not be zero");
 
     buffer.reserve(this->chunkSize);
 
+    this->sharedError = false;
+    this->sharedErrorMessage.clear();
+    this->uploadedBytes = 0;
+    gettimeofday(&this->startTime, NULL);
+
     this->uploadId = this->s3interface->getUploadId(this->url, this->region, this->cred);
     CHECK_OR_DIE_MSG(!this->uploadId.empty(), "%s", "Failed to get upload id");
 }
@@ -23,6 +32,7 @@ void S3KeyWriter::open(const WriterParams &params) {
 // errors.
 uint64_t S3KeyWriter::write(char *buf, uint64_t count) {
     CHECK_OR_DIE(buf != NULL);
+    this->checkSharedError();
 
     // GPDB issues 64K- block every time and chunkSize is 8MB+
     if (count > this->chunkSize) {
@@ -46,26 +56,137 @@ void S3KeyWriter::close() {
     }
 }
 
-void S3KeyWriter::flushBuffer() {
-    if (!this->buffer.empty()) {
-        string etag = this->s3interface->uploadPartOfData(
-            buffer, this->url, this->region, this->cred, etagList.size() + 1, this->uploadId);
+void *UploadThreadFunc(void *data) {
+    UploadPart *part = static_cast<UploadPart *>(data);
+
+    S3DEBUG("Uploading thread starts");
+    part->writer->uploadPart(part);
+    S3DEBUG("Uploading thread ended");
+
+    return NULL;
+}
+
+void S3KeyWriter::uploadPart(UploadPart *part) {
+    string etag;
+    string errorMessage;
+
+    if (QueryCancelPending) {
+        S3INFO("Uploading thread is interrupted by GPDB");
+        errorMessage = "Uploading thread is interrupted by GPDB";
+    } else {
+        try {
+            etag = this->s3interface->uploadPartOfData(part->data, this->url, this->region,
+                                                       this->cred, part->partNumber,
+                                                       this->uploadId);
+        } catch (std::exception &e) {
+            S3ERROR("Failed to upload part %" PRIu64 ": %s", part->partNumber, e.what());
+            errorMessage = e.what();
+        }
+    }
 
-        etagList.push_back(etag);
+    uint64_t partNumber = part->partNumber;
+    uint64_t partSize = part->data.size();
+    delete part;
+
+    // The writer may go away as soon as activeThreads drops, don't touch it after unlocking.
+    pthread_mutex_lock(&this->mutex);
+    if (!errorMessage.empty()) {
+        if (!this->sharedError) {
+            this->sharedError = true;
+            this->sharedErrorMessage = errorMessage;
+        }
+    } else {
+        this->etagList[partNumber - 1] = etag;
+        this->uploadedBytes += partSize;
+    }
+    this->activeThreads--;
+    pthread_cond_signal(&this->threadFinished);
+    pthread_mutex_unlock(&this->mutex);
+}
 
-        this->buffer.clear();
+void S3KeyWriter::waitForThreads(uint64_t maxActiveThreads) {
+    pthread_mutex_lock(&this->mutex);
+    while (this->activeThreads > maxActiveThreads) {
+        pthread_cond_wait(&this->threadFinished, &this->mutex);
+    }
+    pthread_mutex_unlock(&this->mutex);
+}
+
+void S3KeyWriter::checkSharedError() {
+    pthread_mutex_lock(&this->mutex);
+    bool error = this->sharedError;
+    string message = this->sharedErrorMessage;
+    pthread_mutex_unlock(&this->mutex);
+
+    CHECK_OR_DIE_MSG(!error, "%s", message.c_str());
+}
+
+void S3KeyWriter::flushBuffer() {
+    if (!this->buffer.empty()) {
+        // Backpressure: wait for a free uploading thread.
+        this->waitForThreads(this->numOfChunks - 1);
+        this->checkSharedError();
+
+        pthread_mutex_lock(&this->mutex);
+        this->etagList.push_back("");
+        UploadPart *part = new UploadPart(this, this->etagList.size());
+        pthread_mutex_unlock(&this->mutex);
+
+        // Hand the data over to the thread, and start the next part with an empty buffer.
+        part->data.swap(this->buffer);
+        this->buffer.reserve(this->chunkSize);
+
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+        pthread_mutex_lock(&this->mutex);
+        this->activeThreads++;
+        pthread_mutex_unlock(&this->mutex);
+
+        pthread_t thread;
+        int ret = pthread_create(&thread, &attr, UploadThreadFunc, part);
+        pthread_attr_destroy(&attr);
+
+        if (ret != 0) {
+            S3WARN("Failed to create uploading thread, upload part %" PRIu64 " in place",
+                   part->partNumber);
+            this->uploadPart(part);
+        }
     }
 }
 
 void S3KeyWriter::completeKeyWriting() {
-    // make sure the buffer is clear
-    this->flushBuffer();
+    // Don't leave uploading threads behind, even if we are going to fail.
+    try {
+        // make sure the buffer is clear
+        this->flushBuffer();
+    } catch (...) {
+        this->waitForThreads(0);
+        this->etagList.clear();
+        this->uploadId.clear();
+        throw;
+    }
+    this->waitForThreads(0);
+
+    bool error = this->sharedError;
+    string message = this->sharedErrorMessage;
 
-    if (!this->etagList.empty() && !this->uploadId.empty()) {
+    if (!error && !this->etagList.empty() && !this->uploadId.empty()) {
         this->s3interface->completeMultiPart(this->url, this->region, this->cred, this->uploadId,
                                              etagList);
+
+        struct timeval endTime;
+        gettimeofday(&endTime, NULL);
+        double seconds = (endTime.tv_sec - this->startTime.tv_sec) +
+                         (endTime.tv_usec - this->startTime.tv_usec) / 1000000.0;
+        S3INFO("Segment %" PRIu64 " uploaded %" PRIu64 " bytes in %zu parts in %.2f seconds (%.2f MB/s)",
+               this->segId, this->uploadedBytes, this->etagList.size(), seconds,
+               seconds > 0 ? this->uploadedBytes / seconds / (1024 * 1024) : 0.0);
     }
 
     this->etagList.clear();
     this->uploadId.clear();
+
+    CHECK_OR_DIE_MSG(!error, "%s", message.c_str());
 }
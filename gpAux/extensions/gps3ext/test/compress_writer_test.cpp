@@ -0,0 +1,143 @@
+#include <vector>
+
+#include "compress_writer.cpp"
+#include "gtest/gtest.h"
+
+using std::vector;
+
+class MockBufferWriter : public Writer {
+   public:
+    MockBufferWriter() : closeCount(0), maxWriteSize(0) {
+    }
+
+    void open(const WriterParams &params) {
+    }
+
+    uint64_t write(char *buf, uint64_t count) {
+        this->maxWriteSize = std::max(this->maxWriteSize, count);
+        this->data.insert(this->data.end(), buf, buf + count);
+        return count;
+    }
+
+    void close() {
+        this->closeCount++;
+    }
+
+    vector<uint8_t> data;
+    int closeCount;
+    uint64_t maxWriteSize;
+};
+
+class CompressWriterTest : public testing::Test {
+   protected:
+    // Remember that SetUp() is run immediately before a test starts.
+    virtual void SetUp() {
+        compressWriter.setWriter(&bufWriter);
+        compressWriter.open(params);
+    }
+
+    // TearDown() is invoked immediately after a test finishes.
+    virtual void TearDown() {
+        compressWriter.close();
+    }
+
+    // Decompress what was written to bufWriter, as a gzip stream.
+    vector<uint8_t> decompressWrittenData() {
+        vector<uint8_t> result;
+        z_stream zstream;
+        memset(&zstream, 0, sizeof(zstream));
+
+        // 47 makes zlib recognize the gzip header, as DecompressReader does.
+        EXPECT_EQ(Z_OK, inflateInit2(&zstream, 47));
+
+        zstream.next_in = bufWriter.data.data();
+        zstream.avail_in = bufWriter.data.size();
+
+        int status;
+        do {
+            Byte out[4096];
+            zstream.next_out = out;
+            zstream.avail_out = sizeof(out);
+
+            status = inflate(&zstream, Z_NO_FLUSH);
+            result.insert(result.end(), out, out + sizeof(out) - zstream.avail_out);
+        } while (status == Z_OK);
+
+        EXPECT_EQ(Z_STREAM_END, status);
+        inflateEnd(&zstream);
+
+        return result;
+    }
+
+    CompressWriter compressWriter;
+    WriterParams params;
+    MockBufferWriter bufWriter;
+};
+
+TEST_F(CompressWriterTest, AbleToCompressEmptyData) {
+    compressWriter.close();
+
+    EXPECT_EQ(1, bufWriter.closeCount);
+    EXPECT_NE(0, bufWriter.data.size());
+    EXPECT_EQ(0, this->decompressWrittenData().size());
+}
+
+TEST_F(CompressWriterTest, AbleToCompressSmallData) {
+    char hello[] = "The quick brown fox jumps over the lazy dog";
+
+    EXPECT_EQ(sizeof(hello), compressWriter.write(hello, sizeof(hello)));
+    compressWriter.close();
+
+    // gzip magic bytes
+    ASSERT_LE(2, bufWriter.data.size());
+    EXPECT_EQ(0x1f, bufWriter.data[0]);
+    EXPECT_EQ(0x8b, bufWriter.data[1]);
+
+    vector<uint8_t> result = this->decompressWrittenData();
+    ASSERT_EQ(sizeof(hello), result.size());
+    EXPECT_EQ(0, memcmp(hello, result.data(), sizeof(hello)));
+}
+
+TEST_F(CompressWriterTest, AbleToCompressDataLargerThanBuffer) {
+    // Pseudo random bytes do not compress, so the output fills the buffer several times.
+    vector<char> input(S3_ZIP_COMPRESS_CHUNKSIZE * 3 + 17);
+    uint32_t seed = 1;
+    for (uint64_t i = 0; i < input.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        input[i] = (char)(seed >> 16);
+    }
+
+    // 64K blocks, like GPDB issues.
+    for (uint64_t offset = 0; offset < input.size(); offset += 65536) {
+        uint64_t count = std::min((uint64_t)65536, input.size() - offset);
+        EXPECT_EQ(count, compressWriter.write(input.data() + offset, count));
+    }
+    compressWriter.close();
+
+    EXPECT_LE(bufWriter.maxWriteSize, S3_ZIP_COMPRESS_CHUNKSIZE);
+
+    vector<uint8_t> result = this->decompressWrittenData();
+    ASSERT_EQ(input.size(), result.size());
+    EXPECT_EQ(0, memcmp(input.data(), result.data(), input.size()));
+}
+
+TEST_F(CompressWriterTest, CloseIsReentrant) {
+    char hello[] = "The quick brown fox jumps over the lazy dog";
+
+    compressWriter.write(hello, sizeof(hello));
+    compressWriter.close();
+    uint64_t writtenSize = bufWriter.data.size();
+
+    compressWriter.close();
+
+    EXPECT_EQ(1, bufWriter.closeCount);
+    EXPECT_EQ(writtenSize, bufWriter.data.size());
+}
+
+TEST_F(CompressWriterTest, WriteAfterCloseFails) {
+    char hello[] = "The quick brown fox jumps over the lazy dog";
+
+    compressWriter.close();
+
+    EXPECT_THROW(compressWriter.write(hello, sizeof(hello)), std::runtime_error);
+}
@@ -34,6 +34,7 @@ TEST(Config, Basic) {
 
     EXPECT_TRUE(s3ext_encryption);
     EXPECT_FALSE(s3ext_debug_curl);
+    EXPECT_FALSE(s3ext_autocompress);
 }
 
 TEST(Config, SpecialSectionValues) {
@@ -67,4 +68,5 @@ TEST(Config, SpecialSwitches) {
 
     EXPECT_FALSE(s3ext_encryption);
     EXPECT_TRUE(s3ext_debug_curl);
+    EXPECT_TRUE(s3ext_autocompress);
 }
@@ -1,3 +1,5 @@
+#include <unistd.h>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -150,3 +152,101 @@ TEST_F(S3KeyWriterTest, TestUploadContent) {
     // Buffer is not empty, close() will upload remaining data in buffer.
     this->close();
 }
+
+// Records the parts uploaded, from several threads at a time.
+class MockUploadParts {
+   public:
+    MockUploadParts() : activeUploads(0), maxActiveUploads(0) {
+        pthread_mutex_init(&this->mutex, NULL);
+    }
+
+    ~MockUploadParts() {
+        pthread_mutex_destroy(&this->mutex);
+    }
+
+    string upload(vector<uint8_t> &data, const string &keyUrl, const string &region,
+                  const S3Credential &cred, uint64_t partNumber, const string &uploadId) {
+        pthread_mutex_lock(&this->mutex);
+        this->activeUploads++;
+        this->maxActiveUploads = std::max(this->maxActiveUploads, this->activeUploads);
+        this->parts[partNumber] = data;
+        pthread_mutex_unlock(&this->mutex);
+
+        // Give the other uploads a chance to overlap with this one.
+        usleep(1000);
+
+        pthread_mutex_lock(&this->mutex);
+        this->activeUploads--;
+        pthread_mutex_unlock(&this->mutex);
+
+        stringstream etag;
+        etag << "\"etag" << partNumber << "\"";
+        return etag.str();
+    }
+
+    pthread_mutex_t mutex;
+    map<uint64_t, vector<uint8_t> > parts;
+    uint64_t activeUploads;
+    uint64_t maxActiveUploads;
+};
+
+TEST_F(S3KeyWriterTest, TestParallelUpload) {
+    testParams.setChunkSize(0x100);
+    testParams.setNumOfChunks(3);
+
+    MockUploadParts uploads;
+    vector<string> expectedEtags;
+    for (int i = 1; i <= 20; i++) {
+        stringstream etag;
+        etag << "\"etag" << i << "\"";
+        expectedEtags.push_back(etag.str());
+    }
+
+    EXPECT_CALL(this->mocks3interface, getUploadId(_, _, _)).WillOnce(Return("uploadId"));
+    EXPECT_CALL(this->mocks3interface, uploadPartOfData(_, _, _, _, _, "uploadId"))
+        .Times(20)
+        .WillRepeatedly(Invoke(&uploads, &MockUploadParts::upload));
+    EXPECT_CALL(this->mocks3interface, completeMultiPart(_, _, _, "uploadId", expectedEtags))
+        .WillOnce(Return(true));
+
+    this->open(testParams);
+
+    // 20 parts, each filled with its part number.
+    char data[0x100];
+    for (int i = 1; i <= 20; i++) {
+        memset(data, i, sizeof(data));
+        ASSERT_EQ(sizeof(data), this->write(data, sizeof(data)));
+    }
+    this->close();
+
+    EXPECT_LE(uploads.maxActiveUploads, 3);
+    ASSERT_EQ(20, uploads.parts.size());
+    for (int i = 1; i <= 20; i++) {
+        ASSERT_EQ(sizeof(data), uploads.parts[i].size());
+        EXPECT_EQ(i, uploads.parts[i][0]);
+        EXPECT_EQ(i, uploads.parts[i][sizeof(data) - 1]);
+    }
+}
+
+TEST_F(S3KeyWriterTest, TestUploadFailure) {
+    testParams.setChunkSize(0x100);
+    testParams.setNumOfChunks(2);
+
+    EXPECT_CALL(this->mocks3interface, getUploadId(_, _, _)).WillOnce(Return("uploadId"));
+    EXPECT_CALL(this->mocks3interface, uploadPartOfData(_, _, _, _, _, _))
+        .WillOnce(Throw(std::runtime_error("failed to upload")))
+        .WillRepeatedly(Return("\"etag\""));
+    EXPECT_CALL(this->mocks3interface, completeMultiPart(_, _, _, _, _)).Times(0);
+
+    this->open(testParams);
+
+    char data[0x100];
+    ASSERT_EQ(sizeof(data), this->write(data, sizeof(data)));
+    ASSERT_EQ(sizeof(data), this->write(data, sizeof(data)));
+
+    // The failure of the first part is reported once all the parts are done.
+    EXPECT_THROW(this->close(), std::runtime_error);
+
+    // close() is reentrant, and does not complete the upload.
+    this->close();
+}
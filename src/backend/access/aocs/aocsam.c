@@ -31,6 +31,7 @@
 #include "access/aocssegfiles.h"
 #include "cdb/cdbaocsam.h"
 #include "cdb/cdbappendonlyam.h"
+#include "executor/executor.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/procarray.h"
@@ -45,6 +46,9 @@
 
 #include "utils/debugbreak.h"
 
+/* GUC: check the qual before reading the other projected columns */
+bool gp_aocs_late_materialization = true;
+
 static AOCSScanDesc
 aocs_beginscan_internal(Relation relation,
 		AOCSFileSegInfo **seginfo,
@@ -340,6 +344,34 @@ static int open_next_scan_seg(AOCSScanDesc scan)
 											  nvp,
 											  scan->blockDirectory);
 
+				if (scan->numZoneMapKeys > 0)
+				{
+					if (scan->skipRanges != NULL)
+						pfree(scan->skipRanges);
+					scan->numSkipRanges =
+						AppendOnlyBlockDirectory_ZoneMapSkipRanges(scan->aos_rel,
+																   scan->appendOnlyMetaDataSnapshot,
+																   (FileSegInfo *) curSegInfo,
+																   true,
+																   scan->zoneMapKeys,
+																   scan->numZoneMapKeys,
+																   &scan->skipRanges);
+					scan->nextSkipRange = 0;
+				}
+
+				/*
+				 * Catching up the other columns to a row that passes the
+				 * qual needs the first row numbers in the block headers.
+				 * Blocks written before 4.0 don't have them, and only come
+				 * before the ones that do in a file.
+				 */
+				scan->lateMaterialize = (scan->qual != NIL);
+				for (i = 0; i < nvp && scan->lateMaterialize; i++)
+				{
+					if (scan->proj[i] && scan->ds[i]->getBlockInfo.firstRow < 0)
+						scan->lateMaterialize = false;
+				}
+
 				return scan->cur_seg;
 			}
 		}
@@ -361,8 +393,14 @@ static void close_cur_scan_seg(AOCSScanDesc scan)
         {
             datumstreamread_close_file(scan->ds[i]);
         }
+
+        /* Drop the values decoded ahead, if any */
+        scan->batches[i].count = 0;
+        scan->batches[i].next = 0;
     }
 
+	scan->numSkipRanges = 0;
+
 	if (scan->buildBlockDirectory)
 	{
 		Assert(scan->blockDirectory != NULL);
@@ -472,6 +510,16 @@ aocs_beginscan_internal(Relation relation,
 
     scan->ds = (DatumStreamRead **) palloc0(sizeof(DatumStreamRead *) * nvp);
 
+    scan->batches = (AOCSColumnBatch *) palloc0(sizeof(AOCSColumnBatch) * nvp);
+    for (int i = 0; i < nvp; ++i)
+    {
+        if (proj[i])
+        {
+            scan->batches[i].values = (Datum *) palloc(sizeof(Datum) * AOCS_SCAN_BATCH_SIZE);
+            scan->batches[i].nulls = (bool *) palloc(sizeof(bool) * AOCS_SCAN_BATCH_SIZE);
+        }
+    }
+
     aocs_initscan(scan);
 
 	scan->buildBlockDirectory = false;
@@ -493,6 +541,60 @@ void aocs_rescan(AOCSScanDesc scan)
     aocs_initscan(scan);
 }
 
+/*
+ * Let the scan skip the rows whose zone maps in the block directory show
+ * that they don't satisfy all of keys, from
+ * AppendOnlyBlockDirectory_ZoneMapKeys. The keys must hold until the end
+ * of the scan.
+ */
+void aocs_setzonemapkeys(AOCSScanDesc scan, AppendOnlyZoneMapKey *keys, int nkeys)
+{
+	Assert(!scan->buildBlockDirectory);
+
+	scan->zoneMapKeys = keys;
+	scan->numZoneMapKeys = nkeys;
+}
+
+/*
+ * Let the scan check qual, an ExprState list over the columns in qualProj,
+ * as soon as it has read those columns of a row, and read the other
+ * projected columns only for the rows that pass. Blocks of the other
+ * columns that have no such row are skipped without decompressing them.
+ *
+ * qual must be the whole qual of the scan: while lateMaterialize is set,
+ * the rows returned have passed it, and the caller need not check it
+ * again. It is evaluated in econtext, whose per-tuple memory is reset for
+ * each row. qual, econtext and qualProj must hold until the end of the
+ * scan.
+ */
+void aocs_setqual(AOCSScanDesc scan, List *qual, ExprContext *econtext, bool *qualProj)
+{
+	int			ncol = scan->relationTupleDesc->natts;
+	bool		hasQual = false;
+	bool		hasOther = false;
+	int			i;
+
+	Assert(!scan->buildBlockDirectory);
+
+	for (i = 0; i < ncol; i++)
+	{
+		if (qualProj[i] && !scan->proj[i])
+			return;
+		if (qualProj[i])
+			hasQual = true;
+		else if (scan->proj[i])
+			hasOther = true;
+	}
+
+	/* Only worth it if some projected column is not in the qual */
+	if (!hasQual || !hasOther)
+		return;
+
+	scan->qual = qual;
+	scan->econtext = econtext;
+	scan->qualProj = qualProj;
+}
+
 void aocs_endscan(AOCSScanDesc scan)
 {
     int i;
@@ -504,6 +606,16 @@ void aocs_endscan(AOCSScanDesc scan)
 
     pfree(scan->ds);
 
+    for(i=0; i<scan->relationTupleDesc->natts; ++i)
+    {
+        if (scan->batches[i].values)
+        {
+            pfree(scan->batches[i].values);
+            pfree(scan->batches[i].nulls);
+        }
+    }
+    pfree(scan->batches);
+
     for(i=0; i<scan->total_seg; ++i)
     {
         if(scan->seginfo[i])
@@ -512,14 +624,195 @@ void aocs_endscan(AOCSScanDesc scan)
             scan->seginfo[i] = NULL;
         }
     }
-    if (scan->seginfo)
-        pfree(scan->seginfo);
+	if (scan->seginfo)
+		pfree(scan->seginfo);
+
+	if (scan->skipRanges)
+		pfree(scan->skipRanges);
 
 	AppendOnlyVisimap_Finish(&scan->visibilityMap, AccessShareLock);
 
     pfree(scan);
 }
 
+/*
+ * Decode the next values of column colno into its batch, reading the next
+ * block of the column if the current one is exhausted.
+ *
+ * Decoding a batch of values at once, while the block is hot in the CPU data
+ * cache, keeps the per-row work of aocs_getnext to a copy per column.
+ *
+ * Returns false if there is no next block in the current segment file.
+ */
+static bool
+aocs_fill_column_batch(AOCSScanDesc scan, int colno)
+{
+	DatumStreamRead *ds = scan->ds[colno];
+	AOCSColumnBatch *batch = &scan->batches[colno];
+	int			count;
+
+	count = datumstreamread_get_batch(ds, batch->values, batch->nulls,
+									  AOCS_SCAN_BATCH_SIZE);
+	if (count == 0)
+	{
+		if (datumstreamread_block(ds) < 0)
+			return false;
+
+		if (scan->buildBlockDirectory)
+		{
+			Assert(scan->blockDirectory != NULL);
+
+			AppendOnlyBlockDirectory_InsertEntry(scan->blockDirectory,
+												 colno,
+												 ds->blockFirstRowNum,
+												 ds->blockFileOffset,
+												 ds->blockRowCount);
+		}
+
+		count = datumstreamread_get_batch(ds, batch->values, batch->nulls,
+										  AOCS_SCAN_BATCH_SIZE);
+		Assert(count > 0);
+	}
+
+	batch->count = count;
+	batch->next = 0;
+
+	/* The stream is positioned on the last value of the batch */
+	if (ds->blockFirstRowNum != INT64CONST(-1))
+	{
+		Assert(ds->blockFirstRowNum > 0);
+		batch->firstRowNum = ds->blockFirstRowNum +
+			datumstreamread_nth(ds) - (count - 1);
+	}
+	else
+		batch->firstRowNum = INT64CONST(-1);
+
+	return true;
+}
+
+/*
+ * If the next row of the scan is in a range that the zone maps rule out,
+ * move the columns in cols to the end of the range. Blocks that end
+ * within the range are skipped without decompressing them.
+ *
+ * Returns false if that was the rest of the segment file.
+ */
+static bool
+aocs_skip_rows(AOCSScanDesc scan, int ncol, bool *cols)
+{
+	int64		rowNum = INT64CONST(-1);
+	int64		skipTo;
+	int64		blocksSkipped;
+	bool		found;
+	int			i;
+
+	/* Only blocks that have their first row number in the header can be skipped */
+	for (i = 0; i < ncol; i++)
+	{
+		if (!cols[i])
+			continue;
+
+		if (scan->ds[i]->getBlockInfo.firstRow < 0)
+			return true;
+
+		if (rowNum == INT64CONST(-1))
+		{
+			AOCSColumnBatch *batch = &scan->batches[i];
+
+			if (batch->next < batch->count)
+				rowNum = batch->firstRowNum + batch->next;
+			else
+				rowNum = scan->ds[i]->blockFirstRowNum +
+					datumstreamread_nth(scan->ds[i]) + 1;
+		}
+	}
+
+	if (rowNum == INT64CONST(-1))
+		return true;
+
+	skipTo = AppendOnlyBlockDirectory_SkipRangeEnd(scan->skipRanges,
+												   scan->numSkipRanges,
+												   &scan->nextSkipRange,
+												   rowNum);
+	if (skipTo == rowNum)
+		return true;
+
+	/*
+	 * rowNum is where the first column is; the others may already be past
+	 * a gap in the row numbers after it.
+	 */
+	for (i = 0; i < ncol; i++)
+	{
+		AOCSColumnBatch *batch = &scan->batches[i];
+
+		if (!cols[i])
+			continue;
+
+		if (batch->next < batch->count)
+		{
+			if (skipTo <= batch->firstRowNum + batch->next)
+				continue;
+
+			if (skipTo < batch->firstRowNum + batch->count)
+			{
+				batch->next = skipTo - batch->firstRowNum;
+				continue;
+			}
+		}
+
+		batch->count = 0;
+		batch->next = 0;
+		blocksSkipped = scan->ds[i]->blocksSkipped;
+		found = datumstreamread_skip_to_row(scan->ds[i], skipTo);
+		scan->zoneMapBlocksSkipped += scan->ds[i]->blocksSkipped - blocksSkipped;
+		if (!found)
+			return false;
+	}
+
+	scan->cur_seg_row += skipTo - rowNum;
+
+	return true;
+}
+
+/*
+ * Move column colno, which is behind the columns of the qual, to row rowNum
+ * of the current segment file. Blocks that end before rowNum are skipped
+ * without decompressing them.
+ *
+ * Returns false if the column has no more rows in the segment file.
+ */
+static bool
+aocs_catch_up_column(AOCSScanDesc scan, int colno, int64 rowNum)
+{
+	AOCSColumnBatch *batch = &scan->batches[colno];
+
+	if (batch->next < batch->count)
+	{
+		Assert(rowNum >= batch->firstRowNum + batch->next);
+
+		if (rowNum < batch->firstRowNum + batch->count)
+		{
+			batch->next = rowNum - batch->firstRowNum;
+			return true;
+		}
+	}
+
+	batch->count = 0;
+	batch->next = 0;
+	if (!datumstreamread_skip_to_row(scan->ds[colno], rowNum) ||
+		!aocs_fill_column_batch(scan, colno))
+		return false;
+
+	/* All the columns of a row have the same row number */
+	if (batch->firstRowNum != rowNum)
+		elog(ERROR, "column %d of append-only column-oriented relation \"%s\" "
+			 "has row " INT64_FORMAT " where row " INT64_FORMAT " was expected",
+			 colno + 1, RelationGetRelationName(scan->aos_rel),
+			 batch->firstRowNum, rowNum);
+
+	return true;
+}
+
 void aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
 {
 	int ncol;
@@ -556,54 +849,45 @@ ReadNext:
 
 		Assert(scan->cur_seg >= 0);
 
-		/* Read from cur_seg */
+		if (scan->numSkipRanges > 0 &&
+			!aocs_skip_rows(scan, ncol,
+							scan->lateMaterialize ? scan->qualProj : scan->proj))
+		{
+			close_cur_scan_seg(scan);
+			err = -1;
+			goto ReadNext;
+		}
+
+		/*
+		 * Read from cur_seg. With late materialization, only the columns of
+		 * the qual are read here, and the others once the row passes it.
+		 */
 		for(i=0; i<ncol; ++i)
 		{
-			if(scan->proj[i])
+			if(scan->proj[i] && (!scan->lateMaterialize || scan->qualProj[i]))
 			{
-				err = datumstreamread_advance(scan->ds[i]);
-				Assert(err >= 0);
-				if(err == 0)
-				{
-					err = datumstreamread_block(scan->ds[i]);
-					if(err < 0)
-					{
-						/* Ha, cannot read next block,
-						 * we need to go to next seg
-						 */
-						close_cur_scan_seg(scan);
-						goto ReadNext;
-					}
-
-					if (scan->buildBlockDirectory)
-					{
-						Assert(scan->blockDirectory != NULL);
-
-						AppendOnlyBlockDirectory_InsertEntry(scan->blockDirectory,
-															 i,
-															 scan->ds[i]->blockFirstRowNum,
-															 scan->ds[i]->blockFileOffset,
-															 scan->ds[i]->blockRowCount);
-					}
+				AOCSColumnBatch *batch = &scan->batches[i];
 
-					err = datumstreamread_advance(scan->ds[i]);
-					Assert(err > 0);
+				if (batch->next >= batch->count &&
+					!aocs_fill_column_batch(scan, i))
+				{
+					/* Ha, cannot read next block,
+					 * we need to go to next seg
+					 */
+					close_cur_scan_seg(scan);
+					err = -1;
+					goto ReadNext;
 				}
 
-				/*
-				 * Get the column's datum right here since the data structures should still
-				 * be hot in CPU data cache memory.
-				 */
-				datumstreamread_get(scan->ds[i], &d[i], &null[i]);
+				d[i] = batch->values[batch->next];
+				null[i] = batch->nulls[batch->next];
 
 				if (rowNum == INT64CONST(-1) &&
-					scan->ds[i]->blockFirstRowNum != INT64CONST(-1))
+					batch->firstRowNum != INT64CONST(-1))
 				{
-					Assert(scan->ds[i]->blockFirstRowNum > 0);
-					rowNum = scan->ds[i]->blockFirstRowNum +
-						datumstreamread_nth(scan->ds[i]);
-
+					rowNum = batch->firstRowNum + batch->next;
 				}
+				batch->next++;
 			}
 		}
 
@@ -630,6 +914,44 @@ ReadNext:
 
         TupSetVirtualTupleNValid(slot, ncol);
         slot_set_ctid(slot, &(scan->cdb_fake_ctid));
+
+		if (scan->lateMaterialize)
+		{
+			ExprContext *econtext = scan->econtext;
+
+			Assert(rowNum != INT64CONST(-1));
+
+			/* The qual only looks at the columns read so far */
+			ResetExprContext(econtext);
+			econtext->ecxt_scantuple = slot;
+			scan->lateMatRows++;
+			if (!ExecQual(scan->qual, econtext, false))
+			{
+				rowNum = INT64CONST(-1);
+				goto ReadNext;
+			}
+			scan->lateMatRowsPassed++;
+
+			for (i = 0; i < ncol; i++)
+			{
+				if (scan->proj[i] && !scan->qualProj[i])
+				{
+					AOCSColumnBatch *batch = &scan->batches[i];
+
+					if (!aocs_catch_up_column(scan, i, rowNum))
+					{
+						close_cur_scan_seg(scan);
+						err = -1;
+						rowNum = INT64CONST(-1);
+						goto ReadNext;
+					}
+
+					d[i] = batch->values[batch->next];
+					null[i] = batch->nulls[batch->next];
+					batch->next++;
+				}
+			}
+		}
         return;
     }
 
@@ -841,6 +1163,7 @@ Oid aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool * null, AOTupleId *a
 	{
 		void *toFree1;
 		Datum datum;
+		bool isLob = false;
 
 		datum = d[i];
 		int err = datumstreamwrite_put(idesc->ds[i], datum, null[i], &toFree1);
@@ -894,6 +1217,7 @@ Oid aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool * null, AOTupleId *a
 
 				err = datumstreamwrite_lob(idesc->ds[i], datum);
 				Assert(err >= 0);
+				isLob = true;
 
 				/* Insert an entry to the block directory */
 				AppendOnlyBlockDirectory_InsertEntry(
@@ -914,6 +1238,11 @@ Oid aocs_insert_values(AOCSInsertDesc idesc, Datum *d, bool * null, AOTupleId *a
 			}
 		}
 
+		/* The value went into the current block, add it to its zone map */
+		if (!isLob)
+			AppendOnlyBlockDirectory_AddZoneMapValues(&idesc->blockDirectory,
+													  i, d, null);
+
 		if (toFree1 != NULL)
 		{
 			pfree(toFree1);
@@ -354,6 +354,25 @@ SetNextFileSegForRead(AppendOnlyScanDesc scan)
 								&scan->executorReadBlock,
 								/* blockFirstRowNum */ 1);
 
+	if (scan->numZoneMapKeys > 0)
+	{
+		MemoryContext oldMemoryContext = MemoryContextSwitchTo(scan->aoScanInitContext);
+
+		if (scan->skipRanges != NULL)
+			pfree(scan->skipRanges);
+		scan->numSkipRanges =
+			AppendOnlyBlockDirectory_ZoneMapSkipRanges(scan->aos_rd,
+													   scan->appendOnlyMetaDataSnapshot,
+													   scan->aos_segfile_arr[scan->aos_segfiles_processed - 1],
+													   false,
+													   scan->zoneMapKeys,
+													   scan->numZoneMapKeys,
+													   &scan->skipRanges);
+		scan->nextSkipRange = 0;
+
+		MemoryContextSwitchTo(oldMemoryContext);
+	}
+
 	/* ready to go! */
 	scan->aos_need_new_segfile = false;
 
@@ -1244,20 +1263,45 @@ getNextBlock(
 			return false;
 	}
 
-	if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
-									&scan->storageRead,
-									&scan->executorReadBlock))
+	while (true)
 	{
-		if (scan->buildBlockDirectory)
+		if (!AppendOnlyExecutorReadBlock_GetBlockInfo(
+										&scan->storageRead,
+										&scan->executorReadBlock))
 		{
-			Assert(scan->blockDirectory != NULL);
-			AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			if (scan->buildBlockDirectory)
+			{
+				Assert(scan->blockDirectory != NULL);
+				AppendOnlyBlockDirectory_End_forInsert(scan->blockDirectory);
+			}
+
+			/* done reading the file */
+			CloseScannedFileSeg(scan);
+
+			return false;
 		}
 
-		/* done reading the file */
-		CloseScannedFileSeg(scan);
+		/*
+		 * Skip the block without decompressing it if its rows are all in a
+		 * range that the zone maps rule out. Only blocks whose header has
+		 * the first row number can be placed in the ranges.
+		 */
+		if (scan->numSkipRanges > 0 &&
+			!scan->executorReadBlock.isLarge &&
+			scan->storageRead.current.hasFirstRowNum &&
+			AppendOnlyBlockDirectory_SkipRangeEnd(scan->skipRanges,
+												  scan->numSkipRanges,
+												  &scan->nextSkipRange,
+												  scan->executorReadBlock.blockFirstRowNum) >=
+			scan->executorReadBlock.blockFirstRowNum + scan->executorReadBlock.rowCount)
+		{
+			AppendOnlyStorageRead_SkipCurrentBlock(&scan->storageRead);
+			AppendOnlyExecutionReadBlock_FinishedScanBlock(&scan->executorReadBlock);
+			scan->zoneMapBlocksSkipped++;
+			continue;
+		}
 
-		return false;
+		break;
 	}
 
 	if (scan->buildBlockDirectory)
@@ -1745,6 +1789,24 @@ appendonly_rescan(AppendOnlyScanDesc scan,
 	initscan(scan, key);
 }
 
+/*
+ * appendonly_setzonemapkeys
+ *
+ * Let the scan skip the blocks whose zone maps in the block directory show
+ * that none of their rows satisfy all of keys, from
+ * AppendOnlyBlockDirectory_ZoneMapKeys. The keys must hold until the end
+ * of the scan.
+ */
+void
+appendonly_setzonemapkeys(AppendOnlyScanDesc scan,
+						  AppendOnlyZoneMapKey *keys, int nkeys)
+{
+	Assert(!scan->buildBlockDirectory);
+
+	scan->zoneMapKeys = keys;
+	scan->numZoneMapKeys = nkeys;
+}
+
 /* ----------------
  *		appendonly_endscan	- end relation scan
  * ----------------
@@ -2821,10 +2883,42 @@ appendonly_insert_init(Relation rel, Snapshot appendOnlyMetaDataSnapshot, int se
 		aoInsertDesc->fsInfo, aoInsertDesc->lastSequence,
 		rel, segno, 1, false);
 
+	if (aoInsertDesc->blockDirectory.blkdirRel != NULL &&
+		aoInsertDesc->blockDirectory.minipages[0].numZoneMapAttrs > 0)
+	{
+		aoInsertDesc->zoneMapValues = palloc0(sizeof(Datum) * RelationGetNumberOfAttributes(rel));
+		aoInsertDesc->zoneMapNulls = palloc0(sizeof(bool) * RelationGetNumberOfAttributes(rel));
+	}
+
 	return aoInsertDesc;
 }
 
 
+/*
+ * Add a tuple that was placed in the current VarBlock to the zone maps of
+ * the block directory entry that the VarBlock will get.
+ */
+static void
+addZoneMapValues(AppendOnlyInsertDesc aoInsertDesc, MemTuple tup)
+{
+	MinipagePerColumnGroup *minipageInfo =
+		&aoInsertDesc->blockDirectory.minipages[0];
+	int			i;
+
+	for (i = 0; i < minipageInfo->numZoneMapAttrs; i++)
+	{
+		AttrNumber	attno = minipageInfo->zoneMapAttnums[i];
+
+		aoInsertDesc->zoneMapValues[attno - 1] =
+			memtuple_getattr(tup, aoInsertDesc->mt_bind, attno,
+							 &aoInsertDesc->zoneMapNulls[attno - 1]);
+	}
+
+	AppendOnlyBlockDirectory_AddZoneMapValues(&aoInsertDesc->blockDirectory, 0,
+											  aoInsertDesc->zoneMapValues,
+											  aoInsertDesc->zoneMapNulls);
+}
+
 /*
  *	appendonly_insert		- insert tuple into a varblock
  *
@@ -3029,6 +3123,9 @@ appendonly_insert_init(Relation rel, Snapshot appendOnlyMetaDataSnapshot, int se
 
 		if (itemLen > 0)
 			memcpy(itemPtr, tup, itemLen);
+
+		if (aoInsertDesc->zoneMapValues != NULL)
+			addZoneMapValues(aoInsertDesc, instup);
 	}
 	else
 	{
@@ -3133,6 +3230,12 @@ appendonly_insert_finish(AppendOnlyInsertDesc aoInsertDesc)
 
 	AppendOnlyStorageWrite_FinishSession(&aoInsertDesc->storageWrite);
 
+	if (aoInsertDesc->zoneMapValues != NULL)
+	{
+		pfree(aoInsertDesc->zoneMapValues);
+		pfree(aoInsertDesc->zoneMapNulls);
+	}
+
 	pfree(aoInsertDesc->title);
 	pfree(aoInsertDesc);
 }
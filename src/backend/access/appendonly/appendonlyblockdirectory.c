@@ -18,16 +18,25 @@
 #include "catalog/aoblkdir.h"
 #include "access/heapam.h"
 #include "access/genam.h"
+#include "access/nbtree.h"
 #include "catalog/indexing.h"
+#include "catalog/pg_am.h"
+#include "catalog/pg_type.h"
+#include "commands/defrem.h"
+#include "nodes/primnodes.h"
+#include "optimizer/clauses.h"
 #include "parser/parse_oper.h"
+#include "utils/date.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/guc.h"
 #include "utils/fmgroids.h"
+#include "utils/timestamp.h"
 #include "cdb/cdbappendonlyam.h"
 
 int gp_blockdirectory_entry_min_range = 0;
 int gp_blockdirectory_minipage_size = NUM_MINIPAGE_ENTRIES;
+bool gp_blockdirectory_zone_maps = true;
 
 static inline uint32 minipage_size(uint32 nEntry)
 {
@@ -35,6 +44,16 @@ static inline uint32 minipage_size(uint32 nEntry)
 		sizeof(MinipageEntry) * nEntry;
 }
 
+/*
+ * The size of a minipage with nEntry entries, each with nZoneMapAttrs
+ * zone maps.
+ */
+static inline uint32 minipage_zonemap_size(uint32 nEntry, int nZoneMapAttrs)
+{
+	return minipage_size(nEntry) + sizeof(uint32) +
+		sizeof(MinipageZoneMap) * nZoneMapAttrs * nEntry;
+}
+
 static void load_last_minipage(
 	AppendOnlyBlockDirectory *blockDirectory,
 	int64 lastSequence,
@@ -62,6 +81,13 @@ insert_new_entry(AppendOnlyBlockDirectory *blockDirectory,
 				 int64 fileOffset,
 				 int64 rowCount,
 				 MinipagePerColumnGroup *minipageInfo);
+static void init_zone_maps(AppendOnlyBlockDirectory *blockDirectory);
+static void take_pending_zone_maps(
+	MinipagePerColumnGroup *minipageInfo,
+	int entryNo,
+	int64 rowCount,
+	bool merge);
+static void extract_zone_maps(MinipagePerColumnGroup *minipageInfo);
 
 void 
 AppendOnlyBlockDirectoryEntry_GetBeginRange(
@@ -148,8 +174,7 @@ init_internal(AppendOnlyBlockDirectory *blockDirectory)
 		}
 		MinipagePerColumnGroup *minipageInfo =
 			&blockDirectory->minipages[groupNo];
-		minipageInfo->minipage =
-			palloc0(minipage_size(NUM_MINIPAGE_ENTRIES));
+		minipageInfo->minipage = palloc0(MINIPAGE_MAX_SIZE);
 		minipageInfo->numMinipageEntries = 0;
 	}
 
@@ -269,6 +294,7 @@ AppendOnlyBlockDirectory_Init_forInsert(
 		index_open(aoRel->rd_appendonly->blkdiridxid, RowExclusiveLock);
 
 	init_internal(blockDirectory);
+	init_zone_maps(blockDirectory);
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
 				(errmsg("Append-only block directory init for insert: "
@@ -710,7 +736,10 @@ insert_new_entry(
 		
 		if (gp_blockdirectory_entry_min_range > 0 &&
 			fileOffset - entry->fileOffset < gp_blockdirectory_entry_min_range)
+		{
+			take_pending_zone_maps(minipageInfo, lastEntryNo, rowCount, true);
 			return true;
+		}
 		
 		/* Update the rowCount in the latest entry */
 		Assert(entry->rowCount <= firstRowNum - entry->firstRowNum);
@@ -729,7 +758,10 @@ insert_new_entry(
 		entry->rowCount = firstRowNum - entry->firstRowNum;
 	}
 	
-	if (minipageInfo->numMinipageEntries >= (uint32)gp_blockdirectory_minipage_size)
+	if (minipageInfo->numMinipageEntries >= (uint32)gp_blockdirectory_minipage_size ||
+		(minipageInfo->hasZoneMaps &&
+		 minipage_zonemap_size(minipageInfo->numMinipageEntries + 1,
+							   minipageInfo->numZoneMapAttrs) > MINIPAGE_MAX_SIZE))
 	{
 		write_minipage(blockDirectory, columnGroupNo, minipageInfo);
 
@@ -746,11 +778,22 @@ insert_new_entry(
 	
 	Assert(minipageInfo->numMinipageEntries < (uint32)gp_blockdirectory_minipage_size);
 
+	/*
+	 * A new minipage has zone maps if the rows of its first entry were
+	 * tracked. Scans that build the block directory of existing data don't
+	 * track any.
+	 */
+	if (minipageInfo->numMinipageEntries == 0)
+		minipageInfo->hasZoneMaps = (minipageInfo->numZoneMapAttrs > 0 &&
+									 minipageInfo->pendingRowCount > 0);
+
 	entry = &(minipageInfo->minipage->entry[minipageInfo->numMinipageEntries]);
 	entry->firstRowNum = firstRowNum;
 	entry->fileOffset = fileOffset;
 	entry->rowCount = rowCount;
 	
+	take_pending_zone_maps(minipageInfo, minipageInfo->numMinipageEntries,
+						   rowCount, false);
 	minipageInfo->numMinipageEntries++;
 	
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -911,7 +954,7 @@ copy_out_minipage(MinipagePerColumnGroup *minipageInfo,
 	value = (struct varlena *)
 		DatumGetPointer(minipage_value);
 	detoast_value = pg_detoast_datum(value);
-	Assert( VARSIZE(detoast_value) <= minipage_size(NUM_MINIPAGE_ENTRIES));
+	Assert( VARSIZE(detoast_value) <= MINIPAGE_MAX_SIZE);
 
 	memcpy(minipageInfo->minipage, detoast_value, VARSIZE(detoast_value));
 	if (detoast_value != value)
@@ -920,6 +963,9 @@ copy_out_minipage(MinipagePerColumnGroup *minipageInfo,
 	Assert(minipageInfo->minipage->nEntry <= NUM_MINIPAGE_ENTRIES);
 	
 	minipageInfo->numMinipageEntries = minipageInfo->minipage->nEntry;
+
+	if (minipageInfo->numZoneMapAttrs > 0)
+		extract_zone_maps(minipageInfo);
 }
 
 
@@ -1151,8 +1197,27 @@ write_minipage(AppendOnlyBlockDirectory *blockDirectory,
 		Int64GetDatum(minipageInfo->minipage->entry[0].firstRowNum);
 	nulls[Anum_pg_aoblkdir_firstrownum - 1] = false;
 
-	SET_VARSIZE(minipageInfo->minipage,
-				minipage_size(minipageInfo->numMinipageEntries));
+	if (minipageInfo->hasZoneMaps)
+	{
+		uint32 nEntry = minipageInfo->numMinipageEntries;
+		uint32 nZoneMapAttrs = minipageInfo->numZoneMapAttrs;
+		char *trailer = (char *) &minipageInfo->minipage->entry[nEntry];
+
+		Assert(minipage_zonemap_size(nEntry, nZoneMapAttrs) <= MINIPAGE_MAX_SIZE);
+
+		memcpy(trailer, &nZoneMapAttrs, sizeof(uint32));
+		memcpy(trailer + sizeof(uint32), minipageInfo->zoneMaps,
+			   sizeof(MinipageZoneMap) * nZoneMapAttrs * nEntry);
+		SET_VARSIZE(minipageInfo->minipage,
+					minipage_zonemap_size(nEntry, nZoneMapAttrs));
+		minipageInfo->minipage->version = MINIPAGE_VERSION_ZONEMAP;
+	}
+	else
+	{
+		SET_VARSIZE(minipageInfo->minipage,
+					minipage_size(minipageInfo->numMinipageEntries));
+		minipageInfo->minipage->version = MINIPAGE_VERSION_ORIGINAL;
+	}
 	minipageInfo->minipage->nEntry = minipageInfo->numMinipageEntries;
 	values[Anum_pg_aoblkdir_minipage - 1] =
 		PointerGetDatum(minipageInfo->minipage);
@@ -1227,6 +1292,12 @@ AppendOnlyBlockDirectory_End_forInsert(
 		}
 		
 		pfree(minipageInfo->minipage);
+		if (minipageInfo->numZoneMapAttrs > 0)
+		{
+			pfree(minipageInfo->zoneMapAttnums);
+			pfree(minipageInfo->zoneMaps);
+			pfree(minipageInfo->pendingZoneMaps);
+		}
 	}
 
 	ereportif(Debug_appendonly_print_blockdirectory, LOG,
@@ -1338,3 +1409,699 @@ AppendOnlyBlockDirectory_End_addCol(
 	MemoryContextDelete(blockDirectory->memoryContext);
 }
 
+
+/*
+ * zonemap_type_supported
+ *
+ * Can columns of the given type have zone maps? Their values must order
+ * the same way as the int64s that zonemap_value returns for them.
+ */
+static bool
+zonemap_type_supported(Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case DATEOID:
+#ifdef HAVE_INT64_TIMESTAMP
+		case TIMEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+#endif
+			return true;
+		default:
+			return false;
+	}
+}
+
+static inline bool
+zonemap_type_is_integer(Oid typid)
+{
+	return (typid == INT2OID || typid == INT4OID || typid == INT8OID);
+}
+
+static int64
+zonemap_value(Oid typid, Datum value)
+{
+	Assert(zonemap_type_supported(typid));
+
+	switch (typid)
+	{
+		case INT2OID:
+			return (int64) DatumGetInt16(value);
+		case INT4OID:
+			return (int64) DatumGetInt32(value);
+		case DATEOID:
+			return (int64) DatumGetDateADT(value);
+		default:
+			return DatumGetInt64(value);
+	}
+}
+
+/*
+ * init_zone_maps
+ *
+ * Choose the columns that have zone maps in each column group: the column
+ * of a column group of a column-oriented table, or the first
+ * MAX_ZONEMAP_ATTRS columns of a row-oriented table whose type is
+ * supported.
+ */
+static void
+init_zone_maps(AppendOnlyBlockDirectory *blockDirectory)
+{
+	TupleDesc tupleDesc = RelationGetDescr(blockDirectory->aoRel);
+	MemoryContext oldcxt;
+	int groupNo;
+
+	if (!gp_blockdirectory_zone_maps)
+		return;
+
+	oldcxt = MemoryContextSwitchTo(blockDirectory->memoryContext);
+
+	for (groupNo = 0; groupNo < blockDirectory->numColumnGroups; groupNo++)
+	{
+		MinipagePerColumnGroup *minipageInfo =
+			&blockDirectory->minipages[groupNo];
+		AttrNumber attnums[MAX_ZONEMAP_ATTRS];
+		int nattrs = 0;
+		int attno;
+		int i;
+
+		for (attno = 1;
+			 attno <= tupleDesc->natts && nattrs < MAX_ZONEMAP_ATTRS;
+			 attno++)
+		{
+			Form_pg_attribute attr = tupleDesc->attrs[attno - 1];
+
+			if (blockDirectory->isAOCol && attno != groupNo + 1)
+				continue;
+
+			if (!attr->attisdropped && zonemap_type_supported(attr->atttypid))
+				attnums[nattrs++] = attno;
+		}
+
+		if (nattrs == 0)
+			continue;
+
+		minipageInfo->numZoneMapAttrs = nattrs;
+		minipageInfo->zoneMapAttnums = palloc(sizeof(AttrNumber) * nattrs);
+		memcpy(minipageInfo->zoneMapAttnums, attnums, sizeof(AttrNumber) * nattrs);
+		minipageInfo->zoneMaps =
+			palloc0(sizeof(MinipageZoneMap) * nattrs * NUM_MINIPAGE_ENTRIES);
+		minipageInfo->pendingZoneMaps = palloc0(sizeof(MinipageZoneMap) * nattrs);
+		for (i = 0; i < nattrs; i++)
+			minipageInfo->pendingZoneMaps[i].attnum = attnums[i];
+		minipageInfo->pendingRowCount = 0;
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * extract_zone_maps
+ *
+ * Copy out the zone maps of a minipage just read from the block directory
+ * relation. Entries added to it only get zone maps if it has them for the
+ * same columns; otherwise it is written back without any.
+ */
+static void
+extract_zone_maps(MinipagePerColumnGroup *minipageInfo)
+{
+	Minipage *minipage = minipageInfo->minipage;
+	uint32 nEntry = minipage->nEntry;
+	char *trailer = (char *) &minipage->entry[nEntry];
+	uint32 nZoneMapAttrs;
+	int i;
+
+	minipageInfo->hasZoneMaps = false;
+
+	if (minipage->version != MINIPAGE_VERSION_ZONEMAP || nEntry == 0)
+		return;
+
+	memcpy(&nZoneMapAttrs, trailer, sizeof(uint32));
+	if (nZoneMapAttrs != minipageInfo->numZoneMapAttrs ||
+		VARSIZE(minipage) != minipage_zonemap_size(nEntry, nZoneMapAttrs))
+		return;
+
+	memcpy(minipageInfo->zoneMaps, trailer + sizeof(uint32),
+		   sizeof(MinipageZoneMap) * nZoneMapAttrs * nEntry);
+
+	for (i = 0; i < nZoneMapAttrs; i++)
+	{
+		if (minipageInfo->zoneMaps[i].attnum != minipageInfo->zoneMapAttnums[i])
+			return;
+	}
+
+	minipageInfo->hasZoneMaps = true;
+}
+
+/*
+ * take_pending_zone_maps
+ *
+ * Move the zone maps of the rows added since the last entry to entry
+ * entryNo, which was just given a block of rowCount rows. If merge is
+ * true, the entry covers earlier blocks as well, and its zone maps are
+ * widened instead. A zone map is only valid if every row of every block
+ * of the entry was added.
+ */
+static void
+take_pending_zone_maps(MinipagePerColumnGroup *minipageInfo,
+					   int entryNo,
+					   int64 rowCount,
+					   bool merge)
+{
+	int nattrs = minipageInfo->numZoneMapAttrs;
+	bool valid = (minipageInfo->pendingRowCount == rowCount);
+	int i;
+
+	if (nattrs == 0)
+		return;
+
+	for (i = 0; i < nattrs; i++)
+	{
+		MinipageZoneMap *pending = &minipageInfo->pendingZoneMaps[i];
+		MinipageZoneMap *zoneMap;
+
+		if (minipageInfo->hasZoneMaps)
+		{
+			zoneMap = &minipageInfo->zoneMaps[entryNo * nattrs + i];
+
+			if (!merge)
+			{
+				*zoneMap = *pending;
+				if (valid)
+					zoneMap->flags |= ZONEMAP_VALID;
+			}
+			else if (!valid)
+				zoneMap->flags &= ~ZONEMAP_VALID;
+			else if ((pending->flags & ZONEMAP_HAS_VALUES) &&
+					 !(zoneMap->flags & ZONEMAP_HAS_VALUES))
+			{
+				zoneMap->min = pending->min;
+				zoneMap->max = pending->max;
+				zoneMap->flags |= ZONEMAP_HAS_VALUES;
+			}
+			else if (pending->flags & ZONEMAP_HAS_VALUES)
+			{
+				zoneMap->min = Min(zoneMap->min, pending->min);
+				zoneMap->max = Max(zoneMap->max, pending->max);
+			}
+		}
+
+		pending->min = 0;
+		pending->max = 0;
+		pending->flags = 0;
+	}
+
+	minipageInfo->pendingRowCount = 0;
+}
+
+/*
+ * AppendOnlyBlockDirectory_AddZoneMapValues
+ *
+ * Add a row to the zone maps of the next entry of a column group. values
+ * and nulls are indexed by attribute number - 1, and only the columns
+ * that have zone maps in the group are looked at.
+ */
+void
+AppendOnlyBlockDirectory_AddZoneMapValues(
+	AppendOnlyBlockDirectory *blockDirectory,
+	int columnGroupNo,
+	Datum *values,
+	bool *nulls)
+{
+	MinipagePerColumnGroup *minipageInfo;
+	TupleDesc tupleDesc;
+	int i;
+
+	if (blockDirectory->blkdirRel == NULL)
+		return;
+
+	minipageInfo = &blockDirectory->minipages[columnGroupNo];
+	if (minipageInfo->numZoneMapAttrs == 0)
+		return;
+
+	tupleDesc = RelationGetDescr(blockDirectory->aoRel);
+
+	for (i = 0; i < minipageInfo->numZoneMapAttrs; i++)
+	{
+		MinipageZoneMap *zoneMap = &minipageInfo->pendingZoneMaps[i];
+		int attno = zoneMap->attnum;
+		int64 value;
+
+		if (nulls[attno - 1])
+			continue;
+
+		value = zonemap_value(tupleDesc->attrs[attno - 1]->atttypid,
+							  values[attno - 1]);
+
+		if (!(zoneMap->flags & ZONEMAP_HAS_VALUES))
+		{
+			zoneMap->min = value;
+			zoneMap->max = value;
+			zoneMap->flags |= ZONEMAP_HAS_VALUES;
+		}
+		else if (value < zoneMap->min)
+			zoneMap->min = value;
+		else if (value > zoneMap->max)
+			zoneMap->max = value;
+	}
+
+	minipageInfo->pendingRowCount++;
+}
+
+/*
+ * zonemap_key_from_clause
+ *
+ * Make a zone map key out of a qual clause of the form "column op
+ * constant" or "constant op column", where op is a btree comparison
+ * operator of the column's type.
+ */
+static bool
+zonemap_key_from_clause(Relation aoRel, Index scanrelid, Node *clause,
+						AppendOnlyZoneMapKey *key)
+{
+	OpExpr *opexpr;
+	Node *leftop;
+	Node *rightop;
+	Var *var;
+	Const *cnst;
+	Form_pg_attribute attr;
+	Oid opclass;
+	int strategy;
+
+	if (!IsA(clause, OpExpr))
+		return false;
+
+	opexpr = (OpExpr *) clause;
+	if (list_length(opexpr->args) != 2)
+		return false;
+
+	leftop = (Node *) linitial(opexpr->args);
+	rightop = (Node *) lsecond(opexpr->args);
+	if (IsA(leftop, Var) && IsA(rightop, Const))
+	{
+		var = (Var *) leftop;
+		cnst = (Const *) rightop;
+	}
+	else if (IsA(leftop, Const) && IsA(rightop, Var))
+	{
+		var = (Var *) rightop;
+		cnst = (Const *) leftop;
+	}
+	else
+		return false;
+
+	if (var->varno != scanrelid || var->varlevelsup != 0 ||
+		var->varattno <= 0 ||
+		var->varattno > RelationGetNumberOfAttributes(aoRel) ||
+		cnst->constisnull)
+		return false;
+
+	attr = RelationGetDescr(aoRel)->attrs[var->varattno - 1];
+	if (attr->attisdropped ||
+		attr->atttypid != var->vartype ||
+		!zonemap_type_supported(attr->atttypid))
+		return false;
+
+	/* Only integers are compared across types */
+	if (cnst->consttype != attr->atttypid &&
+		!(zonemap_type_is_integer(cnst->consttype) &&
+		  zonemap_type_is_integer(attr->atttypid)))
+		return false;
+
+	opclass = GetDefaultOpClass(attr->atttypid, BTREE_AM_OID);
+	if (!OidIsValid(opclass))
+		return false;
+
+	strategy = get_op_opfamily_strategy(opexpr->opno,
+										get_opclass_family(opclass));
+	if (strategy == InvalidStrategy)
+		return false;
+
+	if ((Node *) var == rightop)
+		strategy = BTCommuteStrategyNumber(strategy);
+
+	key->attnum = var->varattno;
+	key->strategy = strategy;
+	key->value = zonemap_value(cnst->consttype, cnst->constvalue);
+
+	return true;
+}
+
+static List *
+zonemap_flatten_qual(List *qual, List *clauses)
+{
+	ListCell *lc;
+
+	foreach(lc, qual)
+	{
+		Node *clause = (Node *) lfirst(lc);
+
+		if (and_clause(clause))
+			clauses = zonemap_flatten_qual(((BoolExpr *) clause)->args, clauses);
+		else
+			clauses = lappend(clauses, clause);
+	}
+
+	return clauses;
+}
+
+/*
+ * AppendOnlyBlockDirectory_ZoneMapKeys
+ *
+ * Find the clauses of a scan's qual that zone maps can rule blocks out
+ * with. Returns NULL, with *nkeys set to 0, if there are none or if the
+ * relation has no block directory.
+ */
+AppendOnlyZoneMapKey *
+AppendOnlyBlockDirectory_ZoneMapKeys(Relation aoRel,
+									 Index scanrelid,
+									 List *qual,
+									 int *nkeys)
+{
+	AppendOnlyZoneMapKey *keys;
+	List *clauses;
+	ListCell *lc;
+
+	*nkeys = 0;
+
+	if (!gp_blockdirectory_zone_maps ||
+		!OidIsValid(aoRel->rd_appendonly->blkdirrelid) ||
+		qual == NIL)
+		return NULL;
+
+	clauses = zonemap_flatten_qual(qual, NIL);
+	keys = palloc(sizeof(AppendOnlyZoneMapKey) * list_length(clauses));
+
+	foreach(lc, clauses)
+	{
+		if (zonemap_key_from_clause(aoRel, scanrelid, (Node *) lfirst(lc),
+									&keys[*nkeys]))
+			(*nkeys)++;
+	}
+
+	list_free(clauses);
+
+	if (*nkeys == 0)
+	{
+		pfree(keys);
+		return NULL;
+	}
+
+	return keys;
+}
+
+/*
+ * Does the zone map show that none of the rows of its entry satisfy all
+ * of keys? The comparison operators are strict, so rows where the column
+ * is NULL never do.
+ */
+static bool
+zonemap_excludes(MinipageZoneMap *zoneMap, AppendOnlyZoneMapKey *keys, int nkeys)
+{
+	int k;
+
+	if (!(zoneMap->flags & ZONEMAP_VALID))
+		return false;
+
+	for (k = 0; k < nkeys; k++)
+	{
+		int64 value = keys[k].value;
+
+		if (keys[k].attnum != zoneMap->attnum)
+			continue;
+
+		if (!(zoneMap->flags & ZONEMAP_HAS_VALUES))
+			return true;
+
+		switch (keys[k].strategy)
+		{
+			case BTLessStrategyNumber:
+				if (zoneMap->min >= value)
+					return true;
+				break;
+			case BTLessEqualStrategyNumber:
+				if (zoneMap->min > value)
+					return true;
+				break;
+			case BTEqualStrategyNumber:
+				if (value < zoneMap->min || value > zoneMap->max)
+					return true;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				if (zoneMap->max < value)
+					return true;
+				break;
+			case BTGreaterStrategyNumber:
+				if (zoneMap->max <= value)
+					return true;
+				break;
+		}
+	}
+
+	return false;
+}
+
+static int
+skip_range_cmp(const void *a, const void *b)
+{
+	int64 first1 = *(const int64 *) a;
+	int64 first2 = *(const int64 *) b;
+
+	if (first1 < first2)
+		return -1;
+	if (first1 > first2)
+		return 1;
+	return 0;
+}
+
+/*
+ * AppendOnlyBlockDirectory_ZoneMapSkipRanges
+ *
+ * Find the rows of a segment file that the zone maps in the block
+ * directory show can't satisfy all of keys. They are returned in *ranges,
+ * allocated in the current memory context, as sorted and disjoint pairs
+ * of the first row number and the row number after the last. The number
+ * of pairs is returned.
+ */
+int
+AppendOnlyBlockDirectory_ZoneMapSkipRanges(
+	Relation aoRel,
+	Snapshot appendOnlyMetaDataSnapshot,
+	FileSegInfo *segmentFileInfo,
+	bool isAOCol,
+	AppendOnlyZoneMapKey *keys,
+	int nkeys,
+	int64 **ranges)
+{
+	MemoryContext scanContext;
+	MemoryContext oldcxt;
+	Relation blkdirRel;
+	Relation blkdirIdx;
+	TupleDesc heapTupleDesc;
+	Minipage *minipage;
+	int64 *result;
+	int maxRanges = 16;
+	int numRanges = 0;
+	int numColumnGroups;
+	int segno;
+	int groupNo;
+	int i;
+
+	*ranges = NULL;
+
+	if (nkeys == 0 || !OidIsValid(aoRel->rd_appendonly->blkdirrelid))
+		return 0;
+
+	if (isAOCol)
+	{
+		segno = ((AOCSFileSegInfo *) segmentFileInfo)->segno;
+		numColumnGroups = RelationGetNumberOfAttributes(aoRel);
+	}
+	else
+	{
+		segno = segmentFileInfo->segno;
+		numColumnGroups = 1;
+	}
+
+	result = palloc(sizeof(int64) * 2 * maxRanges);
+
+	scanContext = AllocSetContextCreate(CurrentMemoryContext,
+										"ZoneMapScanContext",
+										ALLOCSET_DEFAULT_MINSIZE,
+										ALLOCSET_DEFAULT_INITSIZE,
+										ALLOCSET_DEFAULT_MAXSIZE);
+	oldcxt = MemoryContextSwitchTo(scanContext);
+
+	blkdirRel = heap_open(aoRel->rd_appendonly->blkdirrelid, AccessShareLock);
+	blkdirIdx = index_open(aoRel->rd_appendonly->blkdiridxid, AccessShareLock);
+	heapTupleDesc = RelationGetDescr(blkdirRel);
+
+	minipage = palloc(MINIPAGE_MAX_SIZE);
+
+	for (groupNo = 0; groupNo < numColumnGroups; groupNo++)
+	{
+		ScanKeyData scanKeys[2];
+		IndexScanDesc idxScanDesc;
+		HeapTuple tuple;
+		int64 eof;
+
+		if (isAOCol)
+		{
+			/* Only the column groups of the columns in keys matter */
+			for (i = 0; i < nkeys; i++)
+			{
+				if (keys[i].attnum == groupNo + 1)
+					break;
+			}
+			if (i == nkeys)
+				continue;
+
+			eof = ((AOCSFileSegInfo *) segmentFileInfo)->vpinfo.entry[groupNo].eof;
+		}
+		else
+			eof = segmentFileInfo->eof;
+
+		ScanKeyInit(&scanKeys[0],
+					1, /* segno */
+					BTEqualStrategyNumber,
+					F_INT4EQ,
+					Int32GetDatum(segno));
+		ScanKeyInit(&scanKeys[1],
+					2, /* columngroupno */
+					BTEqualStrategyNumber,
+					F_INT4EQ,
+					Int32GetDatum(groupNo));
+
+		idxScanDesc = index_beginscan(blkdirRel, blkdirIdx,
+									  appendOnlyMetaDataSnapshot,
+									  2, scanKeys);
+
+		while ((tuple = index_getnext(idxScanDesc, ForwardScanDirection)) != NULL)
+		{
+			Datum value;
+			bool isnull;
+			struct varlena *detoast_value;
+			char *trailer;
+			uint32 nZoneMapAttrs;
+			uint32 entryNo;
+
+			value = heap_getattr(tuple, Anum_pg_aoblkdir_minipage,
+								 heapTupleDesc, &isnull);
+			Assert(!isnull);
+			detoast_value = pg_detoast_datum((struct varlena *) DatumGetPointer(value));
+			Assert(VARSIZE(detoast_value) <= MINIPAGE_MAX_SIZE);
+			memcpy(minipage, detoast_value, VARSIZE(detoast_value));
+			if (detoast_value != (struct varlena *) DatumGetPointer(value))
+				pfree(detoast_value);
+
+			if (minipage->version != MINIPAGE_VERSION_ZONEMAP)
+				continue;
+
+			trailer = (char *) &minipage->entry[minipage->nEntry];
+			memcpy(&nZoneMapAttrs, trailer, sizeof(uint32));
+			trailer += sizeof(uint32);
+
+			for (entryNo = 0; entryNo < minipage->nEntry; entryNo++)
+			{
+				MinipageEntry *entry = &minipage->entry[entryNo];
+				MinipageZoneMap zoneMap;
+				uint32 attrNo;
+
+				/* Entries past the end of file are left over from aborted inserts */
+				if (entry->fileOffset >= eof)
+					break;
+
+				for (attrNo = 0; attrNo < nZoneMapAttrs; attrNo++)
+				{
+					memcpy(&zoneMap,
+						   trailer + sizeof(MinipageZoneMap) *
+						   (entryNo * nZoneMapAttrs + attrNo),
+						   sizeof(MinipageZoneMap));
+					if (zonemap_excludes(&zoneMap, keys, nkeys))
+						break;
+				}
+
+				if (attrNo == nZoneMapAttrs)
+					continue;
+
+				if (numRanges == maxRanges)
+				{
+					maxRanges *= 2;
+					result = repalloc(result, sizeof(int64) * 2 * maxRanges);
+				}
+				result[2 * numRanges] = entry->firstRowNum;
+				result[2 * numRanges + 1] = entry->firstRowNum + entry->rowCount;
+				numRanges++;
+			}
+		}
+
+		index_endscan(idxScanDesc);
+	}
+
+	index_close(blkdirIdx, AccessShareLock);
+	heap_close(blkdirRel, AccessShareLock);
+
+	MemoryContextSwitchTo(oldcxt);
+	MemoryContextDelete(scanContext);
+
+	/* Sort the ranges of all column groups, and merge the overlapping ones */
+	if (numRanges > 1)
+	{
+		int n = 0;
+
+		qsort(result, numRanges, sizeof(int64) * 2, skip_range_cmp);
+		for (i = 1; i < numRanges; i++)
+		{
+			if (result[2 * i] <= result[2 * n + 1])
+				result[2 * n + 1] = Max(result[2 * n + 1], result[2 * i + 1]);
+			else
+			{
+				n++;
+				result[2 * n] = result[2 * i];
+				result[2 * n + 1] = result[2 * i + 1];
+			}
+		}
+		numRanges = n + 1;
+	}
+
+	ereportif(Debug_appendonly_print_blockdirectory, LOG,
+				(errmsg("Append-only block directory zone maps: "
+						"(segno, nkeys, numRanges) = (%d, %d, %d)",
+						segno, nkeys, numRanges)));
+
+	if (numRanges == 0)
+	{
+		pfree(result);
+		return 0;
+	}
+
+	*ranges = result;
+	return numRanges;
+}
+
+/*
+ * AppendOnlyBlockDirectory_SkipRangeEnd
+ *
+ * If rowNum is in one of the ranges that
+ * AppendOnlyBlockDirectory_ZoneMapSkipRanges returned, return the row
+ * number after that range; otherwise return rowNum. Row numbers must be
+ * looked up in increasing order, *nextRange keeps the place in ranges.
+ */
+int64
+AppendOnlyBlockDirectory_SkipRangeEnd(int64 *ranges,
+									  int numRanges,
+									  int *nextRange,
+									  int64 rowNum)
+{
+	while (*nextRange < numRanges && ranges[2 * (*nextRange) + 1] <= rowNum)
+		(*nextRange)++;
+
+	if (*nextRange < numRanges && ranges[2 * (*nextRange)] <= rowNum)
+		return ranges[2 * (*nextRange) + 1];
+
+	return rowNum;
+}
@@ -195,6 +195,18 @@ setDefaultAOStorageOpts(StdRdOptions *copy)
 }
 
 static int setDefaultCompressionLevel(char* compresstype);
+static bool rleTypeCompressLevelIsValid(int complevel);
+
+/* The rle_type compresslevels accepted by rleTypeCompressLevelIsValid() */
+#if defined(HAVE_LIBLZ4) && defined(HAVE_LIBZSTD)
+#define RLE_TYPE_COMPRESSLEVEL_RANGE "1 to 8"
+#elif defined(HAVE_LIBZSTD)
+#define RLE_TYPE_COMPRESSLEVEL_RANGE "1 to 4 or 6 to 8"
+#elif defined(HAVE_LIBLZ4)
+#define RLE_TYPE_COMPRESSLEVEL_RANGE "1 to 5"
+#else
+#define RLE_TYPE_COMPRESSLEVEL_RANGE "1 to 4"
+#endif
 
 /*
  * Transform a relation options list (list of DefElem) into the text array
@@ -1094,7 +1106,10 @@ parse_validate_reloptions(StdRdOptions *result, Datum reloptions,
 			ereport(ERROR,
 					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 					 errmsg("compresstype can\'t be used with compresslevel 0")));
-		if (result->compresslevel < 0 || result->compresslevel > 9)
+		if (result->compresslevel < 0 ||
+			(result->compresslevel > 9 &&
+			 !(result->compresstype &&
+			   pg_strcasecmp(result->compresstype, "zstd") == 0)))
 		{
 			if (validate)
 				ereport(ERROR,
@@ -1131,15 +1146,47 @@ parse_validate_reloptions(StdRdOptions *result, Datum reloptions,
 					result->compresstype);
 		}
 
+		if (result->compresstype &&
+			(pg_strcasecmp(result->compresstype, "lz4") == 0) &&
+			(result->compresslevel != 1))
+		{
+			if (validate)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("compresslevel=%d is out of range for "
+								"lz4 (should be 1)",
+								result->compresslevel),
+						 errOmitLocation(true)));
+
+			result->compresslevel = setDefaultCompressionLevel(
+					result->compresstype);
+		}
+
+		if (result->compresstype &&
+			(pg_strcasecmp(result->compresstype, "zstd") == 0) &&
+			(result->compresslevel > 19))
+		{
+			if (validate)
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("compresslevel=%d is out of range for zstd"
+								" (should be in the range 1 to 19)",
+								result->compresslevel)));
+
+			result->compresslevel = setDefaultCompressionLevel(
+					result->compresstype);
+		}
+
 		if (result->compresstype &&
 			(pg_strcasecmp(result->compresstype, "rle_type") == 0) &&
-			(result->compresslevel > 4))
+			!rleTypeCompressLevelIsValid(result->compresslevel))
 		{
 			if (validate)
 				ereport(ERROR,
 						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 						 errmsg("compresslevel=%d is out of range for rle_type"
-								" (should be in the range 1 to 4)",
+								" (should be in the range "
+								RLE_TYPE_COMPRESSLEVEL_RANGE ")",
 								result->compresslevel)));
 
 			result->compresslevel = setDefaultCompressionLevel(
@@ -1381,7 +1428,9 @@ void validateAppendOnlyRelOptions(bool ao,
 	if (comptype &&
 		(pg_strcasecmp(comptype, "quicklz") == 0 ||
 		 pg_strcasecmp(comptype, "zlib") == 0 ||
-		 pg_strcasecmp(comptype, "rle_type") == 0))
+		 pg_strcasecmp(comptype, "rle_type") == 0 ||
+		 pg_strcasecmp(comptype, "zstd") == 0 ||
+		 pg_strcasecmp(comptype, "lz4") == 0))
 	{
 
 		if (! co &&
@@ -1398,7 +1447,8 @@ void validateAppendOnlyRelOptions(bool ao,
 					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 					 errmsg("compresstype cannot be used with compresslevel 0")));
 
-		if (complevel < 0 || complevel > 9)
+		if (complevel < 0 ||
+			(complevel > 9 && pg_strcasecmp(comptype, "zstd") != 0))
 			ereport(ERROR,
 					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 					 errmsg("compresslevel=%d is out of range (should be between 0 and 9)",
@@ -1412,13 +1462,30 @@ void validateAppendOnlyRelOptions(bool ao,
 						 errmsg("compresslevel=%d is out of range for quicklz "
 								 "(should be 1)", complevel)));
 		}
+		if (comptype && (pg_strcasecmp(comptype, "lz4") == 0) &&
+			(complevel != 1))
+		{
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("compresslevel=%d is out of range for lz4 "
+								 "(should be 1)", complevel)));
+		}
+		if (comptype && (pg_strcasecmp(comptype, "zstd") == 0) &&
+			(complevel > 19))
+		{
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("compresslevel=%d is out of range for zstd "
+							"(should be in the range 1 to 19)", complevel)));
+		}
 		if (comptype && (pg_strcasecmp(comptype, "rle_type") == 0) &&
-			(complevel > 4))
+			!rleTypeCompressLevelIsValid(complevel))
 		{
 			ereport(ERROR,
 					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 					 errmsg("compresslevel=%d is out of range for rle_type "
-							"(should be in the range 1 to 4)", complevel)));
+							"(should be in the range "
+							RLE_TYPE_COMPRESSLEVEL_RANGE ")", complevel)));
 		}
 	}
 
@@ -1444,9 +1511,31 @@ void validateAppendOnlyRelOptions(bool ao,
 						blocksize, gp_safefswritesize)));
 }
 
+/*
+ * rle_type uses the compresslevel to pick the bulk compression applied on
+ * top of it, see init_datumstream_info(): 1 is none, 2 to 4 are zlib, 5 is
+ * lz4 and 6 to 8 are zstd.  The lz4 and zstd levels are only accepted if
+ * the server was built with the library.
+ */
+static bool
+rleTypeCompressLevelIsValid(int complevel)
+{
+	if (complevel >= 1 && complevel <= 4)
+		return true;
+#ifdef HAVE_LIBLZ4
+	if (complevel == 5)
+		return true;
+#endif
+#ifdef HAVE_LIBZSTD
+	if (complevel >= 6 && complevel <= 8)
+		return true;
+#endif
+	return false;
+}
+
 /*
  * if no compressor type was specified, we set to no compression (level 0)
- * otherwise default for both zlib, quicklz and RLE to level 1.
+ * otherwise default for zlib, zstd, quicklz, lz4 and RLE to level 1.
  */
 static int setDefaultCompressionLevel(char* compresstype)
 {
@@ -31,6 +31,7 @@
 #include "access/xlogutils.h"
 #include "access/fileam.h"
 #include "catalog/namespace.h"
+#include "codegen/codegen_wrapper.h"
 #include "commands/async.h"
 #include "commands/tablecmds.h"
 #include "commands/trigger.h"
@@ -3987,6 +3988,7 @@ AbortTransaction(void)
 	/*
 	 * do abort processing
 	 */
+	AtAbort_Codegen();
 	AfterTriggerEndXact(false);
 	AtAbort_Portals();
 	AtEOXact_ExtTables(false);
@@ -6243,6 +6245,7 @@ AbortSubTransaction(void)
 	 */
 	if (s->curTransactionOwner)
 	{
+		AtAbort_Codegen();
 		AfterTriggerEndSubXact(false);
 		AtSubAbort_Portals(s->subTransactionId,
 						   s->parent->subTransactionId,
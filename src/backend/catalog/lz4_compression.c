@@ -0,0 +1,152 @@
+/*
+ * lz4_compression.c
+ *	  Interfaces to LZ4 compression functionality.
+ *
+ * LZ4 has a single compression level.  It compresses less than zlib, but
+ * decompresses several times faster, which suits tables that are scanned
+ * much more often than they are loaded.
+ *
+ * If the server was built without liblz4, the functions are still
+ * registered in pg_compression but refuse to run.
+ */
+
+#include "postgres.h"
+#include "fmgr.h"
+
+#include "catalog/pg_compression.h"
+#include "utils/builtins.h"
+
+#ifdef HAVE_LIBLZ4
+
+#include <lz4.h>
+
+Datum
+lz4_constructor(PG_FUNCTION_ARGS)
+{
+	/* PG_GETARG_POINTER(0) is TupleDesc that is currently unused. */
+
+	StorageAttributes *sa = PG_GETARG_POINTER(1);
+	CompressionState *cs = palloc0(sizeof(CompressionState));
+
+	cs->opaque = NULL;
+	cs->desired_sz = NULL;
+
+	Insist(PointerIsValid(sa->comptype));
+
+	PG_RETURN_POINTER(cs);
+}
+
+Datum
+lz4_destructor(PG_FUNCTION_ARGS)
+{
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_compress(PG_FUNCTION_ARGS)
+{
+	const void *src = PG_GETARG_POINTER(0);
+	int32		src_sz = PG_GETARG_INT32(1);
+	void	   *dst = PG_GETARG_POINTER(2);
+	int32		dst_sz = PG_GETARG_INT32(3);
+	int32	   *dst_used = PG_GETARG_POINTER(4);
+	int			compressed_sz;
+
+	compressed_sz = LZ4_compress_default(src, dst, src_sz, dst_sz);
+
+	/*
+	 * LZ4 returns 0 when the data does not fit in the output buffer.  The
+	 * caller expects to detect an incompressible block itself, by the used
+	 * size.
+	 */
+	if (compressed_sz <= 0)
+		compressed_sz = src_sz;
+
+	*dst_used = compressed_sz;
+
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_decompress(PG_FUNCTION_ARGS)
+{
+	const char *src = PG_GETARG_POINTER(0);
+	int32		src_sz = PG_GETARG_INT32(1);
+	void	   *dst = PG_GETARG_POINTER(2);
+	int32		dst_sz = PG_GETARG_INT32(3);
+	int32	   *dst_used = PG_GETARG_POINTER(4);
+	int			decompressed_sz;
+
+	Insist(src_sz > 0 && dst_sz > 0);
+
+	decompressed_sz = LZ4_decompress_safe(src, dst, src_sz, dst_sz);
+	if (decompressed_sz < 0)
+		elog(ERROR, "lz4 encountered data in an unexpected format");
+
+	*dst_used = decompressed_sz;
+
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_validator(PG_FUNCTION_ARGS)
+{
+	StorageAttributes *sa = PG_GETARG_POINTER(0);
+
+	if (sa->complevel != 1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("compresslevel=%d is out of range for lz4 "
+						"(should be 1)", sa->complevel)));
+
+	PG_RETURN_VOID();
+}
+
+#else							/* HAVE_LIBLZ4 */
+
+Datum
+lz4_constructor(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("lz4 compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_destructor(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("lz4 compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_compress(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("lz4 compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_decompress(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("lz4 compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+lz4_validator(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("lz4 compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+#endif							/* HAVE_LIBLZ4 */
@@ -437,9 +437,19 @@ compresstype_is_valid(char *comptype)
 	 *
 	 * Whenever the list of supported compresstypes is changed, this
 	 * must change!
+	 *
+	 * zstd and lz4 are only accepted when the server was built with the
+	 * library, so that tables can't be created that could not be loaded.
 	 */
 	static const char *const valid_comptypes[] =
-			{"quicklz", "zlib", "rle_type", "none"};
+			{"quicklz", "zlib", "rle_type", "none",
+#ifdef HAVE_LIBZSTD
+			 "zstd",
+#endif
+#ifdef HAVE_LIBLZ4
+			 "lz4",
+#endif
+			};
 	for (i = 0; !found && i < ARRAY_SIZE(valid_comptypes); ++i)
 	{
 		if (pg_strcasecmp(valid_comptypes[i], comptype) == 0)
@@ -172,10 +172,12 @@ CREATE VIEW pg_prepared_xacts AS
          LEFT JOIN pg_database D ON P.dbid = D.oid;
 
 CREATE VIEW pg_prepared_statements AS
-    SELECT P.name, P.statement, P.prepare_time, P.parameter_types, P.from_sql
+    SELECT P.name, P.statement, P.prepare_time, P.parameter_types, P.from_sql,
+           P.param_plan_hits, P.param_plan_misses
     FROM pg_prepared_statement() AS P
     (name text, statement text, prepare_time timestamptz,
-     parameter_types regtype[], from_sql boolean);
+     parameter_types regtype[], from_sql boolean,
+     param_plan_hits int8, param_plan_misses int8);
 
 CREATE VIEW pg_settings AS 
     SELECT * 
@@ -0,0 +1,239 @@
+/*
+ * zstd_compression.c
+ *	  Interfaces to Zstandard compression functionality.
+ *
+ * Compression levels 1 to 19 are supported.  Decompression speed is about
+ * the same at every level, so higher levels only trade load time for space.
+ *
+ * If the server was built without libzstd, the functions are still
+ * registered in pg_compression but refuse to run.
+ */
+
+#include "postgres.h"
+#include "fmgr.h"
+
+#include "catalog/pg_compression.h"
+#include "utils/builtins.h"
+#include "utils/memutils.h"
+
+#ifdef HAVE_LIBZSTD
+
+/* for ZSTD_customMem and the ZSTD_create*Ctx_advanced() functions */
+#define ZSTD_STATIC_LINKING_ONLY
+#include <zstd.h>
+#include <zstd_errors.h>
+
+/* Internal state for zstd */
+typedef struct zstd_state
+{
+	int			level;			/* compression level */
+	bool		compress;		/* compress or decompress? */
+
+	/*
+	 * The contexts are reused for every block of the session, which saves
+	 * rebuilding the zstd tables for each one.  zstd allocates them in the
+	 * memory context the session was created in (see zstd_alloc), so they are
+	 * released with it if the statement errors out before zstd_destructor is
+	 * called.
+	 */
+	ZSTD_CCtx  *cctx;
+	ZSTD_DCtx  *dctx;
+} zstd_state;
+
+static void *
+zstd_alloc(void *opaque, size_t size)
+{
+	return MemoryContextAlloc((MemoryContext) opaque, size);
+}
+
+static void
+zstd_free(void *opaque, void *address)
+{
+	if (address != NULL)
+		pfree(address);
+}
+
+Datum
+zstd_constructor(PG_FUNCTION_ARGS)
+{
+	/* PG_GETARG_POINTER(0) is TupleDesc that is currently unused. */
+
+	StorageAttributes *sa = PG_GETARG_POINTER(1);
+	CompressionState *cs = palloc0(sizeof(CompressionState));
+	zstd_state *state = palloc0(sizeof(zstd_state));
+	bool		compress = PG_GETARG_BOOL(2);
+	ZSTD_customMem mem;
+
+	cs->opaque = (void *) state;
+	cs->desired_sz = NULL;
+
+	Insist(PointerIsValid(sa->comptype));
+
+	if (sa->complevel == 0)
+		sa->complevel = 1;
+
+	state->level = sa->complevel;
+	state->compress = compress;
+
+	mem.customAlloc = zstd_alloc;
+	mem.customFree = zstd_free;
+	mem.opaque = CurrentMemoryContext;
+
+	if (compress)
+		state->cctx = ZSTD_createCCtx_advanced(mem);
+	else
+		state->dctx = ZSTD_createDCtx_advanced(mem);
+
+	if (state->cctx == NULL && state->dctx == NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_OUT_OF_MEMORY),
+				 errmsg("out of memory"),
+				 errdetail("Failed to create zstd compression context.")));
+
+	PG_RETURN_POINTER(cs);
+}
+
+Datum
+zstd_destructor(PG_FUNCTION_ARGS)
+{
+	CompressionState *cs = PG_GETARG_POINTER(0);
+
+	if (cs != NULL && cs->opaque != NULL)
+	{
+		zstd_state *state = (zstd_state *) cs->opaque;
+
+		if (state->cctx != NULL)
+			ZSTD_freeCCtx(state->cctx);
+		if (state->dctx != NULL)
+			ZSTD_freeDCtx(state->dctx);
+		pfree(state);
+		cs->opaque = NULL;
+	}
+
+	PG_RETURN_VOID();
+}
+
+Datum
+zstd_compress(PG_FUNCTION_ARGS)
+{
+	const void *src = PG_GETARG_POINTER(0);
+	int32		src_sz = PG_GETARG_INT32(1);
+	void	   *dst = PG_GETARG_POINTER(2);
+	int32		dst_sz = PG_GETARG_INT32(3);
+	int32	   *dst_used = PG_GETARG_POINTER(4);
+	CompressionState *cs = (CompressionState *) PG_GETARG_POINTER(5);
+	zstd_state *state = (zstd_state *) cs->opaque;
+	size_t		dst_length_used;
+
+	Insist(state->compress && state->cctx != NULL);
+
+	dst_length_used = ZSTD_compressCCtx(state->cctx, dst, dst_sz,
+										src, src_sz, state->level);
+
+	if (ZSTD_isError(dst_length_used))
+	{
+		/*
+		 * The data did not fit in the output buffer.  The caller expects to
+		 * detect an incompressible block itself, by the used size.
+		 */
+		if (ZSTD_getErrorCode(dst_length_used) == ZSTD_error_dstSize_tooSmall)
+			dst_length_used = src_sz;
+		else
+			elog(ERROR, "zstd compression failed: %s",
+				 ZSTD_getErrorName(dst_length_used));
+	}
+
+	*dst_used = (int32) dst_length_used;
+
+	PG_RETURN_VOID();
+}
+
+Datum
+zstd_decompress(PG_FUNCTION_ARGS)
+{
+	const char *src = PG_GETARG_POINTER(0);
+	int32		src_sz = PG_GETARG_INT32(1);
+	void	   *dst = PG_GETARG_POINTER(2);
+	int32		dst_sz = PG_GETARG_INT32(3);
+	int32	   *dst_used = PG_GETARG_POINTER(4);
+	CompressionState *cs = (CompressionState *) PG_GETARG_POINTER(5);
+	zstd_state *state = (zstd_state *) cs->opaque;
+	size_t		dst_length_used;
+
+	Insist(src_sz > 0 && dst_sz > 0);
+	Insist(!state->compress && state->dctx != NULL);
+
+	dst_length_used = ZSTD_decompressDCtx(state->dctx, dst, dst_sz,
+										  src, src_sz);
+
+	if (ZSTD_isError(dst_length_used))
+		elog(ERROR, "zstd decompression failed: %s",
+			 ZSTD_getErrorName(dst_length_used));
+
+	*dst_used = (int32) dst_length_used;
+
+	PG_RETURN_VOID();
+}
+
+Datum
+zstd_validator(PG_FUNCTION_ARGS)
+{
+	StorageAttributes *sa = PG_GETARG_POINTER(0);
+
+	if (sa->complevel < 1 || sa->complevel > 19)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("compresslevel=%d is out of range for zstd "
+						"(should be in the range 1 to 19)", sa->complevel)));
+
+	PG_RETURN_VOID();
+}
+
+#else							/* HAVE_LIBZSTD */
+
+Datum
+zstd_constructor(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("zstd compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+zstd_destructor(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("zstd compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+zstd_compress(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("zstd compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+zstd_decompress(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("zstd compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+Datum
+zstd_validator(PG_FUNCTION_ARGS)
+{
+	ereport(ERROR,
+			(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			 errmsg("zstd compression not supported by this build")));
+	PG_RETURN_VOID();
+}
+
+#endif							/* HAVE_LIBZSTD */
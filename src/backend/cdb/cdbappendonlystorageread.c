@@ -189,6 +189,21 @@ void AppendOnlyStorageRead_FinishSession(
 	// UNDONE: This expects the MemoryContext to be what was used for the 'memory' in ~Init
 	BufferedReadFinish(&storageRead->bufferedRead);
 
+	if (Debug_appendonly_print_decompress_stats &&
+		storageRead->decompressBlockCount > 0)
+		elog(LOG,
+			 "Append-only Storage Read decompression for table '%s' "
+			 "(compression = %s, compression level %d, blocks " INT64_FORMAT
+			 ", compressed bytes " INT64_FORMAT ", uncompressed bytes " INT64_FORMAT
+			 ", decompression time %.3f ms)",
+			 storageRead->relationName,
+			 storageRead->storageAttributes.compressType,
+			 storageRead->storageAttributes.compressLevel,
+			 storageRead->decompressBlockCount,
+			 storageRead->decompressCompressedBytes,
+			 storageRead->decompressUncompressedBytes,
+			 INSTR_TIME_GET_MILLISEC(storageRead->decompressTime));
+
 	if (storageRead->relationName != NULL)
 	{
 		pfree(storageRead->relationName);
@@ -1434,6 +1449,8 @@ void AppendOnlyStorageRead_Content(
 
 			PGFunction	  decompressor;
 			PGFunction	 *cfns = storageRead->compression_functions;
+			instr_time	  startTime;
+			instr_time	  endTime;
 
 			/* How can it be valid that decompressor is NULL, gp_decompress_new will
 			 * always crash if decompresor is NULL
@@ -1443,6 +1460,9 @@ void AppendOnlyStorageRead_Content(
 			else
 				decompressor = cfns[COMPRESSION_DECOMPRESS];
 
+			if (Debug_appendonly_print_decompress_stats)
+				INSTR_TIME_SET_CURRENT(startTime);
+
 			gp_decompress_new(
 				content,				// Compressed data in block.
 				storageRead->current.compressedLen,
@@ -1452,6 +1472,18 @@ void AppendOnlyStorageRead_Content(
 				storageRead->compressionState,
 				storageRead->bufferCount);
 
+			if (Debug_appendonly_print_decompress_stats)
+			{
+				INSTR_TIME_SET_CURRENT(endTime);
+				INSTR_TIME_ACCUM_DIFF(storageRead->decompressTime,
+									  endTime, startTime);
+				storageRead->decompressBlockCount++;
+				storageRead->decompressCompressedBytes +=
+					storageRead->current.compressedLen;
+				storageRead->decompressUncompressedBytes +=
+					storageRead->current.uncompressedLen;
+			}
+
 			if (Debug_appendonly_print_scan)
 				elog(LOG,
 					"Append-only Storage Read decompressed block for table '%s' "
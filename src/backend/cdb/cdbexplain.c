@@ -11,6 +11,7 @@
 #include "portability/instr_time.h"
 
 #include "cdb/cdbconn.h"                /* SegmentDatabaseDescriptor */
+#include "cdb/cdbdisp.h"                /* CdbDispatcherState */
 #include "cdb/cdbdispatchresult.h"      /* CdbDispatchResults */
 #include "cdb/cdbexplain.h"             /* me */
 #include "cdb/cdbpartition.h"
@@ -24,6 +25,7 @@
 #include "libpq/pqformat.h"             /* pq_beginmessage() etc. */
 #include "utils/memutils.h"             /* MemoryContextGetPeakSpace() */
 #include "cdb/memquota.h"
+#include "commands/sequence.h"          /* cdb_sequence_proxy_stats() */
 #include "inttypes.h"
 #include "utils/vmem_tracker.h"
 #include "parser/parsetree.h"
@@ -58,6 +60,8 @@ typedef struct CdbExplain_SliceWorker
     double      peakmemused;    /* bytes alloc in per-query mem context tree */
     double		vmem_reserved;	/* vmem reserved by a QE */
     double		memory_accounting_global_peak;	/* peak memory observed during memory accounting */
+    double      seqserver_requests; /* nextval requests sent to the seqserver */
+    double      seqserver_values;   /* sequence values got from the seqserver */
 } CdbExplain_SliceWorker;
 
 
@@ -143,6 +147,10 @@ typedef struct CdbExplain_SliceSummary
     double          workmemused_max;
     double          workmemwanted_max;
 
+    /* Sum of the seqserver requests and values over the slice's workers */
+    double          seqserver_requests;
+    double          seqserver_values;
+
     /* How many workers were dispatched and returned results? (0 if local) */
     CdbExplain_DispatchSummary  dispatchSummary;
 } CdbExplain_SliceSummary;
@@ -655,6 +663,8 @@ cdbexplain_collectSliceStats(PlanState                 *planstate,
                              CdbExplain_SliceWorker    *out_worker)
 {
     EState     *estate = planstate->state;
+    int64       seqserver_requests;
+    int64       seqserver_values;
 
     /* Max bytes malloc'ed under executor's per-query memory context. */
     out_worker->peakmemused =
@@ -664,6 +674,10 @@ cdbexplain_collectSliceStats(PlanState                 *planstate,
 
     out_worker->memory_accounting_global_peak = (double) MemoryAccountingPeakBalance;
 
+    cdb_sequence_proxy_stats(&seqserver_requests, &seqserver_values);
+    out_worker->seqserver_requests = (double) seqserver_requests;
+    out_worker->seqserver_values = (double) seqserver_values;
+
 }                               /* cdbexplain_collectSliceStats */
 
 
@@ -744,6 +758,8 @@ cdbexplain_depositSliceStats(CdbExplain_StatHdr        *hdr,
     cdbexplain_agg_upd(&ss->peakmemused, hdr->worker.peakmemused, hdr->segindex);
     cdbexplain_agg_upd(&ss->vmem_reserved, hdr->worker.vmem_reserved, hdr->segindex);
     cdbexplain_agg_upd(&ss->memory_accounting_global_peak, hdr->worker.memory_accounting_global_peak, hdr->segindex);
+    ss->seqserver_requests += hdr->worker.seqserver_requests;
+    ss->seqserver_values += hdr->worker.seqserver_values;
 
     /* Rollup of per-node stats over all nodes of the slice into SliceSummary */
     ss->workmemused_max = recvstatctx->workmemused_max;
@@ -1955,6 +1971,12 @@ cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
             appendStringInfoChar(str, '.');
        }
 
+        /* Round trips to the sequence server (sum over workers of slice) */
+        if (ss->seqserver_requests > 0)
+            appendStringInfo(str, "  Sequence server: %.0f requests for %.0f values.",
+                             ss->seqserver_requests,
+                             ss->seqserver_values);
+
        appendStringInfoChar(str, '\n');
     }
     
@@ -1971,6 +1993,19 @@ cdbexplain_showExecStatsEnd(struct PlannedStmt *stmt,
         
         appendStringInfoChar(str, '\n');
     }
+
+    /* Time spent dispatching the plan to the qExecs */
+    if (estate->dispatcherState &&
+        estate->dispatcherState->primaryResults)
+    {
+        CdbDispatcherState *ds = estate->dispatcherState;
+
+        appendStringInfo(str,
+                         "Dispatch: %.3f ms to build, %.3f ms to start sending, %.3f ms to finish sending.\n",
+                         INSTR_TIME_GET_MILLISEC(ds->buildTime),
+                         INSTR_TIME_GET_MILLISEC(ds->sendTime),
+                         INSTR_TIME_GET_MILLISEC(ds->sendWaitTime));
+    }
 }                               /* cdbexplain_showExecStatsEnd */
 
 static int
@@ -45,12 +45,14 @@
 #include "tcop/utility.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/date.h"
 #include "utils/datum.h"
 #include "utils/elog.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/syscache.h"
+#include "utils/timestamp.h"
 
 #define DEFAULT_CONSTRAINT_ESTIMATE 16
 #define MIN_XCHG_CONTEXT_SIZE 4096
@@ -3608,6 +3610,189 @@ static bool compare_partn_opfuncid(PartitionNode *partnode,
 	return true;
 } /* end compare_partn_opfuncid */
 
+/*
+ * The value of a partitioning key as an int64 that sorts the same way, if
+ * the key is of an integer-like type. Returns false for the other types.
+ */
+static bool
+partition_key_as_int64(Oid typid, Datum d, int64 *key)
+{
+	switch (typid)
+	{
+		case INT2OID:
+			*key = DatumGetInt16(d);
+			return true;
+		case INT4OID:
+			*key = DatumGetInt32(d);
+			return true;
+		case INT8OID:
+			*key = DatumGetInt64(d);
+			return true;
+		case DATEOID:
+			*key = DatumGetDateADT(d);
+			return true;
+#ifdef HAVE_INT64_TIMESTAMP
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			*key = DatumGetTimestamp(d);
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+typedef struct PartitionListValueEntry
+{
+	int64		value;			/* hash key */
+	PartitionRule *rule;
+} PartitionListValueEntry;
+
+/*
+ * Build a hash table from the values of the rules of a single-column list
+ * partition to their rules, for selectListPartition to route rows without
+ * calling the equality operator. Leaves ls->valueHash NULL if the key is
+ * not of an integer-like type.
+ */
+static void
+compileListValues(PartitionNode *partnode, TupleDesc tupdesc,
+				  PartitionListState *ls)
+{
+	AttrNumber	attno = partnode->part->paratts[0];
+	Oid			typid = tupdesc->attrs[attno - 1]->atttypid;
+	HASHCTL		ctl;
+	HTAB	   *hash;
+	ListCell   *lc;
+	int64		value;
+
+	ls->valueHash = NULL;
+	ls->nullRule = NULL;
+
+	if (!partition_key_as_int64(typid, (Datum) 0, &value))
+		return;
+
+	MemSet(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(int64);
+	ctl.entrysize = sizeof(PartitionListValueEntry);
+	ctl.hash = tag_hash;
+	ctl.hcxt = CurrentMemoryContext;
+	hash = hash_create("partition list values", list_length(partnode->rules),
+					   &ctl, HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+
+	foreach(lc, partnode->rules)
+	{
+		PartitionRule *rule = lfirst(lc);
+		ListCell   *lc2;
+
+		foreach(lc2, rule->parlistvalues)
+		{
+			Const	   *c = linitial((List *) lfirst(lc2));
+			PartitionListValueEntry *entry;
+			bool		found;
+
+			if (c->constisnull)
+			{
+				/* The first rule that matches wins, as in the list scan */
+				if (ls->nullRule == NULL)
+					ls->nullRule = rule;
+				continue;
+			}
+
+			if (c->consttype != typid)
+			{
+				hash_destroy(hash);
+				ls->nullRule = NULL;
+				return;
+			}
+
+			partition_key_as_int64(typid, c->constvalue, &value);
+			entry = hash_search(hash, &value, HASH_ENTER, &found);
+			if (!found)
+				entry->rule = rule;
+		}
+	}
+
+	ls->valueHash = hash;
+}
+
+/*
+ * Compute the inclusive bounds of the rules of a single-column range
+ * partition, for selectRangePartition to route rows by comparing integers.
+ * Leaves rs->nbounds 0 if the key is not of an integer-like type, or the
+ * rules are not in order of their ranges.
+ */
+static void
+compileRangeBounds(PartitionNode *partnode, TupleDesc tupdesc,
+				   PartitionRangeState *rs)
+{
+	AttrNumber	attno = partnode->part->paratts[0];
+	Oid			typid = tupdesc->attrs[attno - 1]->atttypid;
+	int			nrules = list_length(partnode->rules);
+	int64	   *lo;
+	int64	   *hi;
+	int64		value;
+	int			i;
+
+	rs->nbounds = 0;
+
+	if (!partition_key_as_int64(typid, (Datum) 0, &value))
+		return;
+
+	lo = palloc(sizeof(int64) * nrules);
+	hi = palloc(sizeof(int64) * nrules);
+
+	for (i = 0; i < nrules; i++)
+	{
+		PartitionRule *rule = rs->rules[i];
+		Const	   *c;
+
+		lo[i] = PG_INT64_MIN;
+		if (PointerIsValid(rule->parrangestart))
+		{
+			c = (Const *) linitial((List *) rule->parrangestart);
+			if (c->constisnull || c->consttype != typid)
+				break;
+			partition_key_as_int64(typid, c->constvalue, &lo[i]);
+			if (!rule->parrangestartincl)
+			{
+				if (lo[i] == PG_INT64_MAX)
+					break;
+				lo[i]++;
+			}
+		}
+
+		hi[i] = PG_INT64_MAX;
+		if (PointerIsValid(rule->parrangeend))
+		{
+			c = (Const *) linitial((List *) rule->parrangeend);
+			if (c->constisnull || c->consttype != typid)
+				break;
+			partition_key_as_int64(typid, c->constvalue, &hi[i]);
+			if (!rule->parrangeendincl)
+			{
+				if (hi[i] == PG_INT64_MIN)
+					break;
+				hi[i]--;
+			}
+		}
+
+		/* The search needs nonempty ranges in ascending order */
+		if (lo[i] > hi[i] || (i > 0 && hi[i - 1] >= lo[i]))
+			break;
+	}
+
+	if (i < nrules)
+	{
+		pfree(lo);
+		pfree(hi);
+		return;
+	}
+
+	rs->lobounds = lo;
+	rs->hibounds = hi;
+	rs->nbounds = nrules;
+}
+
 /*
  *	Given a partition-by-list PartitionNode, search for
  *	a part that matches the given datum value.
@@ -3641,16 +3826,54 @@ selectListPartition(PartitionNode *partnode, Datum *values, bool *isnull,
 
 		ls->eqfuncs = palloc(sizeof(FmgrInfo) * natts);
 		ls->eqinit = palloc0(sizeof(bool) * natts);
+		ls->valueHash = NULL;
+		ls->nullRule = NULL;
+
+		/*
+		 * Like the rules of range partitions, the values are only compiled
+		 * for the top level, the only one that has a single set of rules.
+		 */
+		if (accessMethods && natts == 1 && partnode->part->parlevel == 0)
+			compileListValues(partnode, tupdesc, ls);
 
 		if (accessMethods)
 			accessMethods->amstate[partnode->part->parlevel] = (void *)ls;
 	}
 
+	*foundOid = InvalidOid;
+
+	if (ls->valueHash != NULL &&
+		(!OidIsValid(exprTypeOid) ||
+		 exprTypeOid == tupdesc->attrs[part->paratts[0] - 1]->atttypid))
+	{
+		AttrNumber attno = part->paratts[0];
+		PartitionRule *rule = NULL;
+
+		if (isnull[attno - 1])
+			rule = ls->nullRule;
+		else
+		{
+			PartitionListValueEntry *entry;
+			int64 value = 0;
+
+			partition_key_as_int64(tupdesc->attrs[attno - 1]->atttypid,
+								   values[attno - 1], &value);
+			entry = hash_search(ls->valueHash, &value, HASH_FIND, NULL);
+			if (entry)
+				rule = entry->rule;
+		}
+
+		if (rule == NULL)
+			return NULL;
+
+		*foundOid = rule->parchildrelid;
+		*prule = rule;
+		return rule->children;
+	}
+
 	if (accessMethods && accessMethods->part_cxt)
 		oldcxt = MemoryContextSwitchTo(accessMethods->part_cxt);
 
-	*foundOid = InvalidOid;
-
 	/* With LIST, we have no choice at the moment except to be exhaustive */
 	foreach(lc, partnode->rules)
 	{
@@ -4003,6 +4226,66 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 		}
 		else
 			rs->rules = NULL;
+
+		rs->last_rule = -1;
+		rs->nbounds = 0;
+		if (accessMethods && rs->rules && natts == 1)
+			compileRangeBounds(partnode, tupdesc, rs);
+
+		if (accessMethods)
+			accessMethods->amstate[partnode->part->parlevel] = (void *)rs;
+	}
+
+	/*
+	 * With the bounds compiled, search them directly. Rows loaded in order
+	 * of the key mostly go to the partition of the row before.
+	 */
+	if (rs->nbounds > 0 && pSearch == NULL &&
+		(!OidIsValid(exprTypeOid) ||
+		 exprTypeOid == tupdesc->attrs[partnode->part->paratts[0] - 1]->atttypid))
+	{
+		AttrNumber attno = partnode->part->paratts[0];
+		int64 key = 0;
+
+		*foundOid = InvalidOid;
+
+		if (isnull[attno - 1])
+			return NULL;
+
+		partition_key_as_int64(tupdesc->attrs[attno - 1]->atttypid,
+							   values[attno - 1], &key);
+
+		if (rs->last_rule < 0 ||
+			key < rs->lobounds[rs->last_rule] ||
+			key > rs->hibounds[rs->last_rule])
+		{
+			low = 0;
+			high = rs->nbounds - 1;
+			rs->last_rule = -1;
+
+			while (low <= high)
+			{
+				mid = low + (high - low) / 2;
+
+				if (key < rs->lobounds[mid])
+					high = mid - 1;
+				else if (key > rs->hibounds[mid])
+					low = mid + 1;
+				else
+				{
+					rs->last_rule = mid;
+					break;
+				}
+			}
+
+			if (rs->last_rule < 0)
+				return NULL;
+		}
+
+		rule = rs->rules[rs->last_rule];
+		*foundOid = rule->parchildrelid;
+		*prule = rule;
+		return rule->children;
 	}
 
 	if (accessMethods && accessMethods->part_cxt)
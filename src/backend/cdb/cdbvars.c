@@ -56,6 +56,8 @@ int			qdPostmasterPort;	/*Master Segment Postmaster port. */
 
 int         gp_command_count;          /* num of commands from client */
 
+int			gp_seqserver_max_prefetch = 1024;	/* values a QE may ask for at once */
+
 bool        gp_debug_pgproc;           /* print debug info for PGPROC */
 bool		Debug_print_prelim_plan;	/* Shall we log argument of
 										 * cdbparallelize? */
@@ -126,8 +128,8 @@ int			gp_fts_probe_timeout = 20;
 int			gp_fts_probe_interval=60;
 
 /*
- * Number of threads to use for probe of segments (it is a good idea to have this
- * larger than the number of segments per host.
+ * Number of threads that were used for probe of segments.  Deprecated; all
+ * segments are probed at once from one event loop now.
  */
 int			gp_fts_probe_threadcount=16;
 
@@ -207,6 +209,8 @@ bool		gp_interconnect_aggressive_retry=true; /* fast-track app-level retry */
 
 bool gp_interconnect_full_crc=false; /* sanity check UDP data. */
 
+bool gp_interconnect_batch_tuples=true; /* several tuples per chunk. */
+
 bool gp_interconnect_elide_setup=true; /* under some conditions we can eliminate the setup */
 
 bool gp_interconnect_log_stats=false; /* emit stats at log-level */
@@ -296,6 +300,8 @@ bool		gp_enable_motion_deadlock_sanity = FALSE; /* planning time sanity check */
 #ifdef USE_ASSERT_CHECKING
 bool		gp_mk_sort_check = false;
 #endif
+int			gp_mk_sort_parallel_workers = 0;
+bool		gp_mk_sort_normalized_keys = true;
 int			gp_sort_flags = 0;
 int			gp_dbg_flags = 0;
 int 		gp_sort_max_distinct = 20000;
@@ -345,6 +351,9 @@ GpperfmonLogAlertLevel gpperfmon_log_alert_level = GPPERFMON_LOG_ALERT_LEVEL_NON
 /* Enable single-slice single-row inserts ?*/
 bool		gp_enable_fast_sri=true;
 
+/* Send COPY rows to segments in chunks, unparsed for random tables ?*/
+bool		gp_copy_dispatch_chunks = true;
+
 /* Enable single-mirror pair dispatch. */
 bool		gp_enable_direct_dispatch=true;
 
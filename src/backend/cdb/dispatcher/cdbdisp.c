@@ -100,6 +100,21 @@ cdbdisp_dispatchToGang(struct CdbDispatcherState *ds,
 	(pDispatchFuncs->dispatchToGang)(ds, gp, sliceIndex, disp_direct);
 }
 
+/*
+ * cdbdisp_waitDispatchFinish:
+ *
+ * Block until the command started by cdbdisp_dispatchToGang() has been
+ * written to all QEs.  The thread dispatcher writes it before returning
+ * from cdbdisp_dispatchToGang(), so this only has work to do for the
+ * asynchronous one.
+ */
+void
+cdbdisp_waitDispatchFinish(struct CdbDispatcherState *ds)
+{
+	if (pDispatchFuncs->waitDispatchFinish != NULL)
+		(pDispatchFuncs->waitDispatchFinish)(ds);
+}
+
 /*
  * CdbCheckDispatchResult:
  *
@@ -379,6 +394,13 @@ cdbdisp_destroyDispatcherState(CdbDispatcherState *ds)
 
 	CdbDispatchResults *results = ds->primaryResults;
 
+	/*
+	 * The connections may still be sending the command text, which lives in
+	 * the dispatch memory context deleted below.
+	 */
+	if (ds->dispatchParams != NULL)
+		cdbdisp_waitDispatchFinish(ds);
+
 	if (results != NULL && results->resultArray != NULL)
 	{
 		int i;
@@ -80,13 +80,17 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 static bool
 cdbdisp_checkForCancel_async(struct CdbDispatcherState *ds);
 
+static void
+cdbdisp_waitDispatchFinish_async(struct CdbDispatcherState *ds);
+
 DispatcherInternalFuncs DispatcherAsyncFuncs =
 {
 	NULL,
 	cdbdisp_checkForCancel_async,
 	cdbdisp_makeDispatchParams_async,
 	cdbdisp_checkDispatchResult_async,
-	cdbdisp_dispatchToGang_async
+	cdbdisp_dispatchToGang_async,
+	cdbdisp_waitDispatchFinish_async
 };
 
 
@@ -110,6 +114,9 @@ finishupFailedConnections(CdbDispatchCmdAsync * pParms);
 static void
 handlePollSuccess(CdbDispatchCmdAsync* pParms, struct pollfd *fds);
 
+static void
+flushPendingSends(CdbDispatchCmdAsync* pParms, bool wait);
+
 /*
  * Check dispatch result.
  * Don't wait all dispatch commands to complete.
@@ -188,6 +195,24 @@ cdbdisp_dispatchToGang_async(struct CdbDispatcherState *ds,
 	}
 }
 
+/*
+ * Wait until the command has been written to all QEs.
+ *
+ * dispatchCommand() only starts the sends, so that the command goes out to
+ * all gangs at once.  The QD must not start executing its own slice until
+ * every QE has its plan.
+ */
+static void
+cdbdisp_waitDispatchFinish_async(struct CdbDispatcherState *ds)
+{
+	CdbDispatchCmdAsync *pParms = (CdbDispatchCmdAsync*)ds->dispatchParams;
+
+	if (pParms == NULL)
+		return;
+
+	flushPendingSends(pParms, true);
+}
+
 /*
  * Check dispatch result.
  *
@@ -266,6 +291,12 @@ checkDispatchResult(CdbDispatcherState *ds,
 	int	timeoutCounter = 0;
 	struct pollfd *fds;
 
+	/*
+	 * Finish sending the command first.  The sockets are polled for input
+	 * only below, and a QE can't answer before it has the whole command.
+	 */
+	flushPendingSends(pParms, wait);
+
 	db_count = pParms->dispatchCount;
 	fds = (struct pollfd *) palloc(db_count * sizeof(struct pollfd));
 
@@ -395,9 +426,13 @@ dispatchCommand(CdbDispatchResult * dispatchResult,
 	}
 
 	/*
-	 * Submit the command asynchronously.
+	 * Submit the command asynchronously.  The connection is non-blocking
+	 * until the whole command is written, so PQsendGpQuery_shared() only
+	 * writes what the socket takes right now; flushPendingSends() writes
+	 * the rest, for all QEs at once.
 	 */
-	if (PQsendGpQuery_shared(dispatchResult->segdbDesc->conn, (char *) query_text, query_text_len) == 0)
+	if (PQsetnonblocking(dispatchResult->segdbDesc->conn, 1) != 0 ||
+		PQsendGpQuery_shared(dispatchResult->segdbDesc->conn, (char *) query_text, query_text_len) == 0)
 	{
 		char *msg = PQerrorMessage(dispatchResult->segdbDesc->conn);
 		dispatchResult->stillRunning = false;
@@ -426,6 +461,94 @@ dispatchCommand(CdbDispatchResult * dispatchResult,
 	ELOG_DISPATCHER_DEBUG("Command dispatched to QE (%s)", dispatchResult->segdbDesc->whoami);
 }
 
+/*
+ * Write the command text that dispatchCommand() left unsent, to all QEs in
+ * a single poll() loop.  Every connection goes back to blocking mode as
+ * soon as its command is written.  The command text is shared by all
+ * connections and is not copied.
+ *
+ * wait: true, block until the command is written to all QEs, or failed.
+ *       false, only write what the sockets take without blocking.
+ *
+ * Don't throw out error, instead, append the error message to
+ * CdbDispatchResult.error_message.
+ */
+static void
+flushPendingSends(CdbDispatchCmdAsync* pParms, bool wait)
+{
+	struct pollfd *fds = NULL;
+	int	i;
+
+	for (;;)
+	{
+		int	nfds = 0;
+		int	n;
+
+		/*
+		 * bail-out if we are dying.
+		 */
+		if (proc_exit_inprogress)
+			break;
+
+		for (i = 0; i < pParms->dispatchCount; i++)
+		{
+			CdbDispatchResult *dispatchResult = pParms->dispatchResultPtrArray[i];
+			PGconn *conn = dispatchResult->segdbDesc->conn;
+
+			if (conn == NULL || !PQisnonblocking(conn))
+				continue;
+
+			switch (PQflush(conn))
+			{
+				case 0:
+					/* All written */
+					PQsetnonblocking(conn, 0);
+					break;
+
+				case 1:
+					if (fds == NULL)
+						fds = (struct pollfd *) palloc(pParms->dispatchCount * sizeof(struct pollfd));
+					fds[nfds].fd = PQsocket(conn);
+					fds[nfds].events = POLLOUT;
+					nfds++;
+					break;
+
+				default:
+					{
+						char *msg = PQerrorMessage(conn);
+
+						dispatchResult->stillRunning = false;
+						cdbdisp_appendMessageNonThread(dispatchResult, LOG,
+											  "Command could not be dispatch to segment %s: %s",
+											  dispatchResult->segdbDesc->whoami, msg ? msg : "unknown error");
+
+						/*
+						 * libpq has given up on the unsent data.  Don't let
+						 * PQsetnonblocking() refuse a broken connection.
+						 */
+						conn->nonblocking = false;
+					}
+					break;
+			}
+		}
+
+		if (nfds == 0 || !wait)
+			break;
+
+		n = poll(fds, nfds, DISPATCH_WAIT_TIMEOUT_SEC * 1000);
+		if (n < 0)
+		{
+			int	sock_errno = SOCK_ERRNO;
+
+			if (sock_errno != EINTR)
+				elog(LOG, "flushPendingSends poll() failed; errno=%d", sock_errno);
+		}
+	}
+
+	if (fds != NULL)
+		pfree(fds);
+}
+
 /*
  * Receive and process results from QEs.
  */
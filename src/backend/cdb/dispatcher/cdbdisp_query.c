@@ -174,6 +174,8 @@ cdbdisp_dispatchPlan(struct QueryDesc *queryDesc,
 	PlannedStmt *stmt;
 	bool is_SRI = false;
 	DispatchCommandQueryParms *pQueryParms;
+	instr_time starttime;
+	instr_time endtime;
 
 	Assert(Gp_role == GP_ROLE_DISPATCH);
 	Assert(queryDesc != NULL && queryDesc->estate != NULL);
@@ -261,7 +263,10 @@ cdbdisp_dispatchPlan(struct QueryDesc *queryDesc,
 		verify_shared_snapshot_ready();
 	}
 
+	INSTR_TIME_SET_CURRENT(starttime);
 	pQueryParms = cdbdisp_buildPlanQueryParms(queryDesc, planRequiresTxn);
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_ACCUM_DIFF(ds->buildTime, endtime, starttime);
 
 	ds->primaryResults = NULL;
 	ds->dispatchParams = NULL;
@@ -1166,6 +1171,8 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 	int rootIdx = pQueryParms->rootIdx;
 	char *queryText = NULL;
 	int queryTextLength = 0;
+	instr_time starttime;
+	instr_time endtime;
 
 	if (log_dispatch_stats)
 		ResetUsage();
@@ -1192,7 +1199,10 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 	 */
 	ds->primaryResults = NULL;
 	ds->dispatchParams = NULL;
+	INSTR_TIME_SET_CURRENT(starttime);
 	queryText = buildGpQueryString(ds, pQueryParms, &queryTextLength);
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_ACCUM_DIFF(ds->buildTime, endtime, starttime);
 	cdbdisp_makeDispatcherState(ds, nSlices, cancelOnError, queryText, queryTextLength);
 
 	cdb_total_plans++;
@@ -1215,6 +1225,8 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 		}
 	}
 
+	INSTR_TIME_SET_CURRENT(starttime);
+
 	for (iSlice = 0; iSlice < nSlices; iSlice++)
 	{
 		CdbDispatchDirectDesc direct;
@@ -1288,6 +1300,9 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 		cdbdisp_dispatchToGang(ds, primaryGang, si, &direct);
 	}
 
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_ACCUM_DIFF(ds->sendTime, endtime, starttime);
+
 	pfree(sliceVector);
 
 	/*
@@ -1322,6 +1337,15 @@ cdbdisp_dispatchX(DispatchCommandQueryParms *pQueryParms,
 						errmsg_internal("Unable to dispatch plan.")));
 	}
 
+	/*
+	 * The QEs of the root slice's subtree must all have their plans before
+	 * we go on to run the root slice here.
+	 */
+	INSTR_TIME_SET_CURRENT(starttime);
+	cdbdisp_waitDispatchFinish(ds);
+	INSTR_TIME_SET_CURRENT(endtime);
+	INSTR_TIME_ACCUM_DIFF(ds->sendWaitTime, endtime, starttime);
+
 	if (DEBUG1 >= log_min_messages)
 	{
 		char msec_str[32];
@@ -159,7 +159,8 @@ DispatcherInternalFuncs DispatcherSyncFuncs =
 	cdbdisp_shouldCancel,
 	cdbdisp_makeDispatchThreads,
 	CdbCheckDispatchResult_internal,
-	cdbdisp_dispatchToGang_internal
+	cdbdisp_dispatchToGang_internal,
+	NULL
 };
 
 /*
@@ -61,10 +61,29 @@ static void processIncomingChunks(MotionLayerState *mlStates,
 								  int16 srcRoute);
 
 static inline void reconstructTuple(MotionNodeEntry * pMNEntry, ChunkSorterEntry * pCSEntry);
+static void reconstructBatch(MotionNodeEntry * pMNEntry, ChunkSorterEntry * pCSEntry,
+							 TupleChunkListItem tcItem);
+
+static TupleBatch *getSendBatch(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry,
+								int16 targetRoute);
+static SendReturnCode sendTupleBatch(MotionLayerState *mlStates,
+									 ChunkTransportState *transportStates,
+									 MotionNodeEntry * pMNEntry,
+									 int16 motNodeID,
+									 int16 targetRoute,
+									 TupleBatch *batch);
+static SendReturnCode sendTupleBatches(MotionLayerState *mlStates,
+									   ChunkTransportState *transportStates,
+									   MotionNodeEntry * pMNEntry,
+									   int16 motNodeID,
+									   bool broadcast,
+									   bool directed);
+static void freeTupleBatches(MotionNodeEntry * pMNEntry);
 
 /* Stats-function declarations. */
 static void statSendTuple(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry, TupleChunkList tcList);
 static void statSendEOS(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry);
+static void statSendBatch(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry);
 static void statChunksProcessed(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry, int chunksProcessed, int chunkBytes, int tupleBytes);
 static void statNewTupleArrived(MotionNodeEntry * pMNEntry, ChunkSorterEntry * pCSEntry);
 static void statRecvTuple(MotionNodeEntry * pMNEntry,
@@ -95,6 +114,29 @@ reconstructTuple(MotionNodeEntry * pMNEntry, ChunkSorterEntry * pCSEntry)
 	statNewTupleArrived(pMNEntry, pCSEntry);
 }
 
+/* Same as reconstructTuple(), for all the tuples of a TC_BATCH chunk. */
+static void
+reconstructBatch(MotionNodeEntry * pMNEntry, ChunkSorterEntry * pCSEntry,
+				 TupleChunkListItem tcItem)
+{
+	HeapTuple  *tuples;
+	int			ntuples;
+	int			i;
+
+	tuples = CvtBatchChunkToHeapTups(tcItem, &ntuples);
+
+	for (i = 0; i < ntuples; i++)
+	{
+		htfifo_addtuple(pCSEntry->ready_tuples, tuples[i]);
+		statNewTupleArrived(pMNEntry, pCSEntry);
+	}
+
+	pfree(tuples);
+
+	/* The tuples have been copied out; the chunk isn't needed anymore. */
+	pfree(tcItem);
+}
+
 /*
  * FUNCTION DEFINITIONS
  */
@@ -283,10 +325,13 @@ InitMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID)
  * Initialize a single motion node.  This is called by the executor when a
  * motion node in the plan tree is being initialized.
  *
+ * batchTuples says whether the sender may hold narrow tuples back to pack
+ * them into TC_BATCH chunks.
+ *
  * This function is called from:  ExecInitMotion()
  */
 void
-UpdateMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool preserveOrder, TupleDesc tupDesc, uint64 operatorMemKB)
+UpdateMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool preserveOrder, bool batchTuples, TupleDesc tupDesc, uint64 operatorMemKB)
 {
 	MemoryContext oldCtxt;
 	MotionNodeEntry *pEntry;
@@ -358,6 +403,11 @@ UpdateMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool preserve
 	pEntry->stopped = false;
 	pEntry->moreNetWork = true;
 
+	pEntry->batch_tuples = batchTuples && tupDesc->natts > 0;
+	pEntry->send_batches = NULL;
+	pEntry->num_send_batches = 0;
+	memset(&pEntry->broadcast_batch, 0, sizeof(TupleBatch));
+
 
 	/* All done!  Go back to caller memory-context. */
 	MemoryContextSwitchTo(oldCtxt);
@@ -417,6 +467,63 @@ SendTuple(MotionLayerState *mlStates,
 	elog(DEBUG5, "Serializing HeapTuple for sending.");
 #endif
 
+	/*
+	 * Narrow tuples are collected into one TC_BATCH chunk per route, which is
+	 * sent when it is full.  A tuple must not overtake tuples collected
+	 * earlier for the same receivers, so those are sent first if this tuple
+	 * goes out any other way.
+	 */
+	if (pMNEntry->batch_tuples)
+	{
+		bool		batchable = TupleIsBatchable(tuple);
+		TupleBatch *batch = getSendBatch(mlStates, pMNEntry, targetRoute);
+		int			added;
+
+		if (targetRoute == BROADCAST_SEGIDX)
+			rc = sendTupleBatches(mlStates, transportStates, pMNEntry, motNodeID,
+								  !batchable, true);
+		else
+		{
+			rc = sendTupleBatches(mlStates, transportStates, pMNEntry, motNodeID,
+								  true, false);
+			if (rc == SEND_COMPLETE && !batchable)
+				rc = sendTupleBatch(mlStates, transportStates, pMNEntry, motNodeID,
+									targetRoute, batch);
+		}
+		if (rc == STOP_SENDING)
+			return rc;
+
+		if (batchable)
+		{
+			oldCtxt = MemoryContextSwitchTo(mlStates->motion_layer_mctx);
+
+			added = SerializeTupleIntoBatch(tuple, &pMNEntry->ser_tup_info, batch);
+			if (added == 0)
+			{
+				/* The chunk is full, send it and start another one */
+				rc = sendTupleBatch(mlStates, transportStates, pMNEntry, motNodeID,
+									targetRoute, batch);
+				if (rc == SEND_COMPLETE)
+				{
+					added = SerializeTupleIntoBatch(tuple, &pMNEntry->ser_tup_info, batch);
+					Assert(added > 0);
+				}
+			}
+
+			MemoryContextSwitchTo(oldCtxt);
+
+			if (rc == SEND_COMPLETE)
+			{
+				/* update stats; the chunk header is counted when it is sent */
+				tcList.num_chunks = 0;
+				tcList.serialized_data_length = added;
+				statSendTuple(mlStates, pMNEntry, &tcList);
+			}
+
+			return rc;
+		}
+	}
+
 	if (targetRoute != BROADCAST_SEGIDX)
 	{
 		struct directTransportBuffer b;
@@ -482,6 +589,134 @@ SendTuple(MotionLayerState *mlStates,
 	return rc;
 }
 
+/*
+ * Get the TC_BATCH chunk being filled for a route.
+ */
+static TupleBatch *
+getSendBatch(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry, int16 targetRoute)
+{
+	if (targetRoute == BROADCAST_SEGIDX)
+		return &pMNEntry->broadcast_batch;
+
+	Assert(targetRoute >= 0);
+
+	if (targetRoute >= pMNEntry->num_send_batches)
+	{
+		MemoryContext oldCtxt;
+		int			n = Max(targetRoute + 1, GpIdentity.numsegments);
+
+		oldCtxt = MemoryContextSwitchTo(mlStates->motion_layer_mctx);
+
+		if (pMNEntry->send_batches == NULL)
+			pMNEntry->send_batches = palloc0(n * sizeof(TupleBatch));
+		else
+		{
+			pMNEntry->send_batches = repalloc(pMNEntry->send_batches,
+											  n * sizeof(TupleBatch));
+			memset(pMNEntry->send_batches + pMNEntry->num_send_batches, 0,
+				   (n - pMNEntry->num_send_batches) * sizeof(TupleBatch));
+		}
+		pMNEntry->num_send_batches = n;
+
+		MemoryContextSwitchTo(oldCtxt);
+	}
+
+	return &pMNEntry->send_batches[targetRoute];
+}
+
+/*
+ * Send the TC_BATCH chunk of a route, if it holds any tuples.
+ */
+static SendReturnCode
+sendTupleBatch(MotionLayerState *mlStates,
+			   ChunkTransportState *transportStates,
+			   MotionNodeEntry * pMNEntry,
+			   int16 motNodeID,
+			   int16 targetRoute,
+			   TupleBatch *batch)
+{
+	TupleChunkListData tcList;
+	SendReturnCode rc = SEND_COMPLETE;
+
+	if (batch->chunk == NULL)
+		return rc;
+
+	tcList.p_first = NULL;
+	tcList.p_last = NULL;
+	tcList.num_chunks = 0;
+	tcList.serialized_data_length = 0;
+	appendChunkToTCList(&tcList, batch->chunk);
+	batch->chunk = NULL;
+
+	if (!SendTupleChunkToAMS(mlStates, transportStates, motNodeID, targetRoute, tcList.p_first))
+	{
+		pMNEntry->stopped = true;
+		rc = STOP_SENDING;
+	}
+	else
+		statSendBatch(mlStates, pMNEntry);
+
+	clearTCList(&pMNEntry->ser_tup_info.chunkCache, &tcList);
+
+	return rc;
+}
+
+/*
+ * Send the TC_BATCH chunks of all routes, the broadcast one, or both.
+ */
+static SendReturnCode
+sendTupleBatches(MotionLayerState *mlStates,
+				 ChunkTransportState *transportStates,
+				 MotionNodeEntry * pMNEntry,
+				 int16 motNodeID,
+				 bool broadcast,
+				 bool directed)
+{
+	SendReturnCode rc = SEND_COMPLETE;
+	int			i;
+
+	if (broadcast &&
+		sendTupleBatch(mlStates, transportStates, pMNEntry, motNodeID,
+					   BROADCAST_SEGIDX, &pMNEntry->broadcast_batch) == STOP_SENDING)
+		rc = STOP_SENDING;
+
+	for (i = 0; directed && i < pMNEntry->num_send_batches; i++)
+	{
+		if (sendTupleBatch(mlStates, transportStates, pMNEntry, motNodeID,
+						   i, &pMNEntry->send_batches[i]) == STOP_SENDING)
+			rc = STOP_SENDING;
+	}
+
+	return rc;
+}
+
+/*
+ * Release the TC_BATCH chunks of a motion node, sent or not.
+ */
+static void
+freeTupleBatches(MotionNodeEntry * pMNEntry)
+{
+	int			i;
+
+	for (i = -1; i < pMNEntry->num_send_batches; i++)
+	{
+		TupleBatch *batch = (i < 0) ? &pMNEntry->broadcast_batch :
+			&pMNEntry->send_batches[i];
+
+		if (batch->chunk != NULL)
+			pfree(batch->chunk);
+		if (batch->prev != NULL)
+			pfree(batch->prev);
+		batch->chunk = NULL;
+		batch->prev = NULL;
+	}
+
+	if (pMNEntry->send_batches != NULL)
+		pfree(pMNEntry->send_batches);
+	pMNEntry->send_batches = NULL;
+	pMNEntry->num_send_batches = 0;
+}
+
 TupleChunkListItem
 get_eos_tuplechunklist(void)
 {
@@ -506,6 +741,11 @@ SendEndOfStream(MotionLayerState       *mlStates,
 	 */
 	pMNEntry = getMotionNodeEntry(mlStates, motNodeID, "SendEndOfStream");
 
+	/* Send the tuples still waiting in TC_BATCH chunks ahead of the EOS */
+	if (pMNEntry->batch_tuples)
+		sendTupleBatches(mlStates, transportStates, pMNEntry, motNodeID,
+						 true, true);
+
 	transportStates->SendEos(mlStates, transportStates, motNodeID, s_eos_chunk_data);
 
 	/*
@@ -827,6 +1067,7 @@ EndMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool flushCommLa
         }
     }
 
+	freeTupleBatches(pMNEntry);
 	CleanupSerTupInfo(&pMNEntry->ser_tup_info);
 	FreeTupleDesc(pMNEntry->tuple_desc);
 	if (!pMNEntry->preserve_order)
@@ -1028,6 +1269,21 @@ addChunkToSorter(MotionLayerState *mlStates,
 
 			break;
 
+		case TC_BATCH:
+			/* There shouldn't be any partial tuple data in the list! */
+			if (chunkSorterEntry->chunk_list.num_chunks != 0)
+			{
+				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+				   errmsg("Received TC_BATCH chunk from [src=%d,mn=%d] after"
+						  " partial tuple data.", srcRoute, motNodeID)));
+			}
+
+			/* A batch is always whole, turn it into HeapTuples right away */
+			reconstructBatch(pMNEntry, chunkSorterEntry, tcItem);
+			tupleCompleted = true;
+
+			break;
+
 		case TC_PARTIAL_START:
 
 			/* There shouldn't be any partial tuple data in the list! */
@@ -1184,6 +1440,24 @@ statSendEOS(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry)
 	mlStates->stat_total_bytes_sent += TUPLE_CHUNK_HEADER_SIZE;
 }
 
+static void
+statSendBatch(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry)
+{
+	int			headerOverhead = TUPLE_CHUNK_HEADER_SIZE + sizeof(TupleBatchHeader);
+
+	AssertArg(pMNEntry != NULL);
+
+	/*
+	 * The tuples of the batch were counted as they were added, see
+	 * SendTuple().
+	 */
+	pMNEntry->stat_total_chunks_sent++;
+	pMNEntry->stat_total_bytes_sent += headerOverhead;
+
+	mlStates->stat_total_chunks_sent++;
+	mlStates->stat_total_bytes_sent += headerOverhead;
+}
+
 static void
 statChunksProcessed(MotionLayerState *mlStates, MotionNodeEntry * pMNEntry, int chunksProcessed, int chunkBytes, int tupleBytes)
 {
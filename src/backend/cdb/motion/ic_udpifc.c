@@ -297,6 +297,27 @@ struct ReceiveControlInfo
 static ReceiveControlInfo rx_control_info;
 
 
+/*
+ * Batched packet transmission and reception.
+ *
+ * Where the platform provides sendmmsg()/recvmmsg(), outgoing data packets
+ * are staged in snd_batch and handed to the kernel with one system call, and
+ * the rx thread drains up to UDPIC_RX_BATCH_SIZE datagrams per recvmmsg().
+ * All connections of a ChunkTransportStateEntry share the same txfd, so a
+ * single batch may carry packets for many connections.
+ */
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define UDPIC_USE_MMSG
+#endif
+
+#ifdef UDPIC_USE_MMSG
+#define UDPIC_SND_BATCH_SIZE	32
+#define UDPIC_RX_BATCH_SIZE		16
+#else
+#define UDPIC_SND_BATCH_SIZE	1
+#define UDPIC_RX_BATCH_SIZE		1
+#endif
+
 /*
  * RxBufferPool
  *
@@ -322,10 +343,10 @@ struct RxBufferPool
 /*
  * The buffer pool used for keeping data packets.
  *
- * maxCount is set to 1 to make sure there is always a buffer
- * for picking packets from OS buffer.
+ * maxCount is set to UDPIC_RX_BATCH_SIZE to make sure there are always
+ * buffers for picking a batch of packets from OS buffer.
  */
-static RxBufferPool rx_buffer_pool = {1, 0, NULL};
+static RxBufferPool rx_buffer_pool = {UDPIC_RX_BATCH_SIZE, 0, NULL};
 
 /*
  * SendBufferPool
@@ -634,6 +655,10 @@ typedef struct AckSendParam
  * duplicatedPktNum          - duplicate packet number.
  * recvAckNum                - the number of Acks received.
  * statusQueryMsgNum         - the number of status query messages sent.
+ * sndBatchNum               - the number of sendmmsg() calls issued for data packets.
+ * sndBatchPktNum            - the number of data packets sent through sendmmsg().
+ * recvBatchNum              - the number of recvmmsg() calls that returned packets.
+ * recvBatchPktNum           - the number of packets received through recvmmsg().
  *
  */
 typedef struct ICStatistics
@@ -654,11 +679,42 @@ typedef struct ICStatistics
 	int32   duplicatedPktNum;
 	int32	recvAckNum;
 	int32	statusQueryMsgNum;
+	int32	sndBatchNum;
+	int32	sndBatchPktNum;
+	int32	recvBatchNum;
+	int32	recvBatchPktNum;
 } ICStatistics;
 
 /* Statistics for UDP interconnect. */
 static ICStatistics ic_statistics;
 
+/*
+ * SendBatch
+ *
+ * Data packets waiting to be passed to sendmmsg().
+ *
+ * holdDepth > 0 means a caller is looping over several connections and will
+ * flush the batch itself by calling endSendBatch(); otherwise sendBuffers()
+ * flushes before returning.
+ *
+ * The buffers referenced here are already in the unack queues of their
+ * connections, so the batch never owns them; it is simply reset when an
+ * interconnect is set up or torn down.
+ */
+typedef struct SendBatch
+{
+	int			count;
+	int			fd;
+	int			holdDepth;
+	ICBuffer   *bufs[UDPIC_SND_BATCH_SIZE];
+#ifdef UDPIC_USE_MMSG
+	struct mmsghdr msgs[UDPIC_SND_BATCH_SIZE];
+	struct iovec iovs[UDPIC_SND_BATCH_SIZE];
+#endif
+} SendBatch;
+
+static SendBatch snd_batch;
+
 /*=========================================================================
  * STATIC FUNCTIONS declarations
  */
@@ -762,6 +818,7 @@ static void checkQDConnectionAlive(void);
 
 
 static void *rxThreadFunc(void *arg);
+static bool handleRxPacket(icpkthdr *pkt, int read_count, struct sockaddr_storage *peer, socklen_t peerlen);
 
 static bool handleMismatch(icpkthdr *pkt, struct sockaddr_storage *peer, int peer_len);
 static void handleAckedPacket(MotionConn *ackConn, ICBuffer *buf, uint64 now);
@@ -777,6 +834,11 @@ static inline void addCRC(icpkthdr *pkt);
 static inline bool checkCRC(icpkthdr *pkt);
 static void sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static void sendOnce(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer *buf, MotionConn * conn);
+static void sendBatched(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer *buf, MotionConn *conn);
+static void flushSendBatch(void);
+static inline void beginSendBatch(void);
+static inline void endSendBatch(void);
+static inline void resetSendBatch(void);
 static inline uint64 computeExpirationPeriod(MotionConn *conn, uint32 retry);
 
 static ICBuffer *getSndBuffer(MotionConn *conn);
@@ -846,6 +908,10 @@ struct TransProtoStats
 	TransProtoStatEntry	*tail;
 	uint64				count;
 	uint64				startTime;
+
+	/* sendmmsg() calls and the data packets they carried */
+	uint64				batchCount;
+	uint64				batchPktCount;
 };
 
 static TransProtoStats trans_proto_stats = {PTHREAD_MUTEX_INITIALIZER, NULL, NULL, 0};
@@ -873,6 +939,21 @@ initTransProtoStats()
 	trans_proto_stats.tail = NULL;
 	trans_proto_stats.count = 0;
 	trans_proto_stats.startTime = getCurrentTime();
+	trans_proto_stats.batchCount = 0;
+	trans_proto_stats.batchPktCount = 0;
+	pthread_mutex_unlock(&trans_proto_stats.lock);
+}
+
+/*
+ * updateBatchStats
+ * 		Account one sendmmsg() call carrying npkts data packets.
+ */
+static void
+updateBatchStats(int npkts)
+{
+	pthread_mutex_lock(&trans_proto_stats.lock);
+	trans_proto_stats.batchCount++;
+	trans_proto_stats.batchPktCount += npkts;
 	pthread_mutex_unlock(&trans_proto_stats.lock);
 }
 
@@ -938,6 +1019,11 @@ dumpTransProtoStats()
 
 	trans_proto_stats.tail = NULL;
 
+	fprintf(ofile, "batches " UINT64_FORMAT " batched_pkts " UINT64_FORMAT " avg_batch %f\n",
+			trans_proto_stats.batchCount, trans_proto_stats.batchPktCount,
+			trans_proto_stats.batchCount == 0 ? 0 :
+			(double) trans_proto_stats.batchPktCount / (double) trans_proto_stats.batchCount);
+
 	pthread_mutex_unlock(&trans_proto_stats.lock);
 
     fclose(ofile);
@@ -2045,7 +2131,7 @@ static void
 initRxBufferPool(RxBufferPool *p)
 {
 	p->count = 0;
-	p->maxCount = 1;
+	p->maxCount = UDPIC_RX_BATCH_SIZE;
 	p->freeList = NULL;
 }
 
@@ -3308,6 +3394,8 @@ SetupUDPIFCInterconnect_Internal(EState *estate)
 
 	pthread_mutex_lock(&ic_control_info.lock);
 
+	resetSendBatch();
+
 	gp_interconnect_id = estate->es_sliceTable->ic_instance_id;
 
 	Assert(gp_interconnect_id > 0);
@@ -3641,6 +3729,9 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 
 	HOLD_INTERRUPTS();
 
+	/* drop packets left staged by an ERROR; their buffers are released below. */
+	resetSendBatch();
+
 	/* Log the start of TeardownInterconnect. */
 	if (gp_log_interconnect >= GPVARS_VERBOSITY_TERSE)
 	{
@@ -3860,7 +3951,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 			" freebuf_avg %f "
 			"mismatch_pkt_num %d disordered_pkt_num %d duplicated_pkt_num %d"
 			" rtt/dev [" UINT64_FORMAT "/" UINT64_FORMAT ", %f/%f, " UINT64_FORMAT "/" UINT64_FORMAT "] "
-			" cwnd %f status_query_msg_num %d",
+			" cwnd %f status_query_msg_num %d"
+			" snd_batch_avg %f recv_batch_avg %f",
 			ic_control_info.isSender, isReceiver,
 			Gp_interconnect_snd_queue_depth, Gp_interconnect_queue_depth, Gp_max_packet_size,
 			UNACK_QUEUE_RING_SLOTS_NUM, TIMER_SPAN, DEFAULT_RTT,
@@ -3873,7 +3965,9 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 			(double)((double)ic_statistics.totalBuffers)/((double)ic_statistics.bufferCountingTime),
 			ic_statistics.mismatchNum, ic_statistics.disorderedPktNum, ic_statistics.duplicatedPktNum,
 			(minRtt == ~((uint64)0) ? 0 : minRtt), (minDev == ~((uint64)0) ? 0 : minDev), avgRtt, avgDev, maxRtt, maxDev,
-			snd_control_info.cwnd, ic_statistics.statusQueryMsgNum);
+			snd_control_info.cwnd, ic_statistics.statusQueryMsgNum,
+			(ic_statistics.sndBatchNum == 0 ? 0 : (double)ic_statistics.sndBatchPktNum / (double)ic_statistics.sndBatchNum),
+			(ic_statistics.recvBatchNum == 0 ? 0 : (double)ic_statistics.recvBatchPktNum / (double)ic_statistics.recvBatchNum));
 
 	ic_control_info.isSender = false;
 	memset(&ic_statistics, 0, sizeof(ICStatistics));
@@ -4463,6 +4557,9 @@ handleAcks(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntr
 
 	bool shouldSendBuffers = false;
 
+	/* let the buffers released by these acks go out together */
+	beginSendBatch();
+
 	for (;;)
 	{
 
@@ -4475,6 +4572,7 @@ handleAcks(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntr
 		{
 			if (errno == EWOULDBLOCK) /* had nothing to read. */
 			{
+				endSendBatch();
 				aggregateStatistics(pEntry);
 				return ret;
 			}
@@ -4780,6 +4878,162 @@ xmit_retry:
 	return;
 }
 
+/*
+ * sendBatched
+ * 		Stage a data packet for transmission with sendmmsg().
+ *
+ * The batch is flushed when it is full or when its packets would go out
+ * through a different socket; otherwise the caller is responsible for
+ * flushing it (see sendBuffers and beginSendBatch/endSendBatch).
+ */
+static void
+sendBatched(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer *buf, MotionConn *conn)
+{
+#ifdef UDPIC_USE_MMSG
+	struct mmsghdr *msg;
+	struct iovec *iov;
+
+#ifdef USE_ASSERT_CHECKING
+	if (testmode_inject_fault(gp_udpic_dropxmit_percent))
+	{
+	#ifdef AMS_VERBOSE_LOGGING
+		write_log("THROW PKT with seq %d srcpid %d despid %d", buf->pkt->seq, buf->pkt->srcPid, buf->pkt->dstPid);
+	#endif
+		return;
+	}
+#endif
+
+	if (snd_batch.count > 0 && snd_batch.fd != pEntry->txfd)
+		flushSendBatch();
+
+	msg = &snd_batch.msgs[snd_batch.count];
+	iov = &snd_batch.iovs[snd_batch.count];
+
+	iov->iov_base = buf->pkt;
+	iov->iov_len = buf->pkt->len;
+
+	memset(msg, 0, sizeof(*msg));
+	msg->msg_hdr.msg_name = &conn->peer;
+	msg->msg_hdr.msg_namelen = conn->peer_len;
+	msg->msg_hdr.msg_iov = iov;
+	msg->msg_hdr.msg_iovlen = 1;
+
+	snd_batch.bufs[snd_batch.count] = buf;
+	snd_batch.fd = pEntry->txfd;
+	snd_batch.count++;
+
+	if (snd_batch.count == UDPIC_SND_BATCH_SIZE)
+		flushSendBatch();
+#else
+	sendOnce(transportStates, pEntry, buf, conn);
+#endif
+}
+
+/*
+ * flushSendBatch
+ * 		Send all the staged data packets.
+ *
+ * Error handling mirrors sendOnce: EINTR is retried, EAGAIN drops the rest
+ * of the batch (the packets stay in the unack queues and will be
+ * retransmitted), anything else is reported as an interconnect error.
+ */
+static void
+flushSendBatch(void)
+{
+#ifdef UDPIC_USE_MMSG
+	int			count = snd_batch.count;
+	int			sent = 0;
+	int			i;
+
+	if (count == 0)
+		return;
+
+	/* Reset first, so that an ERROR below leaves no stale entries behind. */
+	snd_batch.count = 0;
+
+	ic_statistics.sndBatchNum++;
+	ic_statistics.sndBatchPktNum += count;
+
+#ifdef TRANSFER_PROTOCOL_STATS
+	updateBatchStats(count);
+#endif
+
+	while (sent < count)
+	{
+		int			n;
+
+		n = sendmmsg(snd_batch.fd, &snd_batch.msgs[sent], count - sent, 0);
+		if (n < 0)
+		{
+			MotionConn *conn;
+
+			if (errno == EINTR)
+				continue;
+
+			if (errno == EAGAIN) /* no space ? not an error. */
+				return;
+
+			conn = snd_batch.bufs[sent]->conn;
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error writing an outgoing packet: %m"),
+							errdetail("error during sendmmsg() call (error:%d).\n"
+									  "For Remote Connection: contentId=%d at %s",
+									  errno, conn->remoteContentId,
+									  conn->remoteHostAndPort)));
+			/* not reached */
+		}
+
+		for (i = sent; i < sent + n; i++)
+		{
+			ICBuffer   *buf = snd_batch.bufs[i];
+
+			if (snd_batch.msgs[i].msg_len != buf->pkt->len && DEBUG1 >= log_min_messages)
+				write_log("Interconnect error writing an outgoing packet [seq %d]: short transmit (given %d sent %d) during sendmmsg() call."
+						  "For Remote Connection: contentId=%d at %s", buf->pkt->seq, buf->pkt->len, snd_batch.msgs[i].msg_len,
+						  buf->conn->remoteContentId,
+						  buf->conn->remoteHostAndPort);
+		}
+
+		sent += n;
+	}
+#endif
+}
+
+/*
+ * beginSendBatch
+ * 		Keep sendBuffers from flushing, so packets of several connections
+ * 		can share one sendmmsg() call.
+ */
+static inline void
+beginSendBatch(void)
+{
+	snd_batch.holdDepth++;
+}
+
+/*
+ * endSendBatch
+ * 		Counterpart of beginSendBatch; flushes the batch at the outermost level.
+ */
+static inline void
+endSendBatch(void)
+{
+	Assert(snd_batch.holdDepth > 0);
+
+	if (--snd_batch.holdDepth == 0)
+		flushSendBatch();
+}
+
+/*
+ * resetSendBatch
+ * 		Forget any staged packets, e.g. after an ERROR escaped a batch.
+ */
+static inline void
+resetSendBatch(void)
+{
+	snd_batch.count = 0;
+	snd_batch.holdDepth = 0;
+}
+
 
 /*
  * handleStopMsgs
@@ -4885,6 +5139,10 @@ handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *p
  *
  * After sending a buffer, the buffer will be placed into both the unack queue and
  * the corresponding queue in the unack queue ring.
+ *
+ * The packets go out with a single sendmmsg() call when the platform supports
+ * it; inside a beginSendBatch/endSendBatch section they are kept staged so that
+ * packets of other connections can join the same call.
  */
 static void
 sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn)
@@ -4922,10 +5180,10 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		}
 
 		/*
-		 * Note the place of sendOnce here.
+		 * Note the place of sendBatched here.
 		 * If we send before appending it to the unack queue and
 		 * putting it into unack queue ring, and there is a
-		 * network error occurred in the sendOnce function, error
+		 * network error occurred in the send path, error
 		 * message will be output. In the time of error message output,
 		 * interrupts is potentially checked, if there is a pending query cancel,
 		 * it will lead to a dangled buffer (memory leak).
@@ -4934,7 +5192,7 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		updateStats(TPE_DATA_PKT_SEND, conn, buf->pkt);
 #endif
 
-		sendOnce(transportStates, pEntry, buf, conn);
+		sendBatched(transportStates, pEntry, buf, conn);
 		ic_statistics.sndPktNum++;
 
 #ifdef AMS_VERBOSE_LOGGING
@@ -4943,6 +5201,9 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 
 		buf->conn->sentSeq = buf->pkt->seq;
 	}
+
+	if (snd_batch.holdDepth == 0)
+		flushSendBatch();
 }
 
 /*
@@ -5229,6 +5490,8 @@ checkExpiration(ChunkTransportState *transportStates, ChunkTransportStateEntry *
 	/* check for expiration */
 	int count = 0;
 	int retransmits = 0;
+
+	beginSendBatch();
 	while (now >= (unack_queue_ring.currentTime + TIMER_SPAN) && count++ < UNACK_QUEUE_RING_SLOTS_NUM)
 	{
 		/* expired, need to resend them */
@@ -5245,7 +5508,7 @@ checkExpiration(ChunkTransportState *transportStates, ChunkTransportStateEntry *
 			updateStats(TPE_DATA_PKT_SEND, curBuf->conn, curBuf->pkt);
 #endif
 
-			sendOnce(transportStates, pEntry, curBuf, curBuf->conn);
+			sendBatched(transportStates, pEntry, curBuf, curBuf->conn);
 
 			retransmits++;
 			ic_statistics.retransmits++;
@@ -5264,6 +5527,8 @@ checkExpiration(ChunkTransportState *transportStates, ChunkTransportStateEntry *
 		unack_queue_ring.idx = (unack_queue_ring.idx + 1) % (UNACK_QUEUE_RING_SLOTS_NUM);
 	}
 
+	endSendBatch();
+
 	/*
 	 * deal with case when there is a long time this function is not called.
 	 */
@@ -5640,6 +5905,7 @@ SendEosUDPIFC(MotionLayerState *mlStates,
 	uint64 now = getCurrentTime();
 
 	/* now flush all of the buffers. */
+	beginSendBatch();
 	for (i = 0; i < pEntry->numConns; i++)
 	{
 		conn = pEntry->conns + i;
@@ -5668,6 +5934,7 @@ SendEosUDPIFC(MotionLayerState *mlStates,
 			activeCount++;
 		}
 	}
+	endSendBatch();
 
 	/*
 	 * Now waiting for acks from receivers.
@@ -6242,10 +6509,127 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
 	return true;
 }
 
+/*
+ * handleRxPacket
+ * 		Validate a datagram read by the rx thread and hand it to its connection.
+ *
+ * Returns true if the packet buffer was taken over by the connection (or the
+ * startup cache), false if the caller still owns it.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ * NOTE: In threads, we cannot use palloc/pfree, because it's not thread safe.
+ */
+static bool
+handleRxPacket(icpkthdr *pkt, int read_count, struct sockaddr_storage *peer, socklen_t peerlen)
+{
+	MotionConn *conn = NULL;
+	bool		consumed = false;
+	AckSendParam param;
+
+	if (DEBUG5 >= log_min_messages)
+		write_log("received inbound len %d", read_count);
+
+	if (read_count < sizeof(icpkthdr))
+	{
+		if (DEBUG1 >= log_min_messages)
+			write_log("Interconnect error: short conn receive (%d)", read_count);
+		return false;
+	}
+
+	/* length must be >= 0 */
+	if (pkt->len < 0)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound with negative length");
+		return false;
+	}
+
+	if (pkt->len != read_count)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
+		return false;
+	}
+
+	/*
+	 * check the CRC of the payload.
+	 */
+	if (gp_interconnect_full_crc)
+	{
+		if (!checkCRC(pkt))
+		{
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *)&ic_statistics.crcErrors, 1);
+			if (DEBUG2 >= log_min_messages)
+				write_log("received network data error, dropping bad packet, user data unaffected.");
+			return false;
+		}
+	}
+
+	#ifdef AMS_VERBOSE_LOGGING
+		logPkt("GOT MESSAGE", pkt);
+	#endif
+
+	memset(&param, 0, sizeof(AckSendParam));
+
+	/*
+	 * Get the connection for the pkt.
+	 *
+	 * 	The connection hash table should be locked until
+	 * 	finishing the processing of the packet to avoid
+	 *  the connection addition/removal from the hash table
+	 *  during the mean time.
+	 */
+
+	pthread_mutex_lock(&ic_control_info.lock);
+	conn = findConnByHeader(&ic_control_info.connHtab, pkt);
+
+	if (conn != NULL)
+	{
+		/* Handling a regular packet */
+		if (handleDataPacket(conn, pkt, peer, &peerlen, &param))
+			consumed = true;
+		ic_statistics.recvPktNum++;
+	}
+	else
+	{
+		/*
+		 * There may have two kinds of Mismatched packets:
+		 *    a) Past packets from previous command after I was torn down
+		 *    b) Future packets from current command before my connections are built.
+		 *
+		 * The handling logic is to "Ack the past and Nak the future".
+		 */
+		if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
+		{
+			if (DEBUG1 >= log_min_messages)
+				write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+
+		#ifdef AMS_VERBOSE_LOGGING
+			logPkt("Got a Mismatched Packet", pkt);
+		#endif
+
+			if (handleMismatch(pkt, peer, peerlen))
+				consumed = true;
+			ic_statistics.mismatchNum++;
+		}
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	/* real ack sending is after lock release to decrease the lock holding time. */
+	if (param.msg.len != 0)
+		sendAckWithParam(&param);
+
+	return consumed;
+}
+
 /*
  * rxThreadFunc
  * 		Main function of the receive background thread.
  *
+ * The thread keeps up to UDPIC_RX_BATCH_SIZE receive buffers and fills as
+ * many of them as are ready with a single recvmmsg() call.  Buffers that
+ * were not taken over by a connection are kept for the next round.
+ *
  * NOTE: This function MUST NOT contain elog or ereport statements.
  * elog is NOT thread-safe.  Developers should instead use something like:
  *
@@ -6257,9 +6641,16 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
 static void *
 rxThreadFunc(void *arg)
 {
-	icpkthdr *pkt = NULL;
+	icpkthdr   *pkts[UDPIC_RX_BATCH_SIZE];
+	struct sockaddr_storage peers[UDPIC_RX_BATCH_SIZE];
+#ifdef UDPIC_USE_MMSG
+	struct mmsghdr msgs[UDPIC_RX_BATCH_SIZE];
+	struct iovec iovs[UDPIC_RX_BATCH_SIZE];
+#endif
+	int			npkts = 0;
 	bool	skip_poll = false;
 	uint32 	expected = 1;
+	int			i;
 
 	gp_set_thread_sigmasks();
 
@@ -6267,6 +6658,11 @@ rxThreadFunc(void *arg)
 	{
 		struct pollfd nfd;
 		int		n;
+		int		read_count = 0;
+		int		nkept;
+#ifndef UDPIC_USE_MMSG
+		socklen_t	peerlen = sizeof(peers[0]);
+#endif
 
 		/* check shutdown condition*/
 		expected = 1;
@@ -6279,14 +6675,21 @@ rxThreadFunc(void *arg)
 			break;
 		}
 
-		/* Try to get a buffer */
-		if (pkt == NULL)
+		/* Try to get buffers */
+		if (npkts < UDPIC_RX_BATCH_SIZE)
 		{
 			pthread_mutex_lock(&ic_control_info.lock);
-			pkt = getRxBuffer(&rx_buffer_pool);
+			while (npkts < UDPIC_RX_BATCH_SIZE)
+			{
+				icpkthdr   *buf = getRxBuffer(&rx_buffer_pool);
+
+				if (buf == NULL)
+					break;
+				pkts[npkts++] = buf;
+			}
 			pthread_mutex_unlock(&ic_control_info.lock);
 
-			if (pkt == NULL)
+			if (npkts == 0)
 			{
 				setRxThreadError(ENOMEM);
 				continue;
@@ -6331,157 +6734,101 @@ rxThreadFunc(void *arg)
 				continue;
 		}
 
-		if (skip_poll || (n == 1 && (nfd.events & POLLIN)))
-		{
-			/* we've got something interesting to read */
-			/* handle incoming */
-			/* ready to read on our socket */
-			MotionConn *conn = NULL;
-			int read_count = 0;
-
-			struct sockaddr_storage peer;
-			socklen_t peerlen;
-
-			peerlen = sizeof(peer);
-			read_count = recvfrom(UDP_listenerFd, (char *)pkt, Gp_max_packet_size, 0,
-								  (struct sockaddr *)&peer, &peerlen);
-
-			expected = 1;
-			if (pg_atomic_compare_exchange_u32((pg_atomic_uint32 *)&ic_control_info.shutdown, &expected, 0))
-			{
-				if (DEBUG1 >= log_min_messages)
-				{
-					write_log("udp-ic: rx-thread shutting down");
-				}
-				break;
-			}
-
-			if (DEBUG5 >= log_min_messages)
-				write_log("received inbound len %d", read_count);
-
-			if (read_count < 0)
-			{
-				skip_poll = false;
+		if (!skip_poll && !(n == 1 && (nfd.events & POLLIN)))
+			continue;
 
-				if (errno == EWOULDBLOCK || errno == EINTR)
-					continue;
+		/* we've got something interesting to read */
+		/* handle incoming */
+		/* ready to read on our socket */
+#ifdef UDPIC_USE_MMSG
+		for (i = 0; i < npkts; i++)
+		{
+			iovs[i].iov_base = pkts[i];
+			iovs[i].iov_len = Gp_max_packet_size;
+
+			memset(&msgs[i], 0, sizeof(msgs[i]));
+			msgs[i].msg_hdr.msg_name = &peers[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(peers[i]);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
 
-				write_log("Interconnect error: recvfrom (%d)", errno);
-				/*
-				 * ERROR case: if simply break out the loop here, there will be a hung here,
-				 * since main thread will never be waken up, and senders will not
-				 * get responses anymore.
-				 *
-				 * Thus, we set an error flag, and let main thread to report an error.
-				 */
-				setRxThreadError(errno);
-				continue;
-			}
+		n = recvmmsg(UDP_listenerFd, msgs, npkts, 0, NULL);
+#else
+		read_count = recvfrom(UDP_listenerFd, (char *)pkts[0], Gp_max_packet_size, 0,
+							  (struct sockaddr *)&peers[0], &peerlen);
+		n = (read_count < 0) ? -1 : 1;
+#endif
 
-			if (read_count < sizeof(icpkthdr))
+		expected = 1;
+		if (pg_atomic_compare_exchange_u32((pg_atomic_uint32 *)&ic_control_info.shutdown, &expected, 0))
+		{
+			if (DEBUG1 >= log_min_messages)
 			{
-				if (DEBUG1 >= log_min_messages)
-					write_log("Interconnect error: short conn receive (%d)", read_count);
-				continue;
+				write_log("udp-ic: rx-thread shutting down");
 			}
+			break;
+		}
 
-			/* when we get a "good" recvfrom() result, we can skip poll() until we get a bad one. */
-			skip_poll = true;
-
-			/* length must be >= 0 */
-			if (pkt->len < 0)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound with negative length");
-				continue;
-			}
+		if (n < 0)
+		{
+			skip_poll = false;
 
-			if (pkt->len != read_count)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
+			if (errno == EWOULDBLOCK || errno == EINTR)
 				continue;
-			}
 
+			write_log("Interconnect error: recvfrom (%d)", errno);
 			/*
-			 * check the CRC of the payload.
-			 */
-			if (gp_interconnect_full_crc)
-			{
-				if (!checkCRC(pkt))
-				{
-					pg_atomic_add_fetch_u32((pg_atomic_uint32 *)&ic_statistics.crcErrors, 1);
-					if (DEBUG2 >= log_min_messages)
-						write_log("received network data error, dropping bad packet, user data unaffected.");
-					continue;
-				}
-			}
-
-			#ifdef AMS_VERBOSE_LOGGING
-				logPkt("GOT MESSAGE", pkt);
-			#endif
-
-			AckSendParam param;
-			memset(&param, 0, sizeof(AckSendParam));
-
-			/*
-			 * Get the connection for the pkt.
+			 * ERROR case: if simply break out the loop here, there will be a hung here,
+			 * since main thread will never be waken up, and senders will not
+			 * get responses anymore.
 			 *
-			 * 	The connection hash table should be locked until
-			 * 	finishing the processing of the packet to avoid
-			 *  the connection addition/removal from the hash table
-			 *  during the mean time.
+			 * Thus, we set an error flag, and let main thread to report an error.
 			 */
+			setRxThreadError(errno);
+			continue;
+		}
 
-			pthread_mutex_lock(&ic_control_info.lock);
-			conn = findConnByHeader(&ic_control_info.connHtab, pkt);
+		/* when we get a "good" receive result, we can skip poll() until we get a bad one. */
+		skip_poll = true;
 
-			if (conn != NULL)
-			{
-				/* Handling a regular packet */
-				if (handleDataPacket(conn, pkt, &peer, &peerlen, &param))
-					pkt = NULL;
-				ic_statistics.recvPktNum++;
-			}
-			else
-			{
-				/*
-				 * There may have two kinds of Mismatched packets:
-				 *    a) Past packets from previous command after I was torn down
-				 *    b) Future packets from current command before my connections are built.
-				 *
-				 * The handling logic is to "Ack the past and Nak the future".
-				 */
-				if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
-				{
-					if (DEBUG1 >= log_min_messages)
-						write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+#ifdef UDPIC_USE_MMSG
+		ic_statistics.recvBatchNum++;
+		ic_statistics.recvBatchPktNum += n;
+#endif
 
-				#ifdef AMS_VERBOSE_LOGGING
-					logPkt("Got a Mismatched Packet", pkt);
-				#endif
+		/* process the packets, keeping the buffers that were not consumed */
+		nkept = 0;
+		for (i = 0; i < npkts; i++)
+		{
+			icpkthdr   *pkt = pkts[i];
 
-					if (handleMismatch(pkt, &peer, peerlen))
-						pkt = NULL;
-					ic_statistics.mismatchNum++;
-				}
+			if (i < n)
+			{
+#ifdef UDPIC_USE_MMSG
+				read_count = msgs[i].msg_len;
+				if (handleRxPacket(pkt, read_count, &peers[i], msgs[i].msg_hdr.msg_namelen))
+					continue;
+#else
+				if (handleRxPacket(pkt, read_count, &peers[i], peerlen))
+					continue;
+#endif
 			}
-			pthread_mutex_unlock(&ic_control_info.lock);
 
-			/* real ack sending is after lock release to decrease the lock holding time. */
-			if (param.msg.len != 0)
-				sendAckWithParam(&param);
+			pkts[nkept++] = pkt;
 		}
+		npkts = nkept;
 
 		/* pthread_yield(); */
 	}
 
-	/* Before retrun, we release the packet. */
-	if (pkt)
+	/* Before retrun, we release the packets. */
+	if (npkts > 0)
 	{
 		pthread_mutex_lock(&ic_control_info.lock);
-		freeRxBuffer(&rx_buffer_pool, pkt);
-		pkt = NULL;
+		for (i = 0; i < npkts; i++)
+			freeRxBuffer(&rx_buffer_pool, pkts[i]);
+		npkts = 0;
 		pthread_mutex_unlock(&ic_control_info.lock);
 	}
 
@@ -787,6 +787,163 @@ SerializeTupleDirect(HeapTuple tuple, SerTupInfo * pSerInfo, struct directTransp
 	return dataSize;   
 }
 
+/*
+ * Can this tuple be sent in a TC_BATCH chunk?  Only MemTuples are batched,
+ * and only narrow ones: those are the tuples for which the chunk header and
+ * the per-chunk work on the receiver weigh the most.
+ */
+bool
+TupleIsBatchable(HeapTuple tuple)
+{
+	uint32		len;
+
+	if (!is_heaptuple_memtuple(tuple))
+		return false;
+
+	len = memtuple_get_size((MemTuple) tuple, NULL);
+
+	return len <= TUPLE_BATCH_MAX_TUPLE_SIZE &&
+		TUPLE_CHUNK_HEADER_SIZE + sizeof(TupleBatchHeader) +
+		sizeof(TupleBatchEntry) + len <= Gp_max_tuple_chunk_size;
+}
+
+/*
+ * Add a tuple to the TC_BATCH chunk of a route, starting a new chunk if none
+ * is pending.  Only the bytes that differ from the previous tuple of the
+ * chunk are stored.
+ *
+ * Returns the number of bytes added to the chunk, or 0 if the tuple does not
+ * fit; the caller must send the chunk and try again.
+ */
+int
+SerializeTupleIntoBatch(HeapTuple tuple, SerTupInfo *pSerInfo, TupleBatch *batch)
+{
+	TupleBatchHeader hdr;
+	TupleBatchEntry entry;
+	char	   *data = (char *) tuple;
+	char	   *pos;
+	uint32		len;
+	uint32		shared = 0;
+	int			added;
+
+	AssertArg(TupleIsBatchable(tuple));
+
+	len = memtuple_get_size((MemTuple) tuple, NULL);
+
+	if (batch->chunk == NULL)
+	{
+		batch->chunk = getChunkFromCache(&pSerInfo->chunkCache);
+		if (batch->chunk == NULL)
+		{
+			ereport(FATAL, (errcode(ERRCODE_OUT_OF_MEMORY),
+							errmsg("Could not allocate space for tuple batch chunk.")));
+		}
+
+		hdr.ntuples = 0;
+		hdr.unused = 0;
+		memcpy(batch->chunk->chunk_data + TUPLE_CHUNK_HEADER_SIZE, &hdr, sizeof(hdr));
+		SetChunkType(batch->chunk->chunk_data, TC_BATCH);
+		batch->chunk->chunk_length = TUPLE_CHUNK_HEADER_SIZE + sizeof(hdr);
+		batch->prevlen = 0;
+	}
+	else
+	{
+		uint32		maxshared = Min(len, batch->prevlen);
+
+		while (shared < maxshared && data[shared] == batch->prev[shared])
+			shared++;
+	}
+
+	added = sizeof(TupleBatchEntry) + len - shared;
+	if (batch->chunk->chunk_length + added > Gp_max_tuple_chunk_size)
+		return 0;
+
+	entry.len = len;
+	entry.shared = shared;
+
+	pos = (char *) batch->chunk->chunk_data + batch->chunk->chunk_length;
+	memcpy(pos, &entry, sizeof(entry));
+	memcpy(pos + sizeof(entry), data + shared, len - shared);
+
+	batch->chunk->chunk_length += added;
+	SetChunkDataSize(batch->chunk->chunk_data,
+					 batch->chunk->chunk_length - TUPLE_CHUNK_HEADER_SIZE);
+
+	memcpy(&hdr, batch->chunk->chunk_data + TUPLE_CHUNK_HEADER_SIZE, sizeof(hdr));
+	hdr.ntuples++;
+	memcpy(batch->chunk->chunk_data + TUPLE_CHUNK_HEADER_SIZE, &hdr, sizeof(hdr));
+
+	/* Remember the tuple for the next one; the shared part is there already */
+	if (batch->prev == NULL)
+		batch->prev = palloc(TUPLE_BATCH_MAX_TUPLE_SIZE);
+	memcpy(batch->prev + shared, data + shared, len - shared);
+	batch->prevlen = len;
+
+	return added;
+}
+
+/*
+ * Convert a TC_BATCH chunk into the MemTuples it holds.  The tuples, and the
+ * array of them, are palloc'd in the current memory context.
+ */
+HeapTuple *
+CvtBatchChunkToHeapTups(TupleChunkListItem tcItem, int *ntuples)
+{
+	char	   *pos = GetChunkDataPtr(tcItem) + TUPLE_CHUNK_HEADER_SIZE;
+	char	   *end = GetChunkDataPtr(tcItem) + tcItem->chunk_length;
+	char	   *prev = NULL;
+	uint32		prevlen = 0;
+	TupleBatchHeader hdr;
+	HeapTuple  *tuples;
+	int			i;
+
+	if (end - pos < sizeof(hdr))
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Interconnect error: tuple batch chunk too short.")));
+
+	memcpy(&hdr, pos, sizeof(hdr));
+	pos += sizeof(hdr);
+
+	tuples = (HeapTuple *) palloc(sizeof(HeapTuple) * Max(hdr.ntuples, 1));
+
+	for (i = 0; i < hdr.ntuples; i++)
+	{
+		TupleBatchEntry entry;
+		char	   *tup;
+
+		if (end - pos < sizeof(entry))
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error: tuple batch chunk too short.")));
+
+		memcpy(&entry, pos, sizeof(entry));
+		pos += sizeof(entry);
+
+		if (entry.len < sizeof(uint32) || entry.shared > entry.len ||
+			entry.shared > prevlen || end - pos < entry.len - entry.shared)
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error: cannot convert tuple batch chunk to tuples."),
+							errdetail("tuple %d of %d: len %d, shared %d, previous len %d",
+									  i, hdr.ntuples, entry.len, entry.shared, prevlen)));
+
+		tup = palloc(entry.len);
+		if (entry.shared > 0)
+			memcpy(tup, prev, entry.shared);
+		memcpy(tup + entry.shared, pos, entry.len - entry.shared);
+		pos += entry.len - entry.shared;
+
+		tuples[i] = (HeapTuple) tup;
+		prev = tup;
+		prevlen = entry.len;
+	}
+
+	if (pos != end)
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Interconnect error: trailing data in tuple batch chunk.")));
+
+	*ntuples = hdr.ntuples;
+	return tuples;
+}
+
 /*
  * Deserialize a HeapTuple's data from a byte-array.
  *
@@ -0,0 +1,481 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    advance_aggregates_codegen.cc
+//
+//  @doc:
+//    Generates code for advance_aggregates function.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stddef.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codegen/advance_aggregates_codegen.h"
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/op_expr_tree_generator.h"
+#include "codegen/pg_arith_func_generator.h"
+#include "codegen/pg_compare_func_generator.h"
+#include "codegen/pg_func_generator.h"
+#include "codegen/pg_func_generator_interface.h"
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/utils/utility.h"
+
+#include "llvm/IR/Argument.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "executor/executor.h"
+#include "executor/nodeAgg.h"
+#include "executor/tuptable.h"
+#include "nodes/execnodes.h"
+#include "nodes/pg_list.h"
+#include "nodes/primnodes.h"
+#include "utils/elog.h"
+}
+
+namespace llvm {
+class BasicBlock;
+class Function;
+class Value;
+}  // namespace llvm
+
+using gpcodegen::AdvanceAggregatesCodegen;
+using gpcodegen::CodeGenFuncMap;
+using gpcodegen::GpCodegenUtils;
+using gpcodegen::PGArithFuncGenerator;
+using gpcodegen::PGCompareFuncGenerator;
+using gpcodegen::PGFuncGenerator;
+using gpcodegen::PGFuncGeneratorInfo;
+using gpcodegen::PGFuncGeneratorInterface;
+using gpcodegen::PGGenericFuncGenerator;
+
+constexpr char AdvanceAggregatesCodegen::kAdvanceAggregatesPrefix[];
+
+CodeGenFuncMap
+AdvanceAggregatesCodegen::supported_function_;
+
+namespace {
+
+// pg_proc oids of the transition functions that need special handling.
+// See pg_proc.h.
+constexpr Oid kInt8IncOid = 1219;
+constexpr Oid kInt8IncAnyOid = 2804;
+constexpr Oid kInt2SumOid = 1840;
+constexpr Oid kInt4SumOid = 1841;
+
+template <typename Arg0, typename Arg1>
+void RegisterFunction(CodeGenFuncMap* supported_function,
+                      unsigned int pg_func_oid,
+                      const std::string& pg_func_name,
+                      PGFuncGenerator func_ptr) {
+  (*supported_function)[pg_func_oid] =
+      std::unique_ptr<PGFuncGeneratorInterface>(
+          new PGGenericFuncGenerator<Arg0, Arg1>(pg_func_oid,
+                                                 pg_func_name,
+                                                 func_ptr));
+}
+
+// count(*) and count(any) ignore the input value and add 1 to the count.
+bool IsCountTransFunc(Oid transfn_oid) {
+  return kInt8IncOid == transfn_oid || kInt8IncAnyOid == transfn_oid;
+}
+
+// int2_sum() and int4_sum() are the only non-strict functions we inline.
+// They start from the first non-NULL input and skip NULL inputs.
+bool IsIntSumTransFunc(Oid transfn_oid) {
+  return kInt2SumOid == transfn_oid || kInt4SumOid == transfn_oid;
+}
+
+// Transition functions of numeric sum and avg, and of avg on integers, with
+// pass-by-reference transition types. They are not inlined: the generated
+// code calls advance_aggregate_value() for them, which copies the new value
+// into the aggregate context.
+bool IsCalledTransFunc(Oid transfn_oid) {
+  switch (transfn_oid) {
+    case 1724:  // numeric_add, sum(numeric)
+    case 1842:  // int8_sum, sum(int8)
+    case 1962:  // int2_avg_accum
+    case 1963:  // int4_avg_accum
+    case 3100:  // int8_avg_accum
+    case 3102:  // numeric_avg_accum
+    case 3104:  // numeric_avg_amalg
+    case 6009:  // int8_avg_amalg
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+void AdvanceAggregatesCodegen::InitializeSupportedFunction() {
+  if (!supported_function_.empty()) { return; }
+
+  // Transition functions are stored in pg_proc table. See pg_proc.h and
+  // pg_aggregate.h for the oids.
+
+  // count
+  RegisterFunction<int64_t, int64_t>(
+      &supported_function_, kInt8IncOid, "int8inc",
+      &PGArithFuncGenerator<int64_t, int64_t, int64_t>::AddWithOverflow);
+  RegisterFunction<int64_t, int64_t>(
+      &supported_function_, kInt8IncAnyOid, "int8inc_any",
+      &PGArithFuncGenerator<int64_t, int64_t, int64_t>::AddWithOverflow);
+
+  // sum, and combining partial counts and sums in multi-stage aggregation
+  RegisterFunction<int64_t, int16_t>(
+      &supported_function_, kInt2SumOid, "int2_sum",
+      &PGArithFuncGenerator<int64_t, int64_t, int16_t>::AddWithoutOverflow);
+  RegisterFunction<int64_t, int32_t>(
+      &supported_function_, kInt4SumOid, "int4_sum",
+      &PGArithFuncGenerator<int64_t, int64_t, int32_t>::AddWithoutOverflow);
+  RegisterFunction<int64_t, int64_t>(
+      &supported_function_, 463, "int8pl",
+      &PGArithFuncGenerator<int64_t, int64_t, int64_t>::AddWithOverflow);
+  RegisterFunction<float, float>(
+      &supported_function_, 204, "float4pl",
+      &PGArithFuncGenerator<float, float, float>::AddWithOverflow);
+  RegisterFunction<double, double>(
+      &supported_function_, 218, "float8pl",
+      &PGArithFuncGenerator<double, double, double>::AddWithOverflow);
+
+  // max and min
+  RegisterFunction<int16_t, int16_t>(
+      &supported_function_, 770, "int2larger",
+      &PGCompareFuncGenerator<int16_t, int16_t, int16_t>::Larger);
+  RegisterFunction<int16_t, int16_t>(
+      &supported_function_, 771, "int2smaller",
+      &PGCompareFuncGenerator<int16_t, int16_t, int16_t>::Smaller);
+  RegisterFunction<int32_t, int32_t>(
+      &supported_function_, 768, "int4larger",
+      &PGCompareFuncGenerator<int32_t, int32_t, int32_t>::Larger);
+  RegisterFunction<int32_t, int32_t>(
+      &supported_function_, 769, "int4smaller",
+      &PGCompareFuncGenerator<int32_t, int32_t, int32_t>::Smaller);
+  RegisterFunction<int64_t, int64_t>(
+      &supported_function_, 1236, "int8larger",
+      &PGCompareFuncGenerator<int64_t, int64_t, int64_t>::Larger);
+  RegisterFunction<int64_t, int64_t>(
+      &supported_function_, 1237, "int8smaller",
+      &PGCompareFuncGenerator<int64_t, int64_t, int64_t>::Smaller);
+  RegisterFunction<float, float>(
+      &supported_function_, 209, "float4larger",
+      &PGCompareFuncGenerator<float, float, float>::Larger);
+  RegisterFunction<float, float>(
+      &supported_function_, 211, "float4smaller",
+      &PGCompareFuncGenerator<float, float, float>::Smaller);
+  RegisterFunction<double, double>(
+      &supported_function_, 223, "float8larger",
+      &PGCompareFuncGenerator<double, double, double>::Larger);
+  RegisterFunction<double, double>(
+      &supported_function_, 224, "float8smaller",
+      &PGCompareFuncGenerator<double, double, double>::Smaller);
+  RegisterFunction<int32_t, int32_t>(
+      &supported_function_, 1138, "date_larger",
+      &PGCompareFuncGenerator<int32_t, int32_t, int32_t>::Larger);
+  RegisterFunction<int32_t, int32_t>(
+      &supported_function_, 1139, "date_smaller",
+      &PGCompareFuncGenerator<int32_t, int32_t, int32_t>::Smaller);
+}
+
+AdvanceAggregatesCodegen::AdvanceAggregatesCodegen(
+    CodegenManager* manager,
+    AdvanceAggregatesFn regular_func_ptr,
+    AdvanceAggregatesFn* ptr_to_regular_func_ptr,
+    AggState *aggstate)
+    : BaseCodegen(manager,
+                  kAdvanceAggregatesPrefix,
+                  regular_func_ptr, ptr_to_regular_func_ptr),
+      aggstate_(aggstate) {
+}
+
+bool AdvanceAggregatesCodegen::InitDependencies() {
+  InitializeSupportedFunction();
+  return true;
+}
+
+bool AdvanceAggregatesCodegen::IsSupported() {
+  if (nullptr == aggstate_ ||
+      aggstate_->numaggs <= 0) {
+    return false;
+  }
+
+  for (int aggno = 0; aggno < aggstate_->numaggs; aggno++) {
+    AggStatePerAgg peraggstate = &aggstate_->peragg[aggno];
+    if (nullptr == peraggstate->aggref) {
+      elog(DEBUG1, "Unsupported percentile function in advance_aggregates.");
+      return false;
+    }
+    if (peraggstate->numSortCols > 0) {
+      elog(DEBUG1, "Unsupported DISTINCT or ORDER BY aggregate.");
+      return false;
+    }
+    int nargs = list_length(peraggstate->aggref->args);
+    if (nargs > 1 ||
+        nargs != peraggstate->numArguments) {
+      elog(DEBUG1, "Unsupported aggregate with %d arguments.", nargs);
+      return false;
+    }
+    if (IsCalledTransFunc(peraggstate->transfn_oid)) {
+      if (1 != nargs) {
+        return false;
+      }
+      continue;
+    }
+    if (!peraggstate->transtypeByVal) {
+      elog(DEBUG1, "Unsupported pass-by-reference transition type.");
+      return false;
+    }
+    if (supported_function_.end() ==
+        supported_function_.find(peraggstate->transfn_oid)) {
+      elog(DEBUG1, "Unsupported transition function with oid %d.",
+           peraggstate->transfn_oid);
+      return false;
+    }
+    // A strict transition function takes the first input as its initial
+    // value, which needs an input; count(*) always has an initial value.
+    if (peraggstate->transfn.fn_strict) {
+      if (0 == nargs && peraggstate->initValueIsNull) {
+        return false;
+      }
+    } else if (!IsIntSumTransFunc(peraggstate->transfn_oid) ||
+               1 != nargs) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AdvanceAggregatesCodegen::GenerateAdvanceTransitionFunction(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    int aggno,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value* llvm_pergroupstate,
+    llvm::Value* llvm_arg,
+    llvm::Value* llvm_arg_isnull,
+    llvm::BasicBlock* llvm_next_block) {
+  AggStatePerAgg peraggstate = &aggstate_->peragg[aggno];
+  auto irb = codegen_utils->ir_builder();
+  llvm::Function* llvm_main_func = pg_func_info.llvm_main_func;
+
+  PGFuncGeneratorInterface* pg_func_interface =
+      supported_function_[peraggstate->transfn_oid].get();
+  assert(nullptr != pg_func_interface);
+
+  llvm::Value* llvm_trans_value_ptr = codegen_utils->GetPointerToMember(
+      llvm_pergroupstate, &AggStatePerGroupData::transValue);
+  llvm::Value* llvm_trans_value_isnull_ptr = codegen_utils->GetPointerToMember(
+      llvm_pergroupstate, &AggStatePerGroupData::transValueIsNull);
+  llvm::Value* llvm_no_trans_value_ptr = codegen_utils->GetPointerToMember(
+      llvm_pergroupstate, &AggStatePerGroupData::noTransValue);
+
+  llvm::BasicBlock* llvm_advance_block = codegen_utils->CreateBasicBlock(
+      "advance_transition_block", llvm_main_func);
+
+  // Both strict and non-strict (int2_sum/int4_sum) functions keep the prior
+  // transValue when the input is NULL.
+  if (nullptr != llvm_arg_isnull) {
+    llvm::BasicBlock* llvm_arg_not_null_block =
+        codegen_utils->CreateBasicBlock("arg_not_null_block", llvm_main_func);
+    irb->CreateCondBr(llvm_arg_isnull,
+                      llvm_next_block,
+                      llvm_arg_not_null_block);
+    irb->SetInsertPoint(llvm_arg_not_null_block);
+  }
+
+  llvm::Value* llvm_trans_value = nullptr;
+  if (peraggstate->transfn.fn_strict) {
+    llvm::BasicBlock* llvm_check_null_block = codegen_utils->CreateBasicBlock(
+        "check_trans_value_null_block", llvm_main_func);
+
+    // count(*) has no input, and IsSupported() made sure it has an initial
+    // value.
+    if (nullptr != llvm_arg) {
+      llvm::BasicBlock* llvm_init_block = codegen_utils->CreateBasicBlock(
+          "init_trans_value_block", llvm_main_func);
+      irb->CreateCondBr(irb->CreateLoad(llvm_no_trans_value_ptr),
+                        llvm_init_block,
+                        llvm_check_null_block);
+
+      // This is the first non-NULL input and there is no initial value: use
+      // the input as transValue. The input type is binary-compatible with the
+      // transition type.
+      irb->SetInsertPoint(llvm_init_block);
+      irb->CreateStore(llvm_arg, llvm_trans_value_ptr);
+      irb->CreateStore(codegen_utils->GetConstant<bool>(false),
+                       llvm_trans_value_isnull_ptr);
+      irb->CreateStore(codegen_utils->GetConstant<bool>(false),
+                       llvm_no_trans_value_ptr);
+      irb->CreateBr(llvm_next_block);
+    } else {
+      irb->CreateBr(llvm_check_null_block);
+    }
+
+    // The function returned NULL on a prior cycle: keep the NULL.
+    irb->SetInsertPoint(llvm_check_null_block);
+    irb->CreateCondBr(irb->CreateLoad(llvm_trans_value_isnull_ptr),
+                      llvm_next_block,
+                      llvm_advance_block);
+
+    irb->SetInsertPoint(llvm_advance_block);
+    llvm_trans_value = irb->CreateLoad(llvm_trans_value_ptr);
+  } else {
+    // int2_sum/int4_sum: a NULL transValue means no input was seen yet, so
+    // the sum starts from zero.
+    assert(IsIntSumTransFunc(peraggstate->transfn_oid));
+    irb->CreateBr(llvm_advance_block);
+    irb->SetInsertPoint(llvm_advance_block);
+    llvm_trans_value = irb->CreateSelect(
+        irb->CreateLoad(llvm_trans_value_isnull_ptr),
+        codegen_utils->GetConstant<Datum>(0),
+        irb->CreateLoad(llvm_trans_value_ptr));
+  }
+
+  llvm::Value* llvm_input = IsCountTransFunc(peraggstate->transfn_oid) ?
+      codegen_utils->GetConstant<Datum>(1) : llvm_arg;
+  assert(nullptr != llvm_input);
+
+  PGFuncGeneratorInfo pg_trans_func_info(llvm_main_func,
+                                         pg_func_info.llvm_error_block,
+                                         {llvm_trans_value, llvm_input});
+  llvm::Value* llvm_new_value = nullptr;
+  if (!pg_func_interface->GenerateCode(codegen_utils,
+                                       pg_trans_func_info,
+                                       &llvm_new_value) ||
+      nullptr == llvm_new_value) {
+    return false;
+  }
+
+  irb->CreateStore(codegen_utils->CreateCppTypeToDatumCast(llvm_new_value),
+                   llvm_trans_value_ptr);
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false),
+                   llvm_trans_value_isnull_ptr);
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false),
+                   llvm_no_trans_value_ptr);
+  irb->CreateBr(llvm_next_block);
+  return true;
+}
+
+bool AdvanceAggregatesCodegen::GenerateAdvanceAggregates(
+    gpcodegen::GpCodegenUtils* codegen_utils) {
+  assert(nullptr != codegen_utils);
+  static_assert(sizeof(Datum) == sizeof(int64_t),
+      "sizeof(Datum) doesn't match sizeof(int64)");
+
+  if (!IsSupported()) {
+    return false;
+  }
+
+  llvm::Function* advance_aggregates_func = CreateFunction<AdvanceAggregatesFn>(
+      codegen_utils, GetUniqueFuncName());
+
+  // Function arguments to advance_aggregates
+  llvm::Value* llvm_pergroup_arg = ArgumentByPosition(advance_aggregates_func,
+                                                      1);
+
+  // BasicBlock of function entry.
+  llvm::BasicBlock* llvm_entry_block = codegen_utils->CreateBasicBlock(
+      "entry", advance_aggregates_func);
+  llvm::BasicBlock* llvm_error_block = codegen_utils->CreateBasicBlock(
+      "error_block", advance_aggregates_func);
+
+  llvm::Function* llvm_exec_project =
+      codegen_utils->GetOrRegisterExternalFunction(ExecProject, "ExecProject");
+  llvm::Function* llvm_advance_aggregate_value =
+      codegen_utils->GetOrRegisterExternalFunction(advance_aggregate_value,
+                                                   "advance_aggregate_value");
+
+  auto irb = codegen_utils->ir_builder();
+
+  irb->SetInsertPoint(llvm_entry_block);
+
+#ifdef CODEGEN_DEBUG
+  codegen_utils->CreateElog(
+      DEBUG1,
+      "Codegen'ed advance_aggregates called!");
+#endif
+
+  PGFuncGeneratorInfo pg_func_info(advance_aggregates_func,
+                                   llvm_error_block,
+                                   {});
+
+  for (int aggno = 0; aggno < aggstate_->numaggs; aggno++) {
+    AggStatePerAgg peraggstate = &aggstate_->peragg[aggno];
+
+    // pergroupstate = &pergroup[aggno];
+    llvm::Value* llvm_pergroupstate = irb->CreateInBoundsGEP(
+        llvm_pergroup_arg,
+        {codegen_utils->GetConstant<int64_t>(
+            aggno * sizeof(AggStatePerGroupData))});
+
+    // Evaluate the current input expressions for this aggregate. ExecProject
+    // stores a virtual tuple, so all the attributes are already valid.
+    llvm::Value* llvm_arg = nullptr;
+    llvm::Value* llvm_arg_isnull = nullptr;
+    if (list_length(peraggstate->aggref->args) > 0) {
+      llvm::Value* llvm_slot = irb->CreateCall(llvm_exec_project, {
+          codegen_utils->GetConstant(peraggstate->evalproj),
+          codegen_utils->GetConstant<ExprDoneCond*>(nullptr)});
+      llvm::Value* llvm_slot_PRIVATE_tts_values /* Datum* */ =
+          irb->CreateLoad(codegen_utils->GetPointerToMember(
+              llvm_slot, &TupleTableSlot::PRIVATE_tts_values));
+      llvm::Value* llvm_slot_PRIVATE_tts_isnull /* bool* */ =
+          irb->CreateLoad(codegen_utils->GetPointerToMember(
+              llvm_slot, &TupleTableSlot::PRIVATE_tts_isnull));
+      llvm_arg = irb->CreateLoad(llvm_slot_PRIVATE_tts_values);
+      llvm_arg_isnull = irb->CreateLoad(llvm_slot_PRIVATE_tts_isnull);
+    }
+
+    if (IsCalledTransFunc(peraggstate->transfn_oid)) {
+      assert(nullptr != llvm_arg);
+      irb->CreateCall(llvm_advance_aggregate_value, {
+          ArgumentByPosition(advance_aggregates_func, 0),
+          codegen_utils->GetConstant<int32_t>(aggno),
+          llvm_pergroupstate,
+          llvm_arg,
+          llvm_arg_isnull,
+          ArgumentByPosition(advance_aggregates_func, 2)});
+      continue;
+    }
+
+    llvm::BasicBlock* llvm_next_block = codegen_utils->CreateBasicBlock(
+        "advance_aggregate_done_block", advance_aggregates_func);
+    if (!GenerateAdvanceTransitionFunction(codegen_utils,
+                                           aggno,
+                                           pg_func_info,
+                                           llvm_pergroupstate,
+                                           llvm_arg,
+                                           llvm_arg_isnull,
+                                           llvm_next_block)) {
+      return false;
+    }
+    irb->SetInsertPoint(llvm_next_block);
+  }
+  irb->CreateRetVoid();
+
+  irb->SetInsertPoint(llvm_error_block);
+  irb->CreateRetVoid();
+  return true;
+}
+
+bool AdvanceAggregatesCodegen::GenerateCodeInternal(
+    GpCodegenUtils* codegen_utils) {
+  bool isGenerated = GenerateAdvanceAggregates(codegen_utils);
+
+  if (isGenerated) {
+    elog(DEBUG1, "advance_aggregates was generated successfully!");
+    return true;
+  } else {
+    elog(DEBUG1, "advance_aggregates generation failed!");
+    return false;
+  }
+}
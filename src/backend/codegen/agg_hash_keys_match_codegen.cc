@@ -0,0 +1,202 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    agg_hash_keys_match_codegen.cc
+//
+//  @doc:
+//    Generates code for agg_hash_keys_match function.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stddef.h>
+#include <cstdint>
+
+#include "codegen/agg_hash_keys_match_codegen.h"
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/utils/utility.h"
+
+#include "llvm/IR/Argument.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "access/memtup.h"
+#include "executor/tuptable.h"
+#include "nodes/execnodes.h"
+#include "nodes/plannodes.h"
+#include "utils/elog.h"
+}
+
+namespace llvm {
+class BasicBlock;
+class Function;
+class Value;
+}  // namespace llvm
+
+using gpcodegen::AggHashKeysMatchCodegen;
+using gpcodegen::GpCodegenUtils;
+
+constexpr char AggHashKeysMatchCodegen::kAggHashKeysMatchPrefix[];
+
+namespace {
+
+// pg_proc oids of the equality functions we inline. See pg_proc.h.
+constexpr Oid kInt2EqOid = 63;
+constexpr Oid kInt4EqOid = 65;
+constexpr Oid kInt8EqOid = 467;
+constexpr Oid kOidEqOid = 184;
+constexpr Oid kDateEqOid = 1086;
+
+bool IsSupportedEqFunc(Oid eqfn_oid) {
+  return kInt2EqOid == eqfn_oid ||
+      kInt4EqOid == eqfn_oid ||
+      kInt8EqOid == eqfn_oid ||
+      kOidEqOid == eqfn_oid ||
+      kDateEqOid == eqfn_oid;
+}
+
+}  // namespace
+
+AggHashKeysMatchCodegen::AggHashKeysMatchCodegen(
+    CodegenManager* manager,
+    AggHashKeysMatchFn regular_func_ptr,
+    AggHashKeysMatchFn* ptr_to_regular_func_ptr,
+    AggState *aggstate)
+    : BaseCodegen(manager,
+                  kAggHashKeysMatchPrefix,
+                  regular_func_ptr, ptr_to_regular_func_ptr),
+      aggstate_(aggstate) {
+}
+
+bool AggHashKeysMatchCodegen::GenerateAggHashKeysMatch(
+    gpcodegen::GpCodegenUtils* codegen_utils) {
+  assert(nullptr != codegen_utils);
+
+  if (nullptr == aggstate_ ||
+      nullptr == aggstate_->eqfunctions) {
+    return false;
+  }
+  Agg* agg = reinterpret_cast<Agg*>(aggstate_->ss.ps.plan);
+  if (agg->numCols <= 0) {
+    return false;
+  }
+  for (int i = 0; i < agg->numCols; i++) {
+    if (!IsSupportedEqFunc(aggstate_->eqfunctions[i].fn_oid)) {
+      elog(DEBUG1, "Unsupported equality function with oid %d.",
+           aggstate_->eqfunctions[i].fn_oid);
+      return false;
+    }
+  }
+
+  llvm::Function* keys_match_func = CreateFunction<AggHashKeysMatchFn>(
+      codegen_utils, GetUniqueFuncName());
+
+  // Function arguments to agg_hash_keys_match
+  llvm::Value* llvm_aggstate_arg = ArgumentByPosition(keys_match_func, 0);
+  llvm::Value* llvm_inputslot_arg = ArgumentByPosition(keys_match_func, 1);
+  llvm::Value* llvm_entry_tuple_arg = ArgumentByPosition(keys_match_func, 2);
+
+  llvm::BasicBlock* llvm_entry_block = codegen_utils->CreateBasicBlock(
+      "entry", keys_match_func);
+  llvm::BasicBlock* llvm_mismatch_block = codegen_utils->CreateBasicBlock(
+      "mismatch_block", keys_match_func);
+
+  llvm::Function* llvm_slot_getattr =
+      codegen_utils->GetOrRegisterExternalFunction(slot_getattr,
+                                                   "slot_getattr");
+  llvm::Function* llvm_memtuple_getattr =
+      codegen_utils->GetOrRegisterExternalFunction(memtuple_getattr,
+                                                   "memtuple_getattr");
+
+  auto irb = codegen_utils->ir_builder();
+
+  irb->SetInsertPoint(llvm_entry_block);
+
+#ifdef CODEGEN_DEBUG
+  codegen_utils->CreateElog(
+      DEBUG1,
+      "Codegen'ed agg_hash_keys_match called!");
+#endif
+
+  // mt_bind = aggstate->hashslot->tts_mt_bind;
+  llvm::Value* llvm_hashslot = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(llvm_aggstate_arg,
+                                        &AggState::hashslot));
+  llvm::Value* llvm_mt_bind = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(llvm_hashslot,
+                                        &TupleTableSlot::tts_mt_bind));
+
+  llvm::Value* llvm_input_isnull_ptr =
+      irb->CreateAlloca(codegen_utils->GetType<bool>());
+  llvm::Value* llvm_entry_isnull_ptr =
+      irb->CreateAlloca(codegen_utils->GetType<bool>());
+
+  for (int i = 0; i < agg->numCols; i++) {
+    Oid eqfn_oid = aggstate_->eqfunctions[i].fn_oid;
+    llvm::Value* llvm_att =
+        codegen_utils->GetConstant<int32_t>(agg->grpColIdx[i]);
+
+    llvm::Value* llvm_input_datum = irb->CreateCall(llvm_slot_getattr, {
+        llvm_inputslot_arg, llvm_att, llvm_input_isnull_ptr});
+    llvm::Value* llvm_entry_datum = irb->CreateCall(llvm_memtuple_getattr, {
+        llvm_entry_tuple_arg, llvm_mt_bind, llvm_att, llvm_entry_isnull_ptr});
+    llvm::Value* llvm_input_isnull = irb->CreateLoad(llvm_input_isnull_ptr);
+    llvm::Value* llvm_entry_isnull = irb->CreateLoad(llvm_entry_isnull_ptr);
+
+    llvm::Value* llvm_equal = nullptr;
+    switch (eqfn_oid) {
+      case kInt2EqOid:
+        llvm_equal = irb->CreateICmpEQ(
+            codegen_utils->CreateDatumToCppTypeCast<int16_t>(llvm_input_datum),
+            codegen_utils->CreateDatumToCppTypeCast<int16_t>(
+                llvm_entry_datum));
+        break;
+      case kInt8EqOid:
+        llvm_equal = irb->CreateICmpEQ(llvm_input_datum, llvm_entry_datum);
+        break;
+      default:
+        assert(kInt4EqOid == eqfn_oid ||
+               kOidEqOid == eqfn_oid ||
+               kDateEqOid == eqfn_oid);
+        llvm_equal = irb->CreateICmpEQ(
+            codegen_utils->CreateDatumToCppTypeCast<int32_t>(llvm_input_datum),
+            codegen_utils->CreateDatumToCppTypeCast<int32_t>(
+                llvm_entry_datum));
+        break;
+    }
+
+    // Both non-NULL and equal, or both NULL: NULLs match in group keys.
+    llvm::Value* llvm_match = irb->CreateSelect(
+        irb->CreateOr(llvm_input_isnull, llvm_entry_isnull),
+        irb->CreateAnd(llvm_input_isnull, llvm_entry_isnull),
+        llvm_equal);
+
+    llvm::BasicBlock* llvm_next_block = codegen_utils->CreateBasicBlock(
+        "key_match_block", keys_match_func);
+    irb->CreateCondBr(llvm_match, llvm_next_block, llvm_mismatch_block);
+    irb->SetInsertPoint(llvm_next_block);
+  }
+  irb->CreateRet(codegen_utils->GetConstant<bool>(true));
+
+  irb->SetInsertPoint(llvm_mismatch_block);
+  irb->CreateRet(codegen_utils->GetConstant<bool>(false));
+  return true;
+}
+
+bool AggHashKeysMatchCodegen::GenerateCodeInternal(
+    GpCodegenUtils* codegen_utils) {
+  bool isGenerated = GenerateAggHashKeysMatch(codegen_utils);
+
+  if (isGenerated) {
+    elog(DEBUG1, "agg_hash_keys_match was generated successfully!");
+    return true;
+  } else {
+    elog(DEBUG1, "agg_hash_keys_match generation failed!");
+    return false;
+  }
+}
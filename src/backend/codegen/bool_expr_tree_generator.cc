@@ -0,0 +1,187 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    bool_expr_tree_generator.cc
+//
+//  @doc:
+//    Object that generate code for boolean expression.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "codegen/bool_expr_tree_generator.h"
+#include "codegen/expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "utils/elog.h"
+#include "nodes/nodes.h"
+#include "nodes/pg_list.h"
+#include "nodes/primnodes.h"
+}
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+using gpcodegen::BoolExprTreeGenerator;
+using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
+
+bool BoolExprTreeGenerator::VerifyAndCreateExprTree(
+    const ExprState* expr_state,
+    ExprTreeGeneratorInfo* gen_info,
+    std::unique_ptr<ExprTreeGenerator>* expr_tree) {
+  assert(nullptr != expr_state &&
+         nullptr != expr_state->expr &&
+         T_BoolExpr == nodeTag(expr_state->expr) &&
+         nullptr != expr_tree);
+
+  expr_tree->reset(nullptr);
+  List *arguments = reinterpret_cast<const BoolExprState*>(expr_state)->args;
+  assert(nullptr != arguments);
+
+  ListCell   *arg = nullptr;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> expr_tree_arguments;
+  foreach(arg, arguments) {
+    // retrieve argument's ExprState
+    ExprState  *argstate = reinterpret_cast<ExprState*>(lfirst(arg));
+    assert(nullptr != argstate);
+    std::unique_ptr<ExprTreeGenerator> arg(nullptr);
+    if (!ExprTreeGenerator::VerifyAndCreateExprTree(argstate,
+                                                    gen_info,
+                                                    &arg)) {
+      return false;
+    }
+    assert(nullptr != arg);
+    expr_tree_arguments.push_back(std::move(arg));
+  }
+  expr_tree->reset(new BoolExprTreeGenerator(expr_state,
+                                             std::move(expr_tree_arguments)));
+  return true;
+}
+
+BoolExprTreeGenerator::BoolExprTreeGenerator(
+    const ExprState* expr_state,
+    std::vector<
+        std::unique_ptr<ExprTreeGenerator>>&& arguments)  // NOLINT(build/c++11)
+    :  ExprTreeGenerator(expr_state, ExprTreeNodeType::kBool),
+       arguments_(std::move(arguments)) {
+}
+
+bool BoolExprTreeGenerator::GenerateCode(GpCodegenUtils* codegen_utils,
+                                         const ExprTreeGeneratorInfo& gen_info,
+                                         llvm::Value* llvm_isnull_ptr,
+                                         llvm::Value** llvm_out_value) {
+  assert(nullptr != llvm_out_value);
+  *llvm_out_value = nullptr;
+  BoolExpr* bool_expr = reinterpret_cast<BoolExpr*>(expr_state()->expr);
+
+  switch (bool_expr->boolop) {
+    case AND_EXPR:
+      return GenerateAndOr(codegen_utils, gen_info, false,
+                           llvm_isnull_ptr, llvm_out_value);
+    case OR_EXPR:
+      return GenerateAndOr(codegen_utils, gen_info, true,
+                           llvm_isnull_ptr, llvm_out_value);
+    case NOT_EXPR: {
+      // NOT NULL is NULL, so the argument's null flag is ours as well.
+      if (1 != arguments_.size()) {
+        return false;
+      }
+      llvm::Value* llvm_arg = nullptr;
+      llvm::Value* llvm_arg_isnull = nullptr;
+      if (!GenerateArgumentCode(codegen_utils,
+                                gen_info,
+                                arguments_[0].get(),
+                                &llvm_arg,
+                                &llvm_arg_isnull)) {
+        return false;
+      }
+      auto irb = codegen_utils->ir_builder();
+      irb->CreateStore(llvm_arg_isnull, llvm_isnull_ptr);
+      llvm::Value* llvm_not = irb->CreateICmpEQ(
+          llvm_arg, codegen_utils->GetConstant<Datum>(0));
+      *llvm_out_value = codegen_utils->CreateCppTypeToDatumCast(llvm_not);
+      return true;
+    }
+    default:
+      elog(WARNING, "Unsupported boolean expression type %d.",
+           bool_expr->boolop);
+      return false;
+  }
+}
+
+bool BoolExprTreeGenerator::GenerateAndOr(
+    GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    bool short_circuit_value,
+    llvm::Value* llvm_isnull_ptr,
+    llvm::Value** llvm_out_value) {
+  auto irb = codegen_utils->ir_builder();
+
+  llvm::BasicBlock* llvm_short_circuit_block = codegen_utils->CreateBasicBlock(
+      "bool_expr_short_circuit_block", gen_info.llvm_main_func);
+  llvm::BasicBlock* llvm_merge_block = codegen_utils->CreateBasicBlock(
+      "bool_expr_merge_block", gen_info.llvm_main_func);
+
+  // Each argument that does not decide the result branches to the block that
+  // evaluates the next one, so later arguments are evaluated only when needed
+  // (e.g. "x <> 0 AND 10 / x > 1" must not divide by zero).
+  llvm::Value* llvm_any_arg_isnull = codegen_utils->GetConstant<bool>(false);
+  for (auto& arg : arguments_) {
+    llvm::Value* llvm_arg = nullptr;
+    llvm::Value* llvm_arg_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils,
+                              gen_info,
+                              arg.get(),
+                              &llvm_arg,
+                              &llvm_arg_isnull)) {
+      return false;
+    }
+    llvm::Value* llvm_arg_value = irb->CreateICmpNE(
+        llvm_arg, codegen_utils->GetConstant<Datum>(0));
+    if (!short_circuit_value) {
+      llvm_arg_value = irb->CreateNot(llvm_arg_value);
+    }
+    llvm::Value* llvm_decides = irb->CreateAnd(irb->CreateNot(llvm_arg_isnull),
+                                               llvm_arg_value);
+    llvm_any_arg_isnull = irb->CreateOr(llvm_any_arg_isnull, llvm_arg_isnull);
+
+    llvm::BasicBlock* llvm_next_block = codegen_utils->CreateBasicBlock(
+        "bool_expr_next_arg_block", gen_info.llvm_main_func);
+    irb->CreateCondBr(llvm_decides, llvm_short_circuit_block, llvm_next_block);
+    irb->SetInsertPoint(llvm_next_block);
+  }
+
+  // No argument decided the result: it is !short_circuit_value, or NULL if
+  // any of the arguments was NULL.
+  irb->CreateStore(llvm_any_arg_isnull, llvm_isnull_ptr);
+  llvm::BasicBlock* llvm_all_args_block = irb->GetInsertBlock();
+  irb->CreateBr(llvm_merge_block);
+
+  irb->SetInsertPoint(llvm_short_circuit_block);
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+  irb->CreateBr(llvm_merge_block);
+
+  irb->SetInsertPoint(llvm_merge_block);
+  llvm::PHINode* llvm_result = irb->CreatePHI(
+      codegen_utils->GetType<bool>(), 2);
+  llvm_result->addIncoming(
+      codegen_utils->GetConstant<bool>(!short_circuit_value),
+      llvm_all_args_block);
+  llvm_result->addIncoming(
+      codegen_utils->GetConstant<bool>(short_circuit_value),
+      llvm_short_circuit_block);
+  *llvm_out_value = codegen_utils->CreateCppTypeToDatumCast(llvm_result);
+  return true;
+}
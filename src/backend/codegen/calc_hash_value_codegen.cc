@@ -0,0 +1,207 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    calc_hash_value_codegen.cc
+//
+//  @doc:
+//    Generates code for calc_hash_value function.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stddef.h>
+#include <cstdint>
+
+#include "codegen/base_codegen.h"
+#include "codegen/calc_hash_value_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/utils/utility.h"
+
+#include "llvm/IR/Argument.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "access/hash.h"
+#include "executor/tuptable.h"
+#include "nodes/execnodes.h"
+#include "nodes/plannodes.h"
+#include "utils/elog.h"
+}
+
+namespace llvm {
+class BasicBlock;
+class Function;
+class Value;
+}  // namespace llvm
+
+using gpcodegen::CalcHashValueCodegen;
+using gpcodegen::GpCodegenUtils;
+
+constexpr char CalcHashValueCodegen::kCalcHashValuePrefix[];
+
+namespace {
+
+// pg_proc oids of the hash functions we inline. See pg_proc.h.
+constexpr Oid kHashInt2Oid = 449;
+constexpr Oid kHashInt4Oid = 450;
+constexpr Oid kHashInt8Oid = 949;
+constexpr Oid kHashOidOid = 453;
+
+// calc_hash_value() uses this as the hash key of a NULL value.
+constexpr uint32_t kNullHashKey = 0xdeadbeef;
+
+bool IsSupportedHashFunc(Oid hashfn_oid) {
+  return kHashInt2Oid == hashfn_oid ||
+      kHashInt4Oid == hashfn_oid ||
+      kHashInt8Oid == hashfn_oid ||
+      kHashOidOid == hashfn_oid;
+}
+
+}  // namespace
+
+CalcHashValueCodegen::CalcHashValueCodegen(
+    CodegenManager* manager,
+    CalcHashValueFn regular_func_ptr,
+    CalcHashValueFn* ptr_to_regular_func_ptr,
+    AggState *aggstate)
+    : BaseCodegen(manager,
+                  kCalcHashValuePrefix,
+                  regular_func_ptr, ptr_to_regular_func_ptr),
+      aggstate_(aggstate) {
+}
+
+bool CalcHashValueCodegen::GenerateCalcHashValue(
+    gpcodegen::GpCodegenUtils* codegen_utils) {
+  assert(nullptr != codegen_utils);
+
+  if (nullptr == aggstate_ ||
+      nullptr == aggstate_->hashfunctions) {
+    return false;
+  }
+  Agg* agg = reinterpret_cast<Agg*>(aggstate_->ss.ps.plan);
+  if (agg->numCols <= 0) {
+    return false;
+  }
+  for (int i = 0; i < agg->numCols; i++) {
+    if (!IsSupportedHashFunc(aggstate_->hashfunctions[i].fn_oid)) {
+      elog(DEBUG1, "Unsupported hash function with oid %d.",
+           aggstate_->hashfunctions[i].fn_oid);
+      return false;
+    }
+  }
+
+  llvm::Function* calc_hash_value_func = CreateFunction<CalcHashValueFn>(
+      codegen_utils, GetUniqueFuncName());
+
+  // Function arguments to calc_hash_value
+  llvm::Value* llvm_inputslot_arg = ArgumentByPosition(calc_hash_value_func,
+                                                       1);
+
+  llvm::BasicBlock* llvm_entry_block = codegen_utils->CreateBasicBlock(
+      "entry", calc_hash_value_func);
+
+  llvm::Function* llvm_slot_getattr =
+      codegen_utils->GetOrRegisterExternalFunction(slot_getattr,
+                                                   "slot_getattr");
+  llvm::Function* llvm_hash_uint32 =
+      codegen_utils->GetOrRegisterExternalFunction(hash_uint32,
+                                                   "hash_uint32");
+  llvm::Function* llvm_hash_any =
+      codegen_utils->GetOrRegisterExternalFunction(hash_any, "hash_any");
+
+  auto irb = codegen_utils->ir_builder();
+
+  irb->SetInsertPoint(llvm_entry_block);
+
+#ifdef CODEGEN_DEBUG
+  codegen_utils->CreateElog(
+      DEBUG1,
+      "Codegen'ed calc_hash_value called!");
+#endif
+
+  // The per-key hash values are hashed together, like hashtable->hashkey_buf
+  // in calc_hash_value().
+  llvm::Value* llvm_hashkeys = irb->CreateAlloca(
+      codegen_utils->GetType<uint32_t>(),
+      codegen_utils->GetConstant<int32_t>(agg->numCols));
+  llvm::Value* llvm_isnull_ptr =
+      irb->CreateAlloca(codegen_utils->GetType<bool>());
+
+  for (int i = 0; i < agg->numCols; i++) {
+    Oid hashfn_oid = aggstate_->hashfunctions[i].fn_oid;
+
+    llvm::Value* llvm_value = irb->CreateCall(llvm_slot_getattr, {
+        llvm_inputslot_arg,
+        codegen_utils->GetConstant<int32_t>(agg->grpColIdx[i]),
+        llvm_isnull_ptr});
+
+    // Same as the argument hashint2(), hashint4(), hashint8() or hashoid()
+    // passes to hash_uint32().
+    llvm::Value* llvm_key = nullptr;
+    switch (hashfn_oid) {
+      case kHashInt2Oid:
+        llvm_key = irb->CreateSExt(
+            codegen_utils->CreateDatumToCppTypeCast<int16_t>(llvm_value),
+            codegen_utils->GetType<uint32_t>());
+        break;
+      case kHashInt8Oid: {
+        // lohalf ^= (val >= 0) ? hihalf : ~hihalf;
+        llvm::Value* llvm_lohalf =
+            codegen_utils->CreateDatumToCppTypeCast<uint32_t>(llvm_value);
+        llvm::Value* llvm_hihalf =
+            codegen_utils->CreateDatumToCppTypeCast<uint32_t>(
+                irb->CreateAShr(llvm_value, 32));
+        llvm::Value* llvm_is_nonnegative = irb->CreateICmpSGE(
+            llvm_value, codegen_utils->GetConstant<int64_t>(0));
+        llvm_key = irb->CreateXor(
+            llvm_lohalf,
+            irb->CreateSelect(llvm_is_nonnegative,
+                              llvm_hihalf,
+                              irb->CreateNot(llvm_hihalf)));
+        break;
+      }
+      default:
+        assert(kHashInt4Oid == hashfn_oid || kHashOidOid == hashfn_oid);
+        llvm_key =
+            codegen_utils->CreateDatumToCppTypeCast<uint32_t>(llvm_value);
+        break;
+    }
+
+    llvm::Value* llvm_hashkey =
+        codegen_utils->CreateDatumToCppTypeCast<uint32_t>(
+            irb->CreateCall(llvm_hash_uint32, {llvm_key}));
+
+    // NULLs have hash key 0xdeadbeef
+    irb->CreateStore(
+        irb->CreateSelect(irb->CreateLoad(llvm_isnull_ptr),
+                          codegen_utils->GetConstant<uint32_t>(kNullHashKey),
+                          llvm_hashkey),
+        irb->CreateInBoundsGEP(llvm_hashkeys,
+                               {codegen_utils->GetConstant<int32_t>(i)}));
+  }
+
+  llvm::Value* llvm_hash = irb->CreateCall(llvm_hash_any, {
+      irb->CreateBitCast(llvm_hashkeys,
+                         codegen_utils->GetType<const unsigned char*>()),
+      codegen_utils->GetConstant<int32_t>(agg->numCols * sizeof(uint32_t))});
+  irb->CreateRet(
+      codegen_utils->CreateDatumToCppTypeCast<uint32_t>(llvm_hash));
+  return true;
+}
+
+bool CalcHashValueCodegen::GenerateCodeInternal(
+    GpCodegenUtils* codegen_utils) {
+  bool isGenerated = GenerateCalcHashValue(codegen_utils);
+
+  if (isGenerated) {
+    elog(DEBUG1, "calc_hash_value was generated successfully!");
+    return true;
+  } else {
+    elog(DEBUG1, "calc_hash_value generation failed!");
+    return false;
+  }
+}
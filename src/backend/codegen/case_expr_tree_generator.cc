@@ -0,0 +1,198 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    case_expr_tree_generator.cc
+//
+//  @doc:
+//    Object that generate code for CASE expression.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "codegen/case_expr_tree_generator.h"
+#include "codegen/expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "utils/elog.h"
+#include "nodes/nodes.h"
+#include "nodes/pg_list.h"
+#include "nodes/primnodes.h"
+}
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+using gpcodegen::CaseExprTreeGenerator;
+using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
+
+bool CaseExprTreeGenerator::VerifyAndCreateExprTree(
+    const ExprState* expr_state,
+    ExprTreeGeneratorInfo* gen_info,
+    std::unique_ptr<ExprTreeGenerator>* expr_tree) {
+  assert(nullptr != expr_state &&
+         nullptr != expr_state->expr &&
+         T_CaseExpr == nodeTag(expr_state->expr) &&
+         nullptr != expr_tree);
+
+  expr_tree->reset(nullptr);
+  const CaseExprState* case_state =
+      reinterpret_cast<const CaseExprState*>(expr_state);
+  // "CASE arg WHEN ..." compares through a CaseTestExpr placeholder that
+  // ExecEvalCase() fills in at run time; only searched CASE is supported.
+  if (nullptr != case_state->arg) {
+    elog(DEBUG1, "Unsupported CASE expression with a test value.");
+    return false;
+  }
+
+  std::vector<std::unique_ptr<ExprTreeGenerator>> conditions;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> results;
+  ListCell   *cell = nullptr;
+  foreach(cell, case_state->args) {
+    CaseWhenState *when_state = reinterpret_cast<CaseWhenState*>(lfirst(cell));
+    assert(nullptr != when_state &&
+           nullptr != when_state->expr &&
+           nullptr != when_state->result);
+    std::unique_ptr<ExprTreeGenerator> condition(nullptr);
+    std::unique_ptr<ExprTreeGenerator> result(nullptr);
+    if (!ExprTreeGenerator::VerifyAndCreateExprTree(when_state->expr,
+                                                    gen_info,
+                                                    &condition) ||
+        !ExprTreeGenerator::VerifyAndCreateExprTree(when_state->result,
+                                                    gen_info,
+                                                    &result)) {
+      return false;
+    }
+    conditions.push_back(std::move(condition));
+    results.push_back(std::move(result));
+  }
+
+  std::unique_ptr<ExprTreeGenerator> default_result(nullptr);
+  if (nullptr != case_state->defresult &&
+      !ExprTreeGenerator::VerifyAndCreateExprTree(case_state->defresult,
+                                                  gen_info,
+                                                  &default_result)) {
+    return false;
+  }
+
+  expr_tree->reset(new CaseExprTreeGenerator(expr_state,
+                                             std::move(conditions),
+                                             std::move(results),
+                                             std::move(default_result)));
+  return true;
+}
+
+CaseExprTreeGenerator::CaseExprTreeGenerator(
+    const ExprState* expr_state,
+    std::vector<
+        std::unique_ptr<ExprTreeGenerator>>&& conditions,  // NOLINT
+    std::vector<
+        std::unique_ptr<ExprTreeGenerator>>&& results,  // NOLINT
+    std::unique_ptr<ExprTreeGenerator>&& default_result)  // NOLINT
+    :  ExprTreeGenerator(expr_state, ExprTreeNodeType::kCase),
+       conditions_(std::move(conditions)),
+       results_(std::move(results)),
+       default_result_(std::move(default_result)) {
+  assert(conditions_.size() == results_.size());
+}
+
+bool CaseExprTreeGenerator::GenerateCode(GpCodegenUtils* codegen_utils,
+                                         const ExprTreeGeneratorInfo& gen_info,
+                                         llvm::Value* llvm_isnull_ptr,
+                                         llvm::Value** llvm_out_value) {
+  assert(nullptr != llvm_out_value);
+  *llvm_out_value = nullptr;
+  auto irb = codegen_utils->ir_builder();
+
+  llvm::BasicBlock* llvm_merge_block = codegen_utils->CreateBasicBlock(
+      "case_merge_block", gen_info.llvm_main_func);
+
+  // (value, isnull, block) of every branch that reaches the merge block
+  std::vector<llvm::Value*> llvm_values;
+  std::vector<llvm::Value*> llvm_isnulls;
+  std::vector<llvm::BasicBlock*> llvm_blocks;
+
+  // Like ExecEvalCase(), a WHEN clause is taken only if its condition is
+  // true and not NULL; the conditions are tested in order.
+  for (size_t i = 0; i < conditions_.size(); ++i) {
+    llvm::Value* llvm_cond = nullptr;
+    llvm::Value* llvm_cond_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils,
+                              gen_info,
+                              conditions_[i].get(),
+                              &llvm_cond,
+                              &llvm_cond_isnull)) {
+      return false;
+    }
+    llvm::Value* llvm_taken = irb->CreateAnd(
+        irb->CreateNot(llvm_cond_isnull),
+        irb->CreateICmpNE(llvm_cond, codegen_utils->GetConstant<Datum>(0)));
+
+    llvm::BasicBlock* llvm_then_block = codegen_utils->CreateBasicBlock(
+        "case_then_block", gen_info.llvm_main_func);
+    llvm::BasicBlock* llvm_next_block = codegen_utils->CreateBasicBlock(
+        "case_next_when_block", gen_info.llvm_main_func);
+    irb->CreateCondBr(llvm_taken, llvm_then_block, llvm_next_block);
+
+    irb->SetInsertPoint(llvm_then_block);
+    llvm::Value* llvm_result = nullptr;
+    llvm::Value* llvm_result_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils,
+                              gen_info,
+                              results_[i].get(),
+                              &llvm_result,
+                              &llvm_result_isnull)) {
+      return false;
+    }
+    llvm_values.push_back(llvm_result);
+    llvm_isnulls.push_back(llvm_result_isnull);
+    llvm_blocks.push_back(irb->GetInsertBlock());
+    irb->CreateBr(llvm_merge_block);
+
+    irb->SetInsertPoint(llvm_next_block);
+  }
+
+  // ELSE clause; without one the result is NULL.
+  if (nullptr != default_result_) {
+    llvm::Value* llvm_result = nullptr;
+    llvm::Value* llvm_result_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils,
+                              gen_info,
+                              default_result_.get(),
+                              &llvm_result,
+                              &llvm_result_isnull)) {
+      return false;
+    }
+    llvm_values.push_back(llvm_result);
+    llvm_isnulls.push_back(llvm_result_isnull);
+  } else {
+    llvm_values.push_back(codegen_utils->GetConstant<Datum>(0));
+    llvm_isnulls.push_back(codegen_utils->GetConstant<bool>(true));
+  }
+  llvm_blocks.push_back(irb->GetInsertBlock());
+  irb->CreateBr(llvm_merge_block);
+
+  irb->SetInsertPoint(llvm_merge_block);
+  llvm::PHINode* llvm_value_phi = irb->CreatePHI(
+      codegen_utils->GetType<Datum>(), llvm_blocks.size());
+  llvm::PHINode* llvm_isnull_phi = irb->CreatePHI(
+      codegen_utils->GetType<bool>(), llvm_blocks.size());
+  for (size_t i = 0; i < llvm_blocks.size(); ++i) {
+    llvm_value_phi->addIncoming(llvm_values[i], llvm_blocks[i]);
+    llvm_isnull_phi->addIncoming(llvm_isnulls[i], llvm_blocks[i]);
+  }
+  irb->CreateStore(llvm_isnull_phi, llvm_isnull_ptr);
+  *llvm_out_value = llvm_value_phi;
+  return true;
+}
@@ -0,0 +1,104 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    codegen_async_compiler.cc
+//
+//  @doc:
+//    Implementation of the per-backend background compiler thread
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stdlib.h>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "codegen/codegen_async_compiler.h"
+
+using gpcodegen::CodegenAsyncCompiler;
+using gpcodegen::CodegenCompileTask;
+
+extern "C" {
+extern void gp_set_thread_sigmasks(void);
+}
+
+namespace {
+
+// Stop the compiler thread before the backend exits, so that it is not
+// compiling while global destructors run.
+void ShutdownAsyncCompiler() {
+  CodegenAsyncCompiler::GetInstance()->Shutdown();
+}
+
+}  // namespace
+
+CodegenAsyncCompiler::CodegenAsyncCompiler()
+    : shutdown_(false) {
+}
+
+CodegenAsyncCompiler::~CodegenAsyncCompiler() {
+  Shutdown();
+}
+
+CodegenAsyncCompiler* CodegenAsyncCompiler::GetInstance() {
+  static CodegenAsyncCompiler instance;
+  return &instance;
+}
+
+bool CodegenAsyncCompiler::Submit(std::shared_ptr<CodegenCompileTask> task) {
+  assert(nullptr != task);
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (shutdown_) {
+    return false;
+  }
+  if (!thread_.joinable()) {
+    try {
+      thread_ = std::thread(&CodegenAsyncCompiler::ThreadMain, this);
+    } catch (const std::system_error&) {
+      return false;
+    }
+    atexit(ShutdownAsyncCompiler);
+  }
+  tasks_.push_back(std::move(task));
+  task_available_.notify_one();
+  return true;
+}
+
+void CodegenAsyncCompiler::Shutdown() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    shutdown_ = true;
+    tasks_.clear();
+    task_available_.notify_one();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void CodegenAsyncCompiler::ThreadMain() {
+  // Signals are for the main thread of the backend
+  gp_set_thread_sigmasks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    task_available_.wait(lock, [this] {
+      return shutdown_ || !tasks_.empty();
+    });
+    if (shutdown_) {
+      return;
+    }
+    std::shared_ptr<CodegenCompileTask> task = std::move(tasks_.front());
+    tasks_.pop_front();
+
+    lock.unlock();
+    task->Run();
+    // Release the task, and whatever it owns, before taking the lock again
+    task.reset();
+    lock.lock();
+  }
+}
@@ -10,26 +10,97 @@
 //
 //---------------------------------------------------------------------------
 #include <assert.h>
+#include <algorithm>
 #include <iosfwd>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "llvm/Support/raw_ostream.h"
 
+#include "codegen/codegen_async_compiler.h"
 #include "codegen/codegen_interface.h"
 #include "codegen/codegen_manager.h"
+#include "codegen/codegen_module_cache.h"
 #include "codegen/codegen_wrapper.h"
 #include "codegen/utils/codegen_utils.h"
 #include "codegen/utils/gp_codegen_utils.h"
 
+using gpcodegen::CodegenAsyncCompiler;
+using gpcodegen::CodegenCompileTask;
 using gpcodegen::CodegenManager;
+using gpcodegen::CodegenModuleCache;
+
+extern bool codegen_async_compile;  // defined from guc
+extern int codegen_module_cache_size;  // defined from guc
+
+class CodegenManager::AsyncCompileTask : public CodegenCompileTask {
+ public:
+  AsyncCompileTask(CodegenManager* manager,
+                   CodegenModuleCache* module_cache)
+      : manager_(manager),
+        codegen_utils_(manager->codegen_utils_),
+        module_cache_(module_cache) {
+  }
+
+  void Run() override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (nullptr == manager_) {
+        return;
+      }
+    }
+
+    // Compilation only touches the module, so the executor can keep running,
+    // and even destroy the manager, in the meantime.
+    bool compilation_status = codegen_utils_->PrepareForExecution(
+        gpcodegen::GpCodegenUtils::OptimizationLevel::kDefault, true,
+        module_cache_);
+    if (!compilation_status) {
+      return;
+    }
+    codegen_utils_->CompileModules();
+
+    // Looking up the compiled functions is cheap, so holding the lock here
+    // delays the destruction of the manager very little.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nullptr != manager_) {
+      manager_->SetToGenerated();
+    }
+  }
+
+  // Called when the manager is destroyed, or when the transaction aborts,
+  // after which the task must not touch the manager or its generators.
+  void Detach() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    manager_ = nullptr;
+  }
+
+ private:
+  std::mutex mutex_;
+  CodegenManager* manager_;
+  std::shared_ptr<gpcodegen::GpCodegenUtils> codegen_utils_;
+  CodegenModuleCache* module_cache_;
+};
+
+std::vector<std::weak_ptr<CodegenManager::AsyncCompileTask>>
+CodegenManager::async_compile_tasks_;
 
-CodegenManager::CodegenManager(const std::string& module_name) {
+CodegenManager::CodegenManager(const std::string& module_name)
+    : module_cache_hits_(0),
+      module_cache_misses_(0) {
   module_name_ = module_name;
   codegen_utils_.reset(new gpcodegen::GpCodegenUtils(module_name));
 }
 
+CodegenManager::~CodegenManager() {
+  // The generators, which the task swaps in, are destroyed right after this
+  if (nullptr != async_compile_task_) {
+    async_compile_task_->Detach();
+  }
+}
+
 bool CodegenManager::EnrollCodeGenerator(
     CodegenFuncLifespan funcLifespan, CodegenInterface* generator) {
   // Only CodegenFuncLifespan_Parameter_Invariant is supported as of now
@@ -64,16 +135,65 @@ unsigned int CodegenManager::PrepareGeneratedFunctions() {
   }
 
 
+  // Reuse machine code compiled for an identical module earlier in this
+  // backend, if any
+  CodegenModuleCache* module_cache = CodegenModuleCache::GetInstance();
+  module_cache->SetMaxSize(
+      static_cast<size_t>(codegen_module_cache_size) * 1024);
+  if (codegen_module_cache_size == 0) {
+    module_cache = nullptr;
+  }
+  // Compile on the compiler thread, unless EXPLAIN ANALYZE CODEGEN needs
+  // to report how the module was compiled. Fall back to compiling here if
+  // the thread cannot be started.
+  if (codegen_async_compile && explain_string_.empty()) {
+    async_compile_task_.reset(new AsyncCompileTask(this, module_cache));
+    if (CodegenAsyncCompiler::GetInstance()->Submit(async_compile_task_)) {
+      // Forget the tasks that are done and whose managers are gone
+      async_compile_tasks_.erase(
+          std::remove_if(async_compile_tasks_.begin(),
+                         async_compile_tasks_.end(),
+                         [](const std::weak_ptr<AsyncCompileTask>& task) {
+                           return task.expired();
+                         }),
+          async_compile_tasks_.end());
+      async_compile_tasks_.emplace_back(async_compile_task_);
+      return success_count;
+    }
+    async_compile_task_.reset();
+  }
+
+  uint64_t hits = nullptr != module_cache ? module_cache->hits() : 0;
+  uint64_t misses = nullptr != module_cache ? module_cache->misses() : 0;
+
   // Call GpCodegenUtils to compile entire module
   bool compilation_status = codegen_utils_->PrepareForExecution(
-      gpcodegen::GpCodegenUtils::OptimizationLevel::kDefault, true);
+      gpcodegen::GpCodegenUtils::OptimizationLevel::kDefault, true,
+      module_cache);
 
   if (!compilation_status) {
     return success_count;
   }
 
   // On successful compilation, go through all generator and swap
-  // the pointer so compiled function get called
+  // the pointer so compiled function get called. The module is actually
+  // compiled, or taken from the cache, when the first pointer is requested.
+  success_count = SetToGenerated();
+
+  if (nullptr != module_cache) {
+    module_cache_hits_ = module_cache->hits() - hits;
+    module_cache_misses_ = module_cache->misses() - misses;
+  }
+  // For EXPLAIN ANALYZE CODEGEN, the modules were dumped before compilation;
+  // add how they were compiled.
+  if (!explain_string_.empty()) {
+    AppendModuleCacheExplainString(module_cache);
+  }
+  return success_count;
+}
+
+unsigned int CodegenManager::SetToGenerated() {
+  unsigned int success_count = 0;
   gpcodegen::GpCodegenUtils* codegen_utils = codegen_utils_.get();
   for (std::unique_ptr<CodegenInterface>& generator :
       enrolled_code_generators_) {
@@ -82,6 +202,16 @@ unsigned int CodegenManager::PrepareGeneratedFunctions() {
   return success_count;
 }
 
+void CodegenManager::DetachAsyncCompileTasks() {
+  for (std::weak_ptr<AsyncCompileTask>& weak_task : async_compile_tasks_) {
+    std::shared_ptr<AsyncCompileTask> task = weak_task.lock();
+    if (nullptr != task) {
+      task->Detach();
+    }
+  }
+  async_compile_tasks_.clear();
+}
+
 void CodegenManager::NotifyParameterChange() {
   // no support for parameter change yet
   assert(false);
@@ -102,3 +232,21 @@ void CodegenManager::AccumulateExplainString() {
   llvm::raw_string_ostream out(explain_string_);
   codegen_utils_->PrintUnderlyingModules(out);
 }
+
+void CodegenManager::AppendModuleCacheExplainString(
+    const CodegenModuleCache* module_cache) {
+  llvm::raw_string_ostream out(explain_string_);
+  out << "==== MODULE CACHE ====" << "\n";
+  if (nullptr == module_cache) {
+    out << "disabled" << "\n";
+  } else {
+    out << "hits: " << module_cache_hits_
+        << ", misses: " << module_cache_misses_
+        << " (backend: hits: " << module_cache->hits()
+        << ", misses: " << module_cache->misses()
+        << ", modules: " << module_cache->entry_count()
+        << ", size: " << (module_cache->size() + 1023) / 1024 << "kB)"
+        << "\n";
+  }
+  out.flush();
+}
@@ -0,0 +1,117 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    codegen_module_cache.cc
+//
+//  @doc:
+//    Implementation of the per-backend cache of compiled modules
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "codegen/codegen_module_cache.h"
+
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/raw_ostream.h"
+
+using gpcodegen::CodegenModuleCache;
+
+CodegenModuleCache::CodegenModuleCache()
+    : size_(0),
+      max_size_(0),
+      hits_(0),
+      misses_(0) {
+}
+
+CodegenModuleCache* CodegenModuleCache::GetInstance() {
+  static CodegenModuleCache instance;
+  return &instance;
+}
+
+std::string CodegenModuleCache::GetModuleKey(const llvm::Module& module) {
+  // The module identifier names the plan node, and the target is the same for
+  // the whole backend, so only the globals and functions are printed.
+  std::string key;
+  llvm::raw_string_ostream out(key);
+  for (const llvm::GlobalVariable& global : module.globals()) {
+    global.print(out);
+    out << "\n";
+  }
+  for (const llvm::Function& function : module) {
+    function.print(out);
+  }
+  out.flush();
+  return key;
+}
+
+std::unique_ptr<llvm::MemoryBuffer> CodegenModuleCache::getObject(
+    const llvm::Module* module) {
+  assert(nullptr != module);
+  std::string key = GetModuleKey(*module);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    misses_++;
+    pending_keys_[module] = std::move(key);
+    return nullptr;
+  }
+
+  hits_++;
+  // Move the entry to the front of the LRU list
+  lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_position);
+  const llvm::MemoryBuffer& object = *it->second.object;
+  return llvm::MemoryBuffer::getMemBufferCopy(object.getBuffer(),
+                                              object.getBufferIdentifier());
+}
+
+void CodegenModuleCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef object) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto pending = pending_keys_.find(module);
+  if (pending == pending_keys_.end()) {
+    return;
+  }
+  std::string key = std::move(pending->second);
+  pending_keys_.erase(pending);
+
+  std::size_t entry_size = key.size() + object.getBufferSize();
+  if (entry_size > max_size_ || entries_.find(key) != entries_.end()) {
+    return;
+  }
+
+  auto inserted = entries_.emplace(std::move(key), CacheEntry());
+  assert(inserted.second);
+  CacheEntry& entry = inserted.first->second;
+  entry.object = llvm::MemoryBuffer::getMemBufferCopy(
+      object.getBuffer(), object.getBufferIdentifier());
+  // Keys of an unordered_map do not move, so the LRU list can point to them
+  lru_keys_.push_front(&inserted.first->first);
+  entry.lru_position = lru_keys_.begin();
+  size_ += entry_size;
+  Evict();
+}
+
+void CodegenModuleCache::SetMaxSize(std::size_t max_size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_size_ = max_size;
+  Evict();
+}
+
+void CodegenModuleCache::Evict() {
+  while (size_ > max_size_) {
+    assert(!lru_keys_.empty());
+    auto it = entries_.find(*lru_keys_.back());
+    assert(it != entries_.end());
+    size_ -= it->first.size() + it->second.object->getBufferSize();
+    lru_keys_.pop_back();
+    entries_.erase(it);
+  }
+}
@@ -16,7 +16,10 @@
 #include <string>
 #include <type_traits>
 
+#include "codegen/advance_aggregates_codegen.h"
+#include "codegen/agg_hash_keys_match_codegen.h"
 #include "codegen/base_codegen.h"
+#include "codegen/calc_hash_value_codegen.h"
 #include "codegen/codegen_manager.h"
 #include "codegen/exec_eval_expr_codegen.h"
 #include "codegen/exec_variable_list_codegen.h"
@@ -27,6 +30,9 @@ extern "C" {
 #include "lib/stringinfo.h"
 }
 
+using gpcodegen::AdvanceAggregatesCodegen;
+using gpcodegen::AggHashKeysMatchCodegen;
+using gpcodegen::CalcHashValueCodegen;
 using gpcodegen::CodegenManager;
 using gpcodegen::BaseCodegen;
 using gpcodegen::ExecVariableListCodegen;
@@ -94,6 +100,10 @@ void CodeGeneratorManagerDestroy(void* manager) {
   delete (static_cast<CodegenManager*>(manager));
 }
 
+void AtAbort_Codegen() {
+  CodegenManager::DetachAsyncCompileTasks();
+}
+
 void* GetActiveCodeGeneratorManager() {
   return ActiveCodeGeneratorManager;
 }
@@ -165,5 +175,38 @@ void* ExecEvalExprCodegenEnroll(
   return generator;
 }
 
+void* AdvanceAggregatesCodegenEnroll(
+    AdvanceAggregatesFn regular_func_ptr,
+    AdvanceAggregatesFn* ptr_to_chosen_func_ptr,
+    AggState *aggstate) {
+  AdvanceAggregatesCodegen* generator =
+      CodegenEnroll<AdvanceAggregatesCodegen>(
+          regular_func_ptr,
+          ptr_to_chosen_func_ptr,
+          aggstate);
+  return generator;
+}
 
+void* CalcHashValueCodegenEnroll(
+    CalcHashValueFn regular_func_ptr,
+    CalcHashValueFn* ptr_to_chosen_func_ptr,
+    AggState *aggstate) {
+  CalcHashValueCodegen* generator =
+      CodegenEnroll<CalcHashValueCodegen>(
+          regular_func_ptr,
+          ptr_to_chosen_func_ptr,
+          aggstate);
+  return generator;
+}
 
+void* AggHashKeysMatchCodegenEnroll(
+    AggHashKeysMatchFn regular_func_ptr,
+    AggHashKeysMatchFn* ptr_to_chosen_func_ptr,
+    AggState *aggstate) {
+  AggHashKeysMatchCodegen* generator =
+      CodegenEnroll<AggHashKeysMatchCodegen>(
+          regular_func_ptr,
+          ptr_to_chosen_func_ptr,
+          aggstate);
+  return generator;
+}
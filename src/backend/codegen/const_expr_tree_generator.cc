@@ -18,6 +18,7 @@
 #include "codegen/utils/gp_codegen_utils.h"
 
 #include "llvm/IR/Constant.h"
+#include "llvm/IR/IRBuilder.h"
 
 
 extern "C" {
@@ -56,7 +57,19 @@ bool ConstExprTreeGenerator::GenerateCode(GpCodegenUtils* codegen_utils,
                                           llvm::Value** llvm_out_value) {
   assert(nullptr != llvm_out_value);
   Const* const_expr = reinterpret_cast<Const*>(expr_state()->expr);
+  codegen_utils->ir_builder()->CreateStore(
+      codegen_utils->GetConstant<bool>(const_expr->constisnull),
+      llvm_isnull_ptr);
   // const_expr->constvalue is a datum
-  *llvm_out_value = codegen_utils->GetConstant(const_expr->constvalue);
+  if (const_expr->constbyval || const_expr->constisnull) {
+    *llvm_out_value = codegen_utils->GetConstant(const_expr->constvalue);
+  } else {
+    // Refer to pass-by-reference values through a pointer constant, which is
+    // resolved when the module is linked, so that compiled code cached for
+    // reuse by another query never keeps this query's address.
+    *llvm_out_value = codegen_utils->ir_builder()->CreatePtrToInt(
+        codegen_utils->GetConstant(DatumGetPointer(const_expr->constvalue)),
+        codegen_utils->GetType<Datum>());
+  }
   return true;
 }
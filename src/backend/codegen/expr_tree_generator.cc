@@ -12,11 +12,16 @@
 #include <cassert>
 #include <memory>
 
+#include "codegen/bool_expr_tree_generator.h"
+#include "codegen/case_expr_tree_generator.h"
 #include "codegen/const_expr_tree_generator.h"
 #include "codegen/expr_tree_generator.h"
+#include "codegen/null_test_expr_tree_generator.h"
 #include "codegen/op_expr_tree_generator.h"
 #include "codegen/var_expr_tree_generator.h"
 
+#include "llvm/IR/IRBuilder.h"
+
 extern "C" {
 #include "postgres.h"  // NOLINT(build/include)
 #include "nodes/execnodes.h"
@@ -51,6 +56,21 @@ bool ExprTreeGenerator::VerifyAndCreateExprTree(
           expr_state, gen_info, expr_tree);
       break;
     }
+    case T_BoolExpr: {
+      supported_expr_tree = BoolExprTreeGenerator::VerifyAndCreateExprTree(
+          expr_state, gen_info, expr_tree);
+      break;
+    }
+    case T_NullTest: {
+      supported_expr_tree = NullTestExprTreeGenerator::VerifyAndCreateExprTree(
+          expr_state, gen_info, expr_tree);
+      break;
+    }
+    case T_CaseExpr: {
+      supported_expr_tree = CaseExprTreeGenerator::VerifyAndCreateExprTree(
+          expr_state, gen_info, expr_tree);
+      break;
+    }
     default : {
       supported_expr_tree = false;
       elog(DEBUG1, "Unsupported expression tree %d found",
@@ -61,3 +81,31 @@ bool ExprTreeGenerator::VerifyAndCreateExprTree(
          (supported_expr_tree && nullptr != expr_tree->get()));
   return supported_expr_tree;
 }
+
+bool ExprTreeGenerator::GenerateArgumentCode(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    ExprTreeGenerator* arg,
+    llvm::Value** llvm_out_value,
+    llvm::Value** llvm_out_isnull) {
+  assert(nullptr != codegen_utils &&
+         nullptr != arg &&
+         nullptr != llvm_out_value &&
+         nullptr != llvm_out_isnull);
+  auto irb = codegen_utils->ir_builder();
+
+  llvm::Value* llvm_isnull_ptr = irb->CreateAlloca(
+      codegen_utils->GetType<bool>(), nullptr, "arg_isnull");
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+
+  *llvm_out_value = nullptr;
+  if (!arg->GenerateCode(codegen_utils,
+                         gen_info,
+                         llvm_isnull_ptr,
+                         llvm_out_value) ||
+      nullptr == *llvm_out_value) {
+    return false;
+  }
+  *llvm_out_isnull = irb->CreateLoad(llvm_isnull_ptr);
+  return true;
+}
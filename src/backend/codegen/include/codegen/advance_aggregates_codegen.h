@@ -0,0 +1,133 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    advance_aggregates_codegen.h
+//
+//  @doc:
+//    Headers for advance_aggregates codegen.
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_ADVANCE_AGGREGATES_CODEGEN_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_ADVANCE_AGGREGATES_CODEGEN_H_
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/op_expr_tree_generator.h"
+#include "codegen/pg_func_generator_interface.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+class AdvanceAggregatesCodegen: public BaseCodegen<AdvanceAggregatesFn> {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param regular_func_ptr        Regular version of the target function.
+   * @param ptr_to_chosen_func_ptr  Reference to the function pointer that the
+   *                                caller will call.
+   * @param aggstate                The AggState to use for generating code.
+   *
+   * @note 	The ptr_to_chosen_func_ptr can refer to either the generated
+   *        function or the corresponding regular version.
+   *
+   **/
+  explicit AdvanceAggregatesCodegen(
+      CodegenManager* manager,
+      AdvanceAggregatesFn regular_func_ptr,
+      AdvanceAggregatesFn* ptr_to_regular_func_ptr,
+      AggState *aggstate);
+
+  virtual ~AdvanceAggregatesCodegen() = default;
+
+  bool InitDependencies() override;
+
+  /**
+   * @brief Initialize transition functions that we support for code
+   *        generation.
+   **/
+  static void InitializeSupportedFunction();
+
+ protected:
+  /**
+   * @brief Generate code for advance_aggregates().
+   *
+   * @param codegen_utils
+   *
+   * @return true on successful generation; false otherwise.
+   *
+   * @note The aggregates' input expressions are still evaluated by
+   * ExecProject(), which may itself call generated code. The transition
+   * functions registered in InitializeSupportedFunction() are inlined, so
+   * no fmgr call is made per input row for them. numeric sum and avg, and
+   * avg on integers, have pass-by-reference transition values and are
+   * advanced by calling advance_aggregate_value() instead.
+   *
+   * This implementation does not support:
+   *  (1) DISTINCT / ORDER BY aggregates and percentile functions
+   *  (2) Aggregates with more than one argument
+   *  (3) Other pass-by-reference transition types (e.g. float avg's arrays)
+   *  (4) Transition functions other than the ones above
+   *
+   * If any aggregate of the node is not supported, the regular
+   * advance_aggregates() is used for the whole node.
+   */
+  bool GenerateCodeInternal(gpcodegen::GpCodegenUtils* codegen_utils) final;
+
+ private:
+  AggState *aggstate_;
+
+  static constexpr char kAdvanceAggregatesPrefix[] = "advance_aggregates";
+
+  // Map of supported transition functions, keyed by pg_proc oid
+  static CodeGenFuncMap supported_function_;
+
+  /**
+   * @brief Generates runtime code that implements advance_aggregates.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @return true on successful generation.
+   **/
+  bool GenerateAdvanceAggregates(gpcodegen::GpCodegenUtils* codegen_utils);
+
+  /**
+   * @brief Generate code for advancing one aggregate, i.e.
+   *        advance_transition_function() for a by-value transition type.
+   *
+   * @param codegen_utils         Utility to ease the code generation process.
+   * @param aggno                 Index of the aggregate to advance.
+   * @param pg_func_info          Main function and error block; its
+   *                              arguments are ignored.
+   * @param llvm_pergroupstate    Pointer to this aggregate's
+   *                              AggStatePerGroupData.
+   * @param llvm_arg              Input value as Datum, or nullptr if the
+   *                              aggregate has no argument (count(*)).
+   * @param llvm_arg_isnull       Input's null flag, or nullptr.
+   * @param llvm_next_block       Block to continue with afterwards.
+   * @return true on successful generation.
+   **/
+  bool GenerateAdvanceTransitionFunction(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      int aggno,
+      const PGFuncGeneratorInfo& pg_func_info,
+      llvm::Value* llvm_pergroupstate,
+      llvm::Value* llvm_arg,
+      llvm::Value* llvm_arg_isnull,
+      llvm::BasicBlock* llvm_next_block);
+
+  /**
+   * @return true if all the aggregates of aggstate_ can be generated.
+   **/
+  bool IsSupported();
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_ADVANCE_AGGREGATES_CODEGEN_H_
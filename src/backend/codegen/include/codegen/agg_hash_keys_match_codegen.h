@@ -0,0 +1,79 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    agg_hash_keys_match_codegen.h
+//
+//  @doc:
+//    Headers for agg_hash_keys_match codegen.
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_AGG_HASH_KEYS_MATCH_CODEGEN_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_AGG_HASH_KEYS_MATCH_CODEGEN_H_
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+class AggHashKeysMatchCodegen: public BaseCodegen<AggHashKeysMatchFn> {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param regular_func_ptr        Regular version of the target function.
+   * @param ptr_to_chosen_func_ptr  Reference to the function pointer that the
+   *                                caller will call.
+   * @param aggstate                The AggState to use for generating code.
+   *
+   * @note 	The ptr_to_chosen_func_ptr can refer to either the generated
+   *        function or the corresponding regular version.
+   *
+   **/
+  explicit AggHashKeysMatchCodegen(
+      CodegenManager* manager,
+      AggHashKeysMatchFn regular_func_ptr,
+      AggHashKeysMatchFn* ptr_to_regular_func_ptr,
+      AggState *aggstate);
+
+  virtual ~AggHashKeysMatchCodegen() = default;
+
+ protected:
+  /**
+   * @brief Generate code for agg_hash_keys_match().
+   *
+   * @param codegen_utils
+   *
+   * @return true on successful generation; false otherwise.
+   *
+   * @note The equality functions of the grouping keys are inlined, so no
+   * fmgr call is made per compared entry. Only int2, int4, int8, date and
+   * oid keys (int2eq, int4eq, int8eq, date_eq and oideq) are supported; for
+   * any other key type the regular agg_hash_keys_match() is used.
+   */
+  bool GenerateCodeInternal(gpcodegen::GpCodegenUtils* codegen_utils) final;
+
+ private:
+  AggState *aggstate_;
+
+  static constexpr char kAggHashKeysMatchPrefix[] = "agg_hash_keys_match";
+
+  /**
+   * @brief Generates runtime code that implements agg_hash_keys_match.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @return true on successful generation.
+   **/
+  bool GenerateAggHashKeysMatch(gpcodegen::GpCodegenUtils* codegen_utils);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_AGG_HASH_KEYS_MATCH_CODEGEN_H_
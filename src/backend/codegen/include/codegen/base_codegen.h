@@ -102,7 +102,10 @@ class BaseCodegen: public CodegenInterface {
         FuncPtrType>(GetUniqueFuncName());
 
     if (nullptr != compiled_func_ptr) {
-      *ptr_to_chosen_func_ptr_ = compiled_func_ptr;
+      // With codegen_async_compile, this runs on the compiler thread while
+      // the executor may be calling through the pointer.
+      __atomic_store_n(ptr_to_chosen_func_ptr_, compiled_func_ptr,
+                       __ATOMIC_RELEASE);
       return true;
     }
     return false;
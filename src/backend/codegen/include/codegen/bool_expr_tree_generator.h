@@ -0,0 +1,75 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    bool_expr_tree_generator.h
+//
+//  @doc:
+//    Object that generate code for boolean expression.
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_BOOL_EXPR_TREE_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_BOOL_EXPR_TREE_GENERATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/expr_tree_generator.h"
+
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Object that generate code for boolean expression (AND, OR and NOT).
+ **/
+class BoolExprTreeGenerator : public ExprTreeGenerator {
+ public:
+  static bool VerifyAndCreateExprTree(
+      const ExprState* expr_state,
+      ExprTreeGeneratorInfo* gen_info,
+      std::unique_ptr<ExprTreeGenerator>* expr_tree);
+
+  bool GenerateCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                    const ExprTreeGeneratorInfo& gen_info,
+                    llvm::Value* llvm_isnull_ptr,
+                    llvm::Value** llvm_out_value) final;
+
+ protected:
+  /**
+   * @brief Constructor.
+   *
+   * @param expr_state Expression state
+   * @param arguments Arguments of the boolean expression as list of
+   *        ExprTreeGenerator
+   **/
+  BoolExprTreeGenerator(
+      const ExprState* expr_state,
+      std::vector<
+          std::unique_ptr<
+              ExprTreeGenerator>>&& arguments);  // NOLINT(build/c++11)
+
+ private:
+  /**
+   * @brief Generate short-circuit AND / OR following ExecEvalAnd() and
+   *        ExecEvalOr(): the first argument equal to short_circuit_value
+   *        decides the result, otherwise any NULL argument makes it NULL.
+   **/
+  bool GenerateAndOr(gpcodegen::GpCodegenUtils* codegen_utils,
+                     const ExprTreeGeneratorInfo& gen_info,
+                     bool short_circuit_value,
+                     llvm::Value* llvm_isnull_ptr,
+                     llvm::Value** llvm_out_value);
+
+  std::vector<std::unique_ptr<ExprTreeGenerator>> arguments_;
+};
+
+/** @} */
+}  // namespace gpcodegen
+
+#endif  // GPCODEGEN_BOOL_EXPR_TREE_GENERATOR_H_
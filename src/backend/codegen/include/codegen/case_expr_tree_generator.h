@@ -0,0 +1,73 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    case_expr_tree_generator.h
+//
+//  @doc:
+//    Object that generate code for CASE expression.
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_CASE_EXPR_TREE_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_CASE_EXPR_TREE_GENERATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/expr_tree_generator.h"
+
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Object that generate code for CASE expression.
+ **/
+class CaseExprTreeGenerator : public ExprTreeGenerator {
+ public:
+  static bool VerifyAndCreateExprTree(
+      const ExprState* expr_state,
+      ExprTreeGeneratorInfo* gen_info,
+      std::unique_ptr<ExprTreeGenerator>* expr_tree);
+
+  bool GenerateCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                    const ExprTreeGeneratorInfo& gen_info,
+                    llvm::Value* llvm_isnull_ptr,
+                    llvm::Value** llvm_out_value) final;
+
+ protected:
+  /**
+   * @brief Constructor.
+   *
+   * @param expr_state Expression state
+   * @param conditions WHEN conditions as list of ExprTreeGenerator
+   * @param results THEN results as list of ExprTreeGenerator, one per
+   *        condition
+   * @param default_result ELSE result; nullptr if there is no ELSE clause
+   **/
+  CaseExprTreeGenerator(
+      const ExprState* expr_state,
+      std::vector<
+          std::unique_ptr<
+              ExprTreeGenerator>>&& conditions,  // NOLINT(build/c++11)
+      std::vector<
+          std::unique_ptr<
+              ExprTreeGenerator>>&& results,  // NOLINT(build/c++11)
+      std::unique_ptr<
+          ExprTreeGenerator>&& default_result);  // NOLINT(build/c++11)
+
+ private:
+  std::vector<std::unique_ptr<ExprTreeGenerator>> conditions_;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> results_;
+  std::unique_ptr<ExprTreeGenerator> default_result_;
+};
+
+/** @} */
+}  // namespace gpcodegen
+
+#endif  // GPCODEGEN_CASE_EXPR_TREE_GENERATOR_H_
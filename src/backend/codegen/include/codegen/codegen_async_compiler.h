@@ -0,0 +1,100 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    codegen_async_compiler.h
+//
+//  @doc:
+//    Per-backend thread compiling generated modules in the background
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_CODEGEN_ASYNC_COMPILER_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_CODEGEN_ASYNC_COMPILER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "codegen/utils/macros.h"
+
+namespace gpcodegen {
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Unit of work run by the CodegenAsyncCompiler.
+ **/
+class CodegenCompileTask {
+ public:
+  virtual ~CodegenCompileTask() = default;
+
+  /**
+   * @brief Compile the generated code, on the compiler thread.
+   *
+   * @note Runs concurrently with the executor, so it must not call into the
+   *       backend (elog, palloc, ...) and must only touch state that the
+   *       executor does not free while the task runs.
+   **/
+  virtual void Run() = 0;
+
+ protected:
+  CodegenCompileTask() = default;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(CodegenCompileTask);
+};
+
+/**
+ * @brief Runs CodegenCompileTasks, in submission order, on a thread of the
+ *        backend so that the executor does not wait for LLVM.
+ *
+ * The thread is started by the first Submit() and stopped when the backend
+ * exits.
+ **/
+class CodegenAsyncCompiler {
+ public:
+  /**
+   * @return The compiler of this backend.
+   **/
+  static CodegenAsyncCompiler* GetInstance();
+
+  ~CodegenAsyncCompiler();
+
+  /**
+   * @brief Queue a task for the compiler thread.
+   *
+   * @param task Task to run. The compiler keeps a reference until it ran.
+   * @return false if the compiler thread could not be started, in which case
+   *         the task is not run.
+   **/
+  bool Submit(std::shared_ptr<CodegenCompileTask> task);
+
+  /**
+   * @brief Drop the queued tasks, and wait for the running one, if any.
+   **/
+  void Shutdown();
+
+ private:
+  CodegenAsyncCompiler();
+
+  // Body of the compiler thread
+  void ThreadMain();
+
+  std::mutex mutex_;
+  std::condition_variable task_available_;
+  std::deque<std::shared_ptr<CodegenCompileTask>> tasks_;
+  std::thread thread_;
+  bool shutdown_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodegenAsyncCompiler);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_CODEGEN_ASYNC_COMPILER_H_
@@ -13,6 +13,7 @@
 #ifndef GPCODEGEN_CODEGEN_MANAGER_H_  // NOLINT(build/header_guard)
 #define GPCODEGEN_CODEGEN_MANAGER_H_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
@@ -31,6 +32,9 @@ class GpCodegenUtils;
 // Forward declaration of a CodegenInterface that will be managed by manager
 class CodegenInterface;
 
+// Forward declaration of the cache of compiled modules
+class CodegenModuleCache;
+
 /**
  * @brief Object that manages all code gen.
  **/
@@ -44,7 +48,7 @@ class CodegenManager {
    **/
   explicit CodegenManager(const std::string& module_name);
 
-  ~CodegenManager() = default;
+  ~CodegenManager();
 
   /**
    * @brief Enroll a code generator with manager
@@ -70,8 +74,18 @@ class CodegenManager {
    * @brief Compile all the generated functions. On success,
    *        a pointer to the generated method becomes available to the caller.
    *
+   * @note  If the codegen_module_cache_size GUC is not 0, machine code compiled
+   *        earlier in this backend for an identical module is reused instead
+   *        of compiling the module again.
+   *
+   * @note  If the codegen_async_compile GUC is on, and no explain string was
+   *        accumulated, the module is compiled on the CodegenAsyncCompiler
+   *        thread. The callers keep using the regular functions until the
+   *        compiler thread swaps in the generated ones, or the manager is
+   *        destroyed.
+   *
    * @return The number of enrolled codegen that successully generated code
-   *         and 0 on failure
+   *         and 0 on failure or when compiling asynchronously
    **/
   unsigned int PrepareGeneratedFunctions();
 
@@ -110,9 +124,24 @@ class CodegenManager {
    */
   const std::string& GetExplainString();
 
+  /**
+   * @brief Stop all pending asynchronous compilations of this backend from
+   *        swapping in generated functions.
+   *
+   * @note  Called on (sub)transaction abort, before the executor state that
+   *        holds the function pointers is freed: managers are only destroyed
+   *        by ExecEndNode(), which an aborted query does not reach. Returns
+   *        after a task that is swapping in functions right now is done.
+   **/
+  static void DetachAsyncCompileTasks();
+
  private:
-  // GpCodegenUtils provides a facade to LLVM subsystem.
-  std::unique_ptr<gpcodegen::GpCodegenUtils> codegen_utils_;
+  // Compiles the module on the compiler thread
+  class AsyncCompileTask;
+
+  // GpCodegenUtils provides a facade to LLVM subsystem. Shared with the
+  // AsyncCompileTask, which may outlive the manager.
+  std::shared_ptr<gpcodegen::GpCodegenUtils> codegen_utils_;
 
   std::string module_name_;
 
@@ -122,6 +151,29 @@ class CodegenManager {
   // Holds the dumped IR of all underlying modules for EXPLAIN CODEGEN queries
   std::string explain_string_;
 
+  // Outcome of the module cache lookups in PrepareGeneratedFunctions()
+  uint64_t module_cache_hits_;
+  uint64_t module_cache_misses_;
+
+  // Pending asynchronous compilation, if any
+  std::shared_ptr<AsyncCompileTask> async_compile_task_;
+
+  // Asynchronous compilations of all the managers of this backend that may
+  // still be pending
+  static std::vector<std::weak_ptr<AsyncCompileTask>> async_compile_tasks_;
+
+  /*
+   * @brief Swap in the compiled functions of all enrolled generators
+   *
+   * @return The number of generators whose function was swapped in
+   */
+  unsigned int SetToGenerated();
+
+  /*
+   * @brief Append the module cache counters to the explain string
+   */
+  void AppendModuleCacheExplainString(const CodegenModuleCache* module_cache);
+
   DISALLOW_COPY_AND_ASSIGN(CodegenManager);
 };
 
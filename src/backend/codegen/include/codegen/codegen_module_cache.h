@@ -0,0 +1,164 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    codegen_module_cache.h
+//
+//  @doc:
+//    Per-backend cache of machine code compiled for generated modules
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_CODEGEN_MODULE_CACHE_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_CODEGEN_MODULE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "codegen/utils/macros.h"
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace llvm {
+class Module;
+}  // namespace llvm
+
+namespace gpcodegen {
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Keeps the object code of compiled modules so that repeated
+ *        executions of the same plan skip LLVM code generation.
+ *
+ * A module is identified by its printed IR. Generators specialize code on
+ * the expression tree and the tuple descriptor, so both are part of the IR,
+ * while pointers to per-query structures are external symbols that the
+ * ExecutionEngine resolves when it links the (cached or new) object code.
+ *
+ * @note CodegenUtils::PrepareForExecution() renames the generated functions
+ *       before handing the module over, so that instance-specific function
+ *       names do not make identical modules look different.
+ *
+ * @note The cache is used by the compiler thread when the codegen_async_compile
+ *       GUC is on, so all methods take 'mutex_'.
+ **/
+class CodegenModuleCache : public llvm::ObjectCache {
+ public:
+  /**
+   * @return The cache of this backend.
+   **/
+  static CodegenModuleCache* GetInstance();
+
+  ~CodegenModuleCache() override = default;
+
+  /**
+   * @brief Called by the ExecutionEngine before compiling a module.
+   *
+   * @param module Module about to be compiled.
+   * @return A copy of the object code previously compiled for an identical
+   *         module, or NULL on a cache miss.
+   **/
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+  /**
+   * @brief Called by the ExecutionEngine after compiling a module that was
+   *        not found in the cache.
+   *
+   * @param module Module that was compiled.
+   * @param object Object code of the module.
+   **/
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+
+  /**
+   * @brief Set the maximum amount of memory used by the cache, evicting the
+   *        least recently used entries if it is exceeded.
+   *
+   * @param max_size Maximum size in bytes. 0 empties and disables the cache.
+   **/
+  void SetMaxSize(std::size_t max_size);
+
+  /**
+   * @return Number of modules found in the cache since backend start.
+   **/
+  std::uint64_t hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  /**
+   * @return Number of modules that had to be compiled since backend start.
+   **/
+  std::uint64_t misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  /**
+   * @return Number of cached modules.
+   **/
+  std::size_t entry_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  /**
+   * @return Memory used by the cached modules, in bytes.
+   **/
+  std::size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+
+ private:
+  struct CacheEntry {
+    std::unique_ptr<llvm::MemoryBuffer> object;
+    // Position of the entry's key in 'lru_keys_'
+    std::list<const std::string*>::iterator lru_position;
+  };
+
+  CodegenModuleCache();
+
+  // Return the key identifying 'module', i.e. its globals and functions
+  // printed as IR.
+  static std::string GetModuleKey(const llvm::Module& module);
+
+  // Remove least recently used entries until 'size_' fits in 'max_size_'.
+  // 'mutex_' must be held.
+  void Evict();
+
+  mutable std::mutex mutex_;
+
+  // Cached object code, keyed by module
+  std::unordered_map<std::string, CacheEntry> entries_;
+
+  // Keys of 'entries_', most recently used first
+  std::list<const std::string*> lru_keys_;
+
+  // Keys of the modules that missed the cache and are being compiled. The
+  // ExecutionEngine runs code generation passes over a module before
+  // notifyObjectCompiled(), so its key is taken in getObject().
+  std::unordered_map<const llvm::Module*, std::string> pending_keys_;
+
+  std::size_t size_;
+  std::size_t max_size_;
+  std::uint64_t hits_;
+  std::uint64_t misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(CodegenModuleCache);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_CODEGEN_MODULE_CACHE_H_
@@ -39,7 +39,10 @@ namespace gpcodegen {
 enum class ExprTreeNodeType {
   kConst = 0,
   kVar = 1,
-  kOperator = 2
+  kOperator = 2,
+  kBool = 3,
+  kNullTest = 4,
+  kCase = 5
 };
 
 /**
@@ -129,6 +132,25 @@ class ExprTreeGenerator {
   const ExprState* expr_state() { return expr_state_; }
 
  protected:
+  /**
+   * @brief Generate the code for a sub-expression with its own null flag.
+   *
+   * @param codegen_utils   Utility to easy code generation.
+   * @param gen_info        Information needed for generating the expression
+   *                        tree.
+   * @param arg             Sub-expression to generate code for
+   * @param llvm_out_value  Store the sub-expression results (a Datum)
+   * @param llvm_out_isnull Store an i1 that is true if the sub-expression
+   *                        evaluated to NULL
+   *
+   * @return true when it generated successfully otherwise it return false.
+   **/
+  static bool GenerateArgumentCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                                   const ExprTreeGeneratorInfo& gen_info,
+                                   ExprTreeGenerator* arg,
+                                   llvm::Value** llvm_out_value,
+                                   llvm::Value** llvm_out_isnull);
+
   /**
    * @brief Constructor.
    *
@@ -0,0 +1,62 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    null_test_expr_tree_generator.h
+//
+//  @doc:
+//    Object that generate code for NULL test expression.
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_NULL_TEST_EXPR_TREE_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_NULL_TEST_EXPR_TREE_GENERATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/expr_tree_generator.h"
+
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Object that generate code for NULL test expression (IS NULL and
+ *        IS NOT NULL).
+ **/
+class NullTestExprTreeGenerator : public ExprTreeGenerator {
+ public:
+  static bool VerifyAndCreateExprTree(
+      const ExprState* expr_state,
+      ExprTreeGeneratorInfo* gen_info,
+      std::unique_ptr<ExprTreeGenerator>* expr_tree);
+
+  bool GenerateCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                    const ExprTreeGeneratorInfo& gen_info,
+                    llvm::Value* llvm_isnull_ptr,
+                    llvm::Value** llvm_out_value) final;
+
+ protected:
+  /**
+   * @brief Constructor.
+   *
+   * @param expr_state Expression state
+   * @param arg Tested expression as ExprTreeGenerator
+   **/
+  NullTestExprTreeGenerator(
+      const ExprState* expr_state,
+      std::unique_ptr<ExprTreeGenerator>&& arg);  // NOLINT(build/c++11)
+
+ private:
+  std::unique_ptr<ExprTreeGenerator> arg_;
+};
+
+/** @} */
+}  // namespace gpcodegen
+
+#endif  // GPCODEGEN_NULL_TEST_EXPR_TREE_GENERATOR_H_
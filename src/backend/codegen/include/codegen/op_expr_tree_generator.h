@@ -12,6 +12,7 @@
 #ifndef GPCODEGEN_OP_EXPR_TREE_GENERATOR_H_  // NOLINT(build/header_guard)
 #define GPCODEGEN_OP_EXPR_TREE_GENERATOR_H_
 
+#include <string>
 #include <vector>
 
 #include "codegen/expr_tree_generator.h"
@@ -64,6 +65,43 @@ class OpExprTreeGenerator : public ExprTreeGenerator {
               ExprTreeGenerator>>&& arguments);  // NOLINT(build/c++11)
 
  private:
+  /**
+   * @brief Register a generator for the given pg_proc function.
+   *
+   * @tparam Arg0         First Argument CppType
+   * @tparam Arg1         Second Argument CppType
+   **/
+  template <typename Arg0, typename Arg1>
+  static void RegisterFunction(unsigned int pg_func_oid,
+                               const std::string& pg_func_name,
+                               PGFuncGenerator func_ptr);
+
+  /**
+   * @brief Register +, -, * and / for one pair of argument types.
+   *        Function names are built as pg_func_prefix + "pl", "mi", etc.
+   **/
+  template <typename rtype, typename Arg0, typename Arg1>
+  static void RegisterArithFunctions(const std::string& pg_func_prefix,
+                                     unsigned int pl_oid,
+                                     unsigned int mi_oid,
+                                     unsigned int mul_oid,
+                                     unsigned int div_oid);
+
+  /**
+   * @brief Register =, <>, <, <=, > and >= for one pair of argument types.
+   *        Function names are built as pg_func_prefix + "eq", "ne", etc.
+   *
+   * @tparam CmpType  Common type both arguments are compared in
+   **/
+  template <typename CmpType, typename Arg0, typename Arg1>
+  static void RegisterCompareFunctions(const std::string& pg_func_prefix,
+                                       unsigned int eq_oid,
+                                       unsigned int ne_oid,
+                                       unsigned int lt_oid,
+                                       unsigned int le_oid,
+                                       unsigned int gt_oid,
+                                       unsigned int ge_oid);
+
   std::vector<std::unique_ptr<ExprTreeGenerator>> arguments_;
   // Map of supported function with respective generator to generate code
   static CodeGenFuncMap supported_function_;
@@ -13,12 +13,14 @@
 #define GPCODEGEN_PG_ARITH_FUNC_GENERATOR_H_
 
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <memory>
 
 #include "codegen/utils/gp_codegen_utils.h"
 #include "codegen/pg_func_generator_interface.h"
 
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Value.h"
 
@@ -45,6 +47,20 @@ typename std::enable_if<std::is_integral<IntType>::value>::type> {
   static const char* OverFlowErrMsg() { return "integer out of range"; }
 };
 
+template <>
+class ArithOpOverFlowErrorMsg<
+int16_t> {
+ public:
+  static const char* OverFlowErrMsg() { return "smallint out of range"; }
+};
+
+template <>
+class ArithOpOverFlowErrorMsg<
+int64_t> {
+ public:
+  static const char* OverFlowErrMsg() { return "bigint out of range"; }
+};
+
 template <>
 class ArithOpOverFlowErrorMsg<
 float> {
@@ -102,7 +118,8 @@ class PGArithFuncGenerator {
         &gpcodegen::GpCodegenUtils::CreateMulOverflow<rtype>,
         llvm_err_msg,
         pg_func_info,
-        llvm_out_value);
+        llvm_out_value,
+        true /* check_underflow */);
   }
 
   /**
@@ -158,20 +175,150 @@ class PGArithFuncGenerator {
         llvm_out_value);
   }
 
+  /**
+   * @brief Create LLVM Add instruction without any overflow check, the way
+   *        int2_sum() and int4_sum() accumulate into an int8.
+   *
+   * @param codegen_utils     Utility to easy code generation.
+   * @param pg_func_info      Details of pgfunc (arguments, main function,
+   *                          error block)
+   * @param llvm_out_value    Store the results of function
+   *
+   * @return true if generation was successful otherwise return false
+   **/
+  static bool AddWithoutOverflow(gpcodegen::GpCodegenUtils* codegen_utils,
+                                 const PGFuncGeneratorInfo& pg_func_info,
+                                 llvm::Value** llvm_out_value) {
+    assert(nullptr != llvm_out_value);
+    llvm::Value* casted_arg0 =
+        codegen_utils->CreateCast<rtype, Arg0>(pg_func_info.llvm_args[0]);
+    llvm::Value* casted_arg1 =
+        codegen_utils->CreateCast<rtype, Arg1>(pg_func_info.llvm_args[1]);
+    llvm::IRBuilder<>* irb = codegen_utils->ir_builder();
+    *llvm_out_value = std::is_integral<rtype>::value ?
+        irb->CreateAdd(casted_arg0, casted_arg1) :
+        irb->CreateFAdd(casted_arg0, casted_arg1);
+    return true;
+  }
+
+  /**
+   * @brief Create LLVM Div instruction with check for division by zero
+   *
+   * @param codegen_utils     Utility to easy code generation.
+   * @param llvm_main_func    Current function for which we are generating code
+   * @param llvm_error_block  Basic Block to jump when error happens
+   * @param llvm_args         Vector of llvm arguments for the function
+   * @param llvm_out_value    Store the results of function
+   *
+   * @return true if generation was successful otherwise return false
+   *
+   * @note  If the divisor is zero, an integer division overflows
+   *        (e.g. INT_MIN / -1), or a float division overflows or underflows
+   *        (see CHECKFLOATVAL), it will do elog::ERROR and then jump to given
+   *        error block.
+   **/
+  static bool DivWithCheck(gpcodegen::GpCodegenUtils* codegen_utils,
+                           const PGFuncGeneratorInfo& pg_func_info,
+                           llvm::Value** llvm_out_value);
+
   static bool ArithOpWithOverflow(gpcodegen::GpCodegenUtils* codegen_utils,
                                   CGArithOpFunc codegen_mem_funcptr,
                                   llvm::Value* llvm_error_msg,
                                   const PGFuncGeneratorInfo& pg_func_info,
-                                  llvm::Value** llvm_out_value);
+                                  llvm::Value** llvm_out_value,
+                                  bool check_underflow = false);
+
+ private:
+  /**
+   * @brief Create the checks of CHECKFLOATVAL(result, inf_is_valid,
+   *        zero_is_valid) on a float result.
+   *
+   * @param codegen_utils       Utility to easy code generation.
+   * @param pg_func_info        Details of pgfunc (main function, error block)
+   * @param llvm_result         Float result to check
+   * @param llvm_inf_is_valid   i1, true if an infinite result is valid
+   * @param llvm_zero_is_valid  i1, true if a zero result is valid, or nullptr
+   *                            if it always is
+   **/
+  static void CreateFloatValueCheck(gpcodegen::GpCodegenUtils* codegen_utils,
+                                    const PGFuncGeneratorInfo& pg_func_info,
+                                    llvm::Value* llvm_result,
+                                    llvm::Value* llvm_inf_is_valid,
+                                    llvm::Value* llvm_zero_is_valid);
+
+  /**
+   * @brief Create an i1 that is true if the float value is +/-Infinity.
+   **/
+  static llvm::Value* CreateIsInf(gpcodegen::GpCodegenUtils* codegen_utils,
+                                  llvm::Value* llvm_value) {
+    llvm::IRBuilder<>* irb = codegen_utils->ir_builder();
+    llvm::Type* llvm_type = llvm_value->getType();
+    return irb->CreateOr(
+        irb->CreateFCmpOEQ(llvm_value,
+                           llvm::ConstantFP::getInfinity(llvm_type, false)),
+        irb->CreateFCmpOEQ(llvm_value,
+                           llvm::ConstantFP::getInfinity(llvm_type, true)));
+  }
 };
 
+template <typename rtype, typename Arg0, typename Arg1>
+void PGArithFuncGenerator<rtype, Arg0, Arg1>::CreateFloatValueCheck(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value* llvm_result,
+    llvm::Value* llvm_inf_is_valid,
+    llvm::Value* llvm_zero_is_valid) {
+  llvm::IRBuilder<>* irb = codegen_utils->ir_builder();
+
+  llvm::BasicBlock* llvm_overflow_block = codegen_utils->CreateBasicBlock(
+      "float_overflow_block", pg_func_info.llvm_main_func);
+  llvm::BasicBlock* llvm_non_overflow_block = codegen_utils->CreateBasicBlock(
+      "float_non_overflow_block", pg_func_info.llvm_main_func);
+
+  irb->CreateCondBr(
+      irb->CreateAnd(CreateIsInf(codegen_utils, llvm_result),
+                     irb->CreateNot(llvm_inf_is_valid)),
+      llvm_overflow_block,
+      llvm_non_overflow_block);
+
+  irb->SetInsertPoint(llvm_overflow_block);
+  codegen_utils->CreateElog(ERROR, "value out of range: overflow");
+  irb->CreateBr(pg_func_info.llvm_error_block);
+
+  irb->SetInsertPoint(llvm_non_overflow_block);
+
+  if (nullptr == llvm_zero_is_valid) {
+    return;
+  }
+
+  llvm::BasicBlock* llvm_underflow_block = codegen_utils->CreateBasicBlock(
+      "float_underflow_block", pg_func_info.llvm_main_func);
+  llvm::BasicBlock* llvm_non_underflow_block = codegen_utils->CreateBasicBlock(
+      "float_non_underflow_block", pg_func_info.llvm_main_func);
+
+  irb->CreateCondBr(
+      irb->CreateAnd(
+          irb->CreateFCmpOEQ(llvm_result,
+                             llvm::ConstantFP::get(llvm_result->getType(), 0.0)),
+          irb->CreateNot(llvm_zero_is_valid)),
+      llvm_underflow_block,
+      llvm_non_underflow_block);
+
+  irb->SetInsertPoint(llvm_underflow_block);
+  codegen_utils->CreateElog(ERROR, "value out of range: underflow");
+  irb->CreateBr(pg_func_info.llvm_error_block);
+
+  irb->SetInsertPoint(llvm_non_underflow_block);
+}
+
 template <typename rtype, typename Arg0, typename Arg1>
 bool PGArithFuncGenerator<rtype, Arg0, Arg1>::ArithOpWithOverflow(
     gpcodegen::GpCodegenUtils* codegen_utils,
     CGArithOpFunc codegen_mem_funcptr,
     llvm::Value* llvm_error_msg,
     const PGFuncGeneratorInfo& pg_func_info,
-    llvm::Value** llvm_out_value) {
+    llvm::Value** llvm_out_value,
+    bool check_underflow) {
 
   assert(nullptr != llvm_out_value);
   assert(nullptr != codegen_mem_funcptr);
@@ -209,11 +356,120 @@ bool PGArithFuncGenerator<rtype, Arg0, Arg1>::ArithOpWithOverflow(
 
     irb->SetInsertPoint(llvm_non_overflow_block);
   } else {
+    // Same checks as float4pl(), float8mi(), float8mul() etc.: the result
+    // may only be infinite if an argument is, and (for *) only be zero if an
+    // argument is.
+    llvm::Value* llvm_zero = codegen_utils->GetConstant<rtype>(0);
+    llvm::Value* llvm_zero_is_valid = check_underflow ?
+        irb->CreateOr(irb->CreateFCmpOEQ(casted_arg0, llvm_zero),
+                      irb->CreateFCmpOEQ(casted_arg1, llvm_zero)) :
+        nullptr;
+    CreateFloatValueCheck(
+        codegen_utils, pg_func_info, llvm_arith_output,
+        irb->CreateOr(CreateIsInf(codegen_utils, casted_arg0),
+                      CreateIsInf(codegen_utils, casted_arg1)),
+        llvm_zero_is_valid);
     *llvm_out_value = llvm_arith_output;
   }
   return true;
 }
 
+template <typename rtype, typename Arg0, typename Arg1>
+bool PGArithFuncGenerator<rtype, Arg0, Arg1>::DivWithCheck(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+
+  assert(nullptr != llvm_out_value);
+  // Assumed caller checked vector size and nullptr for codegen_utils
+  llvm::Value* casted_arg0 =
+      codegen_utils->CreateCast<rtype, Arg0>(pg_func_info.llvm_args[0]);
+  llvm::Value* casted_arg1 =
+      codegen_utils->CreateCast<rtype, Arg1>(pg_func_info.llvm_args[1]);
+
+  llvm::IRBuilder<>* irb = codegen_utils->ir_builder();
+
+  llvm::BasicBlock* llvm_div_by_zero_block = codegen_utils->CreateBasicBlock(
+      "div_by_zero_block", pg_func_info.llvm_main_func);
+  llvm::BasicBlock* llvm_non_zero_block = codegen_utils->CreateBasicBlock(
+      "div_non_zero_block", pg_func_info.llvm_main_func);
+
+  llvm::Value* llvm_zero = codegen_utils->GetConstant<rtype>(0);
+  llvm::Value* llvm_is_zero = std::is_integral<rtype>::value ?
+      irb->CreateICmpEQ(casted_arg1, llvm_zero) :
+      irb->CreateFCmpOEQ(casted_arg1, llvm_zero);
+
+  irb->CreateCondBr(llvm_is_zero,
+                    llvm_div_by_zero_block,
+                    llvm_non_zero_block);
+
+  irb->SetInsertPoint(llvm_div_by_zero_block);
+  codegen_utils->CreateElog(ERROR, "division by zero");
+  irb->CreateBr(pg_func_info.llvm_error_block);
+
+  irb->SetInsertPoint(llvm_non_zero_block);
+
+  if (!std::is_integral<rtype>::value) {
+    // CHECKFLOATVAL(result, isinf(arg1) || isinf(arg2), arg1 == 0) as in
+    // float8div()
+    llvm::Value* llvm_div_value = irb->CreateFDiv(casted_arg0, casted_arg1);
+    CreateFloatValueCheck(
+        codegen_utils, pg_func_info, llvm_div_value,
+        irb->CreateOr(CreateIsInf(codegen_utils, casted_arg0),
+                      CreateIsInf(codegen_utils, casted_arg1)),
+        irb->CreateFCmpOEQ(casted_arg0, llvm_zero));
+    *llvm_out_value = llvm_div_value;
+    return true;
+  }
+
+  // Dividing the most negative value by -1 overflows (and traps on some
+  // platforms), so compute that case as a checked negation instead.
+  llvm::BasicBlock* llvm_negate_block = codegen_utils->CreateBasicBlock(
+      "div_negate_block", pg_func_info.llvm_main_func);
+  llvm::BasicBlock* llvm_overflow_block = codegen_utils->CreateBasicBlock(
+      "div_overflow_block", pg_func_info.llvm_main_func);
+  llvm::BasicBlock* llvm_negate_done_block = codegen_utils->CreateBasicBlock(
+      "div_negate_done_block", pg_func_info.llvm_main_func);
+  llvm::BasicBlock* llvm_sdiv_block = codegen_utils->CreateBasicBlock(
+      "div_sdiv_block", pg_func_info.llvm_main_func);
+  llvm::BasicBlock* llvm_merge_block = codegen_utils->CreateBasicBlock(
+      "div_merge_block", pg_func_info.llvm_main_func);
+
+  irb->CreateCondBr(
+      irb->CreateICmpEQ(casted_arg1, codegen_utils->GetConstant<rtype>(-1)),
+      llvm_negate_block,
+      llvm_sdiv_block);
+
+  irb->SetInsertPoint(llvm_negate_block);
+  llvm::Value* llvm_negate_output =
+      codegen_utils->CreateSubOverflow<rtype>(llvm_zero, casted_arg0);
+  llvm::Value* llvm_negate_value =
+      irb->CreateExtractValue(llvm_negate_output, 0);
+  irb->CreateCondBr(irb->CreateExtractValue(llvm_negate_output, 1),
+                    llvm_overflow_block,
+                    llvm_negate_done_block);
+
+  irb->SetInsertPoint(llvm_overflow_block);
+  codegen_utils->CreateElog(
+      ERROR, "%s", codegen_utils->GetConstant(
+          ArithOpOverFlowErrorMsg<rtype>::OverFlowErrMsg()));
+  irb->CreateBr(pg_func_info.llvm_error_block);
+
+  irb->SetInsertPoint(llvm_negate_done_block);
+  irb->CreateBr(llvm_merge_block);
+
+  irb->SetInsertPoint(llvm_sdiv_block);
+  llvm::Value* llvm_sdiv_value = irb->CreateSDiv(casted_arg0, casted_arg1);
+  irb->CreateBr(llvm_merge_block);
+
+  irb->SetInsertPoint(llvm_merge_block);
+  llvm::PHINode* llvm_result = irb->CreatePHI(casted_arg0->getType(), 2);
+  llvm_result->addIncoming(llvm_negate_value, llvm_negate_done_block);
+  llvm_result->addIncoming(llvm_sdiv_value, llvm_sdiv_block);
+  *llvm_out_value = llvm_result;
+  return true;
+}
+
 
 
 
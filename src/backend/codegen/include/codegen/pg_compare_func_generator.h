@@ -0,0 +1,261 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    pg_compare_func_generator.h
+//
+//  @doc:
+//    Class with Static member function to generate code for =, <>, <, <=, >
+//    and >= operator, and for the larger/smaller functions built on them
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_PG_COMPARE_FUNC_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_PG_COMPARE_FUNC_GENERATOR_H_
+
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <memory>
+
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/pg_func_generator_interface.h"
+
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Comparison performed by PGCompareFuncGenerator
+ **/
+enum class PGCompareOp {
+  kEQ = 0,
+  kNE,
+  kLT,
+  kLE,
+  kGT,
+  kGE
+};
+
+/**
+ * @brief Class with Static member function to generate code for comparison
+ *        operators, including cross-type ones (e.g. int24lt, float48eq).
+ *
+ * Both arguments are first promoted to CmpType. Integers use signed
+ * comparisons; floating point values follow float8_cmp_internal(), i.e. NaN
+ * is equal to NaN and larger than any non-NaN value.
+ *
+ * @tparam CmpType  Common type both arguments are compared in
+ * @tparam Arg0     First argument's type
+ * @tparam Arg1     Second argument's type
+ **/
+template <typename CmpType, typename Arg0, typename Arg1>
+class PGCompareFuncGenerator {
+ public:
+  static bool EQ(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return Compare(codegen_utils, PGCompareOp::kEQ,
+                   pg_func_info, llvm_out_value);
+  }
+
+  static bool NE(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return Compare(codegen_utils, PGCompareOp::kNE,
+                   pg_func_info, llvm_out_value);
+  }
+
+  static bool LT(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return Compare(codegen_utils, PGCompareOp::kLT,
+                   pg_func_info, llvm_out_value);
+  }
+
+  static bool LE(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return Compare(codegen_utils, PGCompareOp::kLE,
+                   pg_func_info, llvm_out_value);
+  }
+
+  static bool GT(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return Compare(codegen_utils, PGCompareOp::kGT,
+                   pg_func_info, llvm_out_value);
+  }
+
+  static bool GE(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return Compare(codegen_utils, PGCompareOp::kGE,
+                   pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Return the larger argument, e.g. int4larger() or float8larger().
+   *        Arg0 and Arg1 are expected to be CmpType.
+   **/
+  static bool Larger(gpcodegen::GpCodegenUtils* codegen_utils,
+                     const PGFuncGeneratorInfo& pg_func_info,
+                     llvm::Value** llvm_out_value) {
+    return Select(codegen_utils, PGCompareOp::kGT,
+                  pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Return the smaller argument, e.g. int4smaller() or
+   *        float8smaller(). Arg0 and Arg1 are expected to be CmpType.
+   **/
+  static bool Smaller(gpcodegen::GpCodegenUtils* codegen_utils,
+                      const PGFuncGeneratorInfo& pg_func_info,
+                      llvm::Value** llvm_out_value) {
+    return Select(codegen_utils, PGCompareOp::kLT,
+                  pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Create LLVM instructions for the given comparison
+   *
+   * @param codegen_utils     Utility to easy code generation.
+   * @param op                Comparison to generate
+   * @param pg_func_info      Details of pgfunc (arguments, main function,
+   *                          error block)
+   * @param llvm_out_value    Store the results of function
+   *
+   * @return true if generation was successful otherwise return false
+   **/
+  static bool Compare(gpcodegen::GpCodegenUtils* codegen_utils,
+                      PGCompareOp op,
+                      const PGFuncGeneratorInfo& pg_func_info,
+                      llvm::Value** llvm_out_value);
+
+ private:
+  // Pick the first argument if "arg0 op arg1" holds, the second otherwise.
+  static bool Select(gpcodegen::GpCodegenUtils* codegen_utils,
+                     PGCompareOp op,
+                     const PGFuncGeneratorInfo& pg_func_info,
+                     llvm::Value** llvm_out_value);
+
+  static llvm::Value* CompareIntegers(llvm::IRBuilder<>* irb,
+                                      PGCompareOp op,
+                                      llvm::Value* llvm_arg0,
+                                      llvm::Value* llvm_arg1);
+
+  static llvm::Value* CompareFloats(llvm::IRBuilder<>* irb,
+                                    PGCompareOp op,
+                                    llvm::Value* llvm_arg0,
+                                    llvm::Value* llvm_arg1);
+};
+
+template <typename CmpType, typename Arg0, typename Arg1>
+bool PGCompareFuncGenerator<CmpType, Arg0, Arg1>::Compare(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    PGCompareOp op,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  assert(nullptr != llvm_out_value);
+  // Assumed caller checked vector size and nullptr for codegen_utils
+  llvm::Value* casted_arg0 =
+      codegen_utils->CreateCast<CmpType, Arg0>(pg_func_info.llvm_args[0]);
+  llvm::Value* casted_arg1 =
+      codegen_utils->CreateCast<CmpType, Arg1>(pg_func_info.llvm_args[1]);
+
+  llvm::IRBuilder<>* irb = codegen_utils->ir_builder();
+  if (std::is_integral<CmpType>::value) {
+    *llvm_out_value = CompareIntegers(irb, op, casted_arg0, casted_arg1);
+  } else {
+    *llvm_out_value = CompareFloats(irb, op, casted_arg0, casted_arg1);
+  }
+  return nullptr != *llvm_out_value;
+}
+
+template <typename CmpType, typename Arg0, typename Arg1>
+bool PGCompareFuncGenerator<CmpType, Arg0, Arg1>::Select(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    PGCompareOp op,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  assert(nullptr != llvm_out_value);
+  static_assert(std::is_same<CmpType, Arg0>::value &&
+                std::is_same<CmpType, Arg1>::value,
+                "larger/smaller take two arguments of the same type");
+  llvm::Value* llvm_cmp = nullptr;
+  if (!Compare(codegen_utils, op, pg_func_info, &llvm_cmp)) {
+    return false;
+  }
+  *llvm_out_value = codegen_utils->ir_builder()->CreateSelect(
+      llvm_cmp, pg_func_info.llvm_args[0], pg_func_info.llvm_args[1]);
+  return true;
+}
+
+template <typename CmpType, typename Arg0, typename Arg1>
+llvm::Value* PGCompareFuncGenerator<CmpType, Arg0, Arg1>::CompareIntegers(
+    llvm::IRBuilder<>* irb,
+    PGCompareOp op,
+    llvm::Value* llvm_arg0,
+    llvm::Value* llvm_arg1) {
+  switch (op) {
+    case PGCompareOp::kEQ:
+      return irb->CreateICmpEQ(llvm_arg0, llvm_arg1);
+    case PGCompareOp::kNE:
+      return irb->CreateICmpNE(llvm_arg0, llvm_arg1);
+    case PGCompareOp::kLT:
+      return irb->CreateICmpSLT(llvm_arg0, llvm_arg1);
+    case PGCompareOp::kLE:
+      return irb->CreateICmpSLE(llvm_arg0, llvm_arg1);
+    case PGCompareOp::kGT:
+      return irb->CreateICmpSGT(llvm_arg0, llvm_arg1);
+    case PGCompareOp::kGE:
+      return irb->CreateICmpSGE(llvm_arg0, llvm_arg1);
+  }
+  return nullptr;
+}
+
+template <typename CmpType, typename Arg0, typename Arg1>
+llvm::Value* PGCompareFuncGenerator<CmpType, Arg0, Arg1>::CompareFloats(
+    llvm::IRBuilder<>* irb,
+    PGCompareOp op,
+    llvm::Value* llvm_arg0,
+    llvm::Value* llvm_arg1) {
+  // "uno" against itself is true only for NaN
+  llvm::Value* llvm_arg0_isnan = irb->CreateFCmpUNO(llvm_arg0, llvm_arg0);
+  llvm::Value* llvm_arg1_isnan = irb->CreateFCmpUNO(llvm_arg1, llvm_arg1);
+
+  switch (op) {
+    case PGCompareOp::kEQ:
+      return irb->CreateOr(irb->CreateFCmpOEQ(llvm_arg0, llvm_arg1),
+                           irb->CreateAnd(llvm_arg0_isnan, llvm_arg1_isnan));
+    case PGCompareOp::kNE:
+      return irb->CreateNot(
+          irb->CreateOr(irb->CreateFCmpOEQ(llvm_arg0, llvm_arg1),
+                        irb->CreateAnd(llvm_arg0_isnan, llvm_arg1_isnan)));
+    case PGCompareOp::kLT:
+      return irb->CreateOr(irb->CreateFCmpOLT(llvm_arg0, llvm_arg1),
+                           irb->CreateAnd(irb->CreateNot(llvm_arg0_isnan),
+                                          llvm_arg1_isnan));
+    case PGCompareOp::kLE:
+      return irb->CreateOr(irb->CreateFCmpOLE(llvm_arg0, llvm_arg1),
+                           llvm_arg1_isnan);
+    case PGCompareOp::kGT:
+      return irb->CreateOr(irb->CreateFCmpOGT(llvm_arg0, llvm_arg1),
+                           irb->CreateAnd(llvm_arg0_isnan,
+                                          irb->CreateNot(llvm_arg1_isnan)));
+    case PGCompareOp::kGE:
+      return irb->CreateOr(irb->CreateFCmpOGE(llvm_arg0, llvm_arg1),
+                           llvm_arg0_isnan);
+  }
+  return nullptr;
+}
+
+/** @} */
+}  // namespace gpcodegen
+
+#endif  // GPCODEGEN_PG_COMPARE_FUNC_GENERATOR_H_
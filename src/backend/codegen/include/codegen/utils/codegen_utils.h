@@ -46,6 +46,8 @@
 #include "llvm/IR/Value.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 
+namespace llvm { class ObjectCache; }
+
 namespace gpcodegen {
 
 // Forward declaration of helper class for friending purposes.
@@ -429,11 +431,21 @@ class CodegenUtils {
    *        code at the expense of increased compilation time.
    * @param optimize_for_host_cpu If true, LLVM will optimize generated machine
    *        code for the specific CPU model we are running on.
+   * @param object_cache If not NULL, the ExecutionEngine asks it for machine
+   *        code compiled earlier for an identical module before compiling, and
+   *        hands it any newly compiled code. Pointer constants and external
+   *        functions are symbols that are resolved when the code is linked, so
+   *        cached code is valid for a module that refers to different
+   *        addresses. To make identical modules print identically, functions
+   *        defined in the Module are renamed to names that only depend on
+   *        their position; GetFunctionPointer() still accepts the original
+   *        names.
    * @return true if an ExecutionEngine was set up successfully, false if some
    *         error occured.
    **/
   bool PrepareForExecution(const OptimizationLevel cpu_opt_level,
-                           const bool optimize_for_host_cpu);
+                           const bool optimize_for_host_cpu,
+                           llvm::ObjectCache* object_cache = nullptr);
 
   /**
    * @brief Get a pointer to the compiled machine-code version of a function
@@ -451,6 +463,15 @@ class CodegenUtils {
   template <typename FunctionType>
   FunctionType GetFunctionPointer(const std::string& function_name);
 
+  /**
+   * @brief Compile all the Modules to machine code (or load them from the
+   *        object cache) now, rather than when the first function pointer is
+   *        requested.
+   *
+   * @note PrepareForExecution() should be called before calling this method.
+   **/
+  void CompileModules();
+
 
   /**
     * @brief Generate the commonly used "fallback case" that generates a call to
@@ -526,6 +547,7 @@ class CodegenUtils {
 
   static constexpr char kExternalVariableNamePrefix[] = "_gpcodegenv";
   static constexpr char kExternalFunctionNamePrefix[] = "_gpcodegenx";
+  static constexpr char kCanonicalFunctionNamePrefix[] = "_gpcodegenf";
 
   // Used internally when CreateFunction is called. Given the ReturnType
   // and ArgumentTypes this will create an LLVM functions in the module
@@ -566,6 +588,16 @@ class CodegenUtils {
   // Generate a unique name for an external function.
   std::string GenerateExternalFunctionName();
 
+  // Rename every function defined in '*module_' to a name derived from its
+  // position in the module, remembering the original names in
+  // 'function_name_aliases_'.
+  void CanonicalizeFunctionNames();
+
+  // Map a function name given by a caller to the name of the function in the
+  // ExecutionEngine, which differs if CanonicalizeFunctionNames() was called.
+  const std::string& ResolveFunctionName(
+      const std::string& function_name) const;
+
   // Helper method for GetPointerToMember(). This base version does the actual
   // address computation and casting.
   llvm::Value* GetPointerToMemberImpl(llvm::Value* base_ptr,
@@ -624,6 +656,10 @@ class CodegenUtils {
   std::vector<std::pair<const std::string, const std::uint64_t>>
       external_global_variables_;
 
+  // Map of (original_name, canonical_name) for functions renamed by
+  // CanonicalizeFunctionNames().
+  std::unordered_map<std::string, std::string> function_name_aliases_;
+
   // Counters for external variables/functions registered in this CodegenUtils.
   // Used by GenerateExternalVariableName() and GenerateExternalFunctionName(),
   // respectively, to generate unique names for functions/globals.
@@ -1179,7 +1215,7 @@ auto CodegenUtils::GetFunctionPointerImpl(const std::string& function_name)
                       GetFunctionType<ReturnType, ArgumentTypes...>());
 #endif
     return reinterpret_cast<ReturnType (*)(ArgumentTypes...)>(
-        engine_->getFunctionAddress(function_name));
+        engine_->getFunctionAddress(ResolveFunctionName(function_name)));
   } else {
     return nullptr;
   }
@@ -1346,6 +1382,41 @@ typename std::enable_if<std::is_enum<EnumType>::value>::type> {
 template <>
 class ArithOpMaker<float> {
  public:
+  static llvm::Value* CreateAddOverflow(CodegenUtils* generator,
+                                        llvm::Value* arg0,
+                                        llvm::Value* arg1) {
+    Checker(arg0, arg1);
+
+    // TODO(armenatzoglou) Support overflow
+    return generator->ir_builder()->CreateFAdd(arg0, arg1);
+  }
+
+  static llvm::Value* CreateSubOverflow(CodegenUtils* generator,
+                                        llvm::Value* arg0,
+                                        llvm::Value* arg1) {
+    Checker(arg0, arg1);
+
+    // TODO(armenatzoglou) Support overflow
+    return generator->ir_builder()->CreateFSub(arg0, arg1);
+  }
+
+  static llvm::Value* CreateMulOverflow(CodegenUtils* generator,
+                                        llvm::Value* arg0,
+                                        llvm::Value* arg1) {
+    Checker(arg0, arg1);
+
+    // TODO(armenatzoglou) Support overflow
+    return generator->ir_builder()->CreateFMul(arg0, arg1);
+  }
+
+ private:
+  static void Checker(llvm::Value* arg0,
+                      llvm::Value* arg1) {
+    assert(nullptr != arg0 && nullptr != arg0->getType());
+    assert(nullptr != arg1 && nullptr != arg1->getType());
+    assert(arg0->getType()->isFloatTy());
+    assert(arg1->getType()->isFloatTy());
+  }
 };
 
 // Explicit specialization for 64-bit double.
@@ -0,0 +1,113 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    null_test_expr_tree_generator.cc
+//
+//  @doc:
+//    Object that generate code for NULL test expression.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <memory>
+#include <utility>
+
+#include "codegen/expr_tree_generator.h"
+#include "codegen/null_test_expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "utils/elog.h"
+#include "nodes/nodes.h"
+#include "nodes/primnodes.h"
+}
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+using gpcodegen::NullTestExprTreeGenerator;
+using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
+
+bool NullTestExprTreeGenerator::VerifyAndCreateExprTree(
+    const ExprState* expr_state,
+    ExprTreeGeneratorInfo* gen_info,
+    std::unique_ptr<ExprTreeGenerator>* expr_tree) {
+  assert(nullptr != expr_state &&
+         nullptr != expr_state->expr &&
+         T_NullTest == nodeTag(expr_state->expr) &&
+         nullptr != expr_tree);
+
+  expr_tree->reset(nullptr);
+  const NullTestState* null_test_state =
+      reinterpret_cast<const NullTestState*>(expr_state);
+  // Row-valued NULL tests look into every column of the composite datum.
+  if (null_test_state->argisrow) {
+    elog(DEBUG1, "Unsupported NULL test on a row value.");
+    return false;
+  }
+
+  assert(nullptr != null_test_state->arg);
+  std::unique_ptr<ExprTreeGenerator> arg(nullptr);
+  if (!ExprTreeGenerator::VerifyAndCreateExprTree(null_test_state->arg,
+                                                  gen_info,
+                                                  &arg)) {
+    return false;
+  }
+  assert(nullptr != arg);
+  expr_tree->reset(new NullTestExprTreeGenerator(expr_state, std::move(arg)));
+  return true;
+}
+
+NullTestExprTreeGenerator::NullTestExprTreeGenerator(
+    const ExprState* expr_state,
+    std::unique_ptr<ExprTreeGenerator>&& arg)  // NOLINT(build/c++11)
+    :  ExprTreeGenerator(expr_state, ExprTreeNodeType::kNullTest),
+       arg_(std::move(arg)) {
+}
+
+bool NullTestExprTreeGenerator::GenerateCode(
+    GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    llvm::Value* llvm_isnull_ptr,
+    llvm::Value** llvm_out_value) {
+  assert(nullptr != llvm_out_value);
+  *llvm_out_value = nullptr;
+  NullTest* null_test = reinterpret_cast<NullTest*>(expr_state()->expr);
+
+  llvm::Value* llvm_arg = nullptr;
+  llvm::Value* llvm_arg_isnull = nullptr;
+  if (!GenerateArgumentCode(codegen_utils,
+                            gen_info,
+                            arg_.get(),
+                            &llvm_arg,
+                            &llvm_arg_isnull)) {
+    return false;
+  }
+
+  auto irb = codegen_utils->ir_builder();
+  llvm::Value* llvm_result = nullptr;
+  switch (null_test->nulltesttype) {
+    case IS_NULL:
+      llvm_result = llvm_arg_isnull;
+      break;
+    case IS_NOT_NULL:
+      llvm_result = irb->CreateNot(llvm_arg_isnull);
+      break;
+    default:
+      elog(WARNING, "Unsupported NULL test type %d.",
+           null_test->nulltesttype);
+      return false;
+  }
+
+  // The result of a NULL test is never NULL.
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+  *llvm_out_value = codegen_utils->CreateCppTypeToDatumCast(llvm_result);
+  return true;
+}
@@ -13,6 +13,7 @@
 #include <assert.h>
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -24,6 +25,7 @@
 #include "codegen/pg_func_generator_interface.h"
 #include "codegen/utils/gp_codegen_utils.h"
 #include "codegen/pg_arith_func_generator.h"
+#include "codegen/pg_compare_func_generator.h"
 #include "codegen/pg_date_func_generator.h"
 
 #include "llvm/IR/IRBuilder.h"
@@ -48,57 +50,136 @@ using gpcodegen::GpCodegenUtils;
 using gpcodegen::PGFuncGeneratorInterface;
 using gpcodegen::PGFuncGenerator;
 using gpcodegen::CodeGenFuncMap;
+using gpcodegen::PGArithFuncGenerator;
+using gpcodegen::PGCompareFuncGenerator;
+using gpcodegen::PGDateFuncGenerator;
+using gpcodegen::PGGenericFuncGenerator;
 using llvm::IRBuilder;
 
 CodeGenFuncMap
 OpExprTreeGenerator::supported_function_;
 
+template <typename Arg0, typename Arg1>
+void OpExprTreeGenerator::RegisterFunction(unsigned int pg_func_oid,
+                                           const std::string& pg_func_name,
+                                           PGFuncGenerator func_ptr) {
+  supported_function_[pg_func_oid] = std::unique_ptr<PGFuncGeneratorInterface>(
+      new PGGenericFuncGenerator<Arg0, Arg1>(pg_func_oid,
+                                             pg_func_name,
+                                             func_ptr));
+}
+
+template <typename rtype, typename Arg0, typename Arg1>
+void OpExprTreeGenerator::RegisterArithFunctions(
+    const std::string& pg_func_prefix,
+    unsigned int pl_oid,
+    unsigned int mi_oid,
+    unsigned int mul_oid,
+    unsigned int div_oid) {
+  using ArithGenerator = PGArithFuncGenerator<rtype, Arg0, Arg1>;
+  RegisterFunction<Arg0, Arg1>(pl_oid, pg_func_prefix + "pl",
+                               &ArithGenerator::AddWithOverflow);
+  RegisterFunction<Arg0, Arg1>(mi_oid, pg_func_prefix + "mi",
+                               &ArithGenerator::SubWithOverflow);
+  RegisterFunction<Arg0, Arg1>(mul_oid, pg_func_prefix + "mul",
+                               &ArithGenerator::MulWithOverflow);
+  RegisterFunction<Arg0, Arg1>(div_oid, pg_func_prefix + "div",
+                               &ArithGenerator::DivWithCheck);
+}
+
+template <typename CmpType, typename Arg0, typename Arg1>
+void OpExprTreeGenerator::RegisterCompareFunctions(
+    const std::string& pg_func_prefix,
+    unsigned int eq_oid,
+    unsigned int ne_oid,
+    unsigned int lt_oid,
+    unsigned int le_oid,
+    unsigned int gt_oid,
+    unsigned int ge_oid) {
+  using CompareGenerator = PGCompareFuncGenerator<CmpType, Arg0, Arg1>;
+  RegisterFunction<Arg0, Arg1>(eq_oid, pg_func_prefix + "eq",
+                               &CompareGenerator::EQ);
+  RegisterFunction<Arg0, Arg1>(ne_oid, pg_func_prefix + "ne",
+                               &CompareGenerator::NE);
+  RegisterFunction<Arg0, Arg1>(lt_oid, pg_func_prefix + "lt",
+                               &CompareGenerator::LT);
+  RegisterFunction<Arg0, Arg1>(le_oid, pg_func_prefix + "le",
+                               &CompareGenerator::LE);
+  RegisterFunction<Arg0, Arg1>(gt_oid, pg_func_prefix + "gt",
+                               &CompareGenerator::GT);
+  RegisterFunction<Arg0, Arg1>(ge_oid, pg_func_prefix + "ge",
+                               &CompareGenerator::GE);
+}
+
 void OpExprTreeGenerator::InitializeSupportedFunction() {
   if (!supported_function_.empty()) { return; }
 
-  supported_function_[141] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<int32_t, int32_t>(
-          141,
-          "int4mul",
-          &PGArithFuncGenerator<int32_t, int32_t, int32_t>::MulWithOverflow));
-
-  supported_function_[149] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGIRBuilderFuncGenerator<decltype(&IRBuilder<>::CreateICmpSLE),
-      int32_t, int32_t>(149, "int4le", &IRBuilder<>::CreateICmpSLE));
-
-  supported_function_[177] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<int32_t, int32_t>(
-          177,
-          "int4pl",
-          &PGArithFuncGenerator<int32_t, int32_t, int32_t>::AddWithOverflow));
-
-  supported_function_[181] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<int32_t, int32_t>(
-          181,
-          "int4mi",
-          &PGArithFuncGenerator<int32_t, int32_t, int32_t>::SubWithOverflow));
-
-  supported_function_[216] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<float8, float8>(
-          216,
-          "float8mul",
-          &PGArithFuncGenerator<float8, float8, float8>::MulWithOverflow));
-
-  supported_function_[218] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<float8, float8>(
-          218,
-          "float8pl",
-          &PGArithFuncGenerator<float8, float8, float8>::AddWithOverflow));
-
-  supported_function_[219] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<float8, float8>(
-          219,
-          "float8mi",
-          &PGArithFuncGenerator<float8, float8, float8>::SubWithOverflow));
-
-  supported_function_[1088] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGIRBuilderFuncGenerator<decltype(&IRBuilder<>::CreateICmpSLE),
-      int32_t, int32_t>(1088, "date_le", &IRBuilder<>::CreateICmpSLE));
+  // Operators are stored in pg_proc table. See pg_proc.h for the oids.
+
+  // Arithmetic: +, -, * and /
+  RegisterArithFunctions<int16_t, int16_t, int16_t>(
+      "int2", 176, 180, 152, 153);
+  RegisterArithFunctions<int32_t, int32_t, int32_t>(
+      "int4", 177, 181, 141, 154);
+  RegisterArithFunctions<int64_t, int64_t, int64_t>(
+      "int8", 463, 464, 465, 466);
+  RegisterArithFunctions<int32_t, int16_t, int32_t>(
+      "int24", 178, 182, 170, 172);
+  RegisterArithFunctions<int32_t, int32_t, int16_t>(
+      "int42", 179, 183, 171, 173);
+  RegisterArithFunctions<int64_t, int32_t, int64_t>(
+      "int48", 1278, 1279, 1280, 1281);
+  RegisterArithFunctions<int64_t, int64_t, int32_t>(
+      "int84", 1274, 1275, 1276, 1277);
+  RegisterArithFunctions<float, float, float>(
+      "float4", 204, 205, 202, 203);
+  RegisterArithFunctions<float8, float8, float8>(
+      "float8", 218, 219, 216, 217);
+  RegisterArithFunctions<float8, float, float8>(
+      "float48", 281, 282, 279, 280);
+  RegisterArithFunctions<float8, float8, float>(
+      "float84", 285, 286, 283, 284);
+
+  // Comparison: =, <>, <, <=, > and >=
+  RegisterCompareFunctions<int16_t, int16_t, int16_t>(
+      "int2", 63, 145, 64, 148, 146, 151);
+  RegisterCompareFunctions<int32_t, int32_t, int32_t>(
+      "int4", 65, 144, 66, 149, 147, 150);
+  RegisterCompareFunctions<int64_t, int64_t, int64_t>(
+      "int8", 467, 468, 469, 471, 470, 472);
+  RegisterCompareFunctions<int32_t, int16_t, int32_t>(
+      "int24", 158, 164, 160, 166, 162, 168);
+  RegisterCompareFunctions<int32_t, int32_t, int16_t>(
+      "int42", 159, 165, 161, 167, 163, 169);
+  RegisterCompareFunctions<int64_t, int16_t, int64_t>(
+      "int28", 1850, 1851, 1852, 1854, 1853, 1855);
+  RegisterCompareFunctions<int64_t, int64_t, int16_t>(
+      "int82", 1856, 1857, 1858, 1860, 1859, 1861);
+  RegisterCompareFunctions<int64_t, int32_t, int64_t>(
+      "int48", 852, 853, 854, 856, 855, 857);
+  RegisterCompareFunctions<int64_t, int64_t, int32_t>(
+      "int84", 474, 475, 476, 478, 477, 479);
+  RegisterCompareFunctions<float, float, float>(
+      "float4", 287, 288, 289, 290, 291, 292);
+  RegisterCompareFunctions<float8, float8, float8>(
+      "float8", 293, 294, 295, 296, 297, 298);
+  RegisterCompareFunctions<float8, float, float8>(
+      "float48", 299, 300, 301, 302, 303, 304);
+  RegisterCompareFunctions<float8, float8, float>(
+      "float84", 305, 306, 307, 308, 309, 310);
+
+  // DateADT is a plain int32 day count.
+  RegisterCompareFunctions<int32_t, int32_t, int32_t>(
+      "date_", 1086, 1091, 1087, 1088, 1089, 1090);
+
+#ifdef HAVE_INT64_TIMESTAMP
+  // Timestamps are plain int64 microsecond counts only with integer
+  // datetimes; otherwise they are doubles compared by timestamp_cmp_internal.
+  RegisterCompareFunctions<int64_t, int64_t, int64_t>(
+      "timestamp_", 2052, 2053, 2054, 2055, 2057, 2056);
+  RegisterCompareFunctions<int64_t, int64_t, int64_t>(
+      "timestamptz_", 1152, 1153, 1154, 1155, 1157, 1156);
+#endif
 
   supported_function_[2339] = std::unique_ptr<PGFuncGeneratorInterface>(
       new PGGenericFuncGenerator<int32_t, int64_t>(
@@ -189,19 +270,37 @@ bool OpExprTreeGenerator::GenerateCode(GpCodegenUtils* codegen_utils,
          pg_func_interface->GetTotalArgCount());
     return false;
   }
-  bool arg_generated = true;
+  auto irb = codegen_utils->ir_builder();
+
+  // All supported operators are strict: evaluate every argument with its own
+  // null flag and only call the operator when none of them is NULL.
   std::vector<llvm::Value*> llvm_arguments;
+  llvm::Value* llvm_any_arg_isnull = codegen_utils->GetConstant<bool>(false);
   for (auto& arg : arguments_) {
     llvm::Value* llvm_arg = nullptr;
-    arg_generated &= arg->GenerateCode(codegen_utils,
-                                       gen_info,
-                                       llvm_isnull_ptr,
-                                       &llvm_arg);
-    if (!arg_generated) {
+    llvm::Value* llvm_arg_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils,
+                              gen_info,
+                              arg.get(),
+                              &llvm_arg,
+                              &llvm_arg_isnull)) {
       return false;
     }
     llvm_arguments.push_back(llvm_arg);
+    llvm_any_arg_isnull = irb->CreateOr(llvm_any_arg_isnull, llvm_arg_isnull);
   }
+  irb->CreateStore(llvm_any_arg_isnull, llvm_isnull_ptr);
+
+  llvm::BasicBlock* llvm_op_block = codegen_utils->CreateBasicBlock(
+      "op_expr_block", gen_info.llvm_main_func);
+  llvm::BasicBlock* llvm_null_block = codegen_utils->CreateBasicBlock(
+      "op_expr_null_block", gen_info.llvm_main_func);
+  llvm::BasicBlock* llvm_merge_block = codegen_utils->CreateBasicBlock(
+      "op_expr_merge_block", gen_info.llvm_main_func);
+
+  irb->CreateCondBr(llvm_any_arg_isnull, llvm_null_block, llvm_op_block);
+
+  irb->SetInsertPoint(llvm_op_block);
   llvm::Value* llvm_op_value = nullptr;
   PGFuncGeneratorInfo pg_func_info(gen_info.llvm_main_func,
                                    gen_info.llvm_error_block,
@@ -209,7 +308,24 @@ bool OpExprTreeGenerator::GenerateCode(GpCodegenUtils* codegen_utils,
   bool retval = pg_func_interface->GenerateCode(codegen_utils,
                                                 pg_func_info,
                                                 &llvm_op_value);
+  if (!retval || nullptr == llvm_op_value) {
+    return false;
+  }
   // convert return type to Datum
-  *llvm_out_value = codegen_utils->CreateCppTypeToDatumCast(llvm_op_value);
+  llvm::Value* llvm_op_datum =
+      codegen_utils->CreateCppTypeToDatumCast(llvm_op_value);
+  // Operator generation may have created new blocks.
+  llvm::BasicBlock* llvm_op_end_block = irb->GetInsertBlock();
+  irb->CreateBr(llvm_merge_block);
+
+  irb->SetInsertPoint(llvm_null_block);
+  irb->CreateBr(llvm_merge_block);
+
+  irb->SetInsertPoint(llvm_merge_block);
+  llvm::PHINode* llvm_result = irb->CreatePHI(llvm_op_datum->getType(), 2);
+  llvm_result->addIncoming(llvm_op_datum, llvm_op_end_block);
+  llvm_result->addIncoming(codegen_utils->GetConstant<Datum>(0),
+                           llvm_null_block);
+  *llvm_out_value = llvm_result;
   return retval;
 }
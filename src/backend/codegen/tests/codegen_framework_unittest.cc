@@ -16,12 +16,14 @@
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <chrono>
 #include <cstdio>
 #include <ctime>
 #include <initializer_list>
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -63,6 +65,7 @@ extern "C" {
 #include "codegen/base_codegen.h"
 
 extern bool codegen_validate_functions;
+extern bool codegen_async_compile;
 using gpcodegen::GpCodegenUtils;
 namespace gpcodegen {
 
@@ -338,6 +341,7 @@ class CodegenManagerTest : public ::testing::Test {
   virtual void SetUp() {
     manager_.reset(new CodegenManager("CodegenManagerTest"));
     codegen_validate_functions = true;
+    codegen_async_compile = false;
   }
 
   template <typename ClassType, typename FuncType>
@@ -621,6 +625,46 @@ TEST_F(CodegenManagerTest, ResetTest) {
   ASSERT_TRUE(SumFuncRegular == sum_func_ptr);
 }
 
+TEST_F(CodegenManagerTest, AsyncCompileTest) {
+  codegen_async_compile = true;
+  sum_func_ptr = nullptr;
+  EnrollCodegen<SumCodeGenerator, SumFunc>(SumFuncRegular, &sum_func_ptr);
+  EXPECT_EQ(1, manager_->GenerateCode());
+
+  // The module is compiled on the compiler thread, so no function is swapped
+  // in yet as far as the caller knows
+  EXPECT_EQ(0, manager_->PrepareGeneratedFunctions());
+  EXPECT_EQ(3, sum_func_ptr(1, 2));
+
+  // Wait for the compiler thread to swap in the generated function
+  for (int i = 0; i < 1000 && SumFuncRegular == sum_func_ptr; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_TRUE(SumFuncRegular != sum_func_ptr);
+  EXPECT_EQ(3, sum_func_ptr(1, 2));
+
+  // Destroying the manager restores the regular version
+  manager_.reset(nullptr);
+  ASSERT_TRUE(SumFuncRegular == sum_func_ptr);
+  codegen_async_compile = false;
+}
+
+TEST_F(CodegenManagerTest, AsyncCompileDestroyedManagerTest) {
+  codegen_async_compile = true;
+  sum_func_ptr = nullptr;
+  EnrollCodegen<SumCodeGenerator, SumFunc>(SumFuncRegular, &sum_func_ptr);
+  EXPECT_EQ(1, manager_->GenerateCode());
+  EXPECT_EQ(0, manager_->PrepareGeneratedFunctions());
+
+  // Destroy the manager while the module may still be compiling. The
+  // compiler thread must not swap in the generated function afterwards.
+  manager_.reset(nullptr);
+  ASSERT_TRUE(SumFuncRegular == sum_func_ptr);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  ASSERT_TRUE(SumFuncRegular == sum_func_ptr);
+  codegen_async_compile = false;
+}
+
 TEST_F(CodegenManagerTest, TestDatumBoolCast) {
   CheckDatumCast<bool>(BoolGetDatum,
                        DatumGetBool,
@@ -33,6 +33,7 @@
 #include "gtest/gtest.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/APInt.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/IR/Argument.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/Constant.h"
@@ -47,6 +48,7 @@
 #include "llvm/IR/Value.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 namespace gpcodegen {
 
@@ -187,6 +189,46 @@ class StaticIntWrapper {
 
 int StaticIntWrapper::wrapped_value_;
 
+// ObjectCache that remembers the last compiled object and hands it out for
+// every module, whatever the module contains.
+class SingleObjectCache : public llvm::ObjectCache {
+ public:
+  SingleObjectCache()
+      : compiled_count_(0),
+        loaded_count_(0) {
+  }
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override {
+    ++compiled_count_;
+    object_ = llvm::MemoryBuffer::getMemBufferCopy(
+        object.getBuffer(), object.getBufferIdentifier());
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override {
+    if (!object_) {
+      return nullptr;
+    }
+    ++loaded_count_;
+    return llvm::MemoryBuffer::getMemBufferCopy(
+        object_->getBuffer(), object_->getBufferIdentifier());
+  }
+
+  int compiled_count() const {
+    return compiled_count_;
+  }
+
+  int loaded_count() const {
+    return loaded_count_;
+  }
+
+ private:
+  std::unique_ptr<llvm::MemoryBuffer> object_;
+  int compiled_count_;
+  int loaded_count_;
+};
+
 // Toy object used to test instance method invocation.
 template <typename T>
 class Accumulator {
@@ -2777,6 +2819,64 @@ TEST_F(CodegenUtilsTest, OptimizationTest) {
   EXPECT_EQ(758, (*add3_compiled)(12, -67, 813));
 }
 
+// Test that object code compiled for one module can be linked in place of
+// another module with the same code but different function names and pointer
+// constants.
+TEST_F(CodegenUtilsTest, ObjectCacheTest) {
+  typedef int (*LoadFn) ();
+  int first_value = 42;
+  int second_value = -7;
+  SingleObjectCache object_cache;
+
+  // Create a function that returns the int pointed to by a constant.
+  llvm::Function* first_func
+      = codegen_utils_->CreateFunction<LoadFn>("load_first");
+  llvm::BasicBlock* first_body
+      = codegen_utils_->CreateBasicBlock("body", first_func);
+  codegen_utils_->ir_builder()->SetInsertPoint(first_body);
+  codegen_utils_->ir_builder()->CreateRet(
+      codegen_utils_->ir_builder()->CreateLoad(
+          codegen_utils_->GetConstant(&first_value)));
+
+  EXPECT_TRUE(codegen_utils_->PrepareForExecution(
+      CodegenUtils::OptimizationLevel::kNone,
+      true,
+      &object_cache));
+  LoadFn first_compiled
+      = codegen_utils_->GetFunctionPointer<LoadFn>("load_first");
+  ASSERT_NE(first_compiled, nullptr);
+  EXPECT_EQ(42, (*first_compiled)());
+  EXPECT_EQ(1, object_cache.compiled_count());
+  EXPECT_EQ(0, object_cache.loaded_count());
+
+  // Generate the same code under another name for another address.
+  CodegenUtils second_codegen_utils("second_test_module");
+  llvm::Function* second_func
+      = second_codegen_utils.CreateFunction<LoadFn>("load_second");
+  llvm::BasicBlock* second_body
+      = second_codegen_utils.CreateBasicBlock("body", second_func);
+  second_codegen_utils.ir_builder()->SetInsertPoint(second_body);
+  second_codegen_utils.ir_builder()->CreateRet(
+      second_codegen_utils.ir_builder()->CreateLoad(
+          second_codegen_utils.GetConstant(&second_value)));
+
+  // The cached object is used instead of compiling the module, and its
+  // reference to the pointer constant is resolved to the new address.
+  EXPECT_TRUE(second_codegen_utils.PrepareForExecution(
+      CodegenUtils::OptimizationLevel::kNone,
+      true,
+      &object_cache));
+  LoadFn second_compiled
+      = second_codegen_utils.GetFunctionPointer<LoadFn>("load_second");
+  ASSERT_NE(second_compiled, nullptr);
+  EXPECT_EQ(-7, (*second_compiled)());
+  EXPECT_EQ(1, object_cache.compiled_count());
+  EXPECT_EQ(1, object_cache.loaded_count());
+
+  // The first function is unaffected.
+  EXPECT_EQ(42, (*first_compiled)());
+}
+
 // Test code-generation used with instance methods of a statically compiled C++
 // class.
 TEST_F(CodegenUtilsTest, CppClassObjectTest) {
@@ -31,6 +31,7 @@
 // DO NOT REMOVE: including the MCJIT.h header forces the MCJIT engine to be
 // linked in when using static libraries.
 #include "llvm/ExecutionEngine/MCJIT.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/GlobalValue.h"
@@ -80,6 +81,7 @@ inline llvm::CodeGenOpt::Level OptLevelCodegenToLLVM(
 
 constexpr char CodegenUtils::kExternalVariableNamePrefix[];
 constexpr char CodegenUtils::kExternalFunctionNamePrefix[];
+constexpr char CodegenUtils::kCanonicalFunctionNamePrefix[];
 
 CodegenUtils::CodegenUtils(llvm::StringRef module_name)
     : ir_builder_(context_),
@@ -201,7 +203,8 @@ bool CodegenUtils::Optimize(const OptimizationLevel generic_opt_level,
 }
 
 bool CodegenUtils::PrepareForExecution(const OptimizationLevel cpu_opt_level,
-                                        const bool optimize_for_host_cpu) {
+                                        const bool optimize_for_host_cpu,
+                                        llvm::ObjectCache* object_cache) {
   if (engine_.get() != nullptr) {
     // This method was already called successfully.
     return false;
@@ -212,6 +215,15 @@ bool CodegenUtils::PrepareForExecution(const OptimizationLevel cpu_opt_level,
     return false;
   }
 
+  // Code in auxiliary modules may refer to functions in the main module by
+  // their original names, so those are never renamed or cached.
+  if (!auxiliary_modules_.empty()) {
+    object_cache = nullptr;
+  }
+  if (object_cache != nullptr) {
+    CanonicalizeFunctionNames();
+  }
+
   llvm::EngineBuilder builder(std::move(module_));
   builder.setEngineKind(llvm::EngineKind::JIT);
   builder.setOptLevel(OptLevelCodegenToLLVM(cpu_opt_level));
@@ -224,6 +236,10 @@ bool CodegenUtils::PrepareForExecution(const OptimizationLevel cpu_opt_level,
     return false;
   }
 
+  if (object_cache != nullptr) {
+    engine_->setObjectCache(object_cache);
+  }
+
   // Add auxiliary modules generated by companion tools to the ExecutionEngine.
   for (std::unique_ptr<llvm::Module>& auxiliary_module : auxiliary_modules_) {
     engine_->addModule(std::move(auxiliary_module));
@@ -263,6 +279,12 @@ bool CodegenUtils::PrepareForExecution(const OptimizationLevel cpu_opt_level,
   return true;
 }
 
+void CodegenUtils::CompileModules() {
+  if (engine_) {
+    engine_->finalizeObject();
+  }
+}
+
 void CodegenUtils::PrintUnderlyingModules(llvm::raw_ostream& out) {
   // Print the main module
   out << "==== MAIN MODULE ====" << "\n";
@@ -300,7 +322,8 @@ void CodegenUtils::CheckFunctionType(
   // Look up function in the ExecutionEngine if PrepareForExecution() has
   // already been called, or in the Module if it has not.
   const llvm::Function* function
-      = engine_ ? engine_->FindFunctionNamed(function_name.c_str())
+      = engine_ ? engine_->FindFunctionNamed(
+                      ResolveFunctionName(function_name).c_str())
                 : module_->getFunction(function_name);
 
   if (function != nullptr) {
@@ -342,6 +365,28 @@ std::string CodegenUtils::GenerateExternalFunctionName() {
   return std::string(print_buffer);
 }
 
+void CodegenUtils::CanonicalizeFunctionNames() {
+  assert(module_.get() != nullptr);
+  unsigned function_counter = 0;
+  for (llvm::Function& function : *module_) {
+    // Declarations are external functions and intrinsics, which are looked up
+    // by name when the module is linked.
+    if (function.isDeclaration()) {
+      continue;
+    }
+    std::string canonical_name = std::string(kCanonicalFunctionNamePrefix)
+        + std::to_string(function_counter++);
+    function_name_aliases_.emplace(function.getName().str(), canonical_name);
+    function.setName(canonical_name);
+  }
+}
+
+const std::string& CodegenUtils::ResolveFunctionName(
+    const std::string& function_name) const {
+  auto it = function_name_aliases_.find(function_name);
+  return it == function_name_aliases_.end() ? function_name : it->second;
+}
+
 llvm::Value* CodegenUtils::GetPointerToMemberImpl(
     llvm::Value* base_ptr,
     llvm::Type* cast_type,
@@ -25,6 +25,7 @@
 #include "catalog/indexing.h"
 #include "catalog/namespace.h"
 #include "catalog/pg_namespace.h"
+#include "catalog/pg_type.h"
 #include "cdb/cdbpartition.h"
 #include "cdb/cdbtm.h"
 #include "cdb/cdbvars.h"
@@ -96,6 +97,10 @@ static int acquire_sample_rows(Relation onerel, HeapTuple *rows,
 					int targrows, double *totalrows, double *totaldeadrows);
 static int acquire_sample_rows_by_query(Relation onerel, int nattrs, VacAttrStats **attrstats, HeapTuple **rows,
 										int targrows, double *totalrows, double *totaldeadrows, BlockNumber *totalpages);
+static void acquire_hll_ndistinct_by_query(Relation onerel, int nattrs, VacAttrStats **attrstats,
+											double *ndistinct);
+static bool hll_supported_type(Oid typid);
+static void apply_hll_ndistinct(VacAttrStats *stats, double ndistinct, double totalrows);
 static double random_fract(void);
 static double init_selection_state(int n);
 static double get_next_S(double t, int n, double *stateptr);
@@ -133,6 +138,7 @@ analyze_rel(Oid relid, VacuumStmt *vacstmt,
 				totaldeadrows;
 	BlockNumber	totalpages;
 	HeapTuple  *rows;
+	double	   *hll_ndistinct;
 	PGRUsage	ru0;
 	TimestampTz starttime = 0;
 	Oid			save_userid;
@@ -392,6 +398,17 @@ analyze_rel(Oid relid, VacuumStmt *vacstmt,
 	numrows = acquire_sample_rows_by_query(onerel, attr_cnt, vacattrstats, &rows, targrows,
 										   &totalrows, &totaldeadrows, &totalpages);
 
+	/*
+	 * If the sample isn't the whole table, the number of distinct values can
+	 * be estimated much better from sketches of all the rows.
+	 */
+	hll_ndistinct = NULL;
+	if (gp_statistics_use_hll && numrows > 0 && numrows < totalrows && attr_cnt > 0)
+	{
+		hll_ndistinct = (double *) palloc(attr_cnt * sizeof(double));
+		acquire_hll_ndistinct_by_query(onerel, attr_cnt, vacattrstats, hll_ndistinct);
+	}
+
 	/*
 	 * Compute the statistics.	Temporary results during the calculations for
 	 * each column are stored in a child context.  The calc routines are
@@ -420,6 +437,8 @@ analyze_rel(Oid relid, VacuumStmt *vacstmt,
 									 std_fetch_func,
 									 numrows,
 									 totalrows);
+			if (hll_ndistinct != NULL)
+				apply_hll_ndistinct(stats, hll_ndistinct[i], totalrows);
 			MemoryContextResetAndDeleteChildren(col_context);
 		}
 
@@ -1501,6 +1520,160 @@ acquire_sample_rows_by_query(Relation onerel, int nattrs, VacAttrStats **attrsta
 	return sampleTuples;
 }
 
+/*
+ * Estimate the number of distinct values of every column with
+ * gp_hll_ndistinct(), which has each segment build a HyperLogLog sketch over
+ * all of its rows.  Only the sketches are sent to the master.
+ *
+ * Only n_distinct comes from the sketches.  The sample is still acquired,
+ * and the MCVs and histograms are still computed from it.
+ *
+ * ndistinct[i] is set to the estimate for attrstats[i], or to -1 if there is
+ * none: if the column's type is not supported, or the table has external
+ * partitions (which we don't want to scan in full).
+ */
+static void
+acquire_hll_ndistinct_by_query(Relation onerel, int nattrs, VacAttrStats **attrstats,
+							   double *ndistinct)
+{
+	StringInfoData str;
+	int			i;
+	int			ret;
+	bool		any = false;
+
+	for (i = 0; i < nattrs; i++)
+		ndistinct[i] = -1.0;
+
+	if (rel_has_external_partition(RelationGetRelid(onerel)))
+		return;
+
+	initStringInfo(&str);
+	appendStringInfo(&str, "select ");
+	for (i = 0; i < nattrs; i++)
+	{
+		if (i != 0)
+			appendStringInfo(&str, ", ");
+		if (hll_supported_type(getBaseType(attrstats[i]->attr->atttypid)))
+		{
+			appendStringInfo(&str, "pg_catalog.gp_hll_ndistinct(Ta.%s)",
+							 quote_identifier(NameStr(attrstats[i]->attr->attname)));
+			any = true;
+		}
+		else
+			appendStringInfo(&str, "NULL::float8");
+	}
+	appendStringInfo(&str, " from %s.%s as Ta",
+					 quote_identifier(get_namespace_name(RelationGetNamespace(onerel))),
+					 quote_identifier(RelationGetRelationName(onerel)));
+
+	if (!any)
+	{
+		pfree(str.data);
+		return;
+	}
+
+	if (SPI_OK_CONNECT != SPI_connect())
+		ereport(ERROR, (errcode(ERRCODE_CDB_INTERNAL_ERROR),
+						errmsg("Unable to connect to execute internal query.")));
+
+	elog(elevel, "Executing SQL: %s", str.data);
+
+	/* As in acquire_sample_rows_by_query(), don't bother with ORCA */
+	{
+		bool		optimizerBackup = optimizer;
+
+		optimizer = false;
+
+		PG_TRY();
+		{
+			ret = SPI_execute(str.data, false, 0);
+			Assert(ret > 0);
+
+			optimizer = optimizerBackup;
+		}
+		PG_CATCH();
+		{
+			optimizer = optimizerBackup;
+			PG_RE_THROW();
+		}
+		PG_END_TRY();
+	}
+
+	if (SPI_processed == 1)
+	{
+		for (i = 0; i < nattrs; i++)
+		{
+			bool		isnull;
+			Datum		d;
+
+			d = heap_getattr(SPI_tuptable->vals[0], i + 1,
+							 SPI_tuptable->tupdesc, &isnull);
+			if (!isnull)
+				ndistinct[i] = DatumGetFloat8(d);
+		}
+	}
+
+	SPI_finish();
+
+	pfree(str.data);
+}
+
+/*
+ * Can gp_hll_ndistinct() be used on values of this type?  It hashes the
+ * binary representation of the values, so only types whose equal values
+ * are always represented alike qualify.  That rules out, for example,
+ * numeric (1.0 = 1.00), interval ('1 day' = '24 hours') and bpchar, whose
+ * comparisons ignore trailing spaces ('a'::char(2) = 'a  '::char(3)).
+ */
+static bool
+hll_supported_type(Oid typid)
+{
+	switch (typid)
+	{
+		case BOOLOID:
+		case CHAROID:
+		case NAMEOID:
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case OIDOID:
+		case DATEOID:
+		case TIMEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+		case TEXTOID:
+		case VARCHAROID:
+		case BYTEAOID:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Replace the n_distinct estimate that compute_stats made from the sample by
+ * the HyperLogLog estimate over all rows, scaled the same way.
+ */
+static void
+apply_hll_ndistinct(VacAttrStats *stats, double ndistinct, double totalrows)
+{
+	double		nonnullrows;
+
+	if (ndistinct < 0 || !stats->stats_valid || totalrows <= 0)
+		return;
+
+	nonnullrows = totalrows * (1.0 - stats->stanullfrac);
+	if (ndistinct > nonnullrows)
+		ndistinct = nonnullrows;
+	if (ndistinct < 1.0)
+		return;
+
+	if (ndistinct > 0.1 * totalrows)
+		stats->stadistinct = -(ndistinct / totalrows);
+	else
+		stats->stadistinct = floor(ndistinct + 0.5);
+}
+
 
 /**
  * This method estimates reltuples/relpages for a relation. To do this, it employs
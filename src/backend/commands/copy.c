@@ -250,6 +250,14 @@ else \
 \
 }
 
+/*
+ * The dispatcher sends rows to a segment in chunks of about this many bytes,
+ * and keeps at most about COPY_DISPATCH_BUFFER_SIZE bytes of chunks for all
+ * segments together, see CopyFromDispatch().
+ */
+#define COPY_DISPATCH_CHUNK_SIZE (64 * 1024)
+#define COPY_DISPATCH_BUFFER_SIZE (1024 * 1024)
+
 /*
  * if in SREH mode and data error occured it was already handled in
  * COPY_HANDLE_ERROR. Therefore, skip to the next row before attempting
@@ -2522,6 +2530,74 @@ static void CopyFromCreateDispatchCommand(CopyState cstate,
 
 }
 
+/*
+ * Evaluate a default expression on the dispatcher, and append the result as
+ * one more field to the data row in cstate->line_buf.  The executor COPY
+ * command lists the column (see CopyFromCreateDispatchCommand), so that
+ * primary and mirror store the same value.
+ */
+static Datum
+CopyFromAppendDefault(CopyState cstate, ExprContext *econtext,
+					  ExprState *defexpr, FmgrInfo *out_function,
+					  Oid typioparam, int32 typmod, bool *isnull)
+{
+	Datum		value;
+	char	   *string;
+
+	value = ExecEvalExpr(defexpr, econtext, isnull, NULL);
+
+	/*
+	 * prepare to concatinate next value:
+	 * remove eol characters from end of line buf
+	 */
+	truncateEol(&cstate->line_buf, cstate->eol_type);
+
+	if (*isnull)
+	{
+		appendStringInfo(&cstate->line_buf, "%c%s", cstate->delim[0], cstate->null_print);
+	}
+	else
+	{
+		appendStringInfo(&cstate->line_buf, "%c", cstate->delim[0]); /* write the delimiter */
+
+		string = DatumGetCString(FunctionCall3(out_function,
+											   value,
+											   ObjectIdGetDatum(typioparam),
+											   Int32GetDatum(typmod)));
+		if (cstate->csv_mode)
+		{
+			CopyAttributeOutCSV(cstate, string,
+								false, /*force_quote[attnum - 1],*/
+								list_length(cstate->attnumlist) == 1);
+		}
+		else
+			CopyAttributeOutText(cstate, string);
+	}
+
+	/* re-add the eol characters */
+	concatenateEol(cstate);
+
+	return value;
+}
+
+/*
+ * Send the rows collected for a segment, if any.  An error is added to
+ * cdbcopy_err, and left in cdbCopy->io_errors for the caller to act on.
+ */
+static void
+CopyFromSendChunk(CdbCopy *cdbCopy, int target_seg, StringInfo chunk,
+				  StringInfo cdbcopy_err)
+{
+	if (chunk->len == 0)
+		return;
+
+	cdbCopySendData(cdbCopy, target_seg, chunk->data, chunk->len);
+	resetStringInfo(chunk);
+
+	if (cdbCopy->io_errors)
+		appendBinaryStringInfo(cdbcopy_err, cdbCopy->err_msg.data, cdbCopy->err_msg.len);
+}
+
 /*
  * Copy FROM file to relation.
  */
@@ -2601,6 +2677,14 @@ CopyFromDispatch(CopyState cstate)
 	StringInfoData line_buf_with_lineno;
 	int			original_lineno_for_qe;
 
+	/*
+	 * Variables for sending rows to segments in chunks
+	 */
+	StringInfoData *seg_chunks = NULL;	/* rows collected for each segment */
+	int			chunk_size = 0;		/* send a segment's rows at this size */
+	bool		dispatch_unparsed = false;	/* send the rows round-robin? */
+	unsigned int chunk_seg = 0;
+
 	/*
 	 * Variables for cdbhash
 	 */
@@ -2877,6 +2961,34 @@ CopyFromDispatch(CopyState cstate)
 		}
 	}
 
+	/*
+	 * Rather than sending every row to its segment on its own, collect the
+	 * rows for each segment and send them in chunks.  The chunks are smaller
+	 * with many segments, to bound the memory they take.
+	 *
+	 * A randomly distributed table may store any row on any segment, so the
+	 * dispatcher needn't parse the rows to route them.  Unless it has to
+	 * parse them anyway, for partitioning or OIDs, only find the line
+	 * boundaries here, and send the chunks to one segment after another.  The
+	 * segments parse the rows as usual.
+	 */
+	if (gp_copy_dispatch_chunks)
+	{
+		seg_chunks = palloc(cdbCopy->total_segs * sizeof(StringInfoData));
+		for (i = 0; i < cdbCopy->total_segs; i++)
+			initStringInfo(&seg_chunks[i]);
+
+		chunk_size = COPY_DISPATCH_BUFFER_SIZE / cdbCopy->total_segs;
+		chunk_size = Min(chunk_size, COPY_DISPATCH_CHUNK_SIZE);
+		chunk_size = Max(chunk_size, 8 * 1024);
+
+		if (p_nattrs == 0 && !estate->es_result_partitions && !cstate->oids)
+		{
+			dispatch_unparsed = true;
+			chunk_seg = cdb_randint(0, cdbCopy->total_segs - 1);
+		}
+	}
+
 	/*
 	 * Dispatch the COPY command.
 	 *
@@ -3097,6 +3209,62 @@ CopyFromDispatch(CopyState cstate)
 						break;
 				}
 
+				if (dispatch_unparsed)
+				{
+					StringInfo	chunk = &seg_chunks[chunk_seg];
+
+					/*
+					 * Non-constant defaults don't depend on the row, so they
+					 * can be added without parsing it.
+					 */
+					PG_TRY();
+					{
+						for (i = 0; i < num_defaults; i++)
+						{
+							if (defexprs[i]->expr->type != T_Const)
+								(void) CopyFromAppendDefault(cstate, econtext, defexprs[i],
+															 &out_functions[defmap[i]],
+															 typioparams[defmap[i]],
+															 attr[defmap[i]]->atttypmod,
+															 &isnull);
+						}
+					}
+					PG_CATCH();
+					{
+						COPY_HANDLE_ERROR;
+					}
+					PG_END_TRY();
+
+					if(cur_row_rejected)
+					{
+						ErrorIfRejectLimitReached(cstate->cdbsreh, cdbCopy);
+						QD_GOTO_NEXT_ROW;
+					}
+
+					appendStringInfo(chunk, "%d%c%d%c%s",
+									 original_lineno_for_qe,
+									 COPY_METADATA_DELIM,
+									 cstate->line_buf_converted,
+									 COPY_METADATA_DELIM,
+									 cstate->line_buf.data);
+					cstate->processed++;
+
+					if (chunk->len >= chunk_size)
+					{
+						CopyFromSendChunk(cdbCopy, chunk_seg, chunk, &cdbcopy_err);
+						chunk_seg = (chunk_seg + 1) % cdbCopy->total_segs;
+
+						if (cdbCopy->io_errors)
+						{
+							no_more_data = true;
+							break;
+						}
+					}
+
+					RESET_LINEBUF;
+					continue;
+				}
+
 				if (file_has_oids)
 				{
 					char	   *oid_string;
@@ -3215,43 +3383,13 @@ CopyFromDispatch(CopyState cstate)
 
 						if(compute_default)
 						{
-							char *string;
-
-							values[defmap[i]] = ExecEvalExpr(defexprs[i], econtext,
-															 &isnull, NULL);
-
-							/*
-							 * prepare to concatinate next value:
-							 * remove eol characters from end of line buf
-							 */
-							truncateEol(&cstate->line_buf, cstate->eol_type);
-
-							if (isnull)
-							{
-								appendStringInfo(&cstate->line_buf, "%c%s", cstate->delim[0], cstate->null_print);
-							}
-							else
-							{
+							values[defmap[i]] = CopyFromAppendDefault(cstate, econtext, defexprs[i],
+																	  &out_functions[defmap[i]],
+																	  typioparams[defmap[i]],
+																	  attr[defmap[i]]->atttypmod,
+																	  &isnull);
+							if (!isnull)
 								nulls[defmap[i]] = false;
-
-								appendStringInfo(&cstate->line_buf, "%c", cstate->delim[0]); /* write the delimiter */
-
-								string = DatumGetCString(FunctionCall3(&out_functions[defmap[i]],
-																	   values[defmap[i]],
-																	   ObjectIdGetDatum(typioparams[defmap[i]]),
-																	   Int32GetDatum(attr[defmap[i]]->atttypmod)));
-								if (cstate->csv_mode)
-								{
-									CopyAttributeOutCSV(cstate, string,
-														false, /*force_quote[attnum - 1],*/
-														list_length(cstate->attnumlist) == 1);
-								}
-								else
-									CopyAttributeOutText(cstate, string);
-							}
-
-							/* re-add the eol characters */
-							concatenateEol(cstate);
 						}
 
 					}
@@ -3428,20 +3566,41 @@ CopyFromDispatch(CopyState cstate)
 				 * modify the data to look like:
 				 *    "<lineno>^<linebuf_converted>^<data>"
 				 */
-				appendStringInfo(&line_buf_with_lineno, "%d%c%d%c%s",
-								 original_lineno_for_qe,
-								 COPY_METADATA_DELIM,
-								 cstate->line_buf_converted, \
-								 COPY_METADATA_DELIM, \
-								 cstate->line_buf.data);
-				
-				/* send modified data */
-				cdbCopySendData(cdbCopy,
-								target_seg,
-								line_buf_with_lineno.data,
-								line_buf_with_lineno.len);
+				if (seg_chunks)
+				{
+					/* add it to the segment's chunk, and send that when full */
+					StringInfo	chunk = &seg_chunks[target_seg];
 
-				RESET_LINEBUF_WITH_LINENO;
+					appendStringInfo(chunk, "%d%c%d%c%s",
+									 original_lineno_for_qe,
+									 COPY_METADATA_DELIM,
+									 cstate->line_buf_converted,
+									 COPY_METADATA_DELIM,
+									 cstate->line_buf.data);
+
+					if (chunk->len >= chunk_size)
+						CopyFromSendChunk(cdbCopy, target_seg, chunk, &cdbcopy_err);
+				}
+				else
+				{
+					appendStringInfo(&line_buf_with_lineno, "%d%c%d%c%s",
+									 original_lineno_for_qe,
+									 COPY_METADATA_DELIM,
+									 cstate->line_buf_converted, \
+									 COPY_METADATA_DELIM, \
+									 cstate->line_buf.data);
+
+					/* send modified data */
+					cdbCopySendData(cdbCopy,
+									target_seg,
+									line_buf_with_lineno.data,
+									line_buf_with_lineno.len);
+
+					RESET_LINEBUF_WITH_LINENO;
+
+					if (cdbCopy->io_errors)
+						appendBinaryStringInfo(&cdbcopy_err, cdbCopy->err_msg.data, cdbCopy->err_msg.len);
+				}
 
 				cstate->processed++;
 				if (estate->es_result_partitions)
@@ -3449,7 +3608,6 @@ CopyFromDispatch(CopyState cstate)
 
 				if (cdbCopy->io_errors)
 				{
-					appendBinaryStringInfo(&cdbcopy_err, cdbCopy->err_msg.data, cdbCopy->err_msg.len);
 					no_more_data = true;
 					break;
 				}
@@ -3465,6 +3623,18 @@ CopyFromDispatch(CopyState cstate)
 		}
 	} while (!no_more_data);
 
+	/* Send the rows still collected for the segments */
+	if (seg_chunks)
+	{
+		for (i = 0; i < cdbCopy->total_segs; i++)
+		{
+			if (!cdbCopy->io_errors)
+				CopyFromSendChunk(cdbCopy, i, &seg_chunks[i], &cdbcopy_err);
+			pfree(seg_chunks[i].data);
+		}
+		pfree(seg_chunks);
+	}
+
 	/* Free p_attr_types */
 	pfree(p_attr_types);
 
@@ -33,6 +33,7 @@
 #include "tcop/tcopprot.h"
 #include "tcop/utility.h"
 #include "utils/builtins.h"
+#include "utils/guc.h"
 #include "utils/memutils.h"
 
 extern char *savedSeqServerHost;
@@ -304,6 +305,29 @@ ExecuteQuery(ExecuteStmt *stmt, const char *queryString,
 
 	(void) PortalRun(portal, FETCH_ALL, false, dest, dest, completionTag);
 
+	/*
+	 * If we keep plans made for the parameter values (see
+	 * RevalidateCachedPlanWithParams), a plan that got the number of result
+	 * rows badly wrong is dropped, so that the next EXECUTE with these values
+	 * optimizes the query again, rather than re-using it forever.
+	 */
+	if (cplan && cplan->boundParams && gp_plan_cache_replan_factor > 0 &&
+		portal->strategy == PORTAL_ONE_SELECT)
+	{
+		PlannedStmt *pstmt = (PlannedStmt *) linitial(plan_list);
+		double		estimated = Max(pstmt->planTree->plan_rows, 1.0);
+		double		actual = Max((double) portal->portalPos, 1.0);
+
+		if (actual > estimated * gp_plan_cache_replan_factor ||
+			estimated > actual * gp_plan_cache_replan_factor)
+		{
+			elog(DEBUG1, "prepared statement \"%s\" returned %.0f rows, "
+				 "estimated %.0f, will be replanned",
+				 stmt->name, actual, estimated);
+			cplan->dead = true;
+		}
+	}
+
 	PortalDrop(portal, false);
 
 	if (estate)
@@ -782,7 +806,7 @@ pg_prepared_statement(PG_FUNCTION_ARGS)
 	 * build tupdesc for result tuples. This must match the definition of the
 	 * pg_prepared_statements view in system_views.sql
 	 */
-	tupdesc = CreateTemplateTupleDesc(5, false);
+	tupdesc = CreateTemplateTupleDesc(7, false);
 	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "name",
 					   TEXTOID, -1, 0);
 	TupleDescInitEntry(tupdesc, (AttrNumber) 2, "statement",
@@ -793,6 +817,10 @@ pg_prepared_statement(PG_FUNCTION_ARGS)
 					   REGTYPEARRAYOID, -1, 0);
 	TupleDescInitEntry(tupdesc, (AttrNumber) 5, "from_sql",
 					   BOOLOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 6, "param_plan_hits",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 7, "param_plan_misses",
+					   INT8OID, -1, 0);
 
 	/*
 	 * We put all the tuples into a tuplestore in one scan of the hashtable.
@@ -813,8 +841,8 @@ pg_prepared_statement(PG_FUNCTION_ARGS)
 		while ((prep_stmt = hash_seq_search(&hash_seq)) != NULL)
 		{
 			HeapTuple	tuple;
-			Datum		values[5];
-			bool		nulls[5];
+			Datum		values[7];
+			bool		nulls[7];
 
 			MemSet(nulls, 0, sizeof(nulls));
 
@@ -831,6 +859,8 @@ pg_prepared_statement(PG_FUNCTION_ARGS)
 			values[3] = build_regtype_array(prep_stmt->plansource->param_types,
 										  prep_stmt->plansource->num_params);
 			values[4] = BoolGetDatum(prep_stmt->from_sql);
+			values[5] = Int64GetDatum(prep_stmt->plansource->param_plan_hits);
+			values[6] = Int64GetDatum(prep_stmt->plansource->param_plan_misses);
 
 			tuple = heap_form_tuple(tupdesc, values, nulls);
 			tuplestore_puttuple(tupstore, tuple);
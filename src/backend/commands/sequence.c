@@ -86,6 +86,8 @@ typedef struct SeqTableData
 	/* if last != cached, we have not used up all the cached values */
 	int64		increment;		/* copy of sequence's increment field */
 	/* note that increment is zero until we first do read_seq_tuple() */
+	int64		prefetch;		/* values a QE asks the sequence server for */
+	int			prefetch_command;	/* gp_command_count of the last ask */
 } SeqTableData;
 
 typedef SeqTableData *SeqTable;
@@ -98,6 +100,14 @@ static SeqTable seqtab = NULL;	/* Head of list of SeqTable items */
  */
 static SeqTableData *last_used_seq = NULL;
 
+/*
+ * Requests that this QE sent to the sequence server for the command
+ * seqServerStatsCommand, and the values that it got, for EXPLAIN ANALYZE.
+ */
+static int	seqServerStatsCommand = -1;
+static int64 seqServerRequests = 0;
+static int64 seqServerValues = 0;
+
 static int64 nextval_internal(Oid relid);
 static Relation open_share_lock(SeqTable seq);
 static void init_sequence(Oid relid, SeqTable *p_elm, Relation *p_rel);
@@ -111,12 +121,14 @@ static void process_owned_by(Relation seqrel, List *owned_by);
 static void
 cdb_sequence_nextval(SeqTable elm,
 					 Relation   seqrel,
+                     int64      nvalues,
                      int64     *plast,
                      int64     *pcached,
                      int64     *pincrement,
                      bool      *seq_overflow);
 static void
 cdb_sequence_nextval_proxy(Relation seqrel,
+                           int64    nvalues,
                            int64   *plast,
                            int64   *pcached,
                            int64   *pincrement,
@@ -865,14 +877,32 @@ nextval_internal(Oid relid)
 
     /* Update the sequence object. */
     if (Gp_role == GP_ROLE_EXECUTE)
+    {
+        /*
+         * Every trip to the sequence server serializes the QEs on it, so
+         * ask for twice as many values each time the ones we got run out
+         * within the same command.  A new command starts small again, so
+         * that few values are lost when the rest of the session is gone.
+         */
+        if (elm->prefetch_command != gp_command_count)
+        {
+            elm->prefetch = 1;
+            elm->prefetch_command = gp_command_count;
+        }
+        else if (elm->prefetch < gp_seqserver_max_prefetch)
+            elm->prefetch = Min(elm->prefetch * 2, gp_seqserver_max_prefetch);
+
         cdb_sequence_nextval_proxy(seqrel,
+                                   elm->prefetch,
                                    &elm->last,
                                    &elm->cached,
                                    &elm->increment,
                                    &is_overflow);
+    }
     else
         cdb_sequence_nextval(elm,
 							 seqrel,
+                             1,
                              &elm->last,
                              &elm->cached,
                              &elm->increment,
@@ -897,9 +927,14 @@ nextval_internal(Oid relid)
 }
 
 
+/*
+ * Fetch the next value of the sequence, and cache the ones after it up to
+ * the sequence's CACHE setting or nvalues values, whichever is more.
+ */
 static void
 cdb_sequence_nextval(SeqTable elm,
 					 Relation   seqrel,
+                     int64      nvalues,
                      int64     *plast,
                      int64     *pcached,
                      int64     *pincrement,
@@ -936,7 +971,7 @@ cdb_sequence_nextval(SeqTable elm,
 	incby = seq->increment_by;
 	maxv = seq->max_value;
 	minv = seq->min_value;
-	fetch = cache = seq->cache_value;
+	fetch = cache = Max(seq->cache_value, nvalues);
 	log = seq->log_cnt;
 
 	if (!seq->is_called)
@@ -1446,6 +1481,8 @@ init_sequence(Oid relid, SeqTable *p_elm, Relation *p_rel)
 		elm->lxid = InvalidLocalTransactionId;
 		elm->last_valid = false;
 		elm->last = elm->cached = elm->increment = 0;
+		elm->prefetch = 0;
+		elm->prefetch_command = -1;
 		elm->next = seqtab;
 		seqtab = elm;
 	}
@@ -1972,6 +2009,7 @@ cdb_sequence_relation_term(Relation seqrel)
  */
 void
 cdb_sequence_nextval_proxy(Relation	seqrel,
+                           int64    nvalues,
                            int64   *plast,
                            int64   *pcached,
                            int64   *pincrement,
@@ -1981,13 +2019,43 @@ cdb_sequence_nextval_proxy(Relation	seqrel,
 	sendSequenceRequest(GetSeqServerFD(),
 						seqrel,
     					gp_session_id,
+    					nvalues,
     					plast,
     					pcached,
     					pincrement,
     					poverflow);
 
+	if (seqServerStatsCommand != gp_command_count)
+	{
+		seqServerStatsCommand = gp_command_count;
+		seqServerRequests = 0;
+		seqServerValues = 0;
+	}
+	seqServerRequests++;
+	if (*pincrement != 0)
+		seqServerValues += (*pcached - *plast) / *pincrement + 1;
+
 }                               /* cdb_sequence_server_nextval */
 
+/*
+ * CDB: the requests this QE sent to the sequence server for the current
+ * command, and the values that it got.
+ */
+void
+cdb_sequence_proxy_stats(int64 *requests, int64 *values)
+{
+	if (seqServerStatsCommand == gp_command_count)
+	{
+		*requests = seqServerRequests;
+		*values = seqServerValues;
+	}
+	else
+	{
+		*requests = 0;
+		*values = 0;
+	}
+}
+
 
 /*
  * CDB: nextval entry point called by sequence server
@@ -1997,6 +2065,7 @@ cdb_sequence_nextval_server(Oid    tablespaceid,
                             Oid    dbid,
                             Oid    relid,
                             bool   istemp,
+                            int64  nvalues,
                             int64 *plast,
                             int64 *pcached,
                             int64 *pincrement,
@@ -2023,7 +2092,7 @@ cdb_sequence_nextval_server(Oid    tablespaceid,
     /* CDB TODO: Catch errors. */
 
     /* Update the sequence object. */
-    cdb_sequence_nextval(elm, seqrel, plast, pcached, pincrement, poverflow);
+    cdb_sequence_nextval(elm, seqrel, nvalues, plast, pcached, pincrement, poverflow);
 
     /* Cleanup. */
     cdb_sequence_relation_term(seqrel);
@@ -8,14 +8,18 @@
 
 #include "executor/executor.h"
 #include "nodes/execnodes.h"
+#include "optimizer/clauses.h"
 #include "cdb/cdbaocsam.h"
+#include "lib/stringinfo.h"
+
+static void AOCSScanExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 
 static void
 InitAOCSScanOpaque(ScanState *scanState)
 {
 	AOCSScanState *state = (AOCSScanState *)scanState;
 	Assert(state->opaque == NULL);
-	state->opaque = palloc(sizeof(AOCSScanOpaqueData));
+	state->opaque = palloc0(sizeof(AOCSScanOpaqueData));
 
 	/* Initialize AOCS projection info */
 	AOCSScanOpaqueData *opaque = (AOCSScanOpaqueData *)state->opaque;
@@ -55,6 +59,8 @@ FreeAOCSScanOpaque(ScanState *scanState)
 	AOCSScanOpaqueData *opaque = (AOCSScanOpaqueData *)state->opaque;
 	Assert(opaque->proj != NULL);
 	pfree(opaque->proj);
+	if (opaque->qualProj != NULL)
+		pfree(opaque->qualProj);
 	pfree(state->opaque);
 	state->opaque = NULL;
 }
@@ -69,6 +75,10 @@ AOCSScanNext(ScanState *scanState)
 		   node->opaque->scandesc != NULL);
 
 	aocs_getnext(node->opaque->scandesc, node->ss.ps.state->es_direction, node->ss.ss_ScanTupleSlot);
+
+	/* A row read with late materialization has passed the qual */
+	node->ss.ss_qualChecked = node->opaque->scandesc->lateMaterialize;
+
 	return node->ss.ss_ScanTupleSlot;
 }
 
@@ -76,6 +86,8 @@ void
 BeginScanAOCSRelation(ScanState *scanState)
 {
 	Snapshot appendOnlyMetaDataSnapshot;
+	AppendOnlyZoneMapKey *zoneMapKeys;
+	int numZoneMapKeys;
 
 	Assert(IsA(scanState, TableScanState) ||
 		   IsA(scanState, DynamicTableScanState));
@@ -102,6 +114,37 @@ BeginScanAOCSRelation(ScanState *scanState)
 					   NULL /* relationTupleDesc */,
 					   node->opaque->proj);
 
+	/* Skip the rows that the zone maps show can't pass the qual */
+	zoneMapKeys = AppendOnlyBlockDirectory_ZoneMapKeys(
+			node->ss.ss_currentRelation,
+			((Scan *) node->ss.ps.plan)->scanrelid,
+			node->ss.ps.plan->qual,
+			&numZoneMapKeys);
+	if (numZoneMapKeys > 0)
+		aocs_setzonemapkeys(node->opaque->scandesc, zoneMapKeys, numZoneMapKeys);
+
+	/*
+	 * Check the qual as soon as its columns are read, and read the others
+	 * only for the rows that pass. ExecScan does not check it again on
+	 * those. Quals with subplans are left to ExecScan.
+	 */
+	if (gp_aocs_late_materialization &&
+		node->ss.ps.qual != NIL &&
+		!contain_subplans((Node *) node->ss.ps.plan->qual))
+	{
+		AOCSScanOpaqueData *opaque = node->opaque;
+
+		opaque->qualProj = palloc0(sizeof(bool) * opaque->ncol);
+		GetNeededColumnsForScan((Node *) node->ss.ps.plan->qual,
+								opaque->qualProj, opaque->ncol);
+		aocs_setqual(opaque->scandesc, node->ss.ps.qual,
+					 node->ss.ps.ps_ExprContext, opaque->qualProj);
+	}
+
+	if (node->ss.ps.state->es_instrument &&
+		(numZoneMapKeys > 0 || node->opaque->qualProj != NULL))
+		node->ss.ps.cdbexplainfun = AOCSScanExplainEnd;
+
 	node->ss.scan_state = SCAN_SCAN;
 }
  
@@ -116,6 +159,10 @@ EndScanAOCSRelation(ScanState *scanState)
 	Assert(node->opaque != NULL &&
 		   node->opaque->scandesc != NULL);
 
+	node->ss.ss_zoneMapBlocksSkipped += node->opaque->scandesc->zoneMapBlocksSkipped;
+	node->ss.ss_lateMatRows += node->opaque->scandesc->lateMatRows;
+	node->ss.ss_lateMatRowsPassed += node->opaque->scandesc->lateMatRowsPassed;
+	node->ss.ss_qualChecked = false;
 	aocs_endscan(node->opaque->scandesc);
         
 	FreeAOCSScanOpaque(scanState);
@@ -134,3 +181,36 @@ ReScanAOCSRelation(ScanState *scanState)
 
 	aocs_rescan(node->opaque->scandesc); 
 }
+
+/*
+ * AOCSScanExplainEnd
+ *		Called before EXPLAIN ANALYZE output is collected, to tell how many
+ *		column blocks the zone maps let the scan skip, and for how many rows
+ *		late materialization read the columns outside the qual.
+ */
+static void
+AOCSScanExplainEnd(PlanState *planstate, struct StringInfoData *buf)
+{
+	AOCSScanState *node = (AOCSScanState *) planstate;
+	int64		blocksSkipped = node->ss.ss_zoneMapBlocksSkipped;
+	int64		lateMatRows = node->ss.ss_lateMatRows;
+	int64		lateMatRowsPassed = node->ss.ss_lateMatRowsPassed;
+
+	/* The scan may not have ended yet, e.g. under a Limit */
+	if (node->ss.tableType == TableTypeAOCS &&
+		(node->ss.scan_state & SCAN_SCAN) != 0 &&
+		node->opaque != NULL)
+	{
+		blocksSkipped += node->opaque->scandesc->zoneMapBlocksSkipped;
+		lateMatRows += node->opaque->scandesc->lateMatRows;
+		lateMatRowsPassed += node->opaque->scandesc->lateMatRowsPassed;
+	}
+
+	if (blocksSkipped > 0)
+		appendStringInfo(buf, INT64_FORMAT " blocks skipped by zone maps.\n",
+						 blocksSkipped);
+	if (lateMatRows > 0)
+		appendStringInfo(buf, INT64_FORMAT " of " INT64_FORMAT
+						 " rows read the columns outside the qual.\n",
+						 lateMatRowsPassed, lateMatRows);
+}
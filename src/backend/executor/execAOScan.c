@@ -9,6 +9,9 @@
 #include "executor/executor.h"
 #include "nodes/execnodes.h"
 #include "cdb/cdbappendonlyam.h"
+#include "lib/stringinfo.h"
+
+static void AppendOnlyScanExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 
 TupleTableSlot *
 AppendOnlyScanNext(ScanState *scanState)
@@ -43,6 +46,8 @@ void
 BeginScanAppendOnlyRelation(ScanState *scanState)
 {
 	Snapshot appendOnlyMetaDataSnapshot;
+	AppendOnlyZoneMapKey *zoneMapKeys;
+	int numZoneMapKeys;
 
 	Assert(IsA(scanState, TableScanState) ||
 		   IsA(scanState, DynamicTableScanState));
@@ -67,6 +72,21 @@ BeginScanAppendOnlyRelation(ScanState *scanState)
 			node->ss.ps.state->es_snapshot, 
 			appendOnlyMetaDataSnapshot,
 			0, NULL);
+
+	/* Skip the blocks that the zone maps show can't pass the qual */
+	zoneMapKeys = AppendOnlyBlockDirectory_ZoneMapKeys(
+			node->ss.ss_currentRelation,
+			((Scan *) node->ss.ps.plan)->scanrelid,
+			node->ss.ps.plan->qual,
+			&numZoneMapKeys);
+	if (numZoneMapKeys > 0)
+	{
+		appendonly_setzonemapkeys(node->aos_ScanDesc, zoneMapKeys, numZoneMapKeys);
+
+		if (node->ss.ps.state->es_instrument)
+			node->ss.ps.cdbexplainfun = AppendOnlyScanExplainEnd;
+	}
+
 	node->ss.scan_state = SCAN_SCAN;
 }
 
@@ -79,6 +99,7 @@ EndScanAppendOnlyRelation(ScanState *scanState)
 	Assert(node->aos_ScanDesc != NULL);
 
 	Assert((node->ss.scan_state & SCAN_SCAN) != 0);
+	node->ss.ss_zoneMapBlocksSkipped += node->aos_ScanDesc->zoneMapBlocksSkipped;
 	appendonly_endscan(node->aos_ScanDesc);
 
 	node->aos_ScanDesc = NULL;
@@ -96,3 +117,24 @@ ReScanAppendOnlyRelation(ScanState *scanState)
 
 	appendonly_rescan(node->aos_ScanDesc, NULL /* new scan keys */);
 }
+
+/*
+ * AppendOnlyScanExplainEnd
+ *		Called before EXPLAIN ANALYZE output is collected, to tell how many
+ *		blocks the zone maps let the scan skip.
+ */
+static void
+AppendOnlyScanExplainEnd(PlanState *planstate, struct StringInfoData *buf)
+{
+	AppendOnlyScanState *node = (AppendOnlyScanState *) planstate;
+	int64		blocksSkipped = node->ss.ss_zoneMapBlocksSkipped;
+
+	/* The scan may not have ended yet, e.g. under a Limit */
+	if (node->ss.tableType == TableTypeAppendOnly &&
+		(node->ss.scan_state & SCAN_SCAN) != 0 &&
+		node->aos_ScanDesc != NULL)
+		blocksSkipped += node->aos_ScanDesc->zoneMapBlocksSkipped;
+
+	appendStringInfo(buf, INT64_FORMAT " blocks skipped by zone maps.\n",
+					 blocksSkipped);
+}
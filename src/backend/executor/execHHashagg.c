@@ -103,7 +103,6 @@ static void *readHashEntry(AggState *aggstate,
 						   int32 *p_input_size);
 
 /* Methods for hash table */
-static uint32 calc_hash_value(AggState* aggstate, TupleTableSlot *inputslot);
 static void spill_hash_table(AggState *aggstate);
 static void init_agg_hash_iter(HashAggTable* ht);
 static HashAggEntry *lookup_agg_hash_entry(AggState *aggstate, void *input_record,
@@ -161,6 +160,39 @@ calc_hash_value(AggState* aggstate, TupleTableSlot *inputslot)
 	return (uint32) hash_any((unsigned char *) hashtable->hashkey_buf, agg->numCols * sizeof(HashKey));
 }
 
+/* Function: agg_hash_keys_match
+ *
+ * Returns true if the grouping keys of the input tuple match the ones of
+ * the hash table entry's tuple.  NULLs match NULLs.
+ */
+bool
+agg_hash_keys_match(AggState *aggstate, TupleTableSlot *inputslot,
+					MemTuple entry_tuple)
+{
+	Agg *agg = (Agg*)aggstate->ss.ps.plan;
+	MemTupleBinding *mt_bind = aggstate->hashslot->tts_mt_bind;
+	int i;
+
+	for (i = 0; i < agg->numCols; i++)
+	{
+		AttrNumber	att = agg->grpColIdx[i];
+		bool input_isNull = false;
+		bool entry_isNull = false;
+		Datum input_datum = slot_getattr(inputslot, att, &input_isNull);
+		Datum entry_datum = memtuple_getattr(entry_tuple, mt_bind, att, &entry_isNull);
+
+		if ( !input_isNull && !entry_isNull &&
+			 (DatumGetBool(FunctionCall2(&aggstate->eqfunctions[i],
+										 input_datum,
+										 entry_datum)) ) )
+			continue; /* Both non-NULL and equal. */
+		if (!(input_isNull && entry_isNull))
+			return false; /* NULLs match in group keys. */
+	}
+
+	return true;
+}
+
 /* Function: adjustInputGroup
  *
  * Adjust the datum pointers stored in the byte array of an input group.
@@ -424,34 +456,34 @@ lookup_agg_hash_entry(AggState *aggstate,
 			continue;
 		}
 		
-		for (i = 0; match && i < agg->numCols; i++)
+		if (input_type == INPUT_RECORD_TUPLE)
+		{
+			match = call_AggHashKeysMatch(aggstate,
+										  (TupleTableSlot *) input_record,
+										  mtup);
+		}
+		else
 		{
-			AttrNumber	att = agg->grpColIdx[i];
-			Datum input_datum = 0;
-			Datum entry_datum = 0;
-			bool input_isNull = false;
-			bool entry_isNull = false;
-				
-			switch(input_type)
+			Assert(input_type == INPUT_RECORD_GROUP_AND_AGGS);
+
+			for (i = 0; match && i < agg->numCols; i++)
 			{
-				case INPUT_RECORD_TUPLE:
-					input_datum = slot_getattr((TupleTableSlot *)input_record, att, &input_isNull);
-					break;
-				case INPUT_RECORD_GROUP_AND_AGGS:
-					input_datum = memtuple_getattr((MemTuple)input_record, mt_bind, att, &input_isNull);
-					break;
-				default:
-					insist_log(false, "invalid record type %d", input_type);
+				AttrNumber	att = agg->grpColIdx[i];
+				Datum input_datum = 0;
+				Datum entry_datum = 0;
+				bool input_isNull = false;
+				bool entry_isNull = false;
+
+				input_datum = memtuple_getattr((MemTuple)input_record, mt_bind, att, &input_isNull);
+				entry_datum = memtuple_getattr(mtup, mt_bind, att, &entry_isNull);
+
+				if ( !input_isNull && !entry_isNull &&
+					 (DatumGetBool(FunctionCall2(&aggstate->eqfunctions[i],
+												 input_datum,
+												 entry_datum)) ) )
+					continue; /* Both non-NULL and equal. */
+				match = (input_isNull && entry_isNull);/* NULLs match in group keys. */
 			}
-
-			entry_datum = memtuple_getattr(mtup, mt_bind, att, &entry_isNull);
-
-			if ( !input_isNull && !entry_isNull &&
-				 (DatumGetBool(FunctionCall2(&aggstate->eqfunctions[i],
-											 input_datum,
-											 entry_datum)) ) )
-				continue; /* Both non-NULL and equal. */
-			match = (input_isNull && entry_isNull);/* NULLs match in group keys. */
 		}
 		
 		/* Break if found an existing matching entry. */
@@ -821,7 +853,7 @@ agg_hash_initial_pass(AggState *aggstate)
 
 		/* Find or (if there's room) build a hash table entry for the
 		 * input tuple's group. */
-		hashkey = calc_hash_value(aggstate, outerslot);
+		hashkey = call_CalcHashValue(aggstate, outerslot);
 		entry = lookup_agg_hash_entry(aggstate, (void *)outerslot,
 									  INPUT_RECORD_TUPLE, 0, hashkey, 0, &isNew);
 		
@@ -868,7 +900,7 @@ agg_hash_initial_pass(AggState *aggstate)
 		}
 			
 		/* Advance the aggregates */
-		advance_aggregates(aggstate, hashtable->groupaggs->aggs, &(aggstate->mem_manager));
+		call_AdvanceAggregates(aggstate, hashtable->groupaggs->aggs, &(aggstate->mem_manager));
 		
 		hashtable->num_tuples++;
 
@@ -82,6 +82,7 @@
 
 #include "executor/executor.h"
 #include "executor/instrument.h"
+#include "executor/execHHashagg.h"
 #include "executor/nodeAgg.h"
 #include "executor/nodeAppend.h"
 #include "executor/nodeAssertOp.h"
@@ -589,6 +590,18 @@ ExecInitNode(Plan *node, EState *estate, int eflags)
 			    AggStatePerAgg peraggstate = &aggstate->peragg[aggno];
 			    EnrollProjInfoTargetList(result, peraggstate->evalproj);
 			  }
+			  if (((Agg *) node)->aggstrategy == AGG_HASHED)
+			  {
+			    enroll_AdvanceAggregates_codegen(advance_aggregates,
+			        &aggstate->AdvanceAggregates_gen_info.AdvanceAggregates_fn,
+			        aggstate);
+			    enroll_CalcHashValue_codegen(calc_hash_value,
+			        &aggstate->CalcHashValue_gen_info.CalcHashValue_fn,
+			        aggstate);
+			    enroll_AggHashKeysMatch_codegen(agg_hash_keys_match,
+			        &aggstate->AggHashKeysMatch_gen_info.AggHashKeysMatch_fn,
+			        aggstate);
+			  }
 			}
 			}
 			END_MEMORY_ACCOUNT();
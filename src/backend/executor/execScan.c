@@ -17,6 +17,7 @@
 #include "codegen/codegen_wrapper.h"
 
 #include "executor/executor.h"
+#include "executor/nodeHash.h"
 #include "miscadmin.h"
 #include "utils/memutils.h"
 #include "utils/debugbreak.h"
@@ -89,18 +90,20 @@ ExecScan(ScanState *node,
 	ExprContext *econtext;
 	List	   *qual;
 	ProjectionInfo *projInfo;
+	HashJoinRuntimeFilter *runtimeFilter;
 
 	/*
 	 * Fetch data from node
 	 */
 	qual = node->ps.qual;
 	projInfo = node->ps.ps_ProjInfo;
+	runtimeFilter = node->ss_runtimeFilter;
 
 	/*
 	 * If we have neither a qual to check nor a projection to do, just skip
 	 * all the overhead and return the raw scan tuple.
 	 */
-	if (!qual && !projInfo)
+	if (!qual && !projInfo && !runtimeFilter)
 		return (*accessMtd) (node);
 
 	/*
@@ -150,9 +153,13 @@ ExecScan(ScanState *node,
 		 * check for non-nil qual here to avoid a function call to ExecQual()
 		 * when the qual is nil ... saves only a few cycles, but they add up
 		 * ...
+		 *
+		 * CDB: The access method may have checked the qual itself.
 		 */
-		if (!qual || ExecQual(qual, econtext, false))
+		if (!qual || node->ss_qualChecked || ExecQual(qual, econtext, false))
 		{
+			TupleTableSlot *resultSlot;
+
 			/*
 			 * Found a satisfactory scan tuple.
 			 */
@@ -162,15 +169,24 @@ ExecScan(ScanState *node,
 				 * Form a projection tuple, store it in the result tuple slot
 				 * and return it.
 				 */
-				return ExecProject(projInfo, NULL);
+				resultSlot = ExecProject(projInfo, NULL);
 			}
 			else
 			{
 				/*
 				 * Here, we aren't projecting, so just return scan tuple.
 				 */
-				return slot;
+				resultSlot = slot;
 			}
+
+			/*
+			 * CDB: Drop the tuple if the hash join above us will not find a
+			 * match for it.  The filter's hash keys refer to the tuple as we
+			 * return it.
+			 */
+			if (!runtimeFilter ||
+				ExecHashRuntimeFilterCheck(runtimeFilter, econtext, resultSlot))
+				return resultSlot;
 		}
 
 		/*
@@ -499,6 +499,29 @@ invoke_agg_trans_func(FmgrInfo *transfn, int numargs, Datum transValue,
 	return newVal;
 }
 
+/*
+ * Advance one single-argument aggregate with the given input value.
+ *
+ * Generated advance_aggregates() calls this for the transition functions it
+ * does not inline, e.g. the pass-by-reference ones of numeric sum and avg.
+ */
+void
+advance_aggregate_value(AggState *aggstate, int aggno,
+						AggStatePerGroup pergroupstate,
+						Datum value, bool isnull,
+						MemoryManagerContainer *mem_manager)
+{
+	FunctionCallInfoData fcinfo;
+
+	Assert(aggno >= 0 && aggno < aggstate->numaggs);
+	Assert(aggstate->peragg[aggno].numArguments == 1);
+
+	fcinfo.arg[1] = value;
+	fcinfo.argnull[1] = isnull;
+	advance_transition_function(aggstate, &aggstate->peragg[aggno],
+								pergroupstate, &fcinfo, mem_manager);
+}
+
 /*
  * Advance all the aggregates for one input tuple.	The input tuple
  * has been stored in tmpcontext->ecxt_outertuple, so that it is accessible
@@ -1727,6 +1750,9 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 	aggstate->pergroup = NULL;
 	aggstate->grp_firstTuple = NULL;
 	aggstate->hashtable = NULL;
+	aggstate->AdvanceAggregates_gen_info.AdvanceAggregates_fn = advance_aggregates;
+	aggstate->CalcHashValue_gen_info.CalcHashValue_fn = calc_hash_value;
+	aggstate->AggHashKeysMatch_gen_info.AggHashKeysMatch_fn = agg_hash_keys_match;
 
 	/*
 	 * Create expression contexts.	We need two, one for per-input-tuple
@@ -61,6 +61,17 @@ void ExecChooseHashTableSize(double ntuples, int tupwidth,
 
 #define BLOOMVAL(hk)  (((uint64)1) << (((hk) >> 13) & 0x3f))
 
+/*
+ * Size of the runtime filter: bits per expected inner row, and bounds.  The
+ * filter stops being useful, and is not pushed down, once half of its bits
+ * are set.
+ */
+#define RUNTIME_FILTER_BITS_PER_ROW	8
+#define RUNTIME_FILTER_MIN_BITS		(1 << 13)
+#define RUNTIME_FILTER_MAX_BITS		(1 << 26)
+
+static inline void ExecHashRuntimeFilterInsert(HashJoinRuntimeFilter *filter, uint32 hashvalue);
+
 /* Amount of metadata memory required per batch */
 #define MD_MEM_PER_BATCH 	(sizeof(HashJoinBatchData *) + sizeof(HashJoinBatchData))
 
@@ -134,6 +145,9 @@ MultiExecHash(HashState *node)
 								 node->hs_keepnull, &hashvalue, &hashkeys_null))
 		{
 			ExecHashTableInsert(node, hashtable, slot, hashvalue);
+
+			if (hashtable->runtimeFilter && hashtable->runtimeFilter->useful)
+				ExecHashRuntimeFilterInsert(hashtable->runtimeFilter, hashvalue);
 		}
 
 		if (hashkeys_null)
@@ -314,6 +328,7 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	hashtable->log2_nbuckets = log2_nbuckets;
 	hashtable->buckets = NULL;
 	hashtable->bloom = NULL;
+	hashtable->runtimeFilter = NULL;
 	hashtable->nbatch = nbatch;
 	hashtable->curbatch = 0;
 	hashtable->nbatch_original = nbatch;
@@ -690,6 +705,27 @@ ExecHashTableDestroy(HashState *hashState, HashJoinTable hashtable)
 		hashtable->work_set = NULL;
 	}
 
+	/*
+	 * The runtime filter goes away with hashCxt; detach it from the scan, and
+	 * keep its counts for EXPLAIN ANALYZE.
+	 */
+	if (hashtable->runtimeFilter)
+	{
+		HashJoinRuntimeFilter *filter = hashtable->runtimeFilter;
+
+		if (filter->scan)
+		{
+			filter->scan->ss_runtimeFilter = NULL;
+			filter->scan = NULL;
+		}
+		if (hashtable->stats)
+		{
+			hashtable->stats->filterchecked += filter->nchecked;
+			hashtable->stats->filterremoved += filter->nremoved;
+		}
+		hashtable->runtimeFilter = NULL;
+	}
+
 	/* Release working memory (batchCxt is a child, so it goes away too) */
 	MemoryContextDelete(hashtable->hashCxt);
 	hashtable->batches = NULL;
@@ -1098,6 +1134,156 @@ ExecHashGetHashValue(HashState *hashState, HashJoinTable hashtable,
 	return result;
 }
 
+/*
+ * Second hash of a hash value, for the second bit of the runtime filter.
+ */
+static inline uint32
+runtime_filter_rehash(uint32 hashvalue)
+{
+	return ((hashvalue >> 16) | (hashvalue << 16)) * 0x9e3779b1;
+}
+
+/*
+ * ExecHashRuntimeFilterCreate
+ *		Set up an empty runtime filter for the hash table
+ *
+ * The inner tuples' hash values are added to the filter by MultiExecHash.
+ * outerHashKeys are the hash keys of the join for the outer side; the scan
+ * the filter is attached to evaluates them on its output tuples.
+ */
+void
+ExecHashRuntimeFilterCreate(HashJoinTable hashtable, List *outerHashKeys,
+							double innerRows)
+{
+	HashJoinRuntimeFilter *filter;
+	double		nbits;
+	int			log2_nbits;
+
+	nbits = innerRows * RUNTIME_FILTER_BITS_PER_ROW;
+	nbits = Max(nbits, RUNTIME_FILTER_MIN_BITS);
+	nbits = Min(nbits, RUNTIME_FILTER_MAX_BITS);
+	log2_nbits = my_log2((long) nbits);
+
+	filter = (HashJoinRuntimeFilter *)
+		MemoryContextAllocZero(hashtable->hashCxt, sizeof(HashJoinRuntimeFilter));
+	filter->bits = (uint64 *)
+		MemoryContextAllocZero(hashtable->hashCxt, ((Size) 1 << log2_nbits) / 8);
+	filter->mask = ((uint32) 1 << log2_nbits) - 1;
+	filter->nbitsset = 0;
+	filter->useful = true;
+	filter->hashkeys = outerHashKeys;
+	filter->hashfunctions = hashtable->outer_hashfunctions;
+	filter->hashStrict = hashtable->hashStrict;
+	filter->scan = NULL;
+	filter->passedhashvalid = false;
+	filter->nchecked = 0;
+	filter->nremoved = 0;
+
+	hashtable->runtimeFilter = filter;
+}
+
+/*
+ * ExecHashRuntimeFilterInsert
+ *		Add the hash value of an inner tuple to the runtime filter
+ */
+static inline void
+ExecHashRuntimeFilterInsert(HashJoinRuntimeFilter *filter, uint32 hashvalue)
+{
+	uint32		bit1 = hashvalue & filter->mask;
+	uint32		bit2 = runtime_filter_rehash(hashvalue) & filter->mask;
+	uint64		mask1 = ((uint64) 1) << (bit1 & 0x3f);
+	uint64		mask2 = ((uint64) 1) << (bit2 & 0x3f);
+
+	if ((filter->bits[bit1 >> 6] & mask1) == 0)
+	{
+		filter->bits[bit1 >> 6] |= mask1;
+		filter->nbitsset++;
+	}
+	if ((filter->bits[bit2 >> 6] & mask2) == 0)
+	{
+		filter->bits[bit2 >> 6] |= mask2;
+		filter->nbitsset++;
+	}
+
+	/* A filter this full lets most rows through; not worth checking */
+	if (filter->nbitsset > filter->mask / 2)
+		filter->useful = false;
+}
+
+/*
+ * ExecHashRuntimeFilterCheck
+ *		Check a tuple of the scan that the runtime filter is attached to
+ *
+ * slot holds the tuple as the scan returns it, i.e. as the join sees it on
+ * its outer side.  A FALSE result means that the tuple cannot match any
+ * inner tuple; TRUE means that it might, and the tuple's hash value is left
+ * in passedhashvalue for the join.  The hash keys are evaluated in the
+ * per-tuple memory of econtext, which the caller resets.
+ */
+bool
+ExecHashRuntimeFilterCheck(HashJoinRuntimeFilter *filter,
+						   ExprContext *econtext,
+						   TupleTableSlot *slot)
+{
+	uint32		hashkey = 0;
+	uint32		bit1;
+	uint32		bit2;
+	ListCell   *hk;
+	int			i = 0;
+	MemoryContext oldContext;
+
+	filter->nchecked++;
+	filter->passedhashvalid = false;
+
+	econtext->ecxt_outertuple = slot;
+
+	oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	/* Same computation as ExecHashGetHashValue, for the outer side */
+	foreach(hk, filter->hashkeys)
+	{
+		ExprState  *keyexpr = (ExprState *) lfirst(hk);
+		Datum		keyval;
+		bool		isNull = false;
+
+		/* rotate hashkey left 1 bit at each step */
+		hashkey = (hashkey << 1) | ((hashkey & 0x80000000) ? 1 : 0);
+
+		keyval = ExecEvalExpr(keyexpr, econtext, &isNull, NULL);
+
+		if (isNull)
+		{
+			/* The join drops the tuple as well */
+			if (filter->hashStrict[i])
+			{
+				MemoryContextSwitchTo(oldContext);
+				filter->nremoved++;
+				return false;
+			}
+		}
+		else
+			hashkey ^= DatumGetUInt32(FunctionCall1(&filter->hashfunctions[i], keyval));
+
+		i++;
+	}
+
+	MemoryContextSwitchTo(oldContext);
+
+	bit1 = hashkey & filter->mask;
+	bit2 = runtime_filter_rehash(hashkey) & filter->mask;
+
+	if ((filter->bits[bit1 >> 6] & (((uint64) 1) << (bit1 & 0x3f))) == 0 ||
+		(filter->bits[bit2 >> 6] & (((uint64) 1) << (bit2 & 0x3f))) == 0)
+	{
+		filter->nremoved++;
+		return false;
+	}
+
+	filter->passedhashvalue = hashkey;
+	filter->passedhashvalid = true;
+	return true;
+}
+
 /*
  * ExecHashGetBucketAndBatch
  *		Determine the bucket number and batch number for a hash value
@@ -1398,6 +1584,23 @@ ExecHashTableExplainEnd(PlanState *planstate, struct StringInfoData *buf)
 				"Secondary Overflow");
     }
 
+    /* Report how many outer rows the runtime filter removed. */
+    if (hashtable->runtimeFilter || stats->filterchecked > 0)
+    {
+        uint64  nchecked = stats->filterchecked;
+        uint64  nremoved = stats->filterremoved;
+
+        if (hashtable->runtimeFilter)
+        {
+            nchecked += hashtable->runtimeFilter->nchecked;
+            nremoved += hashtable->runtimeFilter->nremoved;
+        }
+        appendStringInfo(buf,
+                         "Local scan filter removed " UINT64_FORMAT
+                         " of " UINT64_FORMAT " outer rows.\n",
+                         nremoved, nchecked);
+    }
+
     /* Report hash chain statistics. */
     total_buckets = stats->nonemptybatches * hashtable->nbuckets;
     if (total_buckets > 0)
@@ -40,6 +40,7 @@ static bool isNotDistinctJoin(List *qualList);
 
 static void ReleaseHashTable(HashJoinState *node);
 static bool isHashtableEmpty(HashJoinTable hashtable);
+static bool isRuntimeFilterTarget(HashJoinState *node, PlanState *outerNode);
 
 /* ----------------------------------------------------------------
  *		ExecHashJoin
@@ -197,6 +198,14 @@ ExecHashJoin(HashJoinState *node)
 		 * the HashJoin plan when creating the spill file set */
 		hashtable->hjstate = node;
 
+		/*
+		 * CDB: Have the Hash node collect the inner hash values in a Bloom
+		 * filter, for the outer side scan.
+		 */
+		if (isRuntimeFilterTarget(node, outerNode))
+			ExecHashRuntimeFilterCreate(hashtable, node->hj_OuterHashKeys,
+										hashNode->ps.plan->plan_rows);
+
 		/* Execute the Hash node and build the hashtable */
 		(void) MultiExecProcNode((PlanState *) hashNode);
 
@@ -253,6 +262,18 @@ ExecHashJoin(HashJoinState *node)
 			return NULL;
         }
 
+		/*
+		 * CDB: Every inner tuple is in the runtime filter now, including the
+		 * ones of the spilled batches, so the outer scan can use it.
+		 */
+		if (hashtable->runtimeFilter && hashtable->runtimeFilter->useful)
+		{
+			ScanState  *scanState = (ScanState *) outerNode;
+
+			hashtable->runtimeFilter->scan = scanState;
+			scanState->ss_runtimeFilter = hashtable->runtimeFilter;
+		}
+
 		/*
 		 * Reset OuterNotEmpty for scan.  (It's OK if we fetched a tuple
 		 * above, because ExecHashJoinOuterGetTuple will immediately set it
@@ -718,6 +739,21 @@ ExecHashJoinOuterGetTuple(PlanState *outerNode,
 			econtext = hjstate->js.ps.ps_ExprContext;
 			econtext->ecxt_outertuple = slot;
 
+			/*
+			 * CDB: The runtime filter in the outer scan has computed it
+			 * already when it let the tuple through.
+			 */
+			if (hashtable->runtimeFilter &&
+				hashtable->runtimeFilter->passedhashvalid &&
+				(PlanState *) hashtable->runtimeFilter->scan == outerNode)
+			{
+				hashtable->runtimeFilter->passedhashvalid = false;
+				*hashvalue = hashtable->runtimeFilter->passedhashvalue;
+				hjstate->hj_OuterNotEmpty = true;
+
+				return slot;
+			}
+
 			bool hashkeys_null = false;
 			bool keep_nulls = (hjstate->js.jointype == JOIN_LEFT) ||
 					(hjstate->js.jointype == JOIN_LASJ) ||
@@ -1360,3 +1396,39 @@ isHashtableEmpty(HashJoinTable hashtable)
 }
 
 /* EOF */
+
+/*
+ * isRuntimeFilterTarget
+ *
+ *  Can the join hand a runtime filter on its inner keys to its outer side?
+ *  That is the case when the outer side is a scan, in the same slice, and
+ *  the join drops the outer tuples that find no match.  A scan below a
+ *  motion runs in another process, which has no way to get the filter, so
+ *  it is never filtered.
+ */
+static bool
+isRuntimeFilterTarget(HashJoinState *node, PlanState *outerNode)
+{
+	if (!gp_hashjoin_local_scan_filter)
+		return false;
+
+	if (node->js.jointype != JOIN_INNER && node->js.jointype != JOIN_IN)
+		return false;
+
+	/* Null keys can match, which the filter does not know about */
+	if (node->hj_nonequijoin)
+		return false;
+
+	switch (nodeTag(outerNode))
+	{
+		case T_SeqScanState:
+		case T_AppendOnlyScanState:
+		case T_AOCSScanState:
+		case T_TableScanState:
+		case T_DynamicTableScanState:
+			/* These go through ExecScan(), which checks the filter */
+			return true;
+		default:
+			return false;
+	}
+}
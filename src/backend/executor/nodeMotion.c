@@ -117,6 +117,7 @@ static uint32 evalHashKey(ExprContext *econtext, List *hashkeys, List *hashtypes
 
 static void doSendEndOfStream(Motion * motion, MotionState * node);
 static void doSendTuple(Motion * motion, MotionState * node, TupleTableSlot *outerTupleSlot);
+static void ExecMotionExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 
 
 /*=========================================================================
@@ -232,6 +233,36 @@ setMotionStatsForGpmon(MotionState *node)
 }
 
 
+/*
+ * ExecMotionExplainEnd
+ *		Called before ExecutorEnd to finish EXPLAIN ANALYZE reporting.
+ *
+ * Reports how many tuple-chunks carried the tuples, which shows whether
+ * they were batched (gp_interconnect_batch_tuples).
+ */
+static void
+ExecMotionExplainEnd(PlanState *planstate, struct StringInfoData *buf)
+{
+	MotionState *node = (MotionState *) planstate;
+	MotionLayerState *mlStates = (MotionLayerState *) node->ps.state->motionlayer_context;
+	MotionNodeEntry *mlEntry;
+
+	if (mlStates == NULL)
+		return;
+
+	mlEntry = getMotionNodeEntry(mlStates, ((Motion *) node->ps.plan)->motionID,
+								 "ExecMotionExplainEnd");
+
+	if (node->mstype == MOTIONSTATE_SEND)
+		appendStringInfo(buf, UINT64_FORMAT " tuples sent in " UINT64_FORMAT " chunks.\n",
+						 mlEntry->stat_total_sends,
+						 mlEntry->stat_total_chunks_sent);
+	else if (node->mstype == MOTIONSTATE_RECV)
+		appendStringInfo(buf, UINT64_FORMAT " tuples received in " UINT64_FORMAT " chunks.\n",
+						 mlEntry->stat_total_recvs,
+						 mlEntry->stat_total_chunks_recvd);
+}
+
 /* ----------------------------------------------------------------
  *		ExecMotion
  * ----------------------------------------------------------------
@@ -1012,6 +1043,12 @@ ExecInitMotion(Motion * node, EState *estate, int eflags)
 	motionstate->stopRequested = false;
 	motionstate->numInputSegs = sendSlice->numGangMembersToBeActive;
 
+	/*
+	 * CDB: Offer extra info for EXPLAIN ANALYZE.
+	 */
+	if (estate->es_instrument)
+		motionstate->ps.cdbexplainfun = ExecMotionExplainEnd;
+
 	/*
 	 * Miscellaneous initialization
 	 *
@@ -1083,10 +1120,15 @@ ExecInitMotion(Motion * node, EState *estate, int eflags)
 
 	/*
 	 * Perform per-node initialization in the motion layer.
+	 *
+	 * A Gather does not batch its tuples: a batch is only sent once it is
+	 * full, and the single receiver above it (often a Limit, or the QD
+	 * returning rows to the client) may need no more than the first few.
 	 */
 	UpdateMotionLayerNode(motionstate->ps.state->motionlayer_context, 
 			node->motionID, 
 			node->sendSorted, 
+			gp_interconnect_batch_tuples && !isMotionGather(node),
 			tupDesc, 
 			PlanStateOperatorMemKB((PlanState *) motionstate));
 
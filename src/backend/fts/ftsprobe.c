@@ -8,7 +8,6 @@
  *-------------------------------------------------------------------------
  */
 #include "postgres.h"
-#include <pthread.h>
 #include <limits.h>
 
 #include <sys/socket.h>
@@ -18,7 +17,7 @@
 
 #include "gp-libpq-fe.h"
 #include "gp-libpq-int.h"
-#include "cdb/cdbgang.h"		/* gp_pthread_create */
+#include "cdb/cdbutil.h"		/* CdbComponentDatabases */
 #include "libpq/ip.h"
 #include "postmaster/fts.h"
 
@@ -44,6 +43,10 @@
 
 #define PROBE_RESPONSE_LEN  (20)         /* size of segment response message */
 #define PROBE_ERR_MSG_LEN   (256)        /* length of error message for errno */
+#define PROBE_RETRY_DELAY_MS (1000)      /* wait before probing a segment again */
+#define PROBE_POLL_TIMEOUT_MS (100)      /* longest wait for socket events */
+#define PROBE_MAX_IN_FLIGHT (256)        /* most probe connections open at once */
+#define PROBE_HIST_BUCKETS  (12)         /* response times < 1, 2, 4, ..., 1024, >= 1024 ms */
 
 /*
  * MACROS
@@ -56,11 +59,25 @@
  * STRUCTURES
  */
 
-typedef struct threadWorkerInfo
+typedef struct ProbeMsg
 {
-	uint8 *scan_status;
-} threadWorkerInfo;
+	uint32 packetlen;
+	PrimaryMirrorTransitionPacket payload;
+} ProbeMsg;
 
+/*
+ * Where a probe is.  All probes of a cycle are driven by one poll() loop,
+ * each one moving on as its socket becomes ready.
+ */
+typedef enum ProbeState
+{
+	PROBE_STATE_IDLE,                    /* not to be probed (yet) */
+	PROBE_STATE_WAITING,                 /* to be (re)started */
+	PROBE_STATE_CONNECTING,              /* waiting for connect() to complete */
+	PROBE_STATE_SENDING,                 /* sending the probe message */
+	PROBE_STATE_RECEIVING,               /* receiving the response */
+	PROBE_STATE_DONE                     /* segmentStatus is final */
+} ProbeState;
 
 typedef struct ProbeConnectionInfo
 {
@@ -87,22 +104,34 @@ typedef struct ProbeConnectionInfo
 
 	int16 probe_errno;                   /* saved errno from the latest system call */
 	char errmsg[PROBE_ERR_MSG_LEN];      /* message returned by strerror() */
+
+	ProbeState state;                    /* progress of the probe */
+	int retryCnt;                        /* attempts that failed so far */
+	GpMonotonicTime retryTime;           /* when the last attempt failed */
+	ProbeMsg msg;                        /* probe message */
+	uint32 bytesSent;                    /* bytes of msg sent */
+	uint32 bytesReceived;                /* bytes of response received */
+
+	/* for a primary: its mirror, probed if the primary is dead or faulty */
+	struct ProbeConnectionInfo *mirror;
 } ProbeConnectionInfo;
 
-typedef struct ProbeMsg
+/* Statistics of one probe cycle, logged at the end of it */
+typedef struct ProbeCycleStats
 {
-	uint32 packetlen;
-	PrimaryMirrorTransitionPacket payload;
-} ProbeMsg;
+	int probes;                          /* segments probed */
+	int finished;                        /* probes that are done */
+	int retries;                         /* attempts that were retried */
+	int timeouts;                        /* attempts that timed out */
+	int maxInFlight;                     /* most probes in flight at once */
+	int hist[PROBE_HIST_BUCKETS];        /* response times of live segments */
+} ProbeCycleStats;
 
 
 /*
  * STATIC VARIABLES
  */
 
-/* mutex used for pthread synchronization in parallel probing */
-static pthread_mutex_t worker_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
-
 /* struct holding segment configuration */
 static CdbComponentDatabases *cdb_component_dbs = NULL;
 
@@ -113,15 +142,18 @@ static uint8 *scan_status;
  * FUNCTION PROTOTYPES
  */
 
-static void *probeSegmentFromThread(void *cdb_component_dbs);
-
-static char probeSegment(CdbComponentDatabaseInfo *dbInfo);
+static void probeInit(ProbeConnectionInfo *probeInfo, CdbComponentDatabaseInfo *dbInfo);
+static void probeStart(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats);
+static void probeAdvance(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats);
+static void probeFail(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats);
+static void probeFinish(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats);
+static void probeLogCycleStats(ProbeCycleStats *stats, uint64 elapsed_ms);
 
 static bool probeMarkSocketNonBlocking(ProbeConnectionInfo *probeInfo);
 static bool probeGetIpAddr(ProbeConnectionInfo *probeInfo);
 static bool probeOpenSocket(ProbeConnectionInfo *probeInfo);
 static bool probeConnect(ProbeConnectionInfo *probeInfo);
-static bool probePoll(ProbeConnectionInfo *probeInfo, bool incoming);
+static bool probeCheckConnect(ProbeConnectionInfo *probeInfo);
 static bool probeSend(ProbeConnectionInfo *probeInfo);
 static bool probeReceive(ProbeConnectionInfo *probeInfo);
 static bool probeProcessResponse(ProbeConnectionInfo *probeInfo);
@@ -130,9 +162,8 @@ static void probeClose(ProbeConnectionInfo *probeInfo);
 
 
 /*
- * strerror() is not threadsafe.  Therefore, prober threads must use
- * the correct strerror_r() available on the platform to obtain error
- * message corresponding to errno.
+ * Obtain the error message corresponding to the saved errno, using the
+ * strerror_r() available on the platform.
  */
 static char *errmessage(ProbeConnectionInfo *probeInfo)
 {
@@ -160,15 +191,24 @@ static char *errmessage(ProbeConnectionInfo *probeInfo)
 
 /*
  * probe segments to check if they are alive and if any failure has occurred
+ *
+ * All primaries are probed at once: a single poll() loop keeps every probe
+ * connection in flight and moves each one on as its socket becomes ready,
+ * so a cycle takes about as long as the slowest segment rather than growing
+ * with the number of segments.  A mirror is probed once its primary turned
+ * out to be dead or faulty.
  */
 void
 FtsProbeSegments(CdbComponentDatabases *dbs, uint8 *probeRes)
 {
 	int i;
 
-	threadWorkerInfo worker_info;
-	int workers = gp_fts_probe_threadcount;
-	pthread_t *threads = NULL;
+	ProbeConnectionInfo *probes;
+	int nprobes = 0;
+	struct pollfd *pollfds;
+	ProbeConnectionInfo **polled;
+	ProbeCycleStats stats;
+	GpMonotonicTime cycleStartTime;
 
 	cdb_component_dbs = dbs;
 	scan_status = probeRes;
@@ -197,36 +237,188 @@ FtsProbeSegments(CdbComponentDatabases *dbs, uint8 *probeRes)
 		}
 	}
 
-	worker_info.scan_status = scan_status;
-
-	threads = (pthread_t *)palloc(workers * sizeof(pthread_t));
-	for (i = 0; i < workers; i++)
+	probes = (ProbeConnectionInfo *)
+		palloc0(cdb_component_dbs->total_segment_dbs * sizeof(ProbeConnectionInfo));
+	pollfds = (struct pollfd *)
+		palloc(cdb_component_dbs->total_segment_dbs * sizeof(struct pollfd));
+	polled = (ProbeConnectionInfo **)
+		palloc(cdb_component_dbs->total_segment_dbs * sizeof(ProbeConnectionInfo *));
+	MemSet(&stats, 0, sizeof(stats));
+	gp_set_monotonic_begin_time(&cycleStartTime);
+
+	/* set up a probe for every primary-mirror pair to check */
+	for (i = 0; i < cdb_component_dbs->total_segment_dbs; i++)
 	{
-#ifdef USE_ASSERT_CHECKING
-		int ret =
-#endif /* USE_ASSERT_CHECKING */
-		gp_pthread_create(&threads[i], probeSegmentFromThread, &worker_info, "probeSegments");
+		CdbComponentDatabaseInfo *primary = &cdb_component_dbs->segment_db_info[i];
+		CdbComponentDatabaseInfo *mirror;
+		ProbeConnectionInfo *primaryProbe;
+
+		if (!SEGMENT_IS_ACTIVE_PRIMARY(primary) ||
+			!PROBE_CHECK_FLAG(scan_status[primary->dbid], PROBE_SEGMENT))
+		{
+			continue;
+		}
+
+		/* prevent re-checking this pair */
+		scan_status[primary->dbid] &= ~PROBE_SEGMENT;
+
+		primaryProbe = &probes[nprobes++];
+		probeInit(primaryProbe, primary);
+		primaryProbe->state = PROBE_STATE_WAITING;
+
+		/* check if mirror is marked for probing */
+		mirror = FtsGetPeerSegment(primary->segindex, primary->dbid);
+		if (mirror != NULL &&
+			PROBE_CHECK_FLAG(scan_status[mirror->dbid], PROBE_SEGMENT))
+		{
+			scan_status[mirror->dbid] &= ~PROBE_SEGMENT;
 
-		Assert(ret == 0 && "FTS: failed to create probing thread");
+			primaryProbe->mirror = &probes[nprobes++];
+			probeInit(primaryProbe->mirror, mirror);
+		}
 	}
 
-	/* we have nothing left to do but wait */
-	for (i = 0; i < workers; i++)
+	while (stats.finished < nprobes)
 	{
-#ifdef USE_ASSERT_CHECKING
-		int ret =
-#endif /* USE_ASSERT_CHECKING */
-		pthread_join(threads[i], NULL);
+		int npolled = 0;
+		int inFlight = 0;
+		int res;
+
+		/* if we've gotten a pause or shutdown request, we ignore probe results. */
+		if (!FtsIsActive())
+		{
+			break;
+		}
+
+		/* time out the attempts that took too long */
+		for (i = 0; i < nprobes; i++)
+		{
+			ProbeConnectionInfo *probeInfo = &probes[i];
+
+			if (probeInfo->state == PROBE_STATE_CONNECTING ||
+				probeInfo->state == PROBE_STATE_SENDING ||
+				probeInfo->state == PROBE_STATE_RECEIVING)
+			{
+				if (probeTimeout(probeInfo, "poll"))
+				{
+					stats.timeouts++;
+					probeFail(probeInfo, &stats);
+				}
+				else
+				{
+					inFlight++;
+				}
+			}
+		}
+
+		/*
+		 * Start the probes that are due, and collect the sockets to wait for.
+		 * The probe sockets are not opened through fd.c, which does not
+		 * count them, so their number is capped here.
+		 */
+		for (i = 0; i < nprobes; i++)
+		{
+			ProbeConnectionInfo *probeInfo = &probes[i];
+
+			if (probeInfo->state == PROBE_STATE_WAITING &&
+				inFlight < PROBE_MAX_IN_FLIGHT &&
+				(probeInfo->retryCnt == 0 ||
+				 gp_get_elapsed_ms(&probeInfo->retryTime) >= PROBE_RETRY_DELAY_MS))
+			{
+				probeStart(probeInfo, &stats);
+				if (probeInfo->state == PROBE_STATE_CONNECTING)
+				{
+					inFlight++;
+				}
+			}
+
+			if (probeInfo->state == PROBE_STATE_CONNECTING ||
+				probeInfo->state == PROBE_STATE_SENDING)
+			{
+				pollfds[npolled].events = POLLOUT;
+			}
+			else if (probeInfo->state == PROBE_STATE_RECEIVING)
+			{
+				pollfds[npolled].events = POLLIN;
+			}
+			else
+			{
+				continue;
+			}
+
+			pollfds[npolled].fd = probeInfo->fd;
+			pollfds[npolled].revents = 0;
+			polled[npolled++] = probeInfo;
+		}
+
+		stats.maxInFlight = Max(stats.maxInFlight, npolled);
+
+		if (stats.finished == nprobes)
+		{
+			break;
+		}
+
+		/* with nothing in flight, this just waits for retries to be due */
+		res = gp_poll(pollfds, npolled, PROBE_POLL_TIMEOUT_MS);
+		if (res < 0)
+		{
+			if (SYS_ERR_TRANSIENT(errno))
+			{
+				continue;
+			}
+
+			write_log("FTS: failed to poll probe connections, errno %d.", errno);
+
+			/* fail the attempts in flight, and let them retry */
+			for (i = 0; i < npolled; i++)
+			{
+				probeFail(polled[i], &stats);
+			}
+			continue;
+		}
 
-		Assert(ret == 0 && "FTS: failed to join probing thread");
+		for (i = 0; i < npolled && res > 0; i++)
+		{
+			if (pollfds[i].revents == 0)
+			{
+				continue;
+			}
+
+			res--;
+			probeAdvance(polled[i], &stats);
+		}
 	}
 
-	pfree(threads);
-	threads = NULL;
+	/* close whatever is still open if we stopped early */
+	for (i = 0; i < nprobes; i++)
+	{
+		probeClose(&probes[i]);
+	}
 
 	/* if we're shutting down, just exit. */
 	if (!FtsIsActive())
+	{
+		pfree(polled);
+		pfree(pollfds);
+		pfree(probes);
 		return;
+	}
+
+	/* update results */
+	for (i = 0; i < nprobes; i++)
+	{
+		ProbeConnectionInfo *probeInfo = &probes[i];
+
+		Assert(probeInfo->state == PROBE_STATE_DONE);
+		Assert(!PROBE_CHECK_FLAG(probeInfo->segmentStatus, PROBE_SEGMENT));
+		scan_status[probeInfo->dbId] = probeInfo->segmentStatus;
+	}
+
+	probeLogCycleStats(&stats, gp_get_elapsed_ms(&cycleStartTime));
+
+	pfree(polled);
+	pfree(pollfds);
+	pfree(probes);
 
 	if (gp_log_fts >= GPVARS_VERBOSITY_DEBUG)
 	{
@@ -244,83 +436,244 @@ FtsProbeSegments(CdbComponentDatabases *dbs, uint8 *probeRes)
 
 
 /*
- * This is called from several different threads: ONLY USE THREADSAFE FUNCTIONS INSIDE.
+ * Set up the probe descriptor of a segment
  */
-static char
-probeSegment(CdbComponentDatabaseInfo *dbInfo)
+static void
+probeInit(ProbeConnectionInfo *probeInfo, CdbComponentDatabaseInfo *dbInfo)
 {
 	Assert(dbInfo != NULL);
 
-	/* setup probe descriptor */
-	ProbeConnectionInfo probeInfo;
-	memset(&probeInfo, 0, sizeof(ProbeConnectionInfo));
-	probeInfo.segmentId = dbInfo->segindex;
-	probeInfo.dbId = dbInfo->dbid;
-	probeInfo.role = dbInfo->role;
-	probeInfo.mode = dbInfo->mode;
-	probeInfo.hostIp = dbInfo->hostip;
-	probeInfo.port = dbInfo->port;
-	probeInfo.segmentStatus = PROBE_DEAD;
+	memset(probeInfo, 0, sizeof(ProbeConnectionInfo));
+	probeInfo->segmentId = dbInfo->segindex;
+	probeInfo->dbId = dbInfo->dbid;
+	probeInfo->role = dbInfo->role;
+	probeInfo->mode = dbInfo->mode;
+	probeInfo->hostIp = dbInfo->hostip;
+	probeInfo->port = dbInfo->port;
+	probeInfo->segmentStatus = PROBE_DEAD;
+	probeInfo->state = PROBE_STATE_IDLE;
+
+	/* prepare message to send to segment */
+	probeInfo->msg.packetlen = htonl((uint32) sizeof(probeInfo->msg));
+	probeInfo->msg.payload.protocolCode = (MsgType) htonl(PRIMARY_MIRROR_TRANSITION_QUERY_CODE);
+	probeInfo->msg.payload.dataLength = 0;
+}
+
+
+/*
+ * Start an attempt to probe a segment: open socket -> connect.  The rest
+ * is up to probeAdvance() as the socket becomes ready.
+ */
+static void
+probeStart(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats)
+{
+	Assert(probeInfo->state == PROBE_STATE_WAITING);
 
 	/* set probe start timestamp */
-	gp_set_monotonic_begin_time(&probeInfo.startTime);
-	int retryCnt = 1;
+	gp_set_monotonic_begin_time(&probeInfo->startTime);
+	probeInfo->bytesSent = 0;
+	probeInfo->bytesReceived = 0;
+	if (probeInfo->retryCnt == 0)
+	{
+		stats->probes++;
+	}
+
+	if (!probeGetIpAddr(probeInfo) ||
+		!probeOpenSocket(probeInfo) ||
+		!probeMarkSocketNonBlocking(probeInfo) ||
+		!probeConnect(probeInfo))
+	{
+		probeFail(probeInfo, stats);
+		return;
+	}
+
+	probeInfo->state = PROBE_STATE_CONNECTING;
+}
+
+
+/*
+ * Move a probe on after poll() reported an event on its socket:
+ * connect -> send probe msg -> receive response -> process response.
+ */
+static void
+probeAdvance(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats)
+{
+	switch (probeInfo->state)
+	{
+		case PROBE_STATE_CONNECTING:
+			if (!probeCheckConnect(probeInfo))
+			{
+				probeFail(probeInfo, stats);
+				return;
+			}
+			probeInfo->state = PROBE_STATE_SENDING;
+			/* the socket is writable, go on with sending */
+			/* FALLTHROUGH */
+
+		case PROBE_STATE_SENDING:
+			if (!probeSend(probeInfo))
+			{
+				probeFail(probeInfo, stats);
+				return;
+			}
+			if (probeInfo->bytesSent == sizeof(probeInfo->msg))
+			{
+				probeInfo->state = PROBE_STATE_RECEIVING;
+			}
+			break;
+
+		case PROBE_STATE_RECEIVING:
+			if (!probeReceive(probeInfo))
+			{
+				probeFail(probeInfo, stats);
+				return;
+			}
+			if (probeInfo->bytesReceived == sizeof(probeInfo->response))
+			{
+				if (!probeProcessResponse(probeInfo))
+				{
+					probeFail(probeInfo, stats);
+					return;
+				}
+
+				/* segment response to probe was received, close connection  */
+				probeClose(probeInfo);
+				probeFinish(probeInfo, stats);
+			}
+			break;
+
+		default:
+			Assert(!"Unexpected probe state");
+	}
+}
+
+
+/*
+ * An attempt to probe a segment failed: the connection is shut down, the
+ * socket is closed and the probe is restarted after a while; this is
+ * repeated until a response is received or the retries run out.
+ */
+static void
+probeFail(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats)
+{
+	probeClose(probeInfo);
+
+	Assert(probeInfo->segmentStatus == PROBE_DEAD);
+
+	probeInfo->retryCnt++;
 
 	/*
-	 * probe segment: open socket -> connect -> send probe msg -> receive response;
-	 * on any error the connection is shut down, the socket is closed
-	 * and the probe process is restarted;
-	 * this is repeated until no error occurs (response is received) or timeout expires;
+	 * if maximum number of retries was reached,
+	 * report segment as non-responsive (dead)
 	 */
-	while (!probeGetIpAddr(&probeInfo) ||
-	       !probeOpenSocket(&probeInfo) ||
-	       !probeMarkSocketNonBlocking(&probeInfo) ||
-	       !probeConnect(&probeInfo) ||
-	       !probeSend(&probeInfo) ||
-	       !probeReceive(&probeInfo) ||
-	       !probeProcessResponse(&probeInfo))
+	if (probeInfo->retryCnt >= gp_fts_probe_retries)
 	{
-		probeClose(&probeInfo);
+		write_log("FTS: failed to probe segment (content=%d, dbid=%d) after trying %d time(s), "
+				  "maximum number of retries reached.",
+				  probeInfo->segmentId,
+				  probeInfo->dbId,
+				  probeInfo->retryCnt);
+		probeFinish(probeInfo, stats);
+		return;
+	}
 
-		Assert(probeInfo.segmentStatus == PROBE_DEAD);
+	write_log("FTS: retry %d to probe segment (content=%d, dbid=%d).",
+			  probeInfo->retryCnt, probeInfo->segmentId, probeInfo->dbId);
 
-		/* check if FTS is active */
-		if (!FtsIsActive())
-		{
-			/* the returned value will be ignored */
-			probeInfo.segmentStatus = PROBE_ALIVE;
-			break;
-		}
+	/* wait a while to avoid tight loops */
+	stats->retries++;
+	gp_set_monotonic_begin_time(&probeInfo->retryTime);
+	probeInfo->state = PROBE_STATE_WAITING;
+}
 
-		/*
-		 * if maximum number of retries was reached,
-		 * report segment as non-responsive (dead)
-		 */
-		if (retryCnt == gp_fts_probe_retries)
+
+/*
+ * The probe of a segment is over; decide whether its mirror is probed.
+ */
+static void
+probeFinish(ProbeConnectionInfo *probeInfo, ProbeCycleStats *stats)
+{
+	ProbeConnectionInfo *mirror = probeInfo->mirror;
+
+	probeInfo->state = PROBE_STATE_DONE;
+	stats->finished++;
+
+	if (PROBE_CHECK_FLAG(probeInfo->segmentStatus, PROBE_ALIVE))
+	{
+		uint64 elapsed_ms = gp_get_elapsed_ms(&probeInfo->startTime);
+		int bucket = 0;
+
+		while (bucket < PROBE_HIST_BUCKETS - 1 && elapsed_ms >= (UINT64CONST(1) << bucket))
 		{
-			write_log("FTS: failed to probe segment (content=%d, dbid=%d) after trying %d time(s), "
-					  "maximum number of retries reached.",
-					  probeInfo.segmentId,
-					  probeInfo.dbId,
-					  retryCnt);
-			break;
+			bucket++;
 		}
+		stats->hist[bucket]++;
+	}
+	else if (gp_log_fts >= GPVARS_VERBOSITY_VERBOSE)
+	{
+		write_log("FTS: %s (dbid=%d, content=%d, status 0x%x) didn't respond to probe.",
+				  probeInfo->role == 'p' ? "primary" : "mirror",
+				  probeInfo->dbId, probeInfo->segmentId, probeInfo->segmentStatus);
+	}
 
-		/* sleep for 1 second to avoid tight loops */
-		pg_usleep(USECS_PER_SEC);
-		retryCnt++;
+	if (mirror == NULL)
+	{
+		return;
+	}
 
-		write_log("FTS: retry %d to probe segment (content=%d, dbid=%d).",
-				  retryCnt - 1, probeInfo.segmentId, probeInfo.dbId);
+	/* probe mirror only if primary is dead or has a crash/network fault */
+	if (!PROBE_CHECK_FLAG(probeInfo->segmentStatus, PROBE_ALIVE) ||
+		PROBE_CHECK_FLAG(probeInfo->segmentStatus, PROBE_FAULT_CRASH) ||
+		PROBE_CHECK_FLAG(probeInfo->segmentStatus, PROBE_FAULT_NET))
+	{
+		mirror->state = PROBE_STATE_WAITING;
+	}
+	else
+	{
+		/* assume mirror is alive */
+		mirror->segmentStatus = PROBE_ALIVE;
+		mirror->state = PROBE_STATE_DONE;
+		stats->finished++;
+	}
+}
 
-		/* reset timer */
-		gp_set_monotonic_begin_time(&probeInfo.startTime);
+
+/*
+ * Log how long a probe cycle took and how quickly the live segments
+ * responded, in buckets of doubling width.
+ */
+static void
+probeLogCycleStats(ProbeCycleStats *stats, uint64 elapsed_ms)
+{
+	char histbuf[PROBE_HIST_BUCKETS * 32];
+	int len = 0;
+	int bucket;
+
+	if (gp_log_fts < GPVARS_VERBOSITY_VERBOSE)
+	{
+		return;
 	}
 
-	/* segment response to probe was received, close connection  */
-	probeClose(&probeInfo);
+	histbuf[0] = '\0';
+	for (bucket = 0; bucket < PROBE_HIST_BUCKETS; bucket++)
+	{
+		if (stats->hist[bucket] == 0)
+		{
+			continue;
+		}
+
+		if (bucket < PROBE_HIST_BUCKETS - 1)
+			len += snprintf(histbuf + len, sizeof(histbuf) - len, " <%dms: %d",
+							1 << bucket, stats->hist[bucket]);
+		else
+			len += snprintf(histbuf + len, sizeof(histbuf) - len, " >=%dms: %d",
+							1 << (bucket - 1), stats->hist[bucket]);
+	}
 
-	return probeInfo.segmentStatus;
+	write_log("FTS: probed %d segments in " UINT64_FORMAT " ms, %d in flight at most, "
+			  "%d retries, %d timeouts; response times:%s.",
+			  stats->probes, elapsed_ms, stats->maxInFlight,
+			  stats->retries, stats->timeouts, histbuf);
 }
 
 
@@ -479,49 +832,39 @@ probeConnect(ProbeConnectionInfo *probeInfo)
 
 
 /*
- * Poll connection to check if it is ready for sending
+ * Check whether the connection that poll() reported on was established
  */
 static bool
-probePoll(ProbeConnectionInfo *probeInfo, bool incoming)
+probeCheckConnect(ProbeConnectionInfo *probeInfo)
 {
 	Assert(probeInfo != NULL);
 	Assert(probeInfo->isSocketOpened);
 	Assert(probeInfo->isConnected);
 	Assert(probeInfo->fd > 0);
 
-	int	timeoutMs = 1000;
-	int event = (incoming ? POLLIN : POLLOUT);
-	struct pollfd nfd;
-	nfd.fd = probeInfo->fd;
-	nfd.events = event;
+	int err = 0;
+	socklen_t errlen = sizeof(err);
 
-	int res = 0;
+	if (getsockopt(probeInfo->fd, SOL_SOCKET, SO_ERROR, &err, &errlen) < 0)
+	{
+		err = errno;
+	}
 
-	while (FtsIsActive() &&
-	       (res = gp_poll(&nfd, 1, timeoutMs)) <= 0 &&
-		   !probeTimeout(probeInfo, "poll"))
+	if (err != 0)
 	{
-		/* check for transient error */
-		if (res != 0 && !SYS_ERR_TRANSIENT(errno))
-		{
-			probeInfo->probe_errno = errno;
-			const char *operation = (incoming ? "receiving from" : "sending to");
-			write_log("FTS: failed to poll connection before %s segment "
-					  "(content=%d, dbid=%d), errno %d (%s).", operation,
-					  probeInfo->segmentId, probeInfo->dbId,
-					  probeInfo->probe_errno, errmessage(probeInfo));
-			break;
-		}
+		probeInfo->probe_errno = err;
+		write_log("FTS: failed to connect to segment (content=%d, dbid=%d),"
+				  " errno %d (%s).", probeInfo->segmentId, probeInfo->dbId,
+				  probeInfo->probe_errno, errmessage(probeInfo));
+		return false;
 	}
 
-	/* if we success, one file descriptor (socket) is ready for sending/receiving */
-	Assert (res <= 1);
-	return (res == 1 && ((nfd.events & event) == event));
+	return true;
 }
 
 
 /*
- * Send the status request-startup-packet
+ * Send as much of the status request-startup-packet as the socket takes
  */
 static bool
 probeSend(ProbeConnectionInfo *probeInfo)
@@ -530,46 +873,35 @@ probeSend(ProbeConnectionInfo *probeInfo)
 	Assert(probeInfo->isSocketOpened);
 	Assert(probeInfo->isConnected);
 	Assert(probeInfo->fd > 0);
+	Assert(probeInfo->bytesSent < sizeof(probeInfo->msg));
 
-	uint32 bytesSent = 0;
-
-	/* prepare message to send to segment */
-	ProbeMsg msg;
-	msg.packetlen = htonl((uint32) sizeof(msg));
-	msg.payload.protocolCode = (MsgType) htonl(PRIMARY_MIRROR_TRANSITION_QUERY_CODE);
-	msg.payload.dataLength = 0;
-
-	while (bytesSent < sizeof(msg) &&
-	       !probeTimeout(probeInfo, "send") &&
-	       probePoll(probeInfo, false /*incoming*/))
+	int res = gp_send(probeInfo->fd, ((char*) &probeInfo->msg) + probeInfo->bytesSent,
+					  sizeof(probeInfo->msg) - probeInfo->bytesSent, 0);
+	if (res < 0)
 	{
-		int res = gp_send(probeInfo->fd, ((char*) &msg) + bytesSent, sizeof(msg) - bytesSent, 0);
-		if (res < 0)
-		{
-			/* check for transient error */
-			if (!SYS_ERR_TRANSIENT(errno))
-			{
-				probeInfo->probe_errno = errno;
-				write_log("FTS: failed to send request to segment "
-						  "(dbid=%d, content=%d), errno %d (%s).",
-						  probeInfo->dbId, probeInfo->segmentId,
-						  probeInfo->probe_errno, errmessage(probeInfo));
-				break;
-			}
-		}
-		else
+		/* check for transient error */
+		if (!SYS_ERR_TRANSIENT(errno))
 		{
-			bytesSent += res;
+			probeInfo->probe_errno = errno;
+			write_log("FTS: failed to send request to segment "
+					  "(dbid=%d, content=%d), errno %d (%s).",
+					  probeInfo->dbId, probeInfo->segmentId,
+					  probeInfo->probe_errno, errmessage(probeInfo));
+			return false;
 		}
 	}
+	else
+	{
+		probeInfo->bytesSent += res;
+	}
 
-	Assert(bytesSent <= sizeof(msg));
-	return (bytesSent == sizeof(msg));
+	Assert(probeInfo->bytesSent <= sizeof(probeInfo->msg));
+	return true;
 }
 
 
 /*
- * Receive segment response
+ * Receive as much of the segment response as has arrived
  */
 static bool
 probeReceive(ProbeConnectionInfo *probeInfo)
@@ -578,58 +910,53 @@ probeReceive(ProbeConnectionInfo *probeInfo)
 	Assert(probeInfo->isSocketOpened);
 	Assert(probeInfo->isConnected);
 	Assert(probeInfo->fd > 0);
+	Assert(probeInfo->bytesReceived < sizeof(probeInfo->response));
 
-	uint32 bytesReceived = 0;
+	uint32 bytesReceived = probeInfo->bytesReceived;
 
-	while (bytesReceived < sizeof(probeInfo->response) &&
-	       !probeTimeout(probeInfo, "receive") &&
-	       probePoll(probeInfo, true /*incoming*/))
-	{
-		int res = gp_recv
-				(
-				probeInfo->fd,
-				((char*) &probeInfo->response) + bytesReceived,
-				sizeof(probeInfo->response) - bytesReceived,
-				0
-				)
-				;
+	int res = gp_recv
+			(
+			probeInfo->fd,
+			((char*) &probeInfo->response) + bytesReceived,
+			sizeof(probeInfo->response) - bytesReceived,
+			0
+			)
+			;
 
-		if (gp_log_fts > GPVARS_VERBOSITY_VERBOSE)
-		{
-			write_log("FTS: read %d offset %d remainder %ld from segment (dbid=%d, content=%d).",
-			           res, bytesReceived, (long)(sizeof(probeInfo->response) - bytesReceived), probeInfo->dbId, probeInfo->segmentId);
-		}
-
-		if (res == 0)
-		{
-			write_log("FTS: failed to receive data, segment (dbid=%d, content=%d) closed connection unexpectedly.",
-			          probeInfo->dbId, probeInfo->segmentId);
+	if (gp_log_fts > GPVARS_VERBOSITY_VERBOSE)
+	{
+		write_log("FTS: read %d offset %d remainder %ld from segment (dbid=%d, content=%d).",
+		           res, bytesReceived, (long)(sizeof(probeInfo->response) - bytesReceived), probeInfo->dbId, probeInfo->segmentId);
+	}
 
-			break;
-		}
+	if (res == 0)
+	{
+		write_log("FTS: failed to receive data, segment (dbid=%d, content=%d) closed connection unexpectedly.",
+		          probeInfo->dbId, probeInfo->segmentId);
 
-		if (res < 0)
-		{
-			/* check for transient error */
-			if (!SYS_ERR_TRANSIENT(errno))
-			{
-				probeInfo->probe_errno = errno;
-				write_log("FTS: failed to receive response from segment "
-						  "(dbid=%d, content=%d), errno %d (%s).",
-			              probeInfo->dbId, probeInfo->segmentId,
-						  probeInfo->probe_errno, errmessage(probeInfo));
-				break;
-			}
-		}
+		return false;
+	}
 
-		if (res > 0)
+	if (res < 0)
+	{
+		/* check for transient error */
+		if (!SYS_ERR_TRANSIENT(errno))
 		{
-			bytesReceived += res;
+			probeInfo->probe_errno = errno;
+			write_log("FTS: failed to receive response from segment "
+					  "(dbid=%d, content=%d), errno %d (%s).",
+		              probeInfo->dbId, probeInfo->segmentId,
+					  probeInfo->probe_errno, errmessage(probeInfo));
+			return false;
 		}
 	}
+	else
+	{
+		probeInfo->bytesReceived += res;
+	}
 
-	Assert(bytesReceived <= sizeof(probeInfo->response));
-	return (bytesReceived == sizeof(probeInfo->response));
+	Assert(probeInfo->bytesReceived <= sizeof(probeInfo->response));
+	return true;
 }
 
 
@@ -791,122 +1118,4 @@ probeProcessResponse(ProbeConnectionInfo *probeInfo)
 }
 
 
-/*
- * Function called by probing thread;
- * iteratively picks next segment pair to probe until all segments are probed;
- * probes primary; probes mirror if primary reports crash fault or does not respond
- */
-static void *
-probeSegmentFromThread(void *arg)
-{
-	threadWorkerInfo *worker_info;
-	int i;
-
-	worker_info = (threadWorkerInfo *) arg;
-
-	i = 0;
-
-	for (;;)
-	{
-		CdbComponentDatabaseInfo *primary = NULL;
-		CdbComponentDatabaseInfo *mirror = NULL;
-
-		char probe_result_primary = PROBE_DEAD;
-		char probe_result_mirror = PROBE_DEAD;
-
-		/*
-		 * find untested primary, mark primary and mirror "tested" and unlock.
-		 */
-		pthread_mutex_lock(&worker_thread_mutex);
-		for (; i < cdb_component_dbs->total_segment_dbs; i++)
-		{
-			primary = &cdb_component_dbs->segment_db_info[i];
-
-			/* check segments in pairs of primary-mirror */
-			if (!SEGMENT_IS_ACTIVE_PRIMARY(primary))
-			{
-				continue;
-			}
-
-			if (PROBE_CHECK_FLAG(worker_info->scan_status[primary->dbid], PROBE_SEGMENT))
-			{
-				/* prevent re-checking this pair */
-				worker_info->scan_status[primary->dbid] &= ~PROBE_SEGMENT;
-
-				mirror = FtsGetPeerSegment(primary->segindex, primary->dbid);
-
-				/* check if mirror is marked for probing */
-				if (mirror != NULL &&
-					PROBE_CHECK_FLAG(worker_info->scan_status[mirror->dbid], PROBE_SEGMENT))
-				{
-					worker_info->scan_status[mirror->dbid] &= ~PROBE_SEGMENT;
-				}
-				else
-				{
-					mirror = NULL;
-				}
-
-				break;
-			}
-		}
-		pthread_mutex_unlock(&worker_thread_mutex);
-
-		/* check if all segments were probed */
-		if (i == cdb_component_dbs->total_segment_dbs || primary == NULL)
-		{
-			break;
-		}
-
-		/* if we've gotten a pause or shutdown request, we ignore probe results. */
-		if (!FtsIsActive())
-		{
-			break;
-		}
-
-		/* probe primary */
-		probe_result_primary = probeSegment(primary);
-		Assert(!PROBE_CHECK_FLAG(probe_result_primary, PROBE_SEGMENT));
-
-		if ((probe_result_primary & PROBE_ALIVE) == 0 && gp_log_fts >= GPVARS_VERBOSITY_VERBOSE)
-		{
-			write_log("FTS: primary (dbid=%d, content=%d, status 0x%x) didn't respond to probe.",
-			          primary->dbid, primary->segindex, probe_result_primary);
-		}
-
-		if (mirror != NULL)
-		{
-			/* assume mirror is alive */
-			probe_result_mirror = PROBE_ALIVE;
-
-			/* probe mirror only if primary is dead or has a crash/network fault */
-			if (!PROBE_CHECK_FLAG(probe_result_primary, PROBE_ALIVE) ||
-				PROBE_CHECK_FLAG(probe_result_primary, PROBE_FAULT_CRASH) ||
-				PROBE_CHECK_FLAG(probe_result_primary, PROBE_FAULT_NET))
-			{
-				/* probe mirror */
-				probe_result_mirror = probeSegment(mirror);
-				Assert(!PROBE_CHECK_FLAG(probe_result_mirror, PROBE_SEGMENT));
-
-				if ((probe_result_mirror & PROBE_ALIVE) == 0 && gp_log_fts >= GPVARS_VERBOSITY_VERBOSE)
-				{
-					write_log("FTS: mirror (dbid=%d, content=%d, status 0x%x) didn't respond to probe.",
-					          mirror->dbid, mirror->segindex, probe_result_mirror);
-				}
-			}
-		}
-
-		/* update results */
-		pthread_mutex_lock(&worker_thread_mutex);
-		worker_info->scan_status[primary->dbid] = probe_result_primary;
-		if (mirror != NULL)
-		{
-			worker_info->scan_status[mirror->dbid] = probe_result_mirror;
-		}
-		pthread_mutex_unlock(&worker_thread_mutex);
-	}
-
-	return NULL;
-}
-
-
 /* EOF */
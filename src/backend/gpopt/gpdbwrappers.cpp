@@ -3053,11 +3053,19 @@ gpdb::UlLeafPartitions
  * We register a callback to a cache on all the catalog tables that contain
  * information that's contained in the ORCA metadata cache.
 
- * There is no fine-grained mechanism in the metadata cache for invalidating
- * individual entries ATM, so we just blow the whole cache whenever anything
- * changes. The callback simply increments a counter. Whenever we start
- * planning a query, we check the counter to see if it has changed since the
- * last planned query, and reset the whole cache if it has.
+ * Relcache invalidations name the relation that changed, so for them we
+ * remember the relation, and only the metadata cache entries of the changed
+ * relations are evicted before planning the next query (see
+ * PlMDCacheInvalidatedRels()). This covers most DDL on tables, TRUNCATE and
+ * ANALYZE, as changes to pg_statistic also send a relcache invalidation for
+ * the relation.
+ *
+ * Catcache invalidations only tell the changed tuple, not the object, so
+ * for the other catalog tables we still blow the whole cache. The callback
+ * simply increments a counter. Whenever we start planning a query, we check
+ * the counter to see if it has changed since the last planned query, and
+ * reset the whole cache if it has. We do the same if too many relations
+ * changed.
  *
  * To make sure we've covered all catalog tables that contain information
  * that's stored in the metadata cache, there are "catalog tables: xxx"
@@ -3066,10 +3074,16 @@ gpdb::UlLeafPartitions
  * anything fetched via the wrapper functions in this file can end up in the
  * metadata cache and hence need to have an invalidation callback registered.
  */
+#define MDCACHE_MAX_INVALIDATED_RELS 1024
+
 static bool mdcache_invalidation_counter_registered = false;
 static int64 mdcache_invalidation_counter = 0;
 static int64 last_mdcache_invalidation_counter = 0;
 
+/* relations changed since the last planned query */
+static Oid mdcache_invalidated_rels[MDCACHE_MAX_INVALIDATED_RELS];
+static int mdcache_num_invalidated_rels = 0;
+
 static void
 mdsyscache_invalidation_counter_callback(Datum arg, int cacheid,  ItemPointer tuplePtr)
 {
@@ -3079,7 +3093,22 @@ mdsyscache_invalidation_counter_callback(Datum arg, int cacheid,  ItemPointer tu
 static void
 mdrelcache_invalidation_counter_callback(Datum arg, Oid relid)
 {
-	mdcache_invalidation_counter++;
+	int			i;
+
+	/* InvalidOid means all relations */
+	if (!OidIsValid(relid) ||
+		mdcache_num_invalidated_rels == MDCACHE_MAX_INVALIDATED_RELS)
+	{
+		mdcache_invalidation_counter++;
+		return;
+	}
+
+	for (i = 0; i < mdcache_num_invalidated_rels; i++)
+	{
+		if (mdcache_invalidated_rels[i] == relid)
+			return;
+	}
+	mdcache_invalidated_rels[mdcache_num_invalidated_rels++] = relid;
 }
 
 static void
@@ -3095,7 +3124,6 @@ register_mdcache_invalidation_callbacks(void)
 		OPFAMILYOID,		/* pg_opfamily */
 		PARTOID,			/* pg_partition */
 		PARTRULEOID,		/* pg_partition_rule */
-		STATRELATT,			/* pg_statistics */
 		TYPEOID,			/* pg_type */
 		PROCOID,			/* pg_proc */
 
@@ -3117,6 +3145,12 @@ register_mdcache_invalidation_callbacks(void)
 		/* pg_index */
 		/* pg_trigger */
 
+		/*
+		 * Updates of pg_statistic also generate a relcache invalidation event
+		 * for the relation, see PrepareForTupleInvalidation().
+		 */
+		/* pg_statistic */
+
 		/*
 		 * pg_exttable is only updated when a new external table is dropped/created,
 		 * which will trigger a relcache invalidation event.
@@ -3168,7 +3202,9 @@ gpdb::FMDCacheNeedsReset
 			return false;
 		else
 		{
+			/* the whole cache is reset, forget the changed relations */
 			last_mdcache_invalidation_counter = mdcache_invalidation_counter;
+			mdcache_num_invalidated_rels = 0;
 			return true;
 		}
 	}
@@ -3177,4 +3213,28 @@ gpdb::FMDCacheNeedsReset
 	return true;
 }
 
+// Relations changed since last call, whose metadata cache entries must be
+// evicted
+List *
+gpdb::PlMDCacheInvalidatedRels
+		(
+			void
+		)
+{
+	GP_WRAP_START;
+	{
+		List	   *rels = NIL;
+		int			i;
+
+		for (i = 0; i < mdcache_num_invalidated_rels; i++)
+			rels = lappend_oid(rels, mdcache_invalidated_rels[i]);
+		mdcache_num_invalidated_rels = 0;
+
+		return rels;
+	}
+	GP_WRAP_END;
+
+	return NIL;
+}
+
 // EOF
@@ -29,6 +29,9 @@ using namespace gpos;
 using namespace gpdxl;
 using namespace gpmd;
 
+ULLONG CMDProviderRelcache::m_ullObjects = 0;
+ULLONG CMDProviderRelcache::m_ullRelationHits = 0;
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMDProviderRelcache::CMDProviderRelcache
@@ -67,6 +70,7 @@ CMDProviderRelcache::PstrObject
 	IMDCacheObject *pimdobj = CTranslatorRelcacheToDXL::Pimdobj(pmp, pmda, pmdid);
 
 	GPOS_ASSERT(NULL != pimdobj);
+	m_ullObjects++;
 
 	CWStringDynamic *pstr = CDXLUtils::PstrSerializeMDObj(m_pmp, pimdobj, true /*fSerializeHeaders*/, false /*findent*/);
 
@@ -68,6 +68,7 @@
 #include "gpopt/gpdbwrappers.h"
 #include "gpopt/base/CUtils.h"
 #include "gpopt/mdcache/CMDAccessor.h"
+#include "gpopt/relcache/CMDProviderRelcache.h"
 
 using namespace gpdxl;
 using namespace gpmd;
@@ -306,7 +307,9 @@ CTranslatorUtils::Pdxltabdesc
 	
 	CMDIdGPDB *pmdid = CDXLUtils::Pmdid(pmp, oidRel);
 
+	ULLONG ullObjects = CMDProviderRelcache::UllObjects();
 	const IMDRelation *pmdrel = pmda->Pmdrel(pmdid);
+	CMDProviderRelcache::RecordRelationLookup(ullObjects);
 	
 	// look up table name
 	const CWStringConst *pstrTblName = pmdrel->Mdname().Pstr();
@@ -45,6 +45,7 @@
 #include "gpos/io/COstreamFile.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/memory/CCacheAccessor.h"
 #include "gpos/task/CWorkerPoolManager.h"
 #include "gpos/task/CAutoTaskProxy.h"
 #include "gpos/task/CTaskContext.h"
@@ -62,6 +63,7 @@
 #include "gpopt/engine/CCTEConfig.h"
 #include "gpopt/mdcache/CAutoMDAccessor.h"
 #include "gpopt/mdcache/CMDCache.h"
+#include "gpopt/mdcache/CMDKey.h"
 #include "gpopt/minidump/CMiniDumperDXL.h"
 #include "gpopt/minidump/CMinidumperUtils.h"
 #include "gpopt/minidump/CSerializableStackTrace.h"
@@ -115,6 +117,13 @@ using namespace gpdbcost;
 // definition of default AutoMemoryPool
 #define AUTO_MEM_POOL(amp) CAutoMemoryPool amp(CAutoMemoryPool::ElcExc, CMemoryPoolManager::EatTracker, false /* fThreadSafe */)
 
+// accessor of the metadata cache
+typedef CCacheAccessor<IMDCacheObject*, CMDKey*> MDCacheAccessor;
+
+// counters of the metadata cache of this backend
+ULLONG COptTasks::m_ullMDCacheEvictions = 0;
+ULLONG COptTasks::m_ullMDCacheResets = 0;
+
 // default id for the source system
 const CSystemId sysidDefault(IMDId::EmdidGPDB, GPOS_WSZ_STR_LENGTH("GPDB"));
 
@@ -928,6 +937,118 @@ COptTasks::Pcm
 	return pcm;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::EvictMDCacheEntries
+//
+//	@doc:
+//		Evict the metadata cache entries of the given relations: the relation,
+//		its triggers, and the statistics of the relation and its columns
+//
+//---------------------------------------------------------------------------
+void
+COptTasks::EvictMDCacheEntries
+	(
+	IMemoryPool *pmp,
+	List *plRelOids
+	)
+{
+	ListCell *plc = NULL;
+	ForEach (plc, plRelOids)
+	{
+		OID oidRel = lfirst_oid(plc);
+		CMDIdGPDB *pmdidRel = GPOS_NEW(pmp) CMDIdGPDB(oidRel);
+		DrgPmdid *pdrgpmdid = GPOS_NEW(pmp) DrgPmdid(pmp);
+		ULONG ulColumns = 0;
+		BOOL fCached = false;
+
+		// column statistics are identified by the position of the column
+		// in the cached relation, so look at the relation before evicting it
+		{
+			CMDKey mdkey(pmdidRel);
+			MDCacheAccessor mdcacc(CMDCache::Pcache());
+			IMDCacheObject *pimdobj = mdcacc.PtLookup(&mdkey);
+			if (NULL != pimdobj)
+			{
+				const IMDRelation *pmdrel = dynamic_cast<const IMDRelation *>(pimdobj);
+				if (NULL != pmdrel)
+				{
+					ulColumns = pmdrel->UlColumns();
+					for (ULONG ul = 0; ul < pmdrel->UlTriggers(); ul++)
+					{
+						IMDId *pmdidTrigger = pmdrel->PmdidTrigger(ul);
+						pmdidTrigger->AddRef();
+						pdrgpmdid->Append(pmdidTrigger);
+					}
+				}
+				mdcacc.MarkForDeletion();
+				m_ullMDCacheEvictions++;
+				fCached = true;
+			}
+		}
+
+		if (!fCached)
+		{
+			// the relation may have been evicted before its column statistics;
+			// take the number of columns from the relcache, including the
+			// system columns
+			Relation rel = gpdb::RelGetRelation(oidRel);
+			if (NULL != rel)
+			{
+				ulColumns = rel->rd_att->natts - FirstLowInvalidHeapAttributeNumber;
+				gpdb::CloseRelation(rel);
+			}
+		}
+
+		pmdidRel->AddRef();
+		pdrgpmdid->Append(GPOS_NEW(pmp) CMDIdRelStats(pmdidRel));
+		for (ULONG ul = 0; ul < ulColumns; ul++)
+		{
+			pmdidRel->AddRef();
+			pdrgpmdid->Append(GPOS_NEW(pmp) CMDIdColStats(pmdidRel, ul));
+		}
+
+		for (ULONG ul = 0; ul < pdrgpmdid->UlLength(); ul++)
+		{
+			CMDKey mdkey((*pdrgpmdid)[ul]);
+			MDCacheAccessor mdcacc(CMDCache::Pcache());
+			if (NULL != mdcacc.PtLookup(&mdkey))
+			{
+				mdcacc.MarkForDeletion();
+				m_ullMDCacheEvictions++;
+			}
+		}
+
+		pdrgpmdid->Release();
+		pmdidRel->Release();
+	}
+
+	gpdb::FreeList(plRelOids);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::MDCacheStats
+//
+//	@doc:
+//		Counters of the metadata cache of this backend
+//
+//---------------------------------------------------------------------------
+void
+COptTasks::MDCacheStats
+	(
+	ULLONG *pullHits,
+	ULLONG *pullMisses,
+	ULLONG *pullEvictions,
+	ULLONG *pullResets
+	)
+{
+	*pullHits = CMDProviderRelcache::UllRelationHits();
+	*pullMisses = CMDProviderRelcache::UllObjects();
+	*pullEvictions = m_ullMDCacheEvictions;
+	*pullResets = m_ullMDCacheResets;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::PvOptimizeTask
@@ -973,10 +1094,17 @@ COptTasks::PvOptimizeTask
 	{
 		CMDCache::Reset();
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		m_ullMDCacheResets++;
 	}
-	else if (CMDCache::ULLGetCacheQuota() != optimizer_mdcache_size * 1024L)
+	else
 	{
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		// evict the entries of the relations changed since the last query
+		EvictMDCacheEntries(pmp, gpdb::PlMDCacheInvalidatedRels());
+
+		if (CMDCache::ULLGetCacheQuota() != optimizer_mdcache_size * 1024L)
+		{
+			CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		}
 	}
 
 
@@ -1547,10 +1675,17 @@ COptTasks::PvEvalExprFromDXLTask
 	{
 		CMDCache::Reset();
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		m_ullMDCacheResets++;
 	}
-	else if (CMDCache::ULLGetCacheQuota() != optimizer_mdcache_size * 1024L)
+	else
 	{
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		// evict the entries of the relations changed since the last query
+		EvictMDCacheEntries(pmp, gpdb::PlMDCacheInvalidatedRels());
+
+		if (CMDCache::ULLGetCacheQuota() != optimizer_mdcache_size * 1024L)
+		{
+			CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		}
 	}
 
 	GPOS_TRY
@@ -1057,6 +1057,32 @@ LibraryVersion()
 }
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		MDCacheStats
+//
+//	@doc:
+//		Returns the counters of the metadata cache of this backend
+//
+//---------------------------------------------------------------------------
+extern "C" {
+void
+MDCacheStats(int64 *pllHits, int64 *pllMisses, int64 *pllEvictions, int64 *pllResets)
+{
+	ULLONG ullHits = 0;
+	ULLONG ullMisses = 0;
+	ULLONG ullEvictions = 0;
+	ULLONG ullResets = 0;
+
+	COptTasks::MDCacheStats(&ullHits, &ullMisses, &ullEvictions, &ullResets);
+
+	*pllHits = (int64) ullHits;
+	*pllMisses = (int64) ullMisses;
+	*pllEvictions = (int64) ullEvictions;
+	*pllResets = (int64) ullResets;
+}
+}
+
 extern "C" {
 StringInfo
 OptVersion()
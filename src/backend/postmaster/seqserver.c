@@ -75,8 +75,23 @@ static pid_t seqserver_forkexec(void);
 #endif
 NON_EXEC_STATIC void SeqServerMain(int argc, char *argv[]);
 
+/*
+ * A nextval request read from a QE, waiting for the other requests read in
+ * the same round to be served with it.
+ */
+typedef struct PendingNextVal
+{
+	int			sockfd;
+	NextValRequest request;
+	NextValResponse response;
+	bool		done;			/* response is filled in */
+	bool		failed;			/* close the connection instead */
+} PendingNextVal;
+
 static void SeqServerLoop(void);
-static bool processSequenceRequest( int sockfd );
+static bool readSequenceRequest(int sockfd, NextValRequest *request);
+static void processSequenceRequests(PendingNextVal *pending, int npending);
+static bool writeSequenceResponse(int sockfd, NextValResponse *response);
 static int listenerSetup(void);
 
 
@@ -154,6 +169,7 @@ void
 sendSequenceRequest(int     sockfd, 
 					Relation seqrel,
                     int     session_id,
+                    int64   nvalues,
 					int64  *plast, 
                     int64  *pcached,
 			 		int64  *pincrement,
@@ -192,6 +208,7 @@ sendSequenceRequest(int     sockfd,
 	request.seq_oid = htonl(seq_oid);
 	request.isTemp = htonl(isTemp);
     request.session_id = htonl(session_id);
+	request.num_values = htonl((uint32_t) Min(nvalues, PG_INT32_MAX));
 	request.endCookie = SEQ_SERVER_REQUEST_END;
 
 	/*
@@ -565,6 +582,11 @@ SeqServerLoop(void)
 	
 	List   *connectedSockets = NIL;
 	ListCell   *cell;
+
+	PendingNextVal *pending = NULL;
+	int			maxPending = 0;
+	int			npending;
+	int			i;
 	
 	tval.tv_sec = 3;
 	tval.tv_usec = 500000;
@@ -645,7 +667,21 @@ SeqServerLoop(void)
 		}
 		
 		
-		/* loop through all of our established sockets */					
+		/*
+		 * Read a request from each of our established sockets that has one,
+		 * serve them together, and only then answer them.  Requests for the
+		 * same sequence in a round take a single trip to the sequence's
+		 * buffer and WAL, and the QEs that sent them wait together.
+		 */
+		if (list_length(connectedSockets) > maxPending)
+		{
+			maxPending = list_length(connectedSockets) * 2;
+			if (pending)
+				pfree(pending);
+			pending = palloc(maxPending * sizeof(PendingNextVal));
+		}
+		npending = 0;
+
 		cell = list_head(connectedSockets);
 		while (cell != NULL)
 		{
@@ -656,41 +692,48 @@ SeqServerLoop(void)
 			
 			if (MPP_FD_ISSET(fd, &rrset))
 			{				
-				if (!processSequenceRequest(fd))
-				{
-					/* close it down */	
-					MPP_FD_CLR( fd, &rset);
-					connectedSockets = list_delete_int(connectedSockets, fd);
-					shutdown(fd, SHUT_WR);
-					close(fd);
-				}							
+				PendingNextVal *p = &pending[npending];
+
+				p->sockfd = fd;
+				p->done = false;
+				p->failed = !readSequenceRequest(fd, &p->request);
+				npending++;
 			}	
 		}
+
+		processSequenceRequests(pending, npending);
+
+		for (i = 0; i < npending; i++)
+		{
+			PendingNextVal *p = &pending[i];
+
+			if (p->failed ||
+				!writeSequenceResponse(p->sockfd, &p->response))
+			{
+				/* close it down */	
+				MPP_FD_CLR(p->sockfd, &rset);
+				connectedSockets = list_delete_int(connectedSockets, p->sockfd);
+				shutdown(p->sockfd, SHUT_WR);
+				close(p->sockfd);
+			}
+		}
 	} /* end server loop */
 
 	return;
 }
 
 /*
- * Used by sequenceServer to process incoming Sequence Requests
+ * Used by sequenceServer to read an incoming Sequence Request
  */
 static bool
-processSequenceRequest(int sockfd )
+readSequenceRequest(int sockfd, NextValRequest *nextValRequest)
 {
-	NextValRequest nextValRequest;
-    NextValResponse response;
 	int			saved_err;
-	mpp_fd_set	rset, wset;
-	int64 plast;
-	int64 pcached;
-	int64 pincrement;
-	bool poverflow = false;
+	mpp_fd_set	rset;
 	
 	int n;
 	int bytesRead = 0;
-	int bytesWritten = 0;
 	int reqlen = sizeof(NextValRequest);
-    int outputBuffLength = sizeof(NextValResponse);
 
 	bool checkCookie = true;
 
@@ -789,57 +832,171 @@ processSequenceRequest(int sockfd )
 	/*
 	 * process what we've read
 	 */
-	memcpy(&nextValRequest, inputBuff, sizeof(nextValRequest));
-	nextValRequest.dbid    	    = ntohl(nextValRequest.dbid);
-	nextValRequest.tablespaceid = ntohl(nextValRequest.tablespaceid);
-	nextValRequest.seq_oid      = ntohl(nextValRequest.seq_oid);
-	nextValRequest.isTemp       = ntohl(nextValRequest.isTemp);
-    nextValRequest.session_id   = ntohl(nextValRequest.session_id);
+	memcpy(nextValRequest, inputBuff, sizeof(*nextValRequest));
+	nextValRequest->dbid    	 = ntohl(nextValRequest->dbid);
+	nextValRequest->tablespaceid = ntohl(nextValRequest->tablespaceid);
+	nextValRequest->seq_oid      = ntohl(nextValRequest->seq_oid);
+	nextValRequest->isTemp       = ntohl(nextValRequest->isTemp);
+    nextValRequest->session_id   = ntohl(nextValRequest->session_id);
+	nextValRequest->num_values   = Max(ntohl(nextValRequest->num_values), 1);
 	
 	elog(DEBUG5, "Received nextval request for dbid: %ld tablespaceid: %ld seqoid: "
-				  "%ld isTemp: %s session_id: %ld",
-				  (long int)nextValRequest.dbid,
-				  (long int)nextValRequest.tablespaceid,
-				  (long int)nextValRequest.seq_oid,
-				  nextValRequest.isTemp ? "true" : "false",
-				  (long)nextValRequest.session_id);
+				  "%ld isTemp: %s session_id: %ld num_values: %ld",
+				  (long int)nextValRequest->dbid,
+				  (long int)nextValRequest->tablespaceid,
+				  (long int)nextValRequest->seq_oid,
+				  nextValRequest->isTemp ? "true" : "false",
+				  (long)nextValRequest->session_id,
+				  (long)nextValRequest->num_values);
 
-	/*
-	 * Process request.
-	 *
-	 * MPP-10189: May throw an error, we need to catch it -- just slam
-	 * our connection shut (caller will do that if we return false).
-	 */
-	PG_TRY();
-	{
-		cdb_sequence_nextval_server(nextValRequest.tablespaceid,
-									nextValRequest.dbid,
-									nextValRequest.seq_oid,
-									nextValRequest.isTemp,
-									&plast,
-									&pcached,
-									&pincrement,
-									&poverflow);
-	}
-	PG_CATCH();
+	return true;
+}
+
+/*
+ * Do two requests ask for values of the same sequence?
+ */
+static bool
+sameSequence(NextValRequest *a, NextValRequest *b)
+{
+	return a->dbid == b->dbid &&
+		a->tablespaceid == b->tablespaceid &&
+		a->seq_oid == b->seq_oid &&
+		a->isTemp == b->isTemp;
+}
+
+/*
+ * Used by sequenceServer to serve the requests read in one round.
+ *
+ * The requests for the same sequence are served with as few calls to
+ * nextval as the sequence allows: each call fetches the values of all of
+ * them, which are then handed out in order of the requests. The last one
+ * also gets whatever the call fetched beyond what they asked for.
+ */
+static void
+processSequenceRequests(PendingNextVal *pending, int npending)
+{
+	int			i;
+	int			j;
+
+	for (i = 0; i < npending; i++)
 	{
-		if (!elog_demote(LOG))
+		NextValRequest *request = &pending[i].request;
+		int64		total = 0;
+
+		if (pending[i].done || pending[i].failed)
+			continue;
+
+		for (j = i; j < npending; j++)
 		{
-    		elog(LOG, "unable to demote error");
-			PG_RE_THROW();
+			if (!pending[j].done && !pending[j].failed &&
+				sameSequence(request, &pending[j].request))
+				total += pending[j].request.num_values;
 		}
-		return false;
-	}
-	PG_END_TRY();
 
-	/*
-	 * Create the response
-	 */
+		while (total > 0)
+		{
+			int64		plast;
+			int64		pcached;
+			int64		pincrement;
+			bool		poverflow = false;
+			int64		count;
+
+			/*
+			 * MPP-10189: May throw an error, we need to catch it -- just slam
+			 * the connections shut (caller will do that for failed requests).
+			 */
+			PG_TRY();
+			{
+				cdb_sequence_nextval_server(request->tablespaceid,
+											request->dbid,
+											request->seq_oid,
+											request->isTemp,
+											total,
+											&plast,
+											&pcached,
+											&pincrement,
+											&poverflow);
+			}
+			PG_CATCH();
+			{
+				if (!elog_demote(LOG))
+				{
+					elog(LOG, "unable to demote error");
+					PG_RE_THROW();
+				}
+				for (j = i; j < npending; j++)
+				{
+					if (!pending[j].done &&
+						sameSequence(request, &pending[j].request))
+						pending[j].failed = true;
+				}
+				break;
+			}
+			PG_END_TRY();
+
+			/* The values fetched are plast, plast + pincrement, ..., pcached */
+			count = (poverflow || pincrement == 0) ? 0 :
+				(pcached - plast) / pincrement + 1;
+
+			for (j = i; j < npending; j++)
+			{
+				PendingNextVal *p = &pending[j];
+				int64		n;
+
+				if (p->done || p->failed ||
+					!sameSequence(request, &p->request))
+					continue;
 
-	response.plast = plast;
-	response.pcached = pcached;
-	response.pincrement = pincrement;
-	response.poverflowed = poverflow;
+				if (poverflow)
+				{
+					p->response.plast = plast;
+					p->response.pcached = pcached;
+					p->response.pincrement = pincrement;
+					p->response.poverflowed = true;
+					p->done = true;
+					total = 0;
+					continue;
+				}
+
+				if (count == 0)
+					break;
+
+				/*
+				 * nextval fetches at least the CACHE of the sequence, which
+				 * may be more than the requests asked for. The last request
+				 * takes the rest rather than letting it go unused.
+				 */
+				if (total - p->request.num_values <= 0)
+					n = count;
+				else
+					n = Min(p->request.num_values, count);
+				p->response.plast = plast;
+				p->response.pcached = plast + (n - 1) * pincrement;
+				p->response.pincrement = pincrement;
+				p->response.poverflowed = false;
+				p->done = true;
+
+				total -= p->request.num_values;
+				count -= n;
+				if (count > 0)
+					plast = p->response.pcached + pincrement;
+			}
+		}
+	}
+}
+
+/*
+ * Used by sequenceServer to answer a Sequence Request
+ */
+static bool
+writeSequenceResponse(int sockfd, NextValResponse *response)
+{
+	int			saved_err;
+	mpp_fd_set	wset;
+	
+	int n;
+	int bytesWritten = 0;
+    int outputBuffLength = sizeof(NextValResponse);
 
 	/*
 	 * Write the response
@@ -848,7 +1005,7 @@ processSequenceRequest(int sockfd )
 	{
 		CHECK_FOR_INTERRUPTS();
 
-		n = write(sockfd, ((uint8 *)&response)+bytesWritten, outputBuffLength - bytesWritten);
+		n = write(sockfd, ((uint8 *)response)+bytesWritten, outputBuffLength - bytesWritten);
 		saved_err = errno;
 
 		if (n == 0)
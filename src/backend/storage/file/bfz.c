@@ -36,6 +36,16 @@ static const struct{
 {
     {{"none", "false", "no", "off", "0", 0}, bfz_nothing_init},
     {{"zlib", 0}, bfz_zlib_init},
+#ifdef HAVE_LIBLZ4
+    {{"lz4", 0}, bfz_lz4_init},
+#else
+    {{"lz4", 0}, NULL},
+#endif
+#ifdef HAVE_LIBZSTD
+    {{"zstd", 0}, bfz_zstd_init},
+#else
+    {{"zstd", 0}, NULL},
+#endif
     {{0}}
 };
 
@@ -54,9 +64,14 @@ bfz_string_to_compression(const char *string)
 	const char *const * a;
 
 	for (i = 0; compression_algorithms[i].name[0]; i++)
+	{
+		/* Not supported by this build */
+		if (compression_algorithms[i].init == NULL)
+			continue;
 		for (a = compression_algorithms[i].name; *a; a++)
 			if (!pg_strcasecmp(*a, string))
 				return i;
+	}
 	return -1;
 }
 
@@ -0,0 +1,177 @@
+/* compress_lz4.c */
+#include "postgres.h"
+
+#include <unistd.h>
+#include "storage/bfz.h"
+#include "storage/fd.h"
+
+#ifdef HAVE_LIBLZ4
+
+#include <lz4.h>
+
+/*
+ * This file implements bfz compression algorithm "lz4".
+ *
+ * bfz hands us one buffer of at most BFZ_BUFFER_SIZE bytes at a time, and
+ * reads back one buffer at a time, so every buffer is compressed on its own
+ * and written as a block: a header with the compressed and the original
+ * size, followed by the compressed data. A buffer that does not compress
+ * is stored as is, with both sizes equal.
+ */
+
+typedef struct bfz_lz4_header
+{
+	uint32		compressed_size;
+	uint32		raw_size;
+} bfz_lz4_header;
+
+struct bfz_lz4_freeable_stuff
+{
+	struct bfz_freeable_stuff super;
+
+	char		compressed[LZ4_COMPRESSBOUND(BFZ_BUFFER_SIZE)];
+};
+
+/*
+ * bfz_lz4_close_ex
+ *  Close a file and freeing up descriptor, buffers etc.
+ *
+ *  This is also called from an xact end callback, hence it should
+ *  not contain any elog(ERROR) calls.
+ */
+static void
+bfz_lz4_close_ex(bfz_t * thiz)
+{
+	gp_retry_close(thiz->fd);
+	thiz->fd = -1;
+	pfree(thiz->freeable_stuff);
+	thiz->freeable_stuff = NULL;
+}
+
+static void
+bfz_lz4_write_fully(bfz_t * thiz, const char *buffer, int size)
+{
+	while (size)
+	{
+		int			i = writeAndRetry(thiz->fd, buffer, size);
+
+		if (i < 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_IO_ERROR),
+					errmsg("could not write to temporary file: %m")));
+		buffer += i;
+		size -= i;
+	}
+}
+
+/*
+ * Returns the number of bytes read, which is less than size only at the end
+ * of the file.
+ */
+static int
+bfz_lz4_read_fully(bfz_t * thiz, char *buffer, int size)
+{
+	int			orig_size = size;
+
+	while (size)
+	{
+		int			i = readAndRetry(thiz->fd, buffer, size);
+
+		if (i < 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_IO_ERROR),
+					errmsg("could not read from temporary file: %m")));
+		if (i == 0)
+			break;
+		buffer += i;
+		size -= i;
+	}
+	return orig_size - size;
+}
+
+/*
+ * bfz_lz4_write_ex
+ *   Compress a buffer and write it out as one block.
+ */
+static void
+bfz_lz4_write_ex(bfz_t * thiz, const char *buffer, int size)
+{
+	struct bfz_lz4_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_lz4_header header;
+	int			compressed_size;
+
+	Assert(size <= BFZ_BUFFER_SIZE);
+
+	compressed_size = LZ4_compress_default(buffer, fs->compressed,
+										   size, sizeof(fs->compressed));
+	if (compressed_size <= 0 || compressed_size >= size)
+		compressed_size = size;
+
+	header.compressed_size = compressed_size;
+	header.raw_size = size;
+	bfz_lz4_write_fully(thiz, (char *) &header, sizeof(header));
+	bfz_lz4_write_fully(thiz,
+						compressed_size == size ? buffer : fs->compressed,
+						compressed_size);
+}
+
+/*
+ * bfz_lz4_read_ex
+ *  Read the next block and decompress it into buffer.
+ *
+ *  Returns the size of the block, or 0 at the end of the file.
+ */
+static int
+bfz_lz4_read_ex(bfz_t * thiz, char *buffer, int size)
+{
+	struct bfz_lz4_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_lz4_header header;
+	int			i;
+
+	i = bfz_lz4_read_fully(thiz, (char *) &header, sizeof(header));
+	if (i == 0)
+		return 0;
+	if (i != sizeof(header) ||
+		header.raw_size > size ||
+		header.compressed_size > header.raw_size)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("invalid block header in temporary file")));
+
+	if (header.compressed_size == header.raw_size)
+		i = bfz_lz4_read_fully(thiz, buffer, header.raw_size);
+	else
+		i = bfz_lz4_read_fully(thiz, fs->compressed, header.compressed_size);
+	if (i != header.compressed_size)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("unexpected end of temporary file")));
+
+	if (header.compressed_size != header.raw_size &&
+		LZ4_decompress_safe(fs->compressed, buffer, header.compressed_size,
+							header.raw_size) != header.raw_size)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("could not decompress temporary file block")));
+
+	return header.raw_size;
+}
+
+void
+bfz_lz4_init(bfz_t * thiz)
+{
+	/*
+	 * Check that we are allocating in the TopMemoryContext since this
+	 * memory context must still be available when calling the transaction
+	 * callback at the time when the transaction aborts.
+	 */
+	Assert(TopMemoryContext == CurrentMemoryContext);
+	struct bfz_lz4_freeable_stuff *fs = palloc(sizeof *fs);
+
+	thiz->freeable_stuff = &fs->super;
+	fs->super.read_ex = bfz_lz4_read_ex;
+	fs->super.write_ex = bfz_lz4_write_ex;
+	fs->super.close_ex = bfz_lz4_close_ex;
+}
+
+#endif   /* HAVE_LIBLZ4 */
@@ -0,0 +1,214 @@
+/* compress_zstd.c */
+#include "postgres.h"
+
+#include <unistd.h>
+#include "storage/bfz.h"
+#include "storage/fd.h"
+
+#ifdef HAVE_LIBZSTD
+
+#include <zstd.h>
+
+/*
+ * This file implements bfz compression algorithm "zstd".
+ *
+ * bfz hands us one buffer of at most BFZ_BUFFER_SIZE bytes at a time, and
+ * reads back one buffer at a time, so every buffer is compressed on its own
+ * and written as a block: a header with the compressed and the original
+ * size, followed by the compressed data. A buffer that does not compress
+ * is stored as is, with both sizes equal.
+ *
+ * We compress at a low level: spill files are written once and read back
+ * soon, so speed matters more than the ratio.
+ */
+
+#define BFZ_ZSTD_LEVEL 1
+
+typedef struct bfz_zstd_header
+{
+	uint32		compressed_size;
+	uint32		raw_size;
+} bfz_zstd_header;
+
+struct bfz_zstd_freeable_stuff
+{
+	struct bfz_freeable_stuff super;
+
+	/* Created on first use, depending on the mode of the file */
+	ZSTD_CCtx  *cctx;
+	ZSTD_DCtx  *dctx;
+
+	char		compressed[ZSTD_COMPRESSBOUND(BFZ_BUFFER_SIZE)];
+};
+
+/*
+ * bfz_zstd_close_ex
+ *  Close a file and freeing up descriptor, buffers etc.
+ *
+ *  This is also called from an xact end callback, hence it should
+ *  not contain any elog(ERROR) calls.
+ */
+static void
+bfz_zstd_close_ex(bfz_t * thiz)
+{
+	struct bfz_zstd_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+
+	if (fs->cctx)
+		ZSTD_freeCCtx(fs->cctx);
+	if (fs->dctx)
+		ZSTD_freeDCtx(fs->dctx);
+	gp_retry_close(thiz->fd);
+	thiz->fd = -1;
+	pfree(thiz->freeable_stuff);
+	thiz->freeable_stuff = NULL;
+}
+
+static void
+bfz_zstd_write_fully(bfz_t * thiz, const char *buffer, int size)
+{
+	while (size)
+	{
+		int			i = writeAndRetry(thiz->fd, buffer, size);
+
+		if (i < 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_IO_ERROR),
+					errmsg("could not write to temporary file: %m")));
+		buffer += i;
+		size -= i;
+	}
+}
+
+/*
+ * Returns the number of bytes read, which is less than size only at the end
+ * of the file.
+ */
+static int
+bfz_zstd_read_fully(bfz_t * thiz, char *buffer, int size)
+{
+	int			orig_size = size;
+
+	while (size)
+	{
+		int			i = readAndRetry(thiz->fd, buffer, size);
+
+		if (i < 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_IO_ERROR),
+					errmsg("could not read from temporary file: %m")));
+		if (i == 0)
+			break;
+		buffer += i;
+		size -= i;
+	}
+	return orig_size - size;
+}
+
+/*
+ * bfz_zstd_write_ex
+ *   Compress a buffer and write it out as one block.
+ */
+static void
+bfz_zstd_write_ex(bfz_t * thiz, const char *buffer, int size)
+{
+	struct bfz_zstd_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_zstd_header header;
+	size_t		compressed_size;
+
+	Assert(size <= BFZ_BUFFER_SIZE);
+
+	if (fs->cctx == NULL)
+	{
+		fs->cctx = ZSTD_createCCtx();
+		if (fs->cctx == NULL)
+			ereport(ERROR,
+					(errcode(ERRCODE_OUT_OF_MEMORY),
+					 errmsg("out of memory")));
+	}
+
+	compressed_size = ZSTD_compressCCtx(fs->cctx, fs->compressed,
+										sizeof(fs->compressed),
+										buffer, size, BFZ_ZSTD_LEVEL);
+	if (ZSTD_isError(compressed_size) || compressed_size >= size)
+		compressed_size = size;
+
+	header.compressed_size = compressed_size;
+	header.raw_size = size;
+	bfz_zstd_write_fully(thiz, (char *) &header, sizeof(header));
+	bfz_zstd_write_fully(thiz,
+						 compressed_size == size ? buffer : fs->compressed,
+						 compressed_size);
+}
+
+/*
+ * bfz_zstd_read_ex
+ *  Read the next block and decompress it into buffer.
+ *
+ *  Returns the size of the block, or 0 at the end of the file.
+ */
+static int
+bfz_zstd_read_ex(bfz_t * thiz, char *buffer, int size)
+{
+	struct bfz_zstd_freeable_stuff *fs = (void *) thiz->freeable_stuff;
+	bfz_zstd_header header;
+	int			i;
+
+	i = bfz_zstd_read_fully(thiz, (char *) &header, sizeof(header));
+	if (i == 0)
+		return 0;
+	if (i != sizeof(header) ||
+		header.raw_size > size ||
+		header.compressed_size > header.raw_size)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("invalid block header in temporary file")));
+
+	if (header.compressed_size == header.raw_size)
+		i = bfz_zstd_read_fully(thiz, buffer, header.raw_size);
+	else
+		i = bfz_zstd_read_fully(thiz, fs->compressed, header.compressed_size);
+	if (i != header.compressed_size)
+		ereport(ERROR,
+				(errcode(ERRCODE_DATA_CORRUPTED),
+				 errmsg("unexpected end of temporary file")));
+
+	if (header.compressed_size != header.raw_size)
+	{
+		if (fs->dctx == NULL)
+		{
+			fs->dctx = ZSTD_createDCtx();
+			if (fs->dctx == NULL)
+				ereport(ERROR,
+						(errcode(ERRCODE_OUT_OF_MEMORY),
+						 errmsg("out of memory")));
+		}
+
+		if (ZSTD_decompressDCtx(fs->dctx, buffer, header.raw_size,
+								fs->compressed,
+								header.compressed_size) != header.raw_size)
+			ereport(ERROR,
+					(errcode(ERRCODE_DATA_CORRUPTED),
+					 errmsg("could not decompress temporary file block")));
+	}
+
+	return header.raw_size;
+}
+
+void
+bfz_zstd_init(bfz_t * thiz)
+{
+	/*
+	 * Check that we are allocating in the TopMemoryContext since this
+	 * memory context must still be available when calling the transaction
+	 * callback at the time when the transaction aborts.
+	 */
+	Assert(TopMemoryContext == CurrentMemoryContext);
+	struct bfz_zstd_freeable_stuff *fs = palloc0(sizeof *fs);
+
+	thiz->freeable_stuff = &fs->super;
+	fs->super.read_ex = bfz_zstd_read_ex;
+	fs->super.write_ex = bfz_zstd_write_ex;
+	fs->super.close_ex = bfz_zstd_close_ex;
+}
+
+#endif   /* HAVE_LIBZSTD */
@@ -0,0 +1,415 @@
+/*
+ * compress_bench.c
+ *		Compare the bfz compression algorithms on spilled tuple streams.
+ *
+ * This is not a unit test, and "make check" does not run it. Build and run
+ * it with
+ *
+ *		make compress_bench && ./compress_bench [megabytes]
+ *
+ * For every algorithm the server was built with, it prints the compression
+ * ratio, and the compression and decompression throughput, on synthetic
+ * streams that look like what hash join, hash aggregate and sort spill to
+ * workfiles: a hash value or a sort key followed by a MemTuple. The data is
+ * fed to the algorithms in BFZ_BUFFER_SIZE buffers, the way bfz does, and
+ * every block is decompressed and checked against the original.
+ */
+#include "postgres_fe.h"
+
+#include <sys/time.h>
+#include <zlib.h>
+#ifdef HAVE_LIBLZ4
+#include <lz4.h>
+#endif
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+/* BFZ_BUFFER_SIZE; storage/bfz.h is for the backend only */
+#define BLOCK_SIZE (1<<14)
+
+typedef struct Stream
+{
+	const char *name;
+	char	   *data;
+	size_t		size;
+} Stream;
+
+typedef struct Codec
+{
+	const char *name;
+
+	/* Compress/decompress the whole stream, block by block */
+	size_t		(*compress) (const Stream *in, char *out, size_t *blocklens);
+	void		(*decompress) (const char *in, size_t insize,
+							   const size_t *blocklens, int nblocks,
+							   char *out);
+} Codec;
+
+static uint32 seed = 42;
+
+static uint32
+next_random(void)
+{
+	/* Numerical Recipes LCG; good enough for test data, and repeatable */
+	seed = seed * 1664525 + 1013904223;
+	return seed >> 8;
+}
+
+static const char *const words[] = {
+	"furiously", "regular", "deposits", "sleep", "quickly", "final",
+	"packages", "among", "the", "ironic", "accounts", "carefully",
+	"express", "requests", "blithely", "pending", "theodolites", "haggle"
+};
+
+static const char *const shipmodes[] = {
+	"AIR", "FOB", "MAIL", "RAIL", "REG AIR", "SHIP", "TRUCK"
+};
+
+static size_t
+append(char *p, const void *data, size_t len)
+{
+	memcpy(p, data, len);
+	return len;
+}
+
+/*
+ * Hash join spill of a lineitem-like table: hash value, then a MemTuple with
+ * a few integer and date columns, a short text column from a small domain,
+ * and a comment made of words.
+ */
+static size_t
+make_lineitem_tuple(char *p, int64 i)
+{
+	size_t		off = 0;
+	uint32		hashvalue = next_random() * 2654435761U;
+	uint32		len;
+	int32		orderkey = (int32) (i / 4);
+	int32		partkey = next_random() % 200000;
+	int64		quantity = 1 + next_random() % 50;
+	int64		price = quantity * (90000 + partkey % 20000);
+	int32		shipdate = 9000 + next_random() % 2500;
+	const char *shipmode = shipmodes[next_random() % lengthof(shipmodes)];
+	char		comment[128];
+	int			nwords = 3 + next_random() % 5;
+	int			clen = 0;
+	int			w;
+	char		varlen;
+
+	for (w = 0; w < nwords; w++)
+		clen += snprintf(comment + clen, sizeof(comment) - clen, "%s%s",
+						 w ? " " : "",
+						 words[next_random() % lengthof(words)]);
+
+	off += append(p + off, &hashvalue, sizeof(hashvalue));
+	/* MemTuple length word, filled in below */
+	off += sizeof(len);
+	off += append(p + off, &orderkey, sizeof(orderkey));
+	off += append(p + off, &partkey, sizeof(partkey));
+	off += append(p + off, &quantity, sizeof(quantity));
+	off += append(p + off, &price, sizeof(price));
+	off += append(p + off, &shipdate, sizeof(shipdate));
+	/* short varlenas, with a one-byte header */
+	varlen = (char) (strlen(shipmode) + 1);
+	off += append(p + off, &varlen, 1);
+	off += append(p + off, shipmode, strlen(shipmode));
+	varlen = (char) (clen + 1);
+	off += append(p + off, &varlen, 1);
+	off += append(p + off, comment, clen);
+	/* MemTuples are 8 byte aligned */
+	while (off % 8)
+		p[off++] = 0;
+
+	len = off - sizeof(hashvalue);
+	memcpy(p + sizeof(hashvalue), &len, sizeof(len));
+	return off;
+}
+
+/*
+ * Hash aggregate spill of (int8 group key, int8 count, float8 sum) groups,
+ * in hash order.
+ */
+static size_t
+make_agg_tuple(char *p, int64 i)
+{
+	size_t		off = 0;
+	uint32		hashvalue = next_random() * 2654435761U;
+	uint32		len = 32;
+	int64		key = next_random() % 10000000;
+	int64		count = 1 + next_random() % 100;
+	double		sum = count * (next_random() % 1000) / 10.0;
+
+	off += append(p + off, &hashvalue, sizeof(hashvalue));
+	off += append(p + off, &len, sizeof(len));
+	off += append(p + off, &key, sizeof(key));
+	off += append(p + off, &count, sizeof(count));
+	off += append(p + off, &sum, sizeof(sum));
+	return off;
+}
+
+/*
+ * Sort run of the lineitem-like table, sorted on orderkey: the same tuples,
+ * without the hash value.
+ */
+static size_t
+make_sorted_tuple(char *p, int64 i)
+{
+	size_t		off = make_lineitem_tuple(p, i);
+
+	memmove(p, p + sizeof(uint32), off - sizeof(uint32));
+	return off - sizeof(uint32);
+}
+
+static void
+make_stream(Stream *s, const char *name, size_t size,
+			size_t (*make_tuple) (char *p, int64 i))
+{
+	int64		i = 0;
+
+	s->name = name;
+	s->data = malloc(size + 1024);
+	s->size = 0;
+	while (s->size < size)
+		s->size += make_tuple(s->data + s->size, i++);
+	s->size = size;
+}
+
+/* ---------------- zlib, the way gfile does it ---------------- */
+
+static size_t
+zlib_compress(const Stream *in, char *out, size_t *blocklens)
+{
+	z_stream	z;
+	size_t		off;
+	int			b = 0;
+
+	memset(&z, 0, sizeof(z));
+	if (deflateInit2(&z, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 31, 8,
+					 Z_DEFAULT_STRATEGY) != Z_OK)
+		exit(1);
+	z.next_out = (Bytef *) out;
+	z.avail_out = deflateBound(&z, in->size);
+	for (off = 0; off < in->size; off += BLOCK_SIZE)
+	{
+		size_t		len = Min(BLOCK_SIZE, in->size - off);
+
+		z.next_in = (Bytef *) in->data + off;
+		z.avail_in = len;
+		if (deflate(&z, off + len == in->size ? Z_FINISH : Z_NO_FLUSH) == Z_STREAM_ERROR)
+			exit(1);
+		blocklens[b++] = len;
+	}
+	deflateEnd(&z);
+	return z.total_out;
+}
+
+static void
+zlib_decompress(const char *in, size_t insize, const size_t *blocklens,
+				int nblocks, char *out)
+{
+	z_stream	z;
+	int			b;
+
+	memset(&z, 0, sizeof(z));
+	if (inflateInit2(&z, 31) != Z_OK)
+		exit(1);
+	z.next_in = (Bytef *) in;
+	z.avail_in = insize;
+	z.next_out = (Bytef *) out;
+	for (b = 0; b < nblocks; b++)
+	{
+		/* bfz reads one buffer at a time */
+		z.avail_out = blocklens[b];
+		if (inflate(&z, Z_SYNC_FLUSH) < 0)
+			exit(1);
+	}
+	inflateEnd(&z);
+}
+
+/* ---------------- lz4 and zstd, the way compress_*.c do it ---------------- */
+
+#ifdef HAVE_LIBLZ4
+static size_t
+lz4_compress(const Stream *in, char *out, size_t *blocklens)
+{
+	size_t		off;
+	size_t		total = 0;
+	int			b = 0;
+
+	for (off = 0; off < in->size; off += BLOCK_SIZE)
+	{
+		int			len = Min(BLOCK_SIZE, in->size - off);
+		int			clen;
+
+		clen = LZ4_compress_default(in->data + off, out + total, len,
+									LZ4_COMPRESSBOUND(BLOCK_SIZE));
+		if (clen <= 0)
+			exit(1);
+		blocklens[b++] = clen;
+		/* plus the block header */
+		total += clen + 2 * sizeof(uint32);
+	}
+	return total;
+}
+
+static void
+lz4_decompress(const char *in, size_t insize, const size_t *blocklens,
+			   int nblocks, char *out)
+{
+	int			b;
+
+	for (b = 0; b < nblocks; b++)
+	{
+		int			len = LZ4_decompress_safe(in, out, blocklens[b], BLOCK_SIZE);
+
+		if (len < 0)
+			exit(1);
+		in += blocklens[b] + 2 * sizeof(uint32);
+		out += len;
+	}
+}
+#endif   /* HAVE_LIBLZ4 */
+
+#ifdef HAVE_LIBZSTD
+static int	zstd_level;
+
+static size_t
+zstd_compress(const Stream *in, char *out, size_t *blocklens)
+{
+	ZSTD_CCtx  *cctx = ZSTD_createCCtx();
+	size_t		off;
+	size_t		total = 0;
+	int			b = 0;
+
+	for (off = 0; off < in->size; off += BLOCK_SIZE)
+	{
+		size_t		len = Min(BLOCK_SIZE, in->size - off);
+		size_t		clen;
+
+		clen = ZSTD_compressCCtx(cctx, out + total,
+								 ZSTD_COMPRESSBOUND(BLOCK_SIZE),
+								 in->data + off, len, zstd_level);
+		if (ZSTD_isError(clen))
+			exit(1);
+		blocklens[b++] = clen;
+		total += clen + 2 * sizeof(uint32);
+	}
+	ZSTD_freeCCtx(cctx);
+	return total;
+}
+
+static void
+zstd_decompress(const char *in, size_t insize, const size_t *blocklens,
+				int nblocks, char *out)
+{
+	ZSTD_DCtx  *dctx = ZSTD_createDCtx();
+	int			b;
+
+	for (b = 0; b < nblocks; b++)
+	{
+		size_t		len = ZSTD_decompressDCtx(dctx, out, BLOCK_SIZE,
+											  in, blocklens[b]);
+
+		if (ZSTD_isError(len))
+			exit(1);
+		in += blocklens[b] + 2 * sizeof(uint32);
+		out += len;
+	}
+	ZSTD_freeDCtx(dctx);
+}
+
+static size_t
+zstd1_compress(const Stream *in, char *out, size_t *blocklens)
+{
+	zstd_level = 1;
+	return zstd_compress(in, out, blocklens);
+}
+
+static size_t
+zstd3_compress(const Stream *in, char *out, size_t *blocklens)
+{
+	zstd_level = 3;
+	return zstd_compress(in, out, blocklens);
+}
+#endif   /* HAVE_LIBZSTD */
+
+static const Codec codecs[] = {
+	{"zlib", zlib_compress, zlib_decompress},
+#ifdef HAVE_LIBLZ4
+	{"lz4", lz4_compress, lz4_decompress},
+#endif
+#ifdef HAVE_LIBZSTD
+	{"zstd (level 1)", zstd1_compress, zstd_decompress},
+	{"zstd (level 3)", zstd3_compress, zstd_decompress},
+#endif
+};
+
+static double
+now(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static void
+run(const Stream *s, const Codec *c)
+{
+	int			nblocks = (s->size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	size_t	   *blocklens = malloc(nblocks * sizeof(size_t));
+	char	   *compressed = malloc(s->size + s->size / 8 + nblocks * 64 + 1024);
+	char	   *decompressed = malloc(s->size);
+	size_t		total;
+	double		start,
+				ctime,
+				dtime;
+
+	start = now();
+	total = c->compress(s, compressed, blocklens);
+	ctime = now() - start;
+
+	start = now();
+	c->decompress(compressed, total, blocklens, nblocks, decompressed);
+	dtime = now() - start;
+
+	if (memcmp(s->data, decompressed, s->size) != 0)
+	{
+		fprintf(stderr, "%s: %s stream does not decompress to the original\n",
+				c->name, s->name);
+		exit(1);
+	}
+
+	printf("%-10s %-16s %6.2f %12.0f %12.0f\n", s->name, c->name,
+		   (double) s->size / total,
+		   s->size / ctime / (1024 * 1024),
+		   s->size / dtime / (1024 * 1024));
+
+	free(blocklens);
+	free(compressed);
+	free(decompressed);
+}
+
+int
+main(int argc, char **argv)
+{
+	size_t		size = (argc > 1 ? atoi(argv[1]) : 256) * (size_t) (1024 * 1024);
+	Stream		streams[3];
+	int			i,
+				j;
+
+	make_stream(&streams[0], "hashjoin", size, make_lineitem_tuple);
+	make_stream(&streams[1], "hashagg", size, make_agg_tuple);
+	make_stream(&streams[2], "sort", size, make_sorted_tuple);
+
+	printf("%-10s %-16s %6s %12s %12s\n", "stream", "algorithm", "ratio",
+		   "comp MB/s", "decomp MB/s");
+	for (i = 0; i < lengthof(streams); i++)
+		for (j = 0; j < lengthof(codecs); j++)
+			run(&streams[i], &codecs[j]);
+
+	for (i = 0; i < lengthof(streams); i++)
+		free(streams[i].data);
+
+	return 0;
+}
@@ -8,12 +8,15 @@
  *
  * gp_opt_version: This function wraps LibraryVersion. 
  *
+ * gp_opt_mdcache_stats: This function wraps MDCacheStats.
+ *
  * Copyright(c) 2012 - present, EMC/Greenplum
  */
 
 #include "postgres.h"
 
 #include "funcapi.h"
+#include "access/heapam.h"
 #include "utils/builtins.h"
 
 extern Datum EnableXform(PG_FUNCTION_ARGS);
@@ -60,3 +63,36 @@ gp_opt_version(PG_FUNCTION_ARGS __attribute__((unused)))
 	return CStringGetTextDatum("Server has been compiled without ORCA");
 #endif
 }
+
+extern void MDCacheStats(int64 *hits, int64 *misses, int64 *evictions, int64 *resets);
+
+/*
+* Returns the counters of the optimizer metadata cache of this backend.
+*/
+Datum
+gp_opt_mdcache_stats(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[4];
+	bool		nulls[4];
+	int64		hits = 0;
+	int64		misses = 0;
+	int64		evictions = 0;
+	int64		resets = 0;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+#ifdef USE_ORCA
+	MDCacheStats(&hits, &misses, &evictions, &resets);
+#endif
+
+	values[0] = Int64GetDatum(hits);
+	values[1] = Int64GetDatum(misses);
+	values[2] = Int64GetDatum(evictions);
+	values[3] = Int64GetDatum(resets);
+	MemSet(nulls, false, sizeof(nulls));
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(BlessTupleDesc(tupdesc),
+													  values, nulls)));
+}
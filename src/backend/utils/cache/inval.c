@@ -90,6 +90,7 @@
 #include "access/xact.h"
 #include "catalog/catalog.h"
 #include "catalog/gp_policy.h"
+#include "catalog/pg_statistic.h"
 #include "miscadmin.h"
 #include "storage/sinval.h"
 #include "storage/smgr.h"
@@ -718,6 +719,18 @@ PrepareForTupleInvalidation(Relation relation, HeapTuple tuple)
 		relationId = indextup->indexrelid;
 		databaseId = MyDatabaseId;
 	}
+	else if (tupleRelId == StatisticRelationId)
+	{
+		Form_pg_statistic stattup = (Form_pg_statistic) GETSTRUCT(tuple);
+
+		/*
+		 * Statistics are not part of the relcache entry, but caches of
+		 * derived data, like the ORCA metadata cache, rely on this event to
+		 * learn that the statistics of the relation changed.
+		 */
+		relationId = stattup->starelid;
+		databaseId = MyDatabaseId;
+	}
 	else
 		return;
 
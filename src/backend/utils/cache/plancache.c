@@ -53,7 +53,10 @@
 #include "tcop/pquery.h"
 #include "tcop/tcopprot.h"
 #include "tcop/utility.h"
+#include "utils/datum.h"
+#include "utils/guc.h"
 #include "utils/inval.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/resowner.h"
 #include "utils/syscache.h"
@@ -69,6 +72,14 @@ static void ScanQueryForLocks(Query *parsetree, bool acquire);
 static bool ScanQueryWalker(Node *node, bool *acquire);
 static bool rowmark_member(List *rowMarks, int rt_index);
 static bool plan_list_is_transient(List *stmt_list);
+static bool KeepParamPlans(CachedPlanSource *plansource);
+static void ReleaseParamPlans(CachedPlanSource *plansource);
+static CachedPlan *LookupParamPlan(CachedPlanSource *plansource,
+				ParamListInfo boundParams);
+static bool ParamListsEqual(ParamListInfo a, ParamListInfo b);
+static void InvalidatePlanForRel(CachedPlan *plan, Oid relid);
+static void InvalidatePlanForFunc(CachedPlan *plan, int cacheid,
+					  ItemPointer tuplePtr);
 static void PlanCacheRelCallback(Datum arg, Oid relid);
 static void PlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr);
 static void PlanCacheSysCallback(Datum arg, int cacheid, ItemPointer tuplePtr);
@@ -161,6 +172,9 @@ CreateCachedPlan(Node *raw_parse_tree,
 	plansource->generation = 0; /* StoreCachedPlan will increment */
 	plansource->resultDesc = PlanCacheComputeResultDesc(stmt_list);
 	plansource->plan = NULL;
+	plansource->param_plans = NIL;
+	plansource->param_plan_hits = 0;
+	plansource->param_plan_misses = 0;
 	plansource->context = source_context;
 	plansource->orig_plan = NULL;
 
@@ -243,6 +257,9 @@ FastCreateCachedPlan(Node *raw_parse_tree,
 	plansource->generation = 0; /* StoreCachedPlan will increment */
 	plansource->resultDesc = PlanCacheComputeResultDesc(stmt_list);
 	plansource->plan = NULL;
+	plansource->param_plans = NIL;
+	plansource->param_plan_hits = 0;
+	plansource->param_plan_misses = 0;
 	plansource->context = context;
 	plansource->orig_plan = NULL;
 
@@ -325,6 +342,7 @@ StoreCachedPlan(CachedPlanSource *plansource,
 		plan->saved_xmin = InvalidTransactionId;
 	plan->refcount = 1;			/* for the parent's link */
 	plan->generation = ++(plansource->generation);
+	plan->boundParams = NULL;
 	plan->context = plan_context;
 	if (plansource->fully_planned)
 	{
@@ -365,6 +383,7 @@ DropCachedPlan(CachedPlanSource *plansource)
 	/* Decrement child CachePlan's refcount and drop if no longer needed */
 	if (plansource->plan)
 		ReleaseCachedPlan(plansource->plan, false);
+	ReleaseParamPlans(plansource);
 
 	/*
 	 * If CachedPlanSource has independent storage, just drop it.  Otherwise
@@ -407,12 +426,21 @@ DropCachedPlan(CachedPlanSource *plansource)
  * They should be distributed to the correct segments according to the
  * distribution policy of the target table, instead. A non-NULL intoClause
  * therefore also forces the plan to be re-planned on next call.
+ *
+ * If gp_plan_cache_param_plans is set, a plan made with boundParams is kept
+ * instead, along with a copy of the parameter values, and re-used when the
+ * statement is executed again with the same values.  Up to that many plans,
+ * for different values, are kept for each plansource, and none once the
+ * values of the plansource turn out to rarely repeat (see KeepParamPlans).
+ * This matters most for ORCA, which is slow to optimize big joins, and cannot
+ * make a generic plan for a query with parameters anyway.
  */
 CachedPlan *
 RevalidateCachedPlanWithParams(CachedPlanSource *plansource, bool useResOwner,
 							   ParamListInfo boundParams, IntoClause *intoClause)
 {
 	CachedPlan *plan;
+	bool		keepParamPlan;
 
 	/* Validity check that we were given a CachedPlanSource */
 	Assert(list_member_ptr(cached_plans_list, plansource));
@@ -426,10 +454,20 @@ RevalidateCachedPlanWithParams(CachedPlanSource *plansource, bool useResOwner,
 
 	/*
 	 * If we are to use the parameter values in the plan, or this is a
-	 * CREATE TABLE AS EXECUTE, we cannot re-use a generic plan.
+	 * CREATE TABLE AS EXECUTE, we cannot re-use a generic plan.  We can
+	 * re-use a plan made for the same parameter values, though, if we keep
+	 * those.
 	 */
-	if (plan && (boundParams || intoClause))
-		plan->dead = true;
+	keepParamPlan = boundParams && !intoClause && KeepParamPlans(plansource);
+	if (keepParamPlan)
+		plan = LookupParamPlan(plansource, boundParams);
+	else
+	{
+		if (boundParams)
+			ReleaseParamPlans(plansource);
+		if (plan && (boundParams || intoClause))
+			plan->dead = true;
+	}
 
 	if (plan && !plan->dead)
 	{
@@ -477,6 +515,14 @@ RevalidateCachedPlanWithParams(CachedPlanSource *plansource, bool useResOwner,
 		plan = NULL;
 	}
 
+	if (keepParamPlan)
+	{
+		if (plan)
+			plansource->param_plan_hits++;
+		else
+			plansource->param_plan_misses++;
+	}
+
 	/*
 	 * Build a new plan if needed.
 	 */
@@ -629,8 +675,17 @@ RevalidateCachedPlanWithParams(CachedPlanSource *plansource, bool useResOwner,
 		/*
 		 * If we used the parameter values to create the plan, or this is a
 		 * CREATE TABLE AS, we cannot re-use this plan on subsequent calls.
+		 * Unless we keep plans made for parameter values, in which case
+		 * remember the values, so that LookupParamPlan can find it again.
 		 */
-		if (boundParams || intoClause)
+		if (keepParamPlan)
+		{
+			MemoryContext oldcxt = MemoryContextSwitchTo(plan->context);
+
+			plan->boundParams = copyParamList(boundParams);
+			MemoryContextSwitchTo(oldcxt);
+		}
+		else if (boundParams || intoClause)
 			plan->saved_xmin = BootstrapTransactionId;
 	}
 
@@ -646,6 +701,143 @@ RevalidateCachedPlanWithParams(CachedPlanSource *plansource, bool useResOwner,
 	return plan;
 }
 
+/*
+ * KeepParamPlans: should plans made for parameter values be kept?
+ *
+ * Keeping them only pays off if the statement is executed again with the
+ * same values.  Once a plansource has had PARAM_PLANS_MIN_LOOKUPS lookups,
+ * and at least four per kept plan, we stop keeping plans for it if fewer than
+ * a quarter of the lookups found a plan.  That way a statement whose values
+ * rarely repeat does not hold on to plans it never re-uses.
+ */
+#define PARAM_PLANS_MIN_LOOKUPS		16
+
+static bool
+KeepParamPlans(CachedPlanSource *plansource)
+{
+	int64		lookups;
+
+	if (gp_plan_cache_param_plans <= 0 || !plansource->fully_planned)
+		return false;
+
+	lookups = plansource->param_plan_hits + plansource->param_plan_misses;
+	if (lookups >= PARAM_PLANS_MIN_LOOKUPS &&
+		lookups >= 4 * (int64) gp_plan_cache_param_plans &&
+		plansource->param_plan_hits * 4 < lookups)
+		return false;
+
+	return true;
+}
+
+/*
+ * ReleaseParamPlans: release the plans kept for other parameter values.
+ */
+static void
+ReleaseParamPlans(CachedPlanSource *plansource)
+{
+	ListCell   *lc;
+
+	foreach(lc, plansource->param_plans)
+		ReleaseCachedPlan((CachedPlan *) lfirst(lc), false);
+	list_free(plansource->param_plans);
+	plansource->param_plans = NIL;
+}
+
+/*
+ * LookupParamPlan: find a kept plan made for the given parameter values.
+ *
+ * The found plan becomes plansource->plan, and the plan it replaces, if it
+ * was made for other parameter values, is moved to the head of
+ * plansource->param_plans.  Returns NULL, with plansource->plan unset, if
+ * there is no such plan; the caller then makes a new one.
+ *
+ * Dead plans, and the least recently used ones beyond
+ * gp_plan_cache_param_plans, are released on the way.
+ */
+static CachedPlan *
+LookupParamPlan(CachedPlanSource *plansource, ParamListInfo boundParams)
+{
+	CachedPlan *plan = plansource->plan;
+	CachedPlan *found = NULL;
+	List	   *kept = NIL;
+	ListCell   *lc;
+	MemoryContext oldcxt;
+
+	/* The common case: executed again with the same values */
+	if (plan && !plan->dead && plan->boundParams &&
+		ParamListsEqual(plan->boundParams, boundParams))
+		return plan;
+
+	oldcxt = MemoryContextSwitchTo(plansource->context);
+
+	/* Keep the current plan, unless it is generic or dead */
+	if (plan)
+	{
+		if (!plan->dead && plan->boundParams &&
+			gp_plan_cache_param_plans > 1)
+			kept = lappend(kept, plan);
+		else
+			ReleaseCachedPlan(plan, false);
+		plansource->plan = NULL;
+	}
+
+	foreach(lc, plansource->param_plans)
+	{
+		CachedPlan *p = (CachedPlan *) lfirst(lc);
+
+		if (p->dead)
+			ReleaseCachedPlan(p, false);
+		else if (found == NULL && ParamListsEqual(p->boundParams, boundParams))
+			found = p;
+		else if (list_length(kept) < gp_plan_cache_param_plans - 1)
+			kept = lappend(kept, p);
+		else
+			ReleaseCachedPlan(p, false);
+	}
+	list_free(plansource->param_plans);
+	plansource->param_plans = kept;
+	plansource->plan = found;
+
+	MemoryContextSwitchTo(oldcxt);
+
+	return found;
+}
+
+/*
+ * ParamListsEqual: are the two sets of parameter values the same?
+ */
+static bool
+ParamListsEqual(ParamListInfo a, ParamListInfo b)
+{
+	int			i;
+
+	if (a == NULL || b == NULL)
+		return a == b;
+	if (a->numParams != b->numParams)
+		return false;
+
+	for (i = 0; i < a->numParams; i++)
+	{
+		ParamExternData *pa = &a->params[i];
+		ParamExternData *pb = &b->params[i];
+		int16		typLen;
+		bool		typByVal;
+
+		if (pa->ptype != pb->ptype ||
+			pa->isnull != pb->isnull ||
+			pa->pflags != pb->pflags)
+			return false;
+		if (pa->isnull || !OidIsValid(pa->ptype))
+			continue;
+
+		get_typlenbyval(pa->ptype, &typLen, &typByVal);
+		if (!datumIsEqual(pa->value, pb->value, typByVal, typLen))
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * Compatibility version of RevalidateCachedPlanWithParams, for the simple
  * case of no params and no CREATE TABLE AS.
@@ -993,40 +1185,51 @@ PlanCacheRelCallback(Datum arg, Oid relid)
 	foreach(lc1, cached_plans_list)
 	{
 		CachedPlanSource *plansource = (CachedPlanSource *) lfirst(lc1);
-		CachedPlan *plan = plansource->plan;
+		ListCell   *lc2;
 
-		/* No work if it's already invalidated */
-		if (!plan || plan->dead)
-			continue;
-		if (plan->fully_planned)
-		{
-			/* Have to check the per-PlannedStmt relid lists */
-			ListCell   *lc2;
+		InvalidatePlanForRel(plansource->plan, relid);
+		foreach(lc2, plansource->param_plans)
+			InvalidatePlanForRel((CachedPlan *) lfirst(lc2), relid);
+	}
+}
 
-			foreach(lc2, plan->stmt_list)
-			{
-				PlannedStmt *plannedstmt = (PlannedStmt *) lfirst(lc2);
+/*
+ * InvalidatePlanForRel: subroutine of PlanCacheRelCallback, for one plan
+ */
+static void
+InvalidatePlanForRel(CachedPlan *plan, Oid relid)
+{
+	/* No work if it's already invalidated */
+	if (!plan || plan->dead)
+		return;
+	if (plan->fully_planned)
+	{
+		/* Have to check the per-PlannedStmt relid lists */
+		ListCell   *lc;
 
-				Assert(!IsA(plannedstmt, Query));
-				if (!IsA(plannedstmt, PlannedStmt))
-					continue;	/* Ignore utility statements */
-				if ((relid == InvalidOid) ? plannedstmt->relationOids != NIL :
-					list_member_oid(plannedstmt->relationOids, relid))
-				{
-					/* Invalidate the plan! */
-					plan->dead = true;
-					break;		/* out of stmt_list scan */
-				}
-			}
-		}
-		else
+		foreach(lc, plan->stmt_list)
 		{
-			/* Otherwise check the single list we built ourselves */
-			if ((relid == InvalidOid) ? plan->relationOids != NIL :
-				list_member_oid(plan->relationOids, relid))
+			PlannedStmt *plannedstmt = (PlannedStmt *) lfirst(lc);
+
+			Assert(!IsA(plannedstmt, Query));
+			if (!IsA(plannedstmt, PlannedStmt))
+				continue;	/* Ignore utility statements */
+			if ((relid == InvalidOid) ? plannedstmt->relationOids != NIL :
+				list_member_oid(plannedstmt->relationOids, relid))
+			{
+				/* Invalidate the plan! */
 				plan->dead = true;
+				break;		/* out of stmt_list scan */
+			}
 		}
 	}
+	else
+	{
+		/* Otherwise check the single list we built ourselves */
+		if ((relid == InvalidOid) ? plan->relationOids != NIL :
+			list_member_oid(plan->relationOids, relid))
+			plan->dead = true;
+	}
 }
 
 /*
@@ -1047,48 +1250,37 @@ PlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr)
 	foreach(lc1, cached_plans_list)
 	{
 		CachedPlanSource *plansource = (CachedPlanSource *) lfirst(lc1);
-		CachedPlan *plan = plansource->plan;
+		ListCell   *lc2;
 
-		/* No work if it's already invalidated */
-		if (!plan || plan->dead)
-			continue;
-		if (plan->fully_planned)
-		{
-			/* Have to check the per-PlannedStmt inval-item lists */
-			ListCell   *lc2;
+		InvalidatePlanForFunc(plansource->plan, cacheid, tuplePtr);
+		foreach(lc2, plansource->param_plans)
+			InvalidatePlanForFunc((CachedPlan *) lfirst(lc2), cacheid, tuplePtr);
+	}
+}
 
-			foreach(lc2, plan->stmt_list)
-			{
-				PlannedStmt *plannedstmt = (PlannedStmt *) lfirst(lc2);
-				ListCell   *lc3;
+/*
+ * InvalidatePlanForFunc: subroutine of PlanCacheFuncCallback, for one plan
+ */
+static void
+InvalidatePlanForFunc(CachedPlan *plan, int cacheid, ItemPointer tuplePtr)
+{
+	/* No work if it's already invalidated */
+	if (!plan || plan->dead)
+		return;
+	if (plan->fully_planned)
+	{
+		/* Have to check the per-PlannedStmt inval-item lists */
+		ListCell   *lc1;
 
-				Assert(!IsA(plannedstmt, Query));
-				if (!IsA(plannedstmt, PlannedStmt))
-					continue;	/* Ignore utility statements */
-				foreach(lc3, plannedstmt->invalItems)
-				{
-					PlanInvalItem *item = (PlanInvalItem *) lfirst(lc3);
-
-					if (item->cacheId != cacheid)
-						continue;
-					if (tuplePtr == NULL ||
-						ItemPointerEquals(tuplePtr, &item->tupleId))
-					{
-						/* Invalidate the plan! */
-						plan->dead = true;
-						break;		/* out of invalItems scan */
-					}
-				}
-				if (plan->dead)
-					break;		/* out of stmt_list scan */
-			}
-		}
-		else
+		foreach(lc1, plan->stmt_list)
 		{
-			/* Otherwise check the single list we built ourselves */
+			PlannedStmt *plannedstmt = (PlannedStmt *) lfirst(lc1);
 			ListCell   *lc2;
 
-			foreach(lc2, plan->invalItems)
+			Assert(!IsA(plannedstmt, Query));
+			if (!IsA(plannedstmt, PlannedStmt))
+				continue;	/* Ignore utility statements */
+			foreach(lc2, plannedstmt->invalItems)
 			{
 				PlanInvalItem *item = (PlanInvalItem *) lfirst(lc2);
 
@@ -1099,9 +1291,31 @@ PlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr)
 				{
 					/* Invalidate the plan! */
 					plan->dead = true;
-					break;
+					break;		/* out of invalItems scan */
 				}
 			}
+			if (plan->dead)
+				break;		/* out of stmt_list scan */
+		}
+	}
+	else
+	{
+		/* Otherwise check the single list we built ourselves */
+		ListCell   *lc;
+
+		foreach(lc, plan->invalItems)
+		{
+			PlanInvalItem *item = (PlanInvalItem *) lfirst(lc);
+
+			if (item->cacheId != cacheid)
+				continue;
+			if (tuplePtr == NULL ||
+				ItemPointerEquals(tuplePtr, &item->tupleId))
+			{
+				/* Invalidate the plan! */
+				plan->dead = true;
+				break;
+			}
 		}
 	}
 }
@@ -1130,8 +1344,11 @@ ResetPlanCache(void)
 	{
 		CachedPlanSource *plansource = (CachedPlanSource *) lfirst(lc);
 		CachedPlan *plan = plansource->plan;
+		ListCell   *lc2;
 
 		if (plan)
 			plan->dead = true;
+		foreach(lc2, plansource->param_plans)
+			((CachedPlan *) lfirst(lc2))->dead = true;
 	}
 }
@@ -429,6 +429,30 @@ init_datumstream_info(
 				ao_attr->compressLevel = 9;
 				break;
 
+			case 5:
+				ao_attr->compress = true;
+				ao_attr->compressType = "lz4";
+				ao_attr->compressLevel = 1;
+				break;
+
+			case 6:
+				ao_attr->compress = true;
+				ao_attr->compressType = "zstd";
+				ao_attr->compressLevel = 1;
+				break;
+
+			case 7:
+				ao_attr->compress = true;
+				ao_attr->compressType = "zstd";
+				ao_attr->compressLevel = 5;
+				break;
+
+			case 8:
+				ao_attr->compress = true;
+				ao_attr->compressType = "zstd";
+				ao_attr->compressLevel = 9;
+				break;
+
 			default:
 				ereport(ERROR,
 						(errmsg("Unexpected compresslevel %d",
@@ -1291,8 +1315,12 @@ datumstreamread_block_content(DatumStreamRead * acc)
 }
 
 
-int
-datumstreamread_block(DatumStreamRead * acc)
+/*
+ * Read the header of the next block, and set the block position and row
+ * count from it.
+ */
+static bool
+datumstreamread_next_block_info(DatumStreamRead * acc)
 {
 	bool		readOK = false;
 
@@ -1308,7 +1336,7 @@ datumstreamread_block(DatumStreamRead * acc)
 												&acc->getBlockInfo.isLarge,
 											&acc->getBlockInfo.isCompressed);
 	if (!readOK)
-		return -1;
+		return false;
 
 	if (Debug_appendonly_print_datumstream)
 		elog(LOG,
@@ -1350,11 +1378,60 @@ datumstreamread_block(DatumStreamRead * acc)
 			 acc->blockFileOffset,
 			 acc->blockRowCount);
 
+	return true;
+}
+
+int
+datumstreamread_block(DatumStreamRead * acc)
+{
+	if (!datumstreamread_next_block_info(acc))
+		return -1;
+
 	datumstreamread_block_content(acc);
 
 	return 0;
 }
 
+/*
+ * Position the stream so that the next datum read is that of row rowNum,
+ * or of the first row after it that is in the file. Blocks that end
+ * before rowNum are skipped without reading their contents.
+ *
+ * The current block must have its first row number in the header. Returns
+ * false if the file has no rows from rowNum on.
+ */
+bool
+datumstreamread_skip_to_row(DatumStreamRead * acc, int64 rowNum)
+{
+	int64		rowNumInBlock;
+
+	Assert(acc->getBlockInfo.firstRow >= 0);
+
+	if (rowNum >= acc->blockFirstRowNum + acc->blockRowCount)
+	{
+		while (true)
+		{
+			if (!datumstreamread_next_block_info(acc))
+				return false;
+
+			if (rowNum < acc->blockFirstRowNum + acc->blockRowCount)
+				break;
+
+			AppendOnlyStorageRead_SkipCurrentBlock(&acc->ao_read);
+			acc->blocksSkipped++;
+		}
+
+		datumstreamread_block_content(acc);
+	}
+
+	/* The next datum read is the one after the current one */
+	rowNumInBlock = rowNum - acc->blockFirstRowNum;
+	if (rowNumInBlock - 1 > datumstreamread_nth(acc))
+		datumstreamread_find(acc, rowNumInBlock - 1);
+
+	return true;
+}
+
 void
 datumstreamread_rewind_block(DatumStreamRead * datumStream)
 {
@@ -387,6 +387,121 @@ DatumStreamBlockRead_Finish(
 	/* Place holder. */
 }
 
+/*
+ * Advance to, and get, up to maxCount items of the current block at once.
+ *
+ * The items are returned in the values and nulls arrays, and the block is
+ * left positioned on the last item returned, as if DatumStreamBlockRead_Advance
+ * and DatumStreamBlockRead_Get had been called for each of them.
+ *
+ * Returns the number of items returned, or 0 at the end of the block.
+ */
+int
+DatumStreamBlockRead_GetBatch(
+							  DatumStreamBlockRead * dsr,
+							  Datum *values,
+							  bool *nulls,
+							  int maxCount)
+{
+	int			count;
+	int			i;
+
+	Assert(maxCount > 0);
+
+	count = dsr->logical_row_count - (dsr->nth + 1);
+	if (count <= 0)
+		return 0;
+	if (count > maxCount)
+		count = maxCount;
+
+	if (dsr->typeInfo.byval &&
+		!dsr->has_null &&
+		!dsr->rle_block_was_compressed &&
+		!dsr->delta_block_was_compressed)
+	{
+		/*
+		 * The items are a plain array of fixed-length values, so decode them
+		 * in tight loops.
+		 */
+		int32		datumlen = dsr->typeInfo.datumlen;
+		uint8	   *p = dsr->datump;
+
+		/* The block read pre-positions datump on the first item. */
+		if (dsr->physical_datum_index != -1)
+			p += datumlen;
+
+		Assert(p + count * datumlen <= dsr->datum_afterp);
+
+		if (datumlen == 8)
+		{
+			Assert(IsAligned(p, 8) || IsAligned(p, 4));
+			for (i = 0; i < count; i++)
+				values[i] = ((Datum *) p)[i];
+		}
+		else if (datumlen == 4)
+		{
+			Assert(IsAligned(p, 4));
+			for (i = 0; i < count; i++)
+				values[i] = ((uint32 *) p)[i];
+		}
+		else if (datumlen == 2)
+		{
+			Assert(IsAligned(p, 2));
+			for (i = 0; i < count; i++)
+				values[i] = ((uint16 *) p)[i];
+		}
+		else
+		{
+			Assert(datumlen == 1);
+			for (i = 0; i < count; i++)
+				values[i] = p[i];
+		}
+		memset(nulls, 0, count * sizeof(bool));
+
+		dsr->nth += count;
+		dsr->physical_datum_index += count;
+		dsr->datump = p + (count - 1) * datumlen;
+
+		return count;
+	}
+
+	i = 0;
+	while (i < count)
+	{
+		int			advanced;
+
+		advanced = DatumStreamBlockRead_Advance(dsr);
+		Assert(advanced == 1);
+		DatumStreamBlockRead_Get(dsr, &values[i], &nulls[i]);
+		i++;
+
+		if (dsr->rle_in_repeated_item)
+		{
+			/*
+			 * The next items of an RLE_TYPE run are copies of this one, which
+			 * DatumStreamBlockRead_AdvanceDense only counts down.
+			 */
+			int			repeats = Min(dsr->rle_repeated_item_count, count - i);
+			int			j;
+
+			for (j = 0; j < repeats; j++)
+			{
+				values[i + j] = values[i - 1];
+				nulls[i + j] = false;
+			}
+			i += repeats;
+
+			dsr->nth += repeats;
+			dsr->rle_repeated_item_count -= repeats;
+			dsr->rle_total_repeat_items_read += repeats;
+			if (dsr->rle_repeated_item_count <= 0)
+				dsr->rle_in_repeated_item = false;
+		}
+	}
+
+	return count;
+}
+
 /*
  * Dense routines.
  */
@@ -167,13 +167,73 @@ test__DeltaCompression__Core(void **state)
 	free(dsw);
 }
 
+/*
+ * Unit test function to test that reading a batch of items gives the same
+ * items and position as advancing to each of them
+ */
+void
+test__GetBatch__FixedLength(void **state)
+{
+	DatumStreamBlockRead *dsr;
+	int32		items[10];
+	Datum		values[10];
+	bool		nulls[10];
+	Datum		d;
+	bool		null;
+	int			i;
+
+	for (i = 0; i < 10; i++)
+		items[i] = i * 7;
+
+	dsr = malloc(sizeof(DatumStreamBlockRead));
+	memset(dsr, 0, sizeof(DatumStreamBlockRead));
+	strncpy(dsr->eyecatcher, DatumStreamBlockRead_Eyecatcher, DatumStreamBlockRead_EyecatcherLen);
+	dsr->datumStreamVersion = DatumStreamVersion_Original;
+	dsr->typeInfo.datumlen = 4;
+	dsr->typeInfo.typid = INT4OID;
+	dsr->typeInfo.byval = true;
+	dsr->logical_row_count = 10;
+	dsr->physical_datum_count = 10;
+	dsr->nth = -1;
+	dsr->physical_datum_index = -1;
+	dsr->datum_beginp = (uint8 *) items;
+	dsr->datum_afterp = (uint8 *) (items + 10);
+	dsr->datump = dsr->datum_beginp;
+
+	/* First batch starts at the pre-positioned first item */
+	assert_int_equal(DatumStreamBlockRead_GetBatch(dsr, values, nulls, 4), 4);
+	for (i = 0; i < 4; i++)
+	{
+		assert_int_equal(DatumGetInt32(values[i]), i * 7);
+		assert_false(nulls[i]);
+	}
+	assert_int_equal(DatumStreamBlockRead_Nth(dsr), 3);
+
+	/* Advancing one item at a time continues after the batch */
+	assert_int_equal(DatumStreamBlockRead_Advance(dsr), 1);
+	DatumStreamBlockRead_Get(dsr, &d, &null);
+	assert_int_equal(DatumGetInt32(d), 28);
+	assert_false(null);
+
+	/* The batch is cut at the end of the block */
+	assert_int_equal(DatumStreamBlockRead_GetBatch(dsr, values, nulls, 10), 5);
+	for (i = 0; i < 5; i++)
+		assert_int_equal(DatumGetInt32(values[i]), (i + 5) * 7);
+	assert_int_equal(DatumStreamBlockRead_Nth(dsr), 9);
+
+	assert_int_equal(DatumStreamBlockRead_GetBatch(dsr, values, nulls, 10), 0);
+
+	free(dsr);
+}
+
 int 
 main(int argc, char* argv[]) 
 {
 	cmockery_parse_arguments(argc, argv);
 
 	const UnitTest tests[] = {
-			unit_test(test__DeltaCompression__Core)
+			unit_test(test__DeltaCompression__Core),
+			unit_test(test__GetBatch__FixedLength)
 	};
 	return run_tests(tests);
 }
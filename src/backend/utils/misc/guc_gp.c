@@ -19,6 +19,7 @@
 #include "access/transam.h"
 #include "access/url.h"
 #include "access/xlog_internal.h"
+#include "cdb/cdbaocsam.h"
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbdisp.h"
 #include "cdb/cdbfilerep.h"
@@ -154,6 +155,7 @@ bool		Debug_appendonly_print_insert = false;
 bool		Debug_appendonly_print_insert_tuple = false;
 bool		Debug_appendonly_print_scan = false;
 bool		Debug_appendonly_print_scan_tuple = false;
+bool		Debug_appendonly_print_decompress_stats = false;
 bool		Debug_appendonly_print_delete = false;
 bool		Debug_appendonly_print_update = false;
 bool		Debug_appendonly_print_update_tuple = false;
@@ -416,6 +418,10 @@ int			gp_cancel_query_delay_time;
 bool		gp_partitioning_dynamic_selection_log;
 int			gp_max_partition_level;
 
+/* plan cache GUCs */
+int			gp_plan_cache_param_plans = 0;
+double		gp_plan_cache_replan_factor = 0;
+
 /* Upgrade & maintenance GUCs */
 bool		gp_maintenance_mode;
 bool		gp_maintenance_conn;
@@ -465,6 +471,7 @@ bool		gp_enable_preunique = TRUE;
 bool		gp_eager_preunique = FALSE;
 bool		gp_enable_sequential_window_plans = FALSE;
 bool		gp_hashagg_streambottom = true;
+bool		gp_hashjoin_local_scan_filter = false;
 bool		gp_enable_agg_distinct = true;
 bool		gp_enable_dqa_pruning = true;
 bool		gp_eager_dqa_pruning = FALSE;
@@ -571,7 +578,9 @@ bool		optimizer_array_constraints;
 bool		init_codegen;
 bool		codegen;
 bool		codegen_validate_functions;
+bool		codegen_async_compile;
 int			codegen_varlen_tolerance;
+int			codegen_module_cache_size;
 
 /* Security */
 bool		gp_reject_internal_tcp_conn = true;
@@ -993,6 +1002,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_mk_sort_normalized_keys", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Compare multi-key sort keys of fixed width types as normalized words."),
+			gettext_noop("Integer, float, oid, date, time and timestamp keys are converted "
+						 "once per tuple to an unsigned word that orders like the key."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_mk_sort_normalized_keys,
+		true, NULL, NULL
+	},
+
 
 #ifdef USE_ASSERT_CHECKING
 	{
@@ -1016,6 +1036,19 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_hashjoin_local_scan_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Filter the outer side scan of a hash join on the inner join keys, within a slice."),
+			gettext_noop("After the hash table is built, a Bloom filter on its join keys "
+						 "is pushed to the outer side scan, to drop rows early.  Only a "
+						 "scan right below the join, in the same slice, is filtered; "
+						 "the filter does not cross motions."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_hashjoin_local_scan_filter,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_enable_motion_deadlock_sanity", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Enable verbose check at planning time."),
@@ -1193,6 +1226,26 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_blockdirectory_zone_maps", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Keep per-block min/max values in append-only block directories, and skip blocks in scans with them."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_blockdirectory_zone_maps,
+		true, NULL, NULL
+	},
+
+	{
+		{"gp_aocs_late_materialization", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("In scans of append-only column-oriented tables, check the qual before reading the other columns."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_aocs_late_materialization,
+		true, NULL, NULL
+	},
+
 	{
 		{"gp_appendonly_compaction", PGC_SUSET, APPENDONLY_TABLES,
 			gettext_noop("Perform append-only compaction instead of eof truncation on vacuum."),
@@ -1338,6 +1391,19 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_copy_dispatch_chunks", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Send COPY FROM rows to the segments in chunks."),
+			gettext_noop("The master collects the rows for each segment and sends them "
+						 "together. For randomly distributed tables, it only splits the "
+						 "input into rows and sends the chunks to one segment after another, "
+						 "which parse them."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&gp_copy_dispatch_chunks,
+		true, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_full_crc", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("Sanity check incoming data stream."),
@@ -1348,6 +1414,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_batch_tuples", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Pack narrow tuples sent to the same receiver into one tuple-chunk."),
+			gettext_noop("Each tuple of a batch only carries the bytes that differ "
+						 "from the tuple before it.  Gather motions do not batch."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_interconnect_batch_tuples,
+		true, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_elide_setup", PGC_USERSET, DEPRECATED_OPTIONS,
 			gettext_noop("Avoid performing full startup handshake for every statement."),
@@ -1612,6 +1689,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"debug_appendonly_print_decompress_stats", PGC_SUSET, DEVELOPER_OPTIONS,
+			gettext_noop("Print log messages with the decompression time and bytes of each append-only table scan."),
+			NULL,
+			GUC_SUPERUSER_ONLY | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&Debug_appendonly_print_decompress_stats,
+		false, NULL, NULL
+	},
+
 	{
 		{"debug_appendonly_print_delete", PGC_SUSET, DEVELOPER_OPTIONS,
 			gettext_noop("Print log messages for append-only delete."),
@@ -2197,6 +2284,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true, NULL, NULL
 	},
 
+	{
+		{"gp_statistics_use_hll", PGC_USERSET, STATS_ANALYZE,
+			gettext_noop("Have ANALYZE estimate the number of distinct values from HyperLogLog sketches."),
+			gettext_noop("The segments build a sketch of every column over all of its rows, "
+						 "instead of the estimate being taken from the sample. The most common "
+						 "values and histograms are still computed from the sample.")
+		},
+		&gp_statistics_use_hll,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_eager_hashtable_release", PGC_USERSET, DEPRECATED_OPTIONS,
 			gettext_noop("This guc determines if a hash-join eagerly releases its hash table."),
@@ -3401,6 +3499,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 #endif
 		assign_codegen, NULL
 	},
+
+	{
+		{"codegen_async_compile", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Compile generated code in a background thread."),
+			gettext_noop("Execution starts with the regular functions, which are "
+						 "replaced by the generated ones once they are compiled."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&codegen_async_compile,
+		false, NULL, NULL
+	},
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, false, NULL, NULL
@@ -3440,6 +3549,18 @@ struct config_int ConfigureNamesInt_gp[] =
 		64, 32, 131072, NULL, NULL
 	},
 
+	{
+		{"gp_plan_cache_param_plans", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the number of plans kept for different parameter values of a prepared statement."),
+			gettext_noop("Plans of prepared statements are made with the parameter values of "
+						 "each EXECUTE. 0 makes a new plan for every EXECUTE. No plans are "
+						 "kept for a statement whose values rarely repeat."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_plan_cache_param_plans,
+		0, 0, 1024, NULL, NULL
+	},
+
 	{
 		{"gp_cancel_query_delay_time", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("The time in milliseconds to delay a query cancellation."),
@@ -4109,6 +4230,27 @@ struct config_int ConfigureNamesInt_gp[] =
 		20000, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"gp_mk_sort_parallel_workers", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Sets the number of threads that may sort the in-memory tuples of one sort."),
+			gettext_noop("Only sorts on pass-by-value keys such as integers, floats, dates and "
+						 "timestamps use more than one thread. 0 or 1 sorts on the backend alone."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_mk_sort_parallel_workers,
+		0, 0, 64, NULL, NULL
+	},
+
+	{
+		{"gp_seqserver_max_prefetch", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the most values of a sequence that a segment fetches from the master at once."),
+			gettext_noop("Values that a segment fetched but did not use are lost when its session ends."),
+			GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_seqserver_max_prefetch,
+		1024, 1, 1048576, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_setup_timeout", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Timeout (in seconds) on interconnect setup that occurs at query start"),
@@ -4180,10 +4322,10 @@ struct config_int ConfigureNamesInt_gp[] =
 	},
 
 	{
-		{"gp_fts_probe_threadcount", PGC_POSTMASTER, GP_ARRAY_TUNING,
-			gettext_noop("Use this number of threads for probing the segments."),
-			gettext_noop("The number of threads to create at each probe interval expiration."),
-			GUC_NOT_IN_SAMPLE
+		{"gp_fts_probe_threadcount", PGC_POSTMASTER, DEPRECATED_OPTIONS,
+			gettext_noop("Use this number of threads for probing the segments. Deprecated and has no effect."),
+			gettext_noop("All segments are probed at once from the fts-probe process."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
 		},
 		&gp_fts_probe_threadcount,
 		16, 1, 128, NULL, NULL
@@ -4806,6 +4948,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		5, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"codegen_module_cache_size", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Sets the maximum memory used by each backend to keep compiled code for reuse by later queries."),
+			gettext_noop("Zero disables caching of compiled code."),
+			GUC_UNIT_KB | GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&codegen_module_cache_size,
+		8192, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, 0, 0, 0, NULL, NULL
@@ -4854,6 +5006,16 @@ struct config_real ConfigureNamesReal_gp[] =
 		0, 0, SIZE_MAX / 1024, NULL, NULL,
 	},
 
+	{
+		{"gp_plan_cache_replan_factor", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Replans a kept prepared statement plan whose row estimate was off by more than this factor."),
+			gettext_noop("0 never replans because of the row count."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&gp_plan_cache_replan_factor,
+		0, 0, DBL_MAX, NULL, NULL
+	},
+
 	{
 		{"gp_motion_cost_per_row", PGC_USERSET, QUERY_TUNING_COST,
 			gettext_noop("Sets the planner's estimate of the cost of "
@@ -5002,7 +5164,8 @@ struct config_string ConfigureNamesString_gp[] =
 	{
 		{"gp_workfile_compress_algorithm", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Specify the compression algorithm that work files in the query executor use."),
-			gettext_noop("Valid values are \"NONE\", \"ZLIB\"."),
+			gettext_noop("Valid values are \"NONE\", \"ZLIB\", \"LZ4\", \"ZSTD\". "
+						 "LZ4 and ZSTD are only available if the server was built with them."),
 			GUC_GPDB_ADDOPT
 		},
 		&gp_workfile_compress_algorithm_str,
@@ -114,12 +114,14 @@
 #include "executor/nodeSort.h" 		/* gpmon */
 #include "miscadmin.h"
 #include "utils/datum.h"
+#include "utils/date.h"
 #include "executor/execWorkfile.h"
 #include "utils/logtape.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/pg_rusage.h"
 #include "utils/syscache.h"
+#include "utils/timestamp.h"
 #include "utils/tuplesort.h"
 #include "utils/pg_locale.h"
 #include "utils/builtins.h"
@@ -280,6 +282,13 @@ struct Tuplesortstate_mk
 	 */
 	bool statsFinalized;
 
+	/*
+	 * Number of in-memory sorts done by mk_qsort_parallel, and the most
+	 * threads any of them used, for EXPLAIN ANALYZE.
+	 */
+	int numParallelSorts;
+	int maxParallelWorkers;
+
     int currentRun;
 
     /*
@@ -490,6 +499,7 @@ static void readtup_datum(Tuplesortstate_mk *state, TuplesortPos_mk *pos, MKEntr
         LogicalTape *lt, uint32 len);
 
 static void tupsort_prepare_char(MKEntry *a, bool isChar);
+static MKNormalizeKey tupsort_normalize_func(PGFunction cmp);
 static int tupsort_compare_char(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *mkContext);
 
 static Datum tupsort_fetch_datum_mtup(MKEntry *a, MKContext *mkctxt, MKLvContext *lvctxt, bool *isNullOut);
@@ -502,6 +512,7 @@ static void tuplesort_inmem_limit_insert(Tuplesortstate_mk *state, MKEntry *e);
 static void tuplesort_inmem_nolimit_insert(Tuplesortstate_mk * state, MKEntry * e);
 static void tuplesort_heap_insert(Tuplesortstate_mk *state, MKEntry *e);
 static void tuplesort_limit_sort(Tuplesortstate_mk *state);
+static void tuplesort_qsort_entries(Tuplesortstate_mk *state);
 
 static void tupsort_refcnt(void *vp, int ref); 
 
@@ -676,6 +687,7 @@ create_mksort_context(
     mkctxt->cpfr = tupsort_cpfr;
     mkctxt->freeTup = freeTupleFn;
     mkctxt->estimatedExtraForPrep = 0;
+    mkctxt->parallelWorker = false;
 
     lc_guess_strxfrm_scaling_factor(&mkctxt->strxfrmScaleFactor, &mkctxt->strxfrmConstantFactor);
 
@@ -736,6 +748,13 @@ create_mksort_context(
                 else if (sinfo->scanKey.sk_func.fn_addr == bttextcmp)
                     sinfo->lvtype = MKLV_TYPE_TEXT;
             }
+
+            if (gp_mk_sort_normalized_keys && sinfo->typByVal)
+            {
+                sinfo->normalize = tupsort_normalize_func(sinfo->scanKey.sk_func.fn_addr);
+                if (sinfo->normalize)
+                    sinfo->lvtype = MKLV_TYPE_NORMKEY;
+            }
         }
         else
         {
@@ -1092,6 +1111,27 @@ tuplesort_finalize_stats_mk(Tuplesortstate_mk *state)
 				Max(state->instrument->workmemwanted, memwanted);
 		}
 
+		if (state->explainbuf)
+		{
+			int nnormkeys = 0;
+			int lv;
+
+			for (lv = 0; lv < state->mkctxt.total_lv; lv++)
+				if (state->mkctxt.lvctxt[lv].lvtype == MKLV_TYPE_NORMKEY)
+					nnormkeys++;
+
+			if (nnormkeys > 0)
+				appendStringInfo(state->explainbuf,
+								 "%d of %d sort keys compared as normalized keys.\n",
+								 nnormkeys, state->mkctxt.total_lv);
+		}
+
+		if (state->numParallelSorts > 0 && state->explainbuf)
+			appendStringInfo(state->explainbuf,
+							 "%d in-memory sorts on up to %d threads.\n",
+							 state->numParallelSorts,
+							 state->maxParallelWorkers);
+
 		state->statsFinalized = true;
     }
 }
@@ -1334,7 +1374,7 @@ tuplesort_performsort_mk(Tuplesortstate_mk *state)
              * amount of memory.  Just qsort 'em and we're done.
              */
             if(state->mkctxt.limit == 0)
-                mk_qsort(state->entries, state->entry_count, &state->mkctxt);
+                tuplesort_qsort_entries(state);
             else
                 tuplesort_limit_sort(state);
 
@@ -3055,6 +3095,13 @@ int tupsort_compare_datum(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKConte
                 int result = (i1 < i2) ? -1 : ((i1 == i2) ? 0 : 1);
                 return ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0) ? -result : result;
             }
+        case MKLV_TYPE_NORMKEY:
+            {
+                /* Direction is already folded into the normalized keys */
+                uint64 k1 = (uint64) v1->d;
+                uint64 k2 = (uint64) v2->d;
+                return (k1 < k2) ? -1 : ((k1 == k2) ? 0 : 1);
+            }
         default:
             return tupsort_compare_char(v1, v2, lvctxt, context);
     }
@@ -3261,12 +3308,156 @@ void tupsort_prepare(MKEntry *a, MKContext *mkctxt, int lv)
     else
         mke_set_null(a, (lvctxt->scanKey.sk_flags & SK_BT_NULLS_FIRST) != 0);
 
-    if (lvctxt->lvtype == MKLV_TYPE_CHAR)
+    if (lvctxt->lvtype == MKLV_TYPE_NORMKEY)
+    {
+        if (!isnull)
+            a->d = tupsort_normalize_datum(lvctxt, a->d);
+    }
+    else if (lvctxt->lvtype == MKLV_TYPE_CHAR)
         tupsort_prepare_char(a, true);
     else if (lvctxt->lvtype == MKLV_TYPE_TEXT)
         tupsort_prepare_char(a, false);
 }
 
+/*
+ * Normalized keys.
+ *
+ * A signed integer is offset by flipping its sign bit.  A float is made
+ * comparable as an unsigned integer by flipping the sign bit of positive
+ * values and all bits of negative ones; -0 is folded into 0 and every NaN
+ * into the largest word, as the float comparison functions treat NaN as
+ * equal to itself and larger than any other value.
+ */
+#define NORMKEY_SIGN_BIT	UINT64CONST(0x8000000000000000)
+
+static uint64 normalize_int64(int64 v)
+{
+    return ((uint64) v) ^ NORMKEY_SIGN_BIT;
+}
+
+static uint64 normalize_float8(float8 v)
+{
+    union
+    {
+        float8 f;
+        uint64 i;
+    } u;
+
+    if (isnan(v))
+        return ~UINT64CONST(0);
+    if (v == 0)
+        v = 0;
+
+    u.f = v;
+    if ((u.i & NORMKEY_SIGN_BIT) != 0)
+        return ~u.i;
+    return u.i | NORMKEY_SIGN_BIT;
+}
+
+static uint64 normkey_int2(Datum d)
+{
+    return normalize_int64(DatumGetInt16(d));
+}
+
+static uint64 normkey_int4(Datum d)
+{
+    return normalize_int64(DatumGetInt32(d));
+}
+
+static uint64 normkey_int8(Datum d)
+{
+    return normalize_int64(DatumGetInt64(d));
+}
+
+static uint64 normkey_oid(Datum d)
+{
+    return (uint64) DatumGetObjectId(d);
+}
+
+static uint64 normkey_bool(Datum d)
+{
+    return (uint64) DatumGetBool(d);
+}
+
+static uint64 normkey_float4(Datum d)
+{
+    return normalize_float8(DatumGetFloat4(d));
+}
+
+static uint64 normkey_float8(Datum d)
+{
+    return normalize_float8(DatumGetFloat8(d));
+}
+
+static uint64 normkey_date(Datum d)
+{
+    return normalize_int64(DatumGetDateADT(d));
+}
+
+#ifdef HAVE_INT64_TIMESTAMP
+static uint64 normkey_time(Datum d)
+{
+    return normalize_int64(DatumGetTimeADT(d));
+}
+
+static uint64 normkey_timestamp(Datum d)
+{
+    return normalize_int64(DatumGetTimestamp(d));
+}
+#else
+static uint64 normkey_time(Datum d)
+{
+    return normalize_float8(DatumGetTimeADT(d));
+}
+
+static uint64 normkey_timestamp(Datum d)
+{
+    return normalize_float8(DatumGetTimestamp(d));
+}
+#endif
+
+/*
+ * The normalization for keys compared by cmp, or NULL if the keys of that
+ * comparison function cannot be normalized.  timestamp_cmp also compares
+ * timestamptz.
+ */
+static MKNormalizeKey tupsort_normalize_func(PGFunction cmp)
+{
+    if (cmp == btint2cmp)
+        return normkey_int2;
+    if (cmp == btint4cmp)
+        return normkey_int4;
+    if (cmp == btint8cmp)
+        return normkey_int8;
+    if (cmp == btoidcmp)
+        return normkey_oid;
+    if (cmp == btboolcmp)
+        return normkey_bool;
+    if (cmp == btfloat4cmp)
+        return normkey_float4;
+    if (cmp == btfloat8cmp)
+        return normkey_float8;
+    if (cmp == date_cmp)
+        return normkey_date;
+    if (cmp == time_cmp)
+        return normkey_time;
+    if (cmp == timestamp_cmp)
+        return normkey_timestamp;
+    return NULL;
+}
+
+Datum tupsort_normalize_datum(MKLvContext *lvctxt, Datum d)
+{
+    uint64 k = (lvctxt->normalize) (d);
+
+    Assert(lvctxt->lvtype == MKLV_TYPE_NORMKEY);
+
+    /* Invert the bits for a descending level, so all levels compare ascending */
+    if ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0)
+        k = ~k;
+    return (Datum) k;
+}
+
 /* "True" length (not counting trailing blanks) of a BpChar */
 static inline int bcTruelen(char *p, int len)
 {
@@ -3587,6 +3778,34 @@ static void tuplesort_heap_insert(Tuplesortstate_mk *state, MKEntry *e)
     }
 }
 
+/*
+ * tuplesort_qsort_entries
+ *   Sort the in-memory entries, on several threads if gp_mk_sort_parallel_workers
+ *   allows it and the scratch array that the parallel merge needs still fits
+ *   in the memory allowed for the sort.
+ */
+static void
+tuplesort_qsort_entries(Tuplesortstate_mk *state)
+{
+    int nworkers = mk_qsort_parallel_workers(state->entry_count);
+    Size scratchSize = state->entry_count * sizeof(MKEntry);
+
+    if (nworkers > 1 &&
+        mk_qsort_parallel_safe(&state->mkctxt) &&
+        MemoryContextGetCurrentSpace(state->sortcontext) + scratchSize <= state->memAllowed)
+    {
+        MKEntry *scratch = (MKEntry *) palloc(scratchSize);
+
+        mk_qsort_parallel(state->entries, state->entry_count, &state->mkctxt, nworkers, scratch);
+        pfree(scratch);
+
+        state->numParallelSorts++;
+        state->maxParallelWorkers = Max(state->maxParallelWorkers, nworkers);
+    }
+    else
+        mk_qsort(state->entries, state->entry_count, &state->mkctxt);
+}
+
 static void tuplesort_limit_sort(Tuplesortstate_mk *state)
 {
     Assert(state->mkctxt.limit > 0);
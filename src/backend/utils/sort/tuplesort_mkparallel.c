@@ -0,0 +1,399 @@
+/*
+ * tuplesort_mkparallel.c
+ * 		Multi level key quick sort on several threads.
+ *
+ * Copyright (c) Greenplum Inc, 2008.
+ *
+ * The entry array is cut into one chunk per worker, and every chunk is
+ * sorted with mk_qsort on its own thread.  The sorted chunks are then merged
+ * by key range: splitter keys are sampled from all chunks, each worker finds
+ * its key range in every chunk by binary search and merges those pieces into
+ * its own part of a scratch array, which is finally copied back.
+ *
+ * The backend is not thread safe.  Workers must not palloc, elog, detoast or
+ * check for interrupts, so only sorts whose every key is a pass-by-value
+ * type compared by one of a few known builtin functions are done this way
+ * (see mk_qsort_parallel_safe).  Everything else falls back to the serial
+ * mk_qsort.
+ */
+
+#include "postgres.h"
+
+#include <pthread.h>
+
+#include "access/nbtree.h"
+#include "cdb/cdbgang.h"		/* gp_pthread_create */
+#include "cdb/cdbvars.h"
+#include "miscadmin.h"
+#include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/timestamp.h"
+#include "utils/tuplesort.h"
+#include "utils/tuplesort_mk.h"
+
+/* Don't bother with threads for fewer entries than this per worker */
+#define MK_PARALLEL_MIN_ENTRIES_PER_WORKER	(16 * 1024)
+
+typedef struct MKParallelWorker
+{
+	pthread_t	thread;
+	bool		started;
+	void	   *(*fn) (void *);	/* what the thread runs */
+
+	/* Private copy of the sort context, with parallelWorker set */
+	MKContext	ctxt;
+
+	/* Run formation: sort a[left..right] */
+	MKEntry    *a;
+	int			left;
+	int			right;
+
+	/* Merge: merge src[lo[c]..hi[c]) for every chunk c into dst */
+	MKEntry    *src;
+	MKEntry    *dst;
+	int			nchunks;
+	int		   *lo;
+	int		   *hi;
+} MKParallelWorker;
+
+/*
+ * Can the sort described by ctxt be done by mk_qsort_parallel?
+ */
+bool
+mk_qsort_parallel_safe(MKContext *ctxt)
+{
+	int			lv;
+
+	/*
+	 * Unique sorts free duplicates and index builds report them, both of
+	 * which need the memory manager or elog.  Index tuples also cache
+	 * attribute offsets in the shared tuple descriptor.
+	 */
+	if (ctxt->unique || ctxt->enforceUnique || ctxt->limit != 0 ||
+		ctxt->indexRel != NULL)
+		return false;
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		MKLvContext *lvctxt = ctxt->lvctxt + lv;
+		PGFunction	cmp = lvctxt->scanKey.sk_func.fn_addr;
+
+		if (!lvctxt->typByVal)
+			return false;
+
+		if (lvctxt->lvtype == MKLV_TYPE_INT32 ||
+			lvctxt->lvtype == MKLV_TYPE_NORMKEY)
+			continue;
+
+		if (lvctxt->lvtype != MKLV_TYPE_NONE)
+			return false;
+
+		if (cmp != btint2cmp && cmp != btint4cmp && cmp != btint8cmp &&
+			cmp != btfloat4cmp && cmp != btfloat8cmp && cmp != btoidcmp &&
+			cmp != date_cmp && cmp != time_cmp && cmp != timestamp_cmp)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * How many threads should sort n entries?  Returns 1 for a serial sort.
+ */
+int
+mk_qsort_parallel_workers(int n)
+{
+	int			nworkers = gp_mk_sort_parallel_workers;
+
+	if (nworkers > n / MK_PARALLEL_MIN_ENTRIES_PER_WORKER)
+		nworkers = n / MK_PARALLEL_MIN_ENTRIES_PER_WORKER;
+
+	return Max(nworkers, 1);
+}
+
+/*
+ * Compare two entries on all levels.  Unlike mkqs_comp, this does not rely
+ * on the entries having been prepared for a level, as the entries of
+ * different chunks are prepared to different levels after the chunk sorts.
+ */
+static int
+mk_parallel_compare(const MKEntry *a, const MKEntry *b, MKContext *ctxt)
+{
+	int			lv;
+
+	if (ctxt->fetchForPrep == NULL)
+	{
+		/* Datum sort: the one level is in the entry already */
+		MKEntry		va = *a;
+		MKEntry		vb = *b;
+		int			ret = mke_get_nullbits(&va) - mke_get_nullbits(&vb);
+
+		if (ret == 0 && !mke_is_null(&va))
+			ret = tupsort_compare_datum(&va, &vb, ctxt->lvctxt, ctxt);
+		return ret;
+	}
+
+	for (lv = 0; lv < ctxt->total_lv; lv++)
+	{
+		MKLvContext *lvctxt = ctxt->lvctxt + lv;
+		bool		nullsFirst = (lvctxt->scanKey.sk_flags & SK_BT_NULLS_FIRST) != 0;
+		MKEntry		va = *a;
+		MKEntry		vb = *b;
+		bool		isnull;
+		int			ret;
+
+		va.d = (ctxt->fetchForPrep) (&va, ctxt, lvctxt, &isnull);
+		if (isnull)
+			mke_set_null(&va, nullsFirst);
+		else
+		{
+			mke_set_not_null(&va);
+			if (lvctxt->lvtype == MKLV_TYPE_NORMKEY)
+				va.d = tupsort_normalize_datum(lvctxt, va.d);
+		}
+
+		vb.d = (ctxt->fetchForPrep) (&vb, ctxt, lvctxt, &isnull);
+		if (isnull)
+			mke_set_null(&vb, nullsFirst);
+		else
+		{
+			mke_set_not_null(&vb);
+			if (lvctxt->lvtype == MKLV_TYPE_NORMKEY)
+				vb.d = tupsort_normalize_datum(lvctxt, vb.d);
+		}
+
+		ret = mke_get_nullbits(&va) - mke_get_nullbits(&vb);
+		if (ret == 0 && !mke_is_null(&va))
+			ret = tupsort_compare_datum(&va, &vb, lvctxt, ctxt);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int
+mk_parallel_compare_qsort(const void *a, const void *b, void *arg)
+{
+	return mk_parallel_compare((const MKEntry *) a, (const MKEntry *) b,
+							   (MKContext *) arg);
+}
+
+/*
+ * Index of the first entry in a[left..right) that is not less than key.
+ */
+static int
+mk_parallel_lower_bound(MKEntry *a, int left, int right, MKEntry *key,
+						MKContext *ctxt)
+{
+	while (left < right)
+	{
+		int			mid = left + (right - left) / 2;
+
+		if (mk_parallel_compare(a + mid, key, ctxt) < 0)
+			left = mid + 1;
+		else
+			right = mid;
+	}
+	return left;
+}
+
+static void *
+mk_parallel_sort_chunk(void *arg)
+{
+	MKParallelWorker *w = (MKParallelWorker *) arg;
+
+	mk_qsort_impl(w->a, w->left, w->right, 0, true, &w->ctxt, false);
+	return NULL;
+}
+
+static void *
+mk_parallel_merge_range(void *arg)
+{
+	MKParallelWorker *w = (MKParallelWorker *) arg;
+	MKEntry    *dst = w->dst;
+
+	/*
+	 * There are only as many chunks as workers, so a linear scan for the
+	 * smallest head is cheap enough.
+	 */
+	while (true)
+	{
+		int			best = -1;
+		int			c;
+
+		for (c = 0; c < w->nchunks; c++)
+		{
+			if (w->lo[c] >= w->hi[c])
+				continue;
+			if (best < 0 ||
+				mk_parallel_compare(w->src + w->lo[c], w->src + w->lo[best],
+									&w->ctxt) < 0)
+				best = c;
+		}
+
+		if (best < 0)
+			break;
+
+		*dst++ = w->src[w->lo[best]++];
+	}
+
+	return NULL;
+}
+
+/*
+ * Thread entry point.  Like every other backend thread, a sort worker
+ * blocks the signals the backend handles, so that they are delivered to the
+ * main thread and their handlers never run on a worker.
+ */
+static void *
+mk_parallel_thread_main(void *arg)
+{
+	MKParallelWorker *w = (MKParallelWorker *) arg;
+
+	gp_set_thread_sigmasks();
+
+	return w->fn(w);
+}
+
+/*
+ * Start fn on every worker but the first, run it for the first one on this
+ * thread, and wait for the others.  A worker whose thread cannot be created
+ * is run here as well.
+ */
+static void
+mk_parallel_run(MKParallelWorker *workers, int nworkers, void *(*fn) (void *))
+{
+	int			i;
+
+	for (i = 1; i < nworkers; i++)
+	{
+		workers[i].fn = fn;
+		workers[i].started =
+			(gp_pthread_create(&workers[i].thread, mk_parallel_thread_main,
+							   &workers[i], "mk_qsort_parallel") == 0);
+	}
+
+	fn(&workers[0]);
+
+	for (i = 1; i < nworkers; i++)
+	{
+		if (workers[i].started)
+			pthread_join(workers[i].thread, NULL);
+		else
+			fn(&workers[i]);
+	}
+}
+
+/*
+ * Sort a[0..n) with nworkers threads, using scratch (room for n entries) for
+ * the merge.  The caller has checked mk_qsort_parallel_safe and accounted
+ * for the scratch memory.
+ */
+void
+mk_qsort_parallel(MKEntry *a, int n, MKContext *ctxt, int nworkers,
+				  MKEntry *scratch)
+{
+	MKParallelWorker *workers;
+	int		   *bounds;			/* nworkers x (nworkers + 1) positions */
+	MKEntry    *samples;
+	int			nsamples;
+	int			i;
+	int			c;
+	int			offset;
+
+	Assert(nworkers > 1 && nworkers <= n);
+	Assert(mk_qsort_parallel_safe(ctxt));
+
+	workers = palloc0(sizeof(MKParallelWorker) * nworkers);
+	bounds = palloc(sizeof(int) * nworkers * (nworkers + 1));
+	samples = palloc(sizeof(MKEntry) * nworkers * nworkers);
+
+	/*
+	 * Run formation: one chunk per worker.
+	 */
+	for (i = 0; i < nworkers; i++)
+	{
+		MKParallelWorker *w = workers + i;
+
+		w->ctxt = *ctxt;
+		w->ctxt.parallelWorker = true;
+		w->a = a;
+		w->left = (int) ((int64) n * i / nworkers);
+		w->right = (int) ((int64) n * (i + 1) / nworkers) - 1;
+	}
+
+	mk_parallel_run(workers, nworkers, mk_parallel_sort_chunk);
+
+	CHECK_FOR_INTERRUPTS();
+	if (QueryFinishPending)
+		goto done;
+
+	/*
+	 * Pick nworkers - 1 splitters from evenly spaced samples of every chunk,
+	 * so that the key ranges hold about the same number of entries even when
+	 * the input was already partly ordered.
+	 */
+	nsamples = 0;
+	for (c = 0; c < nworkers; c++)
+	{
+		int			len = workers[c].right - workers[c].left + 1;
+
+		for (i = 0; i < nworkers; i++)
+			samples[nsamples++] =
+				a[workers[c].left + (int) ((int64) len * i / nworkers)];
+	}
+	qsort_arg(samples, nsamples, sizeof(MKEntry), mk_parallel_compare_qsort,
+			  ctxt);
+
+	/*
+	 * bounds[c * (nworkers + 1) + k] is where key range k starts in chunk c.
+	 */
+	for (c = 0; c < nworkers; c++)
+	{
+		int		   *cb = bounds + c * (nworkers + 1);
+
+		cb[0] = workers[c].left;
+		for (i = 1; i < nworkers; i++)
+			cb[i] = mk_parallel_lower_bound(a, cb[i - 1], workers[c].right + 1,
+											samples + i * nworkers, ctxt);
+		cb[nworkers] = workers[c].right + 1;
+	}
+
+	/*
+	 * Merge: worker k merges key range k of every chunk.
+	 */
+	offset = 0;
+	for (i = 0; i < nworkers; i++)
+	{
+		MKParallelWorker *w = workers + i;
+
+		w->src = a;
+		w->dst = scratch + offset;
+		w->nchunks = nworkers;
+		w->lo = palloc(sizeof(int) * nworkers);
+		w->hi = palloc(sizeof(int) * nworkers);
+		for (c = 0; c < nworkers; c++)
+		{
+			w->lo[c] = bounds[c * (nworkers + 1) + i];
+			w->hi[c] = bounds[c * (nworkers + 1) + i + 1];
+			offset += w->hi[c] - w->lo[c];
+		}
+	}
+	Assert(offset == n);
+
+	mk_parallel_run(workers, nworkers, mk_parallel_merge_range);
+
+	memcpy(a, scratch, sizeof(MKEntry) * n);
+
+	for (i = 0; i < nworkers; i++)
+	{
+		pfree(workers[i].lo);
+		pfree(workers[i].hi);
+	}
+
+done:
+	pfree(samples);
+	pfree(bounds);
+	pfree(workers);
+}
@@ -260,7 +260,8 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 	Assert(ctxt);
 	Assert(lv < ctxt->total_lv);
 
-	CHECK_FOR_INTERRUPTS();
+	if (!ctxt->parallelWorker)
+		CHECK_FOR_INTERRUPTS();
 
 	if (QueryFinishPending)
 		return;
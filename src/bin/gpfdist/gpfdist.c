@@ -27,6 +27,7 @@
 #include <fstream/fstream.h>
 
 #ifndef WIN32
+#include <pthread.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/ioctl.h>
@@ -171,7 +172,11 @@ static struct
 	const char* ssl; /* path to certificates in case we use gpfdist with ssl */
 	int 		sslclean; /* Defines the time to wait [sec] until cleanup the SSL resources (internal, not documented) */
 	int			w; /* The time used for session timeout in seconds */
-} opt = { 8080, 8080, 0, 0, 0, ".", 0, 0, -1, 5, 0, 32768, 0, 256, 0, 0, 0, 5, 0 };
+	int			threads; /* number of threads reading files ahead, 0 to read in the event loop */
+} opt = { 8080, 8080, 0, 0, 0, ".", 0, 0, -1, 5, 0, 32768, 0, 256, 0, 0, 0, 5, 0, 0 };
+
+/* upper limit of --threads */
+#define GPFDIST_MAX_THREADS 64
 
 
 typedef union address
@@ -228,6 +233,7 @@ struct session_t
 	struct timeval 	tm;             /* timeout for struct event */
 	struct event   	ev;             /* event we are watching for this session*/
 	apr_hash_t		*requests;
+	struct prefetch_t* prefetch;	/* blocks read ahead by the worker threads (GET only) */
 };
 
 /*  An http request */
@@ -283,6 +289,8 @@ struct request_t
 	block_t	outblock;	/* next block to send out */
 	char*           line_delim_str;
 	int             line_delim_length;
+	int				waiting_block;	/* waiting for a worker thread to read the next block */
+	request_t*		next_waiting;	/* next request waiting for a block */
 
 #ifdef USE_SSL
 	/* SSL related */
@@ -363,6 +371,9 @@ static int get_unsent_bytes(request_t* r);
 
 static void * palloc_safe(request_t *r, apr_pool_t *pool, apr_size_t size, const char *fmt, ...);
 static void * pcalloc_safe(request_t *r, apr_pool_t *pool, apr_size_t size, const char *fmt, ...);
+#ifndef WIN32
+static void prefetch_unwait(request_t* r);
+#endif
 
 void process_signal(int sig);
 int gpfdist_init(int argc, const char* const argv[]);
@@ -484,6 +495,9 @@ static void usage_error(const char* msg, int print_usage)
 			fprintf(stderr,
 					"gpfdist -- file distribution web server\n\n"
 						"usage: gpfdist [--ssl <certificates_directory>] [-d <directory>] [-p <http(s)_port>] [-l <log_file>] [-t <timeout>] [-v | -V | -s] [-m <maxlen>] [-w <timeout>]"
+#ifndef WIN32
+					    " [--threads <n>]"
+#endif
 #ifdef GPFXDIST
 					    "[-c file]"
 #endif
@@ -509,6 +523,9 @@ static void usage_error(const char* msg, int print_usage)
 					    "        -c file    : configuration file for transformations\n"
 #endif
 						"        --version  : print version information\n"
+#ifndef WIN32
+						"        --threads n : number of threads reading files ahead, default is 0 (no threads)\n"
+#endif
 						"        -w timeout : timeout in seconds before close target file\n\n");
 		}
 	}
@@ -573,6 +590,7 @@ static void parse_command_line(int argc, const char* const argv[],
 #endif
 	{ "version", 256, 0, "print version number" },
 	{ NULL, 'w', 1, "wait for session timeout in seconds" },
+	{ "threads", 259, 1, "number of threads reading files ahead" },
 	{ 0 } };
 
 	status = apr_getopt_init(&os, pool, argc, argv);
@@ -661,6 +679,15 @@ static void parse_command_line(int argc, const char* const argv[],
 		case 'w':
 			opt.w = atoi(arg);
 			break;
+#ifndef WIN32
+		case 259:
+			opt.threads = atoi(arg);
+			break;
+#else
+		case 259:
+			usage_error("--threads is not supported by this build", 0);
+			break;
+#endif
 		}
 	}
 
@@ -686,6 +713,10 @@ static void parse_command_line(int argc, const char* const argv[],
     if (! ((GPFDIST_MAX_LINE_LOWER_LIMIT <= opt.m) && (opt.m <= GPFDIST_MAX_LINE_UPPER_LIMIT)))
     	usage_error(GPFDIST_MAX_LINE_MESSAGE, 0);
 
+    if (opt.threads < 0 || opt.threads > GPFDIST_MAX_THREADS)
+		usage_error(apr_psprintf(pool, "Error: --threads must be between 0 and %d",
+								 GPFDIST_MAX_THREADS), 0);
+
     if (!is_valid_listen_queue_size(opt.z))
 		usage_error("Error: -z listen queue size must be between 16 and 512 (default is 256)", 0);
 
@@ -1126,6 +1157,10 @@ static void request_end(request_t* r, int error, const char* errmsg)
 
 	gprintlnif(r, "request end");
 
+#ifndef WIN32
+	prefetch_unwait(r);
+#endif
+
 	/* If we still have a block outstanding, the session is corrupted. */
 	if (r->outblock.top != r->outblock.bot)
 	{
@@ -1273,11 +1308,425 @@ static void gp1_send_errfile(request_t* r, apr_file_t* errfile)
 }
 #endif
 
+/*
+ * session_get_block() returns this instead of an error string when the
+ * worker threads have not read the next block of the session yet.
+ */
+static const char SESSION_BLOCK_PENDING[] = "block pending";
+
+#ifndef WIN32
+/*
+ * Read ahead with worker threads (--threads)
+ *
+ * Rows of a file must be sent in order, and reading whole rows out of a file
+ * (decompressing it, or finding the row boundaries of a CSV file) can only
+ * be done from the start, so each GET session is read by one worker at a
+ * time. The workers read the sessions in parallel, and read ahead into a
+ * small ring of blocks, while the event loop sends the blocks already read.
+ *
+ * The workers only touch the fstream and the ring. They don't log, and
+ * don't allocate from the APR pools, which are not thread safe; the event
+ * loop does that for them. A worker wakes the event loop by writing to a
+ * pipe, and the event loop then restarts the requests waiting for a block.
+ *
+ * The ring of a session has up to PREFETCH_BLOCKS blocks of opt.m bytes, but
+ * no more than PREFETCH_MAX_BYTES in total, and at least one block. The
+ * buffers are allocated when the worker is about to read into them, so that
+ * short files only get the blocks they use.
+ */
+#define PREFETCH_BLOCKS 4
+#define PREFETCH_MAX_BYTES (1024*1024)
+
+typedef struct prefetch_block_t prefetch_block_t;
+struct prefetch_block_t
+{
+	char*			data;		/* opt.m bytes, or NULL if not allocated yet */
+	int				size;		/* bytes in data */
+	apr_int64_t		read_bytes;	/* compressed bytes read for this block */
+	struct fstream_filename_and_offset fos;
+};
+
+typedef struct prefetch_t prefetch_t;
+struct prefetch_t
+{
+	fstream_t*		fstream;
+	char*			line_delim_str;
+	int				line_delim_length;
+	prefetch_block_t blocks[PREFETCH_BLOCKS];
+	int				nblocks;	/* # of blocks of the ring */
+	apr_pool_t*		pool;		/* session pool, for the blocks */
+	int				head;		/* first block read and not sent out */
+	int				count;		/* # of blocks read and not sent out */
+	int				queued;		/* waiting for a worker */
+	int				busy;		/* a worker is reading */
+	int				eof;		/* the worker reached EOF or an error */
+	int				stop;		/* the session is ending, don't read anymore */
+	apr_int64_t		eof_read_bytes;	/* compressed bytes read when reaching EOF */
+	char			error[1024];	/* error message, if the read failed */
+	prefetch_t*		next;		/* next in the queue of the workers */
+};
+
+static struct
+{
+	pthread_mutex_t	mutex;
+	pthread_cond_t	queue_cond;	/* signalled when a session is queued */
+	pthread_cond_t	idle_cond;	/* signalled when a worker is done with a session */
+	prefetch_t*		queue_head;
+	prefetch_t*		queue_tail;
+	int				notify_fd[2];	/* pipe to wake the event loop */
+	struct event	notify_event;
+	request_t*		waiting;	/* requests waiting for a block, event loop only */
+} workers;
+
+/*
+ * queue the session for the workers. caller is the event loop, and holds the
+ * mutex
+ */
+static void prefetch_enqueue(prefetch_t* pf)
+{
+	prefetch_block_t* b;
+
+	if (pf->queued || pf->busy || pf->eof || pf->stop ||
+		pf->count == pf->nblocks)
+		return;
+
+	/* the workers don't allocate, so give them the block to read into */
+	b = &pf->blocks[(pf->head + pf->count) % pf->nblocks];
+	if (!b->data)
+		b->data = palloc_safe(NULL, pf->pool, opt.m,
+							  "out of memory when allocating buffer: %d bytes", opt.m);
+
+	pf->queued = 1;
+	pf->next = 0;
+	if (workers.queue_tail)
+		workers.queue_tail->next = pf;
+	else
+		workers.queue_head = pf;
+	workers.queue_tail = pf;
+	pthread_cond_signal(&workers.queue_cond);
+}
+
+/* remove the session from the queue of the workers. caller holds the mutex */
+static void prefetch_dequeue(prefetch_t* pf)
+{
+	prefetch_t** link = &workers.queue_head;
+	prefetch_t*  prev = 0;
+
+	while (*link && *link != pf)
+	{
+		prev = *link;
+		link = &prev->next;
+	}
+
+	if (*link)
+	{
+		*link = pf->next;
+		if (workers.queue_tail == pf)
+			workers.queue_tail = prev;
+	}
+	pf->queued = 0;
+	pf->next = 0;
+}
+
+/* wake the event loop */
+static void prefetch_notify(void)
+{
+	char c = 0;
+
+	/* the pipe is non blocking: if it is full, the event loop is woken anyway */
+	if (write(workers.notify_fd[1], &c, 1) < 0 && errno != EAGAIN)
+		return;
+}
+
+static void* prefetch_worker(void* arg)
+{
+	sigset_t sigs;
+
+	/* signals are for the event loop */
+	sigfillset(&sigs);
+	pthread_sigmask(SIG_BLOCK, &sigs, 0);
+
+	pthread_mutex_lock(&workers.mutex);
+	for (;;)
+	{
+		prefetch_t* pf;
+
+		while (!workers.queue_head)
+			pthread_cond_wait(&workers.queue_cond, &workers.mutex);
+
+		pf = workers.queue_head;
+		prefetch_dequeue(pf);
+		pf->busy = 1;
+
+		while (!pf->stop && !pf->eof && pf->count < pf->nblocks)
+		{
+			/* the block after the last one read is not seen by the event loop */
+			prefetch_block_t* b = &pf->blocks[(pf->head + pf->count) % pf->nblocks];
+			apr_int64_t pos;
+			int size;
+
+			/* not allocated yet; the event loop queues the session again */
+			if (!b->data)
+				break;
+
+			pthread_mutex_unlock(&workers.mutex);
+
+			memset(&b->fos, 0, sizeof(b->fos));
+			pos = fstream_get_compressed_position(pf->fstream);
+			size = fstream_read(pf->fstream, b->data, opt.m, &b->fos, 1,
+								pf->line_delim_str, pf->line_delim_length);
+
+			pthread_mutex_lock(&workers.mutex);
+
+			if (size > 0)
+			{
+				b->size = size;
+				b->read_bytes = fstream_get_compressed_position(pf->fstream) - pos;
+				pf->count++;
+			}
+			else
+			{
+				if (size == 0)
+					pf->eof_read_bytes = fstream_get_compressed_size(pf->fstream) - pos;
+				else
+				{
+					pf->eof_read_bytes = fstream_get_compressed_position(pf->fstream) - pos;
+					apr_cpystrn(pf->error, fstream_get_error(pf->fstream), sizeof(pf->error));
+				}
+				pf->eof = size == 0 ? 1 : -1;
+			}
+
+			prefetch_notify();
+		}
+
+		pf->busy = 0;
+		pthread_cond_broadcast(&workers.idle_cond);
+	}
+
+	return 0;
+}
+
+/* park a request until a worker has read a block */
+static void prefetch_wait(request_t* r)
+{
+	r->waiting_block = 1;
+	r->next_waiting = workers.waiting;
+	workers.waiting = r;
+}
+
+/* take a request off the list of requests waiting for a block */
+static void prefetch_unwait(request_t* r)
+{
+	request_t** link = &workers.waiting;
+
+	if (!r->waiting_block)
+		return;
+
+	while (*link && *link != r)
+		link = &(*link)->next_waiting;
+	if (*link)
+		*link = r->next_waiting;
+
+	r->waiting_block = 0;
+	r->next_waiting = 0;
+}
+
+/*
+ * prefetch_notify_cb
+ *
+ * Callback when a worker has read a block. Restart the requests that are
+ * waiting for one. A request whose block is still not read parks itself
+ * again.
+ */
+static void prefetch_notify_cb(int fd, short event, void* arg)
+{
+	char 		buf[256];
+	request_t*	r;
+	request_t*	next;
+
+	while (read(fd, buf, sizeof(buf)) > 0)
+		;
+
+	r = workers.waiting;
+	workers.waiting = 0;
+
+	for (; r; r = next)
+	{
+		next = r->next_waiting;
+		r->waiting_block = 0;
+		r->next_waiting = 0;
+
+		if (setup_write(r))
+			request_end(r, 1, 0);
+	}
+}
+
+/* start the worker threads */
+static void prefetch_init(void)
+{
+	pthread_attr_t 	attr;
+	int 			i;
+
+	pthread_mutex_init(&workers.mutex, 0);
+	pthread_cond_init(&workers.queue_cond, 0);
+	pthread_cond_init(&workers.idle_cond, 0);
+
+	if (pipe(workers.notify_fd) < 0)
+		gfatal(NULL, "cannot create pipe for worker threads: %s", strerror(errno));
+
+	for (i = 0; i < 2; i++)
+	{
+		if (fcntl(workers.notify_fd[i], F_SETFL, O_NONBLOCK) < 0 ||
+			fcntl(workers.notify_fd[i], F_SETFD, FD_CLOEXEC) < 0)
+			gfatal(NULL, "cannot setup pipe for worker threads: %s", strerror(errno));
+	}
+
+	event_set(&workers.notify_event, workers.notify_fd[0], EV_READ | EV_PERSIST,
+			  prefetch_notify_cb, 0);
+	if (event_add(&workers.notify_event, 0))
+		gfatal(NULL, "cannot add event for worker threads");
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	for (i = 0; i < opt.threads; i++)
+	{
+		pthread_t thread;
+		int rc = pthread_create(&thread, &attr, prefetch_worker, 0);
+
+		if (rc)
+			gfatal(NULL, "cannot create worker thread: %s", strerror(rc));
+	}
+
+	pthread_attr_destroy(&attr);
+}
+
+/* setup the read ahead of a GET session, on its first block */
+static prefetch_t* prefetch_start(session_t* session, char* line_delim_str,
+								  int line_delim_length)
+{
+	prefetch_t* pf;
+
+	pf = pcalloc_safe(NULL, session->pool, sizeof(prefetch_t),
+					  "out of memory when allocating prefetch_t: %d bytes", sizeof(prefetch_t));
+
+	pf->nblocks = PREFETCH_MAX_BYTES / opt.m;
+	if (pf->nblocks > PREFETCH_BLOCKS)
+		pf->nblocks = PREFETCH_BLOCKS;
+	if (pf->nblocks < 1)
+		pf->nblocks = 1;
+	pf->pool = session->pool;
+	pf->fstream = session->fstream;
+	pf->line_delim_length = line_delim_length;
+	pf->line_delim_str = apr_pstrdup(session->pool, line_delim_str ? line_delim_str : "");
+
+	session->prefetch = pf;
+	return pf;
+}
+
+/*
+ * prefetch_stop
+ *
+ * Stop reading ahead for the session, and wait for the worker reading it,
+ * so that the fstream can be closed.
+ */
+static void prefetch_stop(session_t* session)
+{
+	prefetch_t* pf = session->prefetch;
+
+	if (!pf)
+		return;
+
+	pthread_mutex_lock(&workers.mutex);
+	pf->stop = 1;
+	if (pf->queued)
+		prefetch_dequeue(pf);
+	while (pf->busy)
+		pthread_cond_wait(&workers.idle_cond, &workers.mutex);
+	pthread_mutex_unlock(&workers.mutex);
+
+	session->prefetch = 0;
+
+	/* the other requests waiting for a block of the session find it ended */
+	prefetch_notify();
+}
+
+/*
+ * prefetch_get_block
+ *
+ * Take the next block read by the workers. Same as session_get_block(),
+ * but returns SESSION_BLOCK_PENDING if the block is not read yet.
+ */
+static const char*
+prefetch_get_block(const request_t* r, block_t* retblock, char* line_delim_str, int line_delim_length)
+{
+	session_t*	session = r->session;
+	prefetch_t* pf = session->prefetch;
+	prefetch_block_t* b;
+	struct fstream_filename_and_offset fos;
+	int 		eof;
+
+	if (!pf)
+		pf = prefetch_start(session, line_delim_str, line_delim_length);
+
+	pthread_mutex_lock(&workers.mutex);
+
+	if (pf->count == 0)
+	{
+		eof = pf->eof;
+		if (!eof)
+			prefetch_enqueue(pf);
+		pthread_mutex_unlock(&workers.mutex);
+
+		if (!eof)
+			return SESSION_BLOCK_PENDING;
+
+		gcb.read_bytes += pf->eof_read_bytes;
+
+		if (eof < 0)
+		{
+			/* copy the message, the session may be freed with the request */
+			const char* ferror = apr_pstrdup(r->pool, pf->error);
+
+			gwarning(NULL, "session_get_block end session due to %s", ferror);
+			session_end(session, 1);
+			return ferror;
+		}
+
+		gprintln(NULL, "session_get_block: end session due to EOF");
+		session_end(session, 0);
+		return 0;
+	}
+
+	/* the workers don't write to the head block, until it is given back */
+	b = &pf->blocks[pf->head];
+	pthread_mutex_unlock(&workers.mutex);
+
+	memcpy(retblock->data, b->data, b->size);
+	retblock->top = b->size;
+	fos = b->fos;
+	gcb.read_bytes += b->read_bytes;
+
+	/* give the block back to the workers */
+	pthread_mutex_lock(&workers.mutex);
+	pf->head = (pf->head + 1) % pf->nblocks;
+	pf->count--;
+	prefetch_enqueue(pf);
+	pthread_mutex_unlock(&workers.mutex);
+
+	block_fill_header(r, retblock, &fos);
+
+	return 0;
+}
+#endif
+
 /*
  * session_get_block
  *
  * Get a block out of the session. return error string. This includes a block
  * header (metadata for client such as filename, etc) and the data itself.
+ * With worker threads, returns SESSION_BLOCK_PENDING if the next block is
+ * not read yet.
  */
 static const char*
 session_get_block(const request_t* r, block_t* retblock, char* line_delim_str, int line_delim_length)
@@ -1297,6 +1746,11 @@ session_get_block(const request_t* r, block_t* retblock, char* line_delim_str, i
 		return 0;
 	}
 
+#ifndef WIN32
+	if (opt.threads > 0)
+		return prefetch_get_block(r, retblock, line_delim_str, line_delim_length);
+#endif
+
 	gcb.read_bytes -= fstream_get_compressed_position(session->fstream);
 
 	/* read data from our filestream as a chunk with whole data rows */
@@ -1337,6 +1791,10 @@ static void session_end(session_t* session, int error)
 	if (error)
 		session->is_error = error;
 
+#ifndef WIN32
+	prefetch_stop(session);
+#endif
+
 	if (session->fstream)
 	{
 		fstream_close(session->fstream);
@@ -1349,6 +1807,10 @@ static void session_free(session_t* session)
 {
 	gprintln(NULL, "free session %s", session->key);
 
+#ifndef WIN32
+	prefetch_stop(session);
+#endif
+
 	if (session->fstream)
 	{
 		fstream_close(session->fstream);
@@ -1729,6 +2191,12 @@ static void do_write(int fd, short event, void* arg)
 		{
 			const char* ferror = session_get_block(r, &r->outblock, r->line_delim_str, r->line_delim_length);
 
+			if (ferror == SESSION_BLOCK_PENDING)
+			{
+				/* prefetch_notify_cb() will set up the write again */
+				prefetch_wait(r);
+				return;
+			}
 			if (ferror)
 			{
 				request_end(r, 1, ferror);
@@ -3468,6 +3936,11 @@ int gpfdist_init(int argc, const char* const argv[])
 	event_init();
 	http_setup();
 
+#ifndef WIN32
+	if (opt.threads > 0)
+		prefetch_init();
+#endif
+
 #ifdef USE_SSL
 	if (opt.ssl)
 		printf("Serving HTTPS on port %d, directory %s\n", opt.p, opt.d);
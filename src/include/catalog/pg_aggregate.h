@@ -288,6 +288,9 @@ DATA(insert ( 3538	string_agg_delim_transfn - - - string_agg_finalfn 0 2281 _nul
 
 DATA(insert ( 6112	pg_partition_oid_transfn      - - - pg_partition_oid_finalfn 0 2281 _null_ f));
 
+/* statistics */
+DATA(insert ( 6133	gp_hll_accum             - gp_hll_combine - gp_hll_estimate 0 17 _null_ f));
+
 
 
 /*
@@ -72,6 +72,10 @@ DATA(insert OID = 3062 ( rle_type gp_rle_type_constructor gp_rle_type_destructor
 
 DATA(insert OID = 3063 ( none gp_dummy_compression_constructor gp_dummy_compression_destructor gp_dummy_compression_compress gp_dummy_compression_decompress gp_dummy_compression_validator PGUID ));
 
+DATA(insert OID = 3070 ( zstd gp_zstd_constructor gp_zstd_destructor gp_zstd_compress gp_zstd_decompress gp_zstd_validator PGUID ));
+
+DATA(insert OID = 3071 ( lz4 gp_lz4_constructor gp_lz4_destructor gp_lz4_compress gp_lz4_decompress gp_lz4_validator PGUID ));
+
 #define NUM_COMPRESS_FUNCS 5
 
 #define COMPRESSION_CONSTRUCTOR 0
@@ -1594,6 +1594,14 @@
 -- Analyze related
  CREATE FUNCTION gp_statistics_estimate_reltuples_relpages_oid(oid) RETURNS _float4 LANGUAGE internal VOLATILE STRICT AS 'gp_statistics_estimate_reltuples_relpages_oid' WITH (OID=5032, DESCRIPTION="Return reltuples/relpages information for relation.");
 
+ CREATE FUNCTION gp_hll_accum(bytea, anyelement) RETURNS bytea LANGUAGE internal IMMUTABLE AS 'gp_hll_accum' WITH (OID=6130, DESCRIPTION="gp_hll_ndistinct transition function");
+
+ CREATE FUNCTION gp_hll_combine(bytea, bytea) RETURNS bytea LANGUAGE internal IMMUTABLE AS 'gp_hll_combine' WITH (OID=6131, DESCRIPTION="gp_hll_ndistinct preliminary function");
+
+ CREATE FUNCTION gp_hll_estimate(bytea) RETURNS float8 LANGUAGE internal IMMUTABLE STRICT AS 'gp_hll_estimate' WITH (OID=6132, DESCRIPTION="gp_hll_ndistinct final function");
+
+ CREATE FUNCTION gp_hll_ndistinct(anyelement) RETURNS float8 LANGUAGE internal IMMUTABLE AS 'aggregate_dummy' WITH (OID=6133, DESCRIPTION="estimated number of distinct values, using HyperLogLog", proisagg="t");
+
 -- Backoff related
  CREATE FUNCTION gp_adjust_priority(int4, int4, int4) RETURNS int4 LANGUAGE internal VOLATILE STRICT AS 'gp_adjust_priority_int' WITH (OID=5040, DESCRIPTION="change weight of all the backends for a given session id");
 
@@ -1718,6 +1726,26 @@ CREATE FUNCTION gp_nondbspecific_ptcat_verification() RETURNS bool LANGUAGE inte
 
  CREATE FUNCTION gp_rle_type_validator(internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'rle_type_validator' WITH(OID=9923, DESCRIPTION="Type speific RLE compression validator");
 
+ CREATE FUNCTION gp_zstd_constructor(internal, internal, bool) RETURNS internal LANGUAGE internal VOLATILE AS 'zstd_constructor' WITH (OID=6120, DESCRIPTION="zstd constructor");
+
+ CREATE FUNCTION gp_zstd_destructor(internal) RETURNS void LANGUAGE internal VOLATILE AS 'zstd_destructor' WITH(OID=6121, DESCRIPTION="zstd destructor");
+
+ CREATE FUNCTION gp_zstd_compress(internal, int4, internal, int4, internal, internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'zstd_compress' WITH(OID=6122, DESCRIPTION="zstd compressor");
+
+ CREATE FUNCTION gp_zstd_decompress(internal, int4, internal, int4, internal, internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'zstd_decompress' WITH(OID=6123, DESCRIPTION="zstd decompressor");
+
+ CREATE FUNCTION gp_zstd_validator(internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'zstd_validator' WITH(OID=6124, DESCRIPTION="zstd compression validator");
+
+ CREATE FUNCTION gp_lz4_constructor(internal, internal, bool) RETURNS internal LANGUAGE internal VOLATILE AS 'lz4_constructor' WITH (OID=6125, DESCRIPTION="lz4 constructor");
+
+ CREATE FUNCTION gp_lz4_destructor(internal) RETURNS void LANGUAGE internal VOLATILE AS 'lz4_destructor' WITH(OID=6126, DESCRIPTION="lz4 destructor");
+
+ CREATE FUNCTION gp_lz4_compress(internal, int4, internal, int4, internal, internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'lz4_compress' WITH(OID=6127, DESCRIPTION="lz4 compressor");
+
+ CREATE FUNCTION gp_lz4_decompress(internal, int4, internal, int4, internal, internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'lz4_decompress' WITH(OID=6128, DESCRIPTION="lz4 decompressor");
+
+ CREATE FUNCTION gp_lz4_validator(internal) RETURNS void LANGUAGE internal IMMUTABLE AS 'lz4_validator' WITH(OID=6129, DESCRIPTION="lz4 compression validator");
+
  CREATE FUNCTION gp_dummy_compression_constructor(internal, internal, bool) RETURNS internal LANGUAGE internal VOLATILE AS 'dummy_compression_constructor' WITH (OID=3064, DESCRIPTION="Dummy compression destructor");
 
  CREATE FUNCTION gp_dummy_compression_destructor(internal) RETURNS internal LANGUAGE internal VOLATILE AS 'dummy_compression_destructor' WITH (OID=3065, DESCRIPTION="Dummy compression destructor");
@@ -1765,6 +1793,8 @@ CREATE FUNCTION gp_nondbspecific_ptcat_verification() RETURNS bool LANGUAGE inte
  CREATE FUNCTION enable_xform(text) RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'enable_xform' WITH (OID=6088, DESCRIPTION="enables transformations in the optimizer");
 
  CREATE FUNCTION gp_opt_version() RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'gp_opt_version' WITH (OID=6089, DESCRIPTION="Returns the optimizer and gpos library versions");
+
+ CREATE FUNCTION gp_opt_mdcache_stats(OUT hits int8, OUT misses int8, OUT evictions int8, OUT resets int8) RETURNS pg_catalog.record LANGUAGE internal VOLATILE STRICT AS 'gp_opt_mdcache_stats' WITH (OID=6119, DESCRIPTION="Returns the counters of the optimizer metadata cache of this backend");
  
  
   -- functions for the complex data type
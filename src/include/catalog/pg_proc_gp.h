@@ -22,7 +22,7 @@
 
    WARNING: DO NOT MODIFY THE FOLLOWING SECTION: 
    Generated by catullus.pl version 8
-   on Thu Apr 14 18:56:55 2016
+   on Fri Oct 16 00:33:55 2026
 
    Please make your changes in pg_proc.sql
 */
@@ -2591,6 +2591,22 @@ DESCR("Greenplum fault testing only");
 DATA(insert OID = 5032 ( gp_statistics_estimate_reltuples_relpages_oid  PGNSP PGUID 12 1 0 0 f f t f v 1 0 1021 f "26" _null_ _null_ _null_ _null_ gp_statistics_estimate_reltuples_relpages_oid _null_ _null_ _null_ n ));
 DESCR("Return reltuples/relpages information for relation.");
 
+/* gp_hll_accum(bytea, anyelement) => bytea */ 
+DATA(insert OID = 6130 ( gp_hll_accum  PGNSP PGUID 12 1 0 0 f f f f i 2 0 17 f "17 2283" _null_ _null_ _null_ _null_ gp_hll_accum _null_ _null_ _null_ n ));
+DESCR("gp_hll_ndistinct transition function");
+
+/* gp_hll_combine(bytea, bytea) => bytea */ 
+DATA(insert OID = 6131 ( gp_hll_combine  PGNSP PGUID 12 1 0 0 f f f f i 2 0 17 f "17 17" _null_ _null_ _null_ _null_ gp_hll_combine _null_ _null_ _null_ n ));
+DESCR("gp_hll_ndistinct preliminary function");
+
+/* gp_hll_estimate(bytea) => float8 */ 
+DATA(insert OID = 6132 ( gp_hll_estimate  PGNSP PGUID 12 1 0 0 f f t f i 1 0 701 f "17" _null_ _null_ _null_ _null_ gp_hll_estimate _null_ _null_ _null_ n ));
+DESCR("gp_hll_ndistinct final function");
+
+/* gp_hll_ndistinct(anyelement) => float8 */ 
+DATA(insert OID = 6133 ( gp_hll_ndistinct  PGNSP PGUID 12 1 0 0 t f f f i 1 0 701 f "2283" _null_ _null_ _null_ _null_ aggregate_dummy _null_ _null_ _null_ n ));
+DESCR("estimated number of distinct values, using HyperLogLog");
+
 
 /* Backoff related */
 /* gp_adjust_priority(int4, int4, int4) => int4 */ 
@@ -2830,6 +2846,46 @@ DESCR("Type specific RLE decompressor");
 DATA(insert OID = 9923 ( gp_rle_type_validator  PGNSP PGUID 12 1 0 0 f f f f i 1 0 2278 f "2281" _null_ _null_ _null_ _null_ rle_type_validator _null_ _null_ _null_ n ));
 DESCR("Type speific RLE compression validator");
 
+/* gp_zstd_constructor(internal, internal, bool) => internal */ 
+DATA(insert OID = 6120 ( gp_zstd_constructor  PGNSP PGUID 12 1 0 0 f f f f v 3 0 2281 f "2281 2281 16" _null_ _null_ _null_ _null_ zstd_constructor _null_ _null_ _null_ n ));
+DESCR("zstd constructor");
+
+/* gp_zstd_destructor(internal) => void */ 
+DATA(insert OID = 6121 ( gp_zstd_destructor  PGNSP PGUID 12 1 0 0 f f f f v 1 0 2278 f "2281" _null_ _null_ _null_ _null_ zstd_destructor _null_ _null_ _null_ n ));
+DESCR("zstd destructor");
+
+/* gp_zstd_compress(internal, int4, internal, int4, internal, internal) => void */ 
+DATA(insert OID = 6122 ( gp_zstd_compress  PGNSP PGUID 12 1 0 0 f f f f i 6 0 2278 f "2281 23 2281 23 2281 2281" _null_ _null_ _null_ _null_ zstd_compress _null_ _null_ _null_ n ));
+DESCR("zstd compressor");
+
+/* gp_zstd_decompress(internal, int4, internal, int4, internal, internal) => void */ 
+DATA(insert OID = 6123 ( gp_zstd_decompress  PGNSP PGUID 12 1 0 0 f f f f i 6 0 2278 f "2281 23 2281 23 2281 2281" _null_ _null_ _null_ _null_ zstd_decompress _null_ _null_ _null_ n ));
+DESCR("zstd decompressor");
+
+/* gp_zstd_validator(internal) => void */ 
+DATA(insert OID = 6124 ( gp_zstd_validator  PGNSP PGUID 12 1 0 0 f f f f i 1 0 2278 f "2281" _null_ _null_ _null_ _null_ zstd_validator _null_ _null_ _null_ n ));
+DESCR("zstd compression validator");
+
+/* gp_lz4_constructor(internal, internal, bool) => internal */ 
+DATA(insert OID = 6125 ( gp_lz4_constructor  PGNSP PGUID 12 1 0 0 f f f f v 3 0 2281 f "2281 2281 16" _null_ _null_ _null_ _null_ lz4_constructor _null_ _null_ _null_ n ));
+DESCR("lz4 constructor");
+
+/* gp_lz4_destructor(internal) => void */ 
+DATA(insert OID = 6126 ( gp_lz4_destructor  PGNSP PGUID 12 1 0 0 f f f f v 1 0 2278 f "2281" _null_ _null_ _null_ _null_ lz4_destructor _null_ _null_ _null_ n ));
+DESCR("lz4 destructor");
+
+/* gp_lz4_compress(internal, int4, internal, int4, internal, internal) => void */ 
+DATA(insert OID = 6127 ( gp_lz4_compress  PGNSP PGUID 12 1 0 0 f f f f i 6 0 2278 f "2281 23 2281 23 2281 2281" _null_ _null_ _null_ _null_ lz4_compress _null_ _null_ _null_ n ));
+DESCR("lz4 compressor");
+
+/* gp_lz4_decompress(internal, int4, internal, int4, internal, internal) => void */ 
+DATA(insert OID = 6128 ( gp_lz4_decompress  PGNSP PGUID 12 1 0 0 f f f f i 6 0 2278 f "2281 23 2281 23 2281 2281" _null_ _null_ _null_ _null_ lz4_decompress _null_ _null_ _null_ n ));
+DESCR("lz4 decompressor");
+
+/* gp_lz4_validator(internal) => void */ 
+DATA(insert OID = 6129 ( gp_lz4_validator  PGNSP PGUID 12 1 0 0 f f f f i 1 0 2278 f "2281" _null_ _null_ _null_ _null_ lz4_validator _null_ _null_ _null_ n ));
+DESCR("lz4 compression validator");
+
 /* gp_dummy_compression_constructor(internal, internal, bool) => internal */ 
 DATA(insert OID = 3064 ( gp_dummy_compression_constructor  PGNSP PGUID 12 1 0 0 f f f f v 3 0 2281 f "2281 2281 16" _null_ _null_ _null_ _null_ dummy_compression_constructor _null_ _null_ _null_ n ));
 DESCR("Dummy compression destructor");
@@ -2925,6 +2981,10 @@ DESCR("enables transformations in the optimizer");
 DATA(insert OID = 6089 ( gp_opt_version  PGNSP PGUID 12 1 0 0 f f t f i 0 0 25 f "" _null_ _null_ _null_ _null_ gp_opt_version _null_ _null_ _null_ n ));
 DESCR("Returns the optimizer and gpos library versions");
 
+/* gp_opt_mdcache_stats(OUT hits int8, OUT misses int8, OUT evictions int8, OUT resets int8) => pg_catalog.record */ 
+DATA(insert OID = 6119 ( gp_opt_mdcache_stats  PGNSP PGUID 12 1 0 0 f f t f v 0 0 2249 f "" "{20,20,20,20}" "{o,o,o,o}" "{hits,misses,evictions,resets}" _null_ gp_opt_mdcache_stats _null_ _null_ _null_ n ));
+DESCR("Returns the counters of the optimizer metadata cache of this backend");
+
 
   /* functions for the complex data type */
 /* complex_in(cstring) => complex */ 
@@ -67,6 +67,27 @@ typedef struct AOCSInsertDescData
 
 typedef AOCSInsertDescData *AOCSInsertDesc;
 
+/*
+ * Maximum number of values of a column that a scan decodes at once.
+ */
+#define AOCS_SCAN_BATCH_SIZE 64
+
+extern bool gp_aocs_late_materialization;
+
+/*
+ * Values of one column of a scan, decoded ahead of the rows that return
+ * them.
+ */
+typedef struct AOCSColumnBatch
+{
+	Datum	   *values;
+	bool	   *nulls;
+	int			count;			/* number of decoded values */
+	int			next;			/* index of the next value to return */
+	int64		firstRowNum;	/* row number of values[0], or -1 if the
+								 * block does not record row numbers */
+} AOCSColumnBatch;
+
 /*
  * used for scan of append only relations using BufferedRead and VarBlocks
  */
@@ -103,6 +124,9 @@ typedef struct AOCSScanDescData
 	struct DatumStreamRead **ds;
 	bool *proj;
 
+	/* decoded values of the projected columns, see aocs_getnext */
+	AOCSColumnBatch *batches;
+
 	/* synthetic system attributes */
 	ItemPointerData cdb_fake_ctid;
 	int64 total_row;
@@ -119,6 +143,31 @@ typedef struct AOCSScanDescData
 
 	AppendOnlyVisimap visibilityMap;
 
+	/*
+	 * Conditions of the scan to check the zone maps in the block directory
+	 * against, and the ranges of rows of the current segment file that they
+	 * rule out. See aocs_setzonemapkeys.
+	 */
+	AppendOnlyZoneMapKey *zoneMapKeys;
+	int numZoneMapKeys;
+	int64 *skipRanges;
+	int numSkipRanges;
+	int nextSkipRange;
+	int64 zoneMapBlocksSkipped;	/* column blocks not decompressed */
+
+	/*
+	 * The qual of the scan, when the scan checks it itself on the columns in
+	 * qualProj before it reads the other projected columns. See
+	 * aocs_setqual. lateMaterialize tells whether that is done for the
+	 * current segment file.
+	 */
+	List *qual;
+	struct ExprContext *econtext;
+	bool *qualProj;
+	bool lateMaterialize;
+	int64 lateMatRows;			/* rows the qual was checked on */
+	int64 lateMatRowsPassed;	/* of those, rows whose other columns were read */
+
 }	AOCSScanDescData;
 
 typedef AOCSScanDescData *AOCSScanDesc;
@@ -203,6 +252,8 @@ extern AOCSScanDesc aocs_beginrangescan(Relation relation, Snapshot snapshot,
 	TupleDesc relationTupleDesc, bool *proj);
 
 extern void aocs_rescan(AOCSScanDesc scan);
+extern void aocs_setzonemapkeys(AOCSScanDesc scan, AppendOnlyZoneMapKey *keys, int nkeys);
+extern void aocs_setqual(AOCSScanDesc scan, List *qual, struct ExprContext *econtext, bool *qualProj);
 extern void aocs_endscan(AOCSScanDesc scan);
 
 extern void aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot);
@@ -103,6 +103,13 @@ typedef struct AppendOnlyInsertDescData
 	/* The block directory for the appendonly relation. */
 	AppendOnlyBlockDirectory blockDirectory;
 
+	/*
+	 * Space to extract the columns of a tuple that have zone maps in the
+	 * block directory, or NULL if none do.
+	 */
+	Datum			*zoneMapValues;
+	bool			*zoneMapNulls;
+
 	bool update_mode;
 } AppendOnlyInsertDescData;
 
@@ -212,6 +219,18 @@ typedef struct AppendOnlyScanDescData
 	 */ 
 	AppendOnlyVisimap visibilityMap;
 
+	/*
+	 * Conditions of the scan to check the zone maps in the block directory
+	 * against, and the ranges of rows of the current segment file that they
+	 * rule out. See appendonly_setzonemapkeys.
+	 */
+	AppendOnlyZoneMapKey *zoneMapKeys;
+	int			numZoneMapKeys;
+	int64		*skipRanges;
+	int			numSkipRanges;
+	int			nextSkipRange;
+	int64		zoneMapBlocksSkipped;	/* blocks not decompressed */
+
 }	AppendOnlyScanDescData;
 
 typedef AppendOnlyScanDescData *AppendOnlyScanDesc;
@@ -327,6 +346,8 @@ extern AppendOnlyScanDesc appendonly_beginrangescan(Relation relation,
 		int *segfile_no_arr, int segfile_count,
 		int nkeys, ScanKey keys);
 extern void appendonly_rescan(AppendOnlyScanDesc scan, ScanKey key);
+extern void appendonly_setzonemapkeys(AppendOnlyScanDesc scan,
+									  AppendOnlyZoneMapKey *keys, int nkeys);
 extern void appendonly_endscan(AppendOnlyScanDesc scan);
 extern MemTuple appendonly_getnext(AppendOnlyScanDesc scan, 
 									ScanDirection direction,
@@ -17,9 +17,11 @@
 #include "access/aocssegfiles.h"
 #include "access/appendonlytid.h"
 #include "access/skey.h"
+#include "nodes/pg_list.h"
 
 extern int gp_blockdirectory_entry_min_range;
 extern int gp_blockdirectory_minipage_size;
+extern bool gp_blockdirectory_zone_maps;
 
 typedef struct AppendOnlyBlockDirectoryEntry
 {
@@ -61,6 +63,36 @@ typedef struct Minipage
 	MinipageEntry entry[1];
 } Minipage;
 
+/*
+ * Minipage versions. A minipage of version MINIPAGE_VERSION_ZONEMAP has,
+ * after its entries, a uint32 number of zone maps per entry, followed by
+ * that many MinipageZoneMaps for every entry.
+ */
+#define MINIPAGE_VERSION_ORIGINAL	0
+#define MINIPAGE_VERSION_ZONEMAP	1
+
+/*
+ * The zone map of a column for a minipage entry: the smallest and the
+ * largest value of the column in the rows the entry covers. Only columns
+ * of types whose values order like int64s have zone maps.
+ */
+typedef struct MinipageZoneMap
+{
+	int64 min;
+	int64 max;
+	int32 attnum;
+	int32 flags;
+} MinipageZoneMap;
+
+#define ZONEMAP_VALID		0x01	/* min and max cover all rows of the entry */
+#define ZONEMAP_HAS_VALUES	0x02	/* some rows are not NULL */
+
+/*
+ * Most zone maps kept for a row-oriented table. Column-oriented tables
+ * keep one for every column that can have one.
+ */
+#define MAX_ZONEMAP_ATTRS 4
+
 /*
  * Define the relevant info for a minipage for each
  * column group.
@@ -70,6 +102,19 @@ typedef struct MinipagePerColumnGroup
 	Minipage *minipage;
 	uint32 numMinipageEntries;
 	ItemPointerData tupleTid;
+
+	/*
+	 * Zone maps, kept only when inserting. zoneMapAttnums are the columns
+	 * of the group that have them, zoneMaps holds numZoneMapAttrs of them
+	 * for each entry of the minipage if hasZoneMaps, and pendingZoneMaps
+	 * those of the pendingRowCount rows added since the last entry.
+	 */
+	int numZoneMapAttrs;
+	AttrNumber *zoneMapAttnums;
+	bool hasZoneMaps;
+	MinipageZoneMap *zoneMaps;
+	MinipageZoneMap *pendingZoneMaps;
+	int64 pendingRowCount;
 } MinipagePerColumnGroup;
 
 /*
@@ -79,6 +124,24 @@ typedef struct MinipagePerColumnGroup
 #define NUM_MINIPAGE_ENTRIES (((MaxHeapTupleSize)/8 - sizeof(HeapTupleHeaderData) - 64 * 3)\
 							  / sizeof(MinipageEntry))
 
+/*
+ * A minipage with zone maps may take up to twice the space of one with
+ * NUM_MINIPAGE_ENTRIES entries, and holds fewer entries if need be.
+ */
+#define MINIPAGE_MAX_SIZE (2 * (offsetof(Minipage, entry) + \
+								NUM_MINIPAGE_ENTRIES * sizeof(MinipageEntry)))
+
+/*
+ * A condition "column <strategy> value" of a scan that zone maps are
+ * checked against.
+ */
+typedef struct AppendOnlyZoneMapKey
+{
+	AttrNumber attnum;
+	StrategyNumber strategy;
+	int64 value;
+} AppendOnlyZoneMapKey;
+
 /*
  * Define a structure for the append-only relation block directory.
  */
@@ -221,4 +284,27 @@ extern void AppendOnlyBlockDirectory_DeleteSegmentFile(
 		Snapshot snapshot,
 		int segno,
 		int columnGroupNo);
+extern void AppendOnlyBlockDirectory_AddZoneMapValues(
+	AppendOnlyBlockDirectory *blockDirectory,
+	int columnGroupNo,
+	Datum *values,
+	bool *nulls);
+extern AppendOnlyZoneMapKey *AppendOnlyBlockDirectory_ZoneMapKeys(
+	Relation aoRel,
+	Index scanrelid,
+	List *qual,
+	int *nkeys);
+extern int AppendOnlyBlockDirectory_ZoneMapSkipRanges(
+	Relation aoRel,
+	Snapshot appendOnlyMetaDataSnapshot,
+	FileSegInfo *segmentFileInfo,
+	bool isAOCol,
+	AppendOnlyZoneMapKey *keys,
+	int nkeys,
+	int64 **ranges);
+extern int64 AppendOnlyBlockDirectory_SkipRangeEnd(
+	int64 *ranges,
+	int numRanges,
+	int *nextRange,
+	int64 rowNum);
 #endif
@@ -13,6 +13,7 @@
 #include "cdb/cdbappendonlystorage.h"
 #include "cdb/cdbappendonlystoragelayer.h"
 #include "cdb/cdbbufferedread.h"
+#include "portability/instr_time.h"
 #include "utils/palloc.h"
 #include "storage/fd.h"
 
@@ -180,6 +181,12 @@ typedef struct AppendOnlyStorageRead
 	PGFunction       *compression_functions; /* For AO or CO compression funciton pointers.  */
 			/* The array index corresponds to COMP_FUNC_*   */
 
+	/* Decompression statistics, kept with debug_appendonly_print_decompress_stats */
+	int64		decompressBlockCount;
+	int64		decompressCompressedBytes;
+	int64		decompressUncompressedBytes;
+	instr_time	decompressTime;
+
 
 
 } AppendOnlyStorageRead;
@@ -12,6 +12,7 @@
 #define CDBDISP_H
 
 #include "lib/stringinfo.h" /* StringInfo */
+#include "portability/instr_time.h"
 
 #include "cdb/cdbtm.h"
 
@@ -45,6 +46,16 @@ typedef struct CdbDispatcherState
 	struct CdbDispatchResults *primaryResults;
 	void *dispatchParams;
 	MemoryContext dispatchStateContext;
+
+	/*
+	 * Time spent in the phases of dispatching plans with this state, shown
+	 * by EXPLAIN ANALYZE: serializing the plan and building the message,
+	 * starting the sends to all gangs, and waiting until the message has
+	 * been written to every QE.
+	 */
+	instr_time	buildTime;
+	instr_time	sendTime;
+	instr_time	sendWaitTime;
 } CdbDispatcherState;
 
 typedef struct DispatcherInternalFuncs
@@ -55,6 +66,7 @@ typedef struct DispatcherInternalFuncs
 	void (*checkResults)(struct CdbDispatcherState *ds, DispatchWaitMode waitMode);
 	void (*dispatchToGang)(struct CdbDispatcherState *ds, struct Gang *gp,
 			int sliceIndex, CdbDispatchDirectDesc *direct);
+	void (*waitDispatchFinish)(struct CdbDispatcherState *ds);
 }DispatcherInternalFuncs;
 
 #define DISPATCH_WAIT_TIMEOUT_SEC 2
@@ -95,6 +107,17 @@ cdbdisp_dispatchToGang(struct CdbDispatcherState *ds,
 					   int sliceIndex,
 					   CdbDispatchDirectDesc *direct);
 
+/*
+ * cdbdisp_waitDispatchFinish:
+ *
+ * Block until the command started by cdbdisp_dispatchToGang() has been
+ * written to all QEs, without waiting for them to execute it.  A dispatcher
+ * that sends over non-blocking connections may return from
+ * cdbdisp_dispatchToGang() with part of the command still unsent.
+ */
+void
+cdbdisp_waitDispatchFinish(struct CdbDispatcherState *ds);
+
 /*
  * CdbCheckDispatchResult:
  *
@@ -430,6 +430,16 @@ typedef struct MotionNodeEntry
 	bool            moreNetWork;
 	bool            stopped;
 
+	/*
+	 * Should a sending motion node pack narrow tuples into TC_BATCH chunks?
+	 * If so, these are the chunks being filled: one per target route, and
+	 * one for broadcasts.
+	 */
+	bool            batch_tuples;
+	TupleBatch     *send_batches;
+	int             num_send_batches;
+	TupleBatch      broadcast_batch;
+
 	/*
 	 * PER-MOTION-NODE STATISTICS
 	 */
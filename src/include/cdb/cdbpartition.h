@@ -37,6 +37,15 @@ typedef struct PartitionRangeState
 	FmgrInfo *lefuncs_inverse; /* comparator partRule <= expr */
 	int last_rule; /* cache offset to the last rule and test if it matches */
 	PartitionRule **rules;
+
+	/*
+	 * Inclusive bounds of the rules, for a single-column key of an
+	 * integer-like type, so that rows are routed without calling the
+	 * comparators. nbounds is 0 if the rules weren't compiled.
+	 */
+	int nbounds;
+	int64 *lobounds;
+	int64 *hibounds;
 } PartitionRangeState;
 
 /* likewise, for list */
@@ -44,6 +53,13 @@ typedef struct PartitionListState
 {
 	FmgrInfo *eqfuncs;
 	bool *eqinit;
+
+	/*
+	 * The rule of each value, for a single-column key of an integer-like
+	 * type. valueHash is NULL if the rules weren't compiled.
+	 */
+	HTAB *valueHash;
+	PartitionRule *nullRule;
 } PartitionListState;
 
 /* likewise, for hash */
@@ -325,6 +325,15 @@ extern int gp_external_max_segs;
  */
 extern int gp_command_count;
 
+/*
+ * gp_seqserver_max_prefetch
+ *
+ * Most values of one sequence that a QE asks the sequence server for at
+ * once.  A QE asks for one value at the start of each command, and for
+ * twice as many as the last time whenever they run out within it.
+ */
+extern int gp_seqserver_max_prefetch;
+
 /*
  * gp_safefswritesize
  *
@@ -411,7 +420,7 @@ extern int	gp_snapshotadd_timeout; /* GUC var - timeout specifier for snapshot-c
 extern int	gp_fts_probe_retries; /* GUC var - specifies probe number of retries for FTS */
 extern int	gp_fts_probe_timeout; /* GUC var - specifies probe timeout for FTS */
 extern int	gp_fts_probe_interval; /* GUC var - specifies polling interval for FTS */
-extern int	gp_fts_probe_threadcount; /* GUC var - specifies number of threads to use for FTS probes */
+extern int	gp_fts_probe_threadcount; /* GUC var - deprecated, FTS probes no longer use threads */
 extern bool	gp_fts_transition_parallel; /* GUC var - controls parallel segment transition for FTS */
 
 extern int gp_gang_creation_retry_count; /* How many retries ? */
@@ -514,6 +523,14 @@ extern bool gp_interconnect_aggressive_retry; /* fast-track app-level retry */
  */
 extern bool gp_interconnect_full_crc;
 
+/*
+ * Parameter gp_interconnect_batch_tuples
+ *
+ * Pack narrow tuples sent to the same receiver into one tuple-chunk.
+ * Gather motions never batch, so a Limit above them is not held up.
+ */
+extern bool gp_interconnect_batch_tuples;
+
 /*
  * Parameter gp_interconnect_elide_setup
  *
@@ -597,6 +614,9 @@ gpvars_verbosity_to_string(GpVars_Verbosity verbosity);
 /* Enable single-slice single-row inserts. */
 extern bool gp_enable_fast_sri;
 
+/* Send COPY rows to segments in chunks, unparsed for random tables. */
+extern bool gp_copy_dispatch_chunks;
+
 /* Enable single-mirror pair dispatch. */
 extern bool gp_enable_direct_dispatch;
 
@@ -898,6 +918,18 @@ extern bool gp_enable_sort_distinct;
 extern bool gp_enable_mk_sort;
 extern bool gp_enable_motion_mk_sort;
 
+/*
+ * Number of threads that may sort the in-memory entries of one MK sort,
+ * 0 or 1 to sort on the backend alone.
+ */
+extern int gp_mk_sort_parallel_workers;
+
+/*
+ * Compare keys of fixed width types by a precomputed word that orders like
+ * the key, instead of by calling the comparison function.
+ */
+extern bool gp_mk_sort_normalized_keys;
+
 #ifdef USE_ASSERT_CHECKING
 extern bool gp_mk_sort_check;
 #endif
@@ -982,6 +1014,12 @@ extern int gp_hashagg_spillbatch_max;
 /* Hashjoin use bloom filter */
 extern int gp_hashjoin_bloomfilter;
 
+/*
+ * Hashjoin pushes a Bloom filter on its inner keys to the outer scan, when
+ * that scan is right below the join in the same slice
+ */
+extern bool gp_hashjoin_local_scan_filter;
+
 /* Get statistics for partitioned parent from a child */
 extern bool 	gp_statistics_pullup_from_child_partition;
 
@@ -993,6 +1031,9 @@ extern int 		gp_statistics_blocks_target;
 extern double	gp_statistics_ndistinct_scaling_ratio_threshold;
 extern double	gp_statistics_sampling_threshold;
 
+/* Estimate n_distinct from HyperLogLog sketches built on the segments */
+extern bool		gp_statistics_use_hll;
+
 /* Analyze tools */
 extern int gp_motion_slice_noop;
 #ifdef ENABLE_LTRACE
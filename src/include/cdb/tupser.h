@@ -79,6 +79,47 @@ typedef struct SerTupInfo
 	bool	   *nulls;
 }	SerTupInfo;
 
+/*
+ * Narrow MemTuples bound for the same route are packed together into a
+ * single TC_BATCH chunk, instead of one TC_WHOLE chunk each.  The chunk data
+ * starts with a TupleBatchHeader, and every tuple follows as a
+ * TupleBatchEntry and the bytes that differ from the tuple before it:
+ *
+ *	  Offset	  Description						Size
+ *		0	 Number of tuples					  2 bytes
+ *		2	 Unused								  2 bytes
+ *		4	 Tuple 1 length						  2 bytes
+ *		6	 Bytes shared with previous tuple	  2 bytes
+ *		8	 Rest of tuple 1					  length - shared bytes
+ *		...
+ *
+ * Tuples with a leading run of equal columns, or repeated tuples, thus cost
+ * little more than the entry header.  The entries are not aligned; the
+ * receiver copies every tuple out into its own storage anyway.
+ */
+typedef struct TupleBatchHeader
+{
+	uint16		ntuples;
+	uint16		unused;
+} TupleBatchHeader;
+
+typedef struct TupleBatchEntry
+{
+	uint16		len;			/* length of the tuple */
+	uint16		shared;			/* leading bytes equal to previous tuple */
+} TupleBatchEntry;
+
+/* Larger tuples are sent one per chunk, as before */
+#define TUPLE_BATCH_MAX_TUPLE_SIZE 1024
+
+/* A TC_BATCH chunk being filled for one route. */
+typedef struct TupleBatch
+{
+	TupleChunkListItem chunk;	/* NULL if no tuples are pending */
+	char	   *prev;			/* copy of the last tuple added */
+	uint32		prevlen;
+} TupleBatch;
+
 /*
  * forward declaration to avoid #including cdbmotion.h here, which would create a circular
  * dependency
@@ -99,6 +140,15 @@ extern void SerializeTupleIntoChunks(HeapTuple tuple, SerTupInfo *pSerInfo, Tupl
 /* Convert a HeapTuple into chunks directly in a set of transport buffers */
 extern int SerializeTupleDirect(HeapTuple tuple, SerTupInfo *pSerInfo, struct directTransportBuffer *b);
 
+/* Can this tuple be sent in a TC_BATCH chunk? */
+extern bool TupleIsBatchable(HeapTuple tuple);
+
+/* Add a tuple to a TC_BATCH chunk, returns the bytes added or 0 if full */
+extern int SerializeTupleIntoBatch(HeapTuple tuple, SerTupInfo *pSerInfo, TupleBatch *batch);
+
+/* Convert a TC_BATCH chunk into HeapTuples */
+extern HeapTuple *CvtBatchChunkToHeapTups(TupleChunkListItem tcItem, int *ntuples);
+
 /* Deserialize a HeapTuple's data from a byte-array. */
 extern HeapTuple DeserializeTuple(SerTupInfo * pSerInfo, StringInfo serialTup);
 
@@ -31,6 +31,10 @@ struct ProjectionInfo;
 struct ExprContext;
 struct ExprState;
 struct PlanState;
+struct AggState;
+struct AggStatePerGroupData;
+struct MemoryManagerContainer;
+struct MemTupleData;
 
 /*
  * Enum used to mimic ExprDoneCond in ExecEvalExpr function pointer.
@@ -42,6 +46,9 @@ typedef enum tmp_enum{
 typedef void (*ExecVariableListFn) (struct ProjectionInfo *projInfo, Datum *values, bool *isnull);
 typedef Datum (*ExecEvalExprFn) (struct ExprState *expression, struct ExprContext *econtext, bool *isNull, /*ExprDoneCond*/ tmp_enum *isDone);
 typedef Datum (*SlotGetAttrFn) (struct TupleTableSlot *slot, int attnum, bool *isnull);
+typedef void (*AdvanceAggregatesFn) (struct AggState *aggstate, struct AggStatePerGroupData *pergroup, struct MemoryManagerContainer *mem_manager);
+typedef uint32 (*CalcHashValueFn) (struct AggState *aggstate, struct TupleTableSlot *inputslot);
+typedef bool (*AggHashKeysMatchFn) (struct AggState *aggstate, struct TupleTableSlot *inputslot, struct MemTupleData *entry_tuple);
 
 #ifndef USE_CODEGEN
 
@@ -55,6 +62,7 @@ typedef Datum (*SlotGetAttrFn) (struct TupleTableSlot *slot, int attnum, bool *i
 #define CodeGeneratorManagerDestroy(manager);
 #define GetActiveCodeGeneratorManager() NULL
 #define SetActiveCodeGeneratorManager(manager);
+#define AtAbort_Codegen()
 
 #define START_CODE_GENERATOR_MANAGER(newManager)
 #define END_CODE_GENERATOR_MANAGER()
@@ -62,6 +70,12 @@ typedef Datum (*SlotGetAttrFn) (struct TupleTableSlot *slot, int attnum, bool *i
 #define init_codegen()
 #define call_ExecVariableList(projInfo, values, isnull) ExecVariableList(projInfo, values, isnull)
 #define enroll_ExecVariableList_codegen(regular_func, ptr_to_chosen_func, proj_info, slot)
+#define call_AdvanceAggregates(aggstate, pergroup, mem_manager) advance_aggregates(aggstate, pergroup, mem_manager)
+#define enroll_AdvanceAggregates_codegen(regular_func, ptr_to_chosen_func, aggstate)
+#define call_CalcHashValue(aggstate, inputslot) calc_hash_value(aggstate, inputslot)
+#define enroll_CalcHashValue_codegen(regular_func, ptr_to_chosen_func, aggstate)
+#define call_AggHashKeysMatch(aggstate, inputslot, entry_tuple) agg_hash_keys_match(aggstate, inputslot, entry_tuple)
+#define enroll_AggHashKeysMatch_codegen(regular_func, ptr_to_chosen_func, aggstate)
 
 #else
 
@@ -157,6 +171,13 @@ GetActiveCodeGeneratorManager();
 void
 SetActiveCodeGeneratorManager(void* manager);
 
+/*
+ * Stop pending asynchronous compilations from swapping in generated
+ * functions, before an aborting (sub)transaction frees the executor state
+ */
+void
+AtAbort_Codegen();
+
 /*
  * returns the pointer to the ExecVariableList
  */
@@ -176,6 +197,30 @@ ExecEvalExprCodegenEnroll(ExecEvalExprFn regular_func_ptr,
                           struct ExprContext *econtext,
                           struct PlanState* plan_state);
 
+/*
+ * Enroll and returns the pointer to AdvanceAggregatesGenerator
+ */
+void*
+AdvanceAggregatesCodegenEnroll(AdvanceAggregatesFn regular_func_ptr,
+                               AdvanceAggregatesFn* ptr_to_regular_func_ptr,
+                               struct AggState *aggstate);
+
+/*
+ * Enroll and returns the pointer to CalcHashValueGenerator
+ */
+void*
+CalcHashValueCodegenEnroll(CalcHashValueFn regular_func_ptr,
+                           CalcHashValueFn* ptr_to_regular_func_ptr,
+                           struct AggState *aggstate);
+
+/*
+ * Enroll and returns the pointer to AggHashKeysMatchGenerator
+ */
+void*
+AggHashKeysMatchCodegenEnroll(AggHashKeysMatchFn regular_func_ptr,
+                              AggHashKeysMatchFn* ptr_to_regular_func_ptr,
+                              struct AggState *aggstate);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -225,6 +270,27 @@ ExecEvalExprCodegenEnroll(ExecEvalExprFn regular_func_ptr,
  */
 #define call_ExecVariableList(projInfo, values, isnull) \
 		projInfo->ExecVariableList_gen_info.ExecVariableList_fn(projInfo, values, isnull)
+
+/*
+ * Call advance_aggregates using function pointer AdvanceAggregates_fn.
+ * Function pointer may point to regular version or generated function
+ */
+#define call_AdvanceAggregates(aggstate, pergroup, mem_manager) \
+		aggstate->AdvanceAggregates_gen_info.AdvanceAggregates_fn(aggstate, pergroup, mem_manager)
+
+/*
+ * Call calc_hash_value using function pointer CalcHashValue_fn.
+ * Function pointer may point to regular version or generated function
+ */
+#define call_CalcHashValue(aggstate, inputslot) \
+		aggstate->CalcHashValue_gen_info.CalcHashValue_fn(aggstate, inputslot)
+
+/*
+ * Call agg_hash_keys_match using function pointer AggHashKeysMatch_fn.
+ * Function pointer may point to regular version or generated function
+ */
+#define call_AggHashKeysMatch(aggstate, inputslot, entry_tuple) \
+		aggstate->AggHashKeysMatch_gen_info.AggHashKeysMatch_fn(aggstate, inputslot, entry_tuple)
 /*
  * Enrollment macros
  * The enrollment process also ensures that the generated function pointer
@@ -240,6 +306,21 @@ ExecEvalExprCodegenEnroll(ExecEvalExprFn regular_func_ptr,
         (ExecEvalExprFn)regular_func, (ExecEvalExprFn*)ptr_to_regular_func_ptr, exprstate, econtext, plan_state); \
         Assert(exprstate->evalfunc == regular_func); \
 
+#define enroll_AdvanceAggregates_codegen(regular_func, ptr_to_regular_func_ptr, aggstate) \
+		aggstate->AdvanceAggregates_gen_info.code_generator = AdvanceAggregatesCodegenEnroll( \
+				regular_func, ptr_to_regular_func_ptr, aggstate); \
+		Assert(aggstate->AdvanceAggregates_gen_info.AdvanceAggregates_fn == regular_func); \
+
+#define enroll_CalcHashValue_codegen(regular_func, ptr_to_regular_func_ptr, aggstate) \
+		aggstate->CalcHashValue_gen_info.code_generator = CalcHashValueCodegenEnroll( \
+				regular_func, ptr_to_regular_func_ptr, aggstate); \
+		Assert(aggstate->CalcHashValue_gen_info.CalcHashValue_fn == regular_func); \
+
+#define enroll_AggHashKeysMatch_codegen(regular_func, ptr_to_regular_func_ptr, aggstate) \
+		aggstate->AggHashKeysMatch_gen_info.code_generator = AggHashKeysMatchCodegenEnroll( \
+				regular_func, ptr_to_regular_func_ptr, aggstate); \
+		Assert(aggstate->AggHashKeysMatch_gen_info.AggHashKeysMatch_fn == regular_func); \
+
 #endif //USE_CODEGEN
 
 #endif  // CODEGEN_WRAPPER_H_
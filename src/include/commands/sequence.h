@@ -116,10 +116,13 @@ cdb_sequence_nextval_server(Oid    tablespaceid,
                             Oid    dbid,
                             Oid    relid,
                             bool   istemp,
+                            int64  nvalues,
                             int64 *plast,
                             int64 *pcached,
                             int64 *pincrement,
                             bool  *poverflow);
 
+extern void cdb_sequence_proxy_stats(int64 *requests, int64 *values);
+
 
 #endif   /* SEQUENCE_H */
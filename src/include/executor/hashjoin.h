@@ -105,6 +105,10 @@ typedef struct HashJoinTableStats
     int                     nonemptybatches;    /* num of nontrivial batches */
     Size                    workmem_max;        /* work_mem high water mark */
     CdbExplain_Agg          chainlength;        /* hash chain length stats */
+
+    /* Outer rows checked and removed by a runtime filter that is gone */
+    uint64                  filterchecked;
+    uint64                  filterremoved;
 } HashJoinTableStats;
 
 
@@ -141,6 +145,42 @@ typedef struct HashJoinBatchData
 } HashJoinBatchData;
 
 
+/*
+ * HashJoinRuntimeFilter
+ *
+ * Bloom filter on the hash values of the inner tuples, built while the
+ * hash table is built and then attached to the scan below the outer side of
+ * the join, so that the scan drops the rows that cannot find a match before
+ * they travel up the plan.  The scan must be in the join's slice
+ * (gp_hashjoin_local_scan_filter).
+ */
+typedef struct HashJoinRuntimeFilter
+{
+	uint64	   *bits;			/* the filter, nbits = mask + 1 bits */
+	uint32		mask;
+	uint32		nbitsset;		/* number of bits set so far */
+	bool		useful;			/* false once too many bits are set */
+
+	/* What the scan needs to compute the hash value of its tuples */
+	List	   *hashkeys;		/* outer hash keys (list of ExprState) */
+	FmgrInfo   *hashfunctions;	/* outer hash functions */
+	bool	   *hashStrict;
+
+	struct ScanState *scan;		/* scan the filter is attached to, or NULL */
+
+	/*
+	 * Hash value of the last tuple that passed the filter.  The join takes it
+	 * instead of computing the hash value of the tuple again.
+	 */
+	uint32		passedhashvalue;
+	bool		passedhashvalid;
+
+	/* Statistics for EXPLAIN ANALYZE */
+	uint64		nchecked;		/* outer rows checked */
+	uint64		nremoved;		/* outer rows that cannot match */
+} HashJoinRuntimeFilter;
+
+
 /*
  * HashJoinTableData
  */
@@ -152,6 +192,7 @@ typedef struct HashJoinTableData
 	/* buckets[i] is head of list of tuples in i'th in-memory bucket */
 	struct HashJoinTupleData **buckets;
 	uint64     				  *bloom; /* bloom[i] is bloomfilter for buckets[i] */
+	HashJoinRuntimeFilter	  *runtimeFilter;	/* CDB: filter for outer scan, or NULL */
 	/* buckets array is per-batch storage, as are all the tuples */
 
 	int			nbatch;			/* number of batches */
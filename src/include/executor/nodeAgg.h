@@ -176,6 +176,11 @@ initialize_aggregates(AggState *aggstate,
 extern void 
 advance_aggregates(AggState *aggstate, AggStatePerGroup pergroup,
 				   MemoryManagerContainer *mem_manager);
+extern void
+advance_aggregate_value(AggState *aggstate, int aggno,
+						AggStatePerGroup pergroupstate,
+						Datum value, bool isnull,
+						MemoryManagerContainer *mem_manager);
 
 extern List *find_hash_columns(AggState *aggstate);
 
@@ -48,6 +48,11 @@ extern void ExecHashTableReset(HashState *hashState, HashJoinTable hashtable);
 extern void ExecHashTableExplainInit(HashState *hashState, HashJoinState *hjstate,
                                      HashJoinTable  hashtable);
 extern void ExecHashTableExplainBatchEnd(HashState *hashState, HashJoinTable hashtable);
+extern void ExecHashRuntimeFilterCreate(HashJoinTable hashtable, List *outerHashKeys,
+							double innerRows);
+extern bool ExecHashRuntimeFilterCheck(HashJoinRuntimeFilter *filter,
+						   ExprContext *econtext,
+						   struct TupleTableSlot *slot);
 
 enum 
 {
@@ -614,6 +614,10 @@ namespace gpdb {
 	// table has been changed?)
 	bool FMDCacheNeedsReset(void);
 
+	// relations changed since last call, whose entries must be evicted
+	// from the metadata cache
+	List *PlMDCacheInvalidatedRels(void);
+
 } //namespace gpdb
 
 #define ForEach(cell, l)	\
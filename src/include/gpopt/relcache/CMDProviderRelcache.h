@@ -50,6 +50,16 @@ namespace gpmd
 			// memory pool
 			IMemoryPool *m_pmp;
 
+			// number of objects translated from the relcache by this backend,
+			// i.e. metadata cache misses
+			static
+			ULLONG m_ullObjects;
+
+			// number of relation lookups of this backend answered without
+			// translating the relation, i.e. metadata cache hits
+			static
+			ULLONG m_ullRelationHits;
+
 			// private copy ctor
 			CMDProviderRelcache(const CMDProviderRelcache&);
 
@@ -66,6 +76,34 @@ namespace gpmd
 			virtual
 			CWStringBase *PstrObject(IMemoryPool *pmp, CMDAccessor *pmda, IMDId *pmdid) const;
 
+			// number of objects translated from the relcache by this backend
+			static
+			ULLONG UllObjects()
+			{
+				return m_ullObjects;
+			}
+
+			// count a relation lookup as a hit if no object was translated
+			// since UllObjects() returned ullObjectsBefore
+			static
+			void RecordRelationLookup
+				(
+				ULLONG ullObjectsBefore
+				)
+			{
+				if (m_ullObjects == ullObjectsBefore)
+				{
+					m_ullRelationHits++;
+				}
+			}
+
+			// number of relation lookups answered from the metadata cache
+			static
+			ULLONG UllRelationHits()
+			{
+				return m_ullRelationHits;
+			}
+
 			// return the mdid for the requested type
 			virtual
 			IMDId *Pmdid
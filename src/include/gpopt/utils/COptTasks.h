@@ -247,6 +247,18 @@ class COptTasks
 		static
 		void PrintMissingStatsWarning(IMemoryPool *pmp, CMDAccessor *pmda, DrgPmdid *pdrgmdidCol, HMMDIdMDId *phmmdidRel);
 
+		// number of metadata cache entries evicted because their relation changed
+		static
+		ULLONG m_ullMDCacheEvictions;
+
+		// number of times the whole metadata cache was reset
+		static
+		ULLONG m_ullMDCacheResets;
+
+		// evict the metadata cache entries of the given relations
+		static
+		void EvictMDCacheEntries(IMemoryPool *pmp, List *plRelOids);
+
 	public:
 
 		// convert Query->DXL->LExpr->Optimize->PExpr->DXL
@@ -305,6 +317,10 @@ class COptTasks
 		// the serialized representation of the result as DXL
 		static
 		char *SzOptimizeMinidumpFromFile(char *szFileName);
+
+		// counters of the metadata cache of this backend
+		static
+		void MDCacheStats(ULLONG *pullHits, ULLONG *pullMisses, ULLONG *pullEvictions, ULLONG *pullResets);
 };
 
 #endif // COptTasks_H
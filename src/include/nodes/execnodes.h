@@ -234,6 +234,30 @@ typedef struct ExecVariableListCodegenInfo
 	ExecVariableListFn ExecVariableList_fn;
 } ExecVariableListCodegenInfo;
 
+typedef struct AdvanceAggregatesCodegenInfo
+{
+	/* Pointer to store AdvanceAggregatesCodegen from Codegen */
+	void* code_generator;
+	/* Function pointer that points to either regular or generated advance_aggregates */
+	AdvanceAggregatesFn AdvanceAggregates_fn;
+} AdvanceAggregatesCodegenInfo;
+
+typedef struct CalcHashValueCodegenInfo
+{
+	/* Pointer to store CalcHashValueCodegen from Codegen */
+	void* code_generator;
+	/* Function pointer that points to either regular or generated calc_hash_value */
+	CalcHashValueFn CalcHashValue_fn;
+} CalcHashValueCodegenInfo;
+
+typedef struct AggHashKeysMatchCodegenInfo
+{
+	/* Pointer to store AggHashKeysMatchCodegen from Codegen */
+	void* code_generator;
+	/* Function pointer that points to either regular or generated agg_hash_keys_match */
+	AggHashKeysMatchFn AggHashKeysMatch_fn;
+} AggHashKeysMatchCodegenInfo;
+
 /* ----------------
  *		ProjectionInfo node information
  *
@@ -1645,6 +1669,28 @@ typedef struct ScanState
 
 	/* The type of the table that is being scanned */
 	TableType	tableType;
+
+	/* CDB: Bloom filter pushed down by a hash join above, or NULL */
+	struct HashJoinRuntimeFilter *ss_runtimeFilter;
+
+	/*
+	 * CDB: Blocks that the zone maps let the ended AO/AOCS scans of this node
+	 * skip, for EXPLAIN ANALYZE.
+	 */
+	int64		ss_zoneMapBlocksSkipped;
+
+	/*
+	 * CDB: Set by the access method when the tuple it returned has passed
+	 * the qual already, so that ExecScan does not check it again.
+	 */
+	bool		ss_qualChecked;
+
+	/*
+	 * CDB: Rows of the ended AOCS scans of this node whose qual was checked
+	 * before the other columns were read, and how many of them passed.
+	 */
+	int64		ss_lateMatRows;
+	int64		ss_lateMatRowsPassed;
 } ScanState;
 
 /*
@@ -2003,6 +2049,12 @@ typedef struct AOCSScanOpaqueData
 	bool	   *proj;
 	int			ncol;
 
+	/*
+	 * The columns that the qual needs, if the scan checks the qual before
+	 * reading the other columns.
+	 */
+	bool	   *qualProj;
+
 	struct AOCSScanDescData *scandesc;
 } AOCSScanOpaqueData;
 
@@ -2392,6 +2444,13 @@ typedef struct AggState
 	/* set if the operator created workfiles */
 	bool		workfiles_created;
 
+	/* advance_aggregates, possibly generated by codegen */
+	AdvanceAggregatesCodegenInfo AdvanceAggregates_gen_info;
+
+	/* calc_hash_value and agg_hash_keys_match, possibly generated by codegen */
+	CalcHashValueCodegenInfo CalcHashValue_gen_info;
+	AggHashKeysMatchCodegenInfo AggHashKeysMatch_gen_info;
+
 } AggState;
 
 
@@ -34,6 +34,7 @@ typedef struct NextValRequest
 	uint32_t    seq_oid;
 	uint32_t    isTemp;
 	uint32_t    session_id;
+	uint32_t    num_values;		/* values wanted, at least 1 */
 	uint32_t	endCookie;
 }	NextValRequest;
 
@@ -55,6 +56,7 @@ extern void
 sendSequenceRequest(int     sockfd, 
 					Relation seqrel,
                     int     session_id,
+                    int64   nvalues,
 					int64  *plast, 
                     int64  *pcached,
 			 		int64  *pincrement,
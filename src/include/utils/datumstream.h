@@ -85,6 +85,9 @@ typedef struct DatumStreamRead
 	int64		blockFileOffset;
 	int			blockRowCount;
 
+	/* Blocks that datumstreamread_skip_to_row passed over unread */
+	int64		blocksSkipped;
+
 	AppendOnlyStorageRead ao_read;
 
 	/*
@@ -219,6 +222,33 @@ datumstreamread_nth(DatumStreamRead * acc)
 	}
 }
 
+/*
+ * Advance to, and get, up to maxCount datums of the current block at once,
+ * leaving the stream positioned on the last one.  Returns the number of
+ * datums returned, or 0 when the next block needs to be read.
+ */
+inline static int
+datumstreamread_get_batch(DatumStreamRead * acc, Datum *values, bool *nulls, int maxCount)
+{
+	if (acc->largeObjectState == DatumStreamLargeObjectState_None)
+	{
+		/*
+		 * Small objects are handled by the DatumStreamBlockRead module.
+		 */
+		return DatumStreamBlockRead_GetBatch(&acc->blockRead, values, nulls, maxCount);
+	}
+	else
+	{
+		/*
+		 * A large object is the only datum of its block.
+		 */
+		if (datumstreamread_advancelarge(acc) == 0)
+			return 0;
+		datumstreamread_getlarge(acc, values, nulls);
+		return 1;
+	}
+}
+
 /* ------------------------------------------------------------------------------ */
 
 extern int datumstreamwrite_put(
@@ -279,6 +309,7 @@ extern int	datumstreamread_block(DatumStreamRead * ds);
 extern void datumstreamread_find(DatumStreamRead * datumStream,
 					 int32 rowNumInBlock);
 extern void datumstreamread_rewind_block(DatumStreamRead * datumStream);
+extern bool datumstreamread_skip_to_row(DatumStreamRead * acc, int64 rowNum);
 extern bool datumstreamread_find_block(DatumStreamRead * datumStream,
 						   DatumStreamFetchDesc datumStreamFetchDesc,
 						   int64 rowNum);
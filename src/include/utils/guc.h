@@ -140,6 +140,7 @@ extern bool Debug_appendonly_print_insert;
 extern bool Debug_appendonly_print_insert_tuple;
 extern bool Debug_appendonly_print_scan;
 extern bool Debug_appendonly_print_scan_tuple;
+extern bool Debug_appendonly_print_decompress_stats;
 extern bool Debug_appendonly_print_delete;
 extern bool Debug_appendonly_print_update;
 extern bool Debug_appendonly_print_update_tuple;
@@ -297,6 +298,9 @@ extern int gp_cancel_query_delay_time;
 extern bool gp_partitioning_dynamic_selection_log;
 extern int gp_max_partition_level;
 
+extern int gp_plan_cache_param_plans;
+extern double gp_plan_cache_replan_factor;
+
 extern bool gp_temporary_files_filespace_repair;
 extern bool gp_perfmon_print_packet_info;
 extern bool fts_diskio_check;
@@ -468,7 +472,9 @@ extern bool optimizer_array_constraints;
 extern bool init_codegen;
 extern bool codegen;
 extern bool codegen_validate_functions;
+extern bool codegen_async_compile;
 extern int codegen_varlen_tolerance;
+extern int codegen_module_cache_size;
 
 /**
  * Enable logging of DPE match in optimizer.
@@ -61,6 +61,12 @@ typedef struct CachedPlanSource
 	int			generation;		/* counter, starting at 1, for replans */
 	TupleDesc	resultDesc;		/* result type; NULL = doesn't return tuples */
 	struct CachedPlan *plan;	/* link to plan, or NULL if not valid */
+	List	   *param_plans;	/* GPDB: other plans made for other parameter
+								 * values, most recently used first */
+	int64		param_plan_hits;	/* GPDB: executions that re-used a plan
+									 * kept for their parameter values */
+	int64		param_plan_misses;	/* GPDB: executions that had to plan for
+									 * their parameter values */
 	MemoryContext context;		/* context containing this CachedPlanSource */
 	struct CachedPlan *orig_plan;		/* link to plan owning my context */
 } CachedPlanSource;
@@ -82,6 +88,8 @@ typedef struct CachedPlan
 								 * changes from this value */
 	int			refcount;		/* count of live references to this struct */
 	int			generation;		/* counter, starting at 1, for replans */
+	ParamListInfo boundParams;	/* GPDB: parameter values the plan was made
+								 * for, or NULL if it works for any values */
 	MemoryContext context;		/* context containing this CachedPlan */
 	/* These fields are used only in the not-fully-planned case: */
 	List	   *relationOids;	/* OIDs of relations the stmts depend on */
@@ -213,8 +213,16 @@ typedef enum MKLvType
     MKLV_TYPE_INT32, /* this level contains int32 values */
     MKLV_TYPE_CHAR,  /* this level contains char (blank padded) values */
     MKLV_TYPE_TEXT,  /* this level contains text values */
+    MKLV_TYPE_NORMKEY, /* this level contains normalized keys, see MKNormalizeKey */
 } MKLvType;
 
+/*
+ * Convert a non-null key to an unsigned word that orders like the key in
+ * ascending order.  Only used for fixed width types whose whole value fits
+ * in the word, so equal words mean equal keys.
+ */
+typedef uint64 (*MKNormalizeKey) (Datum d);
+
 typedef struct MKLvContext
 {
 	/* Is the type of datums in this level passed by value instead of reference */
@@ -226,6 +234,9 @@ typedef struct MKLvContext
     /* type of datums in this level, converted to our MKLvType enumeration */
     MKLvType lvtype;
 
+    /* for MKLV_TYPE_NORMKEY levels, the conversion of datums to normalized keys */
+    MKNormalizeKey normalize;
+
 	ScanKeyData	scanKey;
 
     int16 attno;
@@ -288,6 +299,12 @@ typedef struct MKContext {
 
 	/* Name of the index we're building, if any. Used for error messages. */
 	char	   *indexname;
+
+	/*
+	 * Set in the private copies of the context used by the threads of
+	 * mk_qsort_parallel, which must not check for interrupts.
+	 */
+	bool parallelWorker;
 } MKContext;
 
 /**
@@ -306,6 +323,7 @@ static inline void mk_prepare_array(MKEntry *a, int i, int j, int32 lv, struct M
     } while (++cur <= last);
 }
 
+extern Datum tupsort_normalize_datum(MKLvContext *lvctxt, Datum d);
 extern void tupsort_cpfr(MKEntry *dst, MKEntry *src, MKLvContext *ctxt);
 extern int tupsort_compare_datum(MKEntry *v1, MKEntry *v2, MKLvContext *ctxt, MKContext *mkContext);
 
@@ -323,6 +341,11 @@ static inline void mk_qsort(MKEntry* a, int n, MKContext *ctxt)
     mk_qsort_impl(a, 0, n-1, 0, true, ctxt, false);
 }
 
+/* MK quicksort on several threads, see tuplesort_mkparallel.c */
+extern bool mk_qsort_parallel_safe(MKContext *ctxt);
+extern int mk_qsort_parallel_workers(int n);
+extern void mk_qsort_parallel(MKEntry *a, int n, MKContext *ctxt, int nworkers, MKEntry *scratch);
+
 /* MK Heap stuff */
 typedef bool (*MKFlagPtrReader) (void *ctxt, MKEntry *e);
 typedef struct MKHeapReader
@@ -0,0 +1,53 @@
+--
+-- zstd and lz4 compresstypes, and rle_type compresslevels 5 to 8, which put
+-- lz4 or zstd on top of rle_type. Builds without libzstd or liblz4 reject the
+-- compresstypes (see ao_compress_zstd_lz4_1.out).
+--
+CREATE TABLE zstd_ao (a int, b text)
+  WITH (appendonly=true, compresstype=zstd, compresslevel=3) DISTRIBUTED BY (a);
+CREATE TABLE zstd_co (a int, b text)
+  WITH (appendonly=true, orientation=column, compresstype=zstd, compresslevel=19) DISTRIBUTED BY (a);
+CREATE TABLE lz4_ao (a int, b text)
+  WITH (appendonly=true, compresstype=lz4, compresslevel=1) DISTRIBUTED BY (a);
+CREATE TABLE lz4_co (a int, b text)
+  WITH (appendonly=true, orientation=column, compresstype=lz4) DISTRIBUTED BY (a);
+CREATE TABLE rle_zstd_lz4 (a int,
+  b int ENCODING (compresstype=rle_type, compresslevel=5),
+  c int ENCODING (compresstype=rle_type, compresslevel=6),
+  d text ENCODING (compresstype=rle_type, compresslevel=7),
+  e text ENCODING (compresstype=rle_type, compresslevel=8))
+  WITH (appendonly=true, orientation=column) DISTRIBUTED BY (a);
+
+INSERT INTO zstd_ao SELECT i, repeat('zstd' || (i % 100), 20) FROM generate_series(1, 10000) i;
+INSERT INTO zstd_co SELECT * FROM zstd_ao;
+INSERT INTO lz4_ao SELECT * FROM zstd_ao;
+INSERT INTO lz4_co SELECT * FROM zstd_ao;
+INSERT INTO rle_zstd_lz4 SELECT i, i / 100, i / 1000, 'rle' || (i / 100), b FROM zstd_ao;
+
+SELECT count(*), sum(a), sum(length(b)), count(DISTINCT b) FROM zstd_ao;
+SELECT count(*), sum(a), sum(length(b)), count(DISTINCT b) FROM zstd_co;
+SELECT count(*), sum(a), sum(length(b)), count(DISTINCT b) FROM lz4_ao;
+SELECT count(*), sum(a), sum(length(b)), count(DISTINCT b) FROM lz4_co;
+SELECT count(*), sum(b), sum(c), count(DISTINCT d), sum(length(e)) FROM rle_zstd_lz4;
+SELECT count(*) FROM zstd_co z JOIN lz4_co l USING (a, b);
+
+-- A statement that fails after compressing some blocks leaves the table as
+-- it was, and the compression contexts are released with the statement.
+INSERT INTO zstd_co SELECT i, repeat('x', 100) || (10 / (i - 5000)) FROM generate_series(1, 10000) i;
+INSERT INTO rle_zstd_lz4 SELECT i, i, i, 'x', 10 / (i - 5000) FROM generate_series(1, 10000) i;
+SELECT count(*) FROM zstd_co;
+SELECT count(*) FROM rle_zstd_lz4;
+
+-- Out of range compresslevels
+CREATE TABLE zstd_bad (a int)
+  WITH (appendonly=true, compresstype=zstd, compresslevel=20) DISTRIBUTED BY (a);
+CREATE TABLE lz4_bad (a int)
+  WITH (appendonly=true, compresstype=lz4, compresslevel=2) DISTRIBUTED BY (a);
+CREATE TABLE rle_bad (a int ENCODING (compresstype=rle_type, compresslevel=9))
+  WITH (appendonly=true, orientation=column) DISTRIBUTED BY (a);
+
+DROP TABLE zstd_ao;
+DROP TABLE zstd_co;
+DROP TABLE lz4_ao;
+DROP TABLE lz4_co;
+DROP TABLE rle_zstd_lz4;
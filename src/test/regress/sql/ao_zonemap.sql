@@ -0,0 +1,71 @@
+--
+-- Zone maps in the block directory of append-only tables
+-- (gp_blockdirectory_zone_maps)
+--
+CREATE TABLE ao_zonemap (id int, d date, payload text)
+WITH (appendonly=true) DISTRIBUTED BY (id);
+CREATE INDEX ao_zonemap_idx ON ao_zonemap (payload);
+INSERT INTO ao_zonemap SELECT i, date '2000-01-01' + i, repeat('x', 100)
+FROM generate_series(1, 50000) i;
+INSERT INTO ao_zonemap SELECT NULL, NULL, 'n' FROM generate_series(1, 10);
+
+CREATE TABLE aocs_zonemap (id int, d date, payload text)
+WITH (appendonly=true, orientation=column) DISTRIBUTED BY (id);
+CREATE INDEX aocs_zonemap_idx ON aocs_zonemap (payload);
+INSERT INTO aocs_zonemap SELECT * FROM ao_zonemap;
+
+-- Zone maps are only kept while inserting with the setting on
+SET gp_blockdirectory_zone_maps = off;
+CREATE TABLE ao_nozonemap (id int, d date, payload text)
+WITH (appendonly=true) DISTRIBUTED BY (id);
+CREATE INDEX ao_nozonemap_idx ON ao_nozonemap (payload);
+INSERT INTO ao_nozonemap SELECT * FROM ao_zonemap;
+RESET gp_blockdirectory_zone_maps;
+
+SELECT count(*), min(id), max(id) FROM ao_zonemap WHERE id BETWEEN 1000 AND 1999;
+SELECT count(*) FROM ao_zonemap WHERE id = 12345;
+SELECT count(*) FROM ao_zonemap WHERE 40000 < id;
+SELECT count(*) FROM ao_zonemap WHERE id < 100::bigint;
+SELECT count(*), min(id) FROM ao_zonemap WHERE d >= date '2000-01-01' + 49000;
+SELECT count(*) FROM ao_zonemap WHERE id < 10 OR payload = 'n';
+SELECT count(*) FROM ao_nozonemap WHERE id BETWEEN 1000 AND 1999;
+
+SELECT count(*), min(id), max(id) FROM aocs_zonemap WHERE id BETWEEN 1000 AND 1999;
+SELECT count(*) FROM aocs_zonemap WHERE id = 12345;
+SELECT count(*) FROM aocs_zonemap WHERE 40000 < id;
+SELECT count(*), min(id) FROM aocs_zonemap WHERE d >= date '2000-01-01' + 49000;
+SELECT sum(length(payload)) FROM aocs_zonemap WHERE id BETWEEN 20000 AND 20099;
+
+-- Did the scan of the query skip blocks by their zone maps?
+SELECT coalesce(m[1]::int8 > 0, false) AS skipped
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM ao_zonemap WHERE id BETWEEN 1000 AND 1999',
+                   '([0-9]+) blocks skipped by zone maps') m;
+SELECT coalesce(m[1]::int8 > 0, false) AS skipped
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM aocs_zonemap WHERE id BETWEEN 1000 AND 1999',
+                   '([0-9]+) blocks skipped by zone maps') m;
+SELECT coalesce(m[1]::int8 > 0, false) AS skipped
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM ao_nozonemap WHERE id BETWEEN 1000 AND 1999',
+                   '([0-9]+) blocks skipped by zone maps') m;
+
+DELETE FROM ao_zonemap WHERE id BETWEEN 1000 AND 1499;
+DELETE FROM aocs_zonemap WHERE id BETWEEN 1000 AND 1499;
+SELECT count(*) FROM ao_zonemap WHERE id BETWEEN 1000 AND 1999;
+SELECT count(*) FROM aocs_zonemap WHERE id BETWEEN 1000 AND 1999;
+
+-- The same results with the zone maps not used
+SET gp_blockdirectory_zone_maps = off;
+SELECT count(*) FROM ao_zonemap WHERE id BETWEEN 1000 AND 1999;
+SELECT count(*) FROM aocs_zonemap WHERE id BETWEEN 1000 AND 1999;
+SELECT count(*) FROM ao_zonemap WHERE 40000 < id;
+SELECT count(*) FROM aocs_zonemap WHERE 40000 < id;
+SELECT coalesce(m[1]::int8 > 0, false) AS skipped
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM ao_zonemap WHERE id BETWEEN 1000 AND 1999',
+                   '([0-9]+) blocks skipped by zone maps') m;
+SELECT coalesce(m[1]::int8 > 0, false) AS skipped
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM aocs_zonemap WHERE id BETWEEN 1000 AND 1999',
+                   '([0-9]+) blocks skipped by zone maps') m;
+RESET gp_blockdirectory_zone_maps;
+
+DROP TABLE ao_zonemap;
+DROP TABLE aocs_zonemap;
+DROP TABLE ao_nozonemap;
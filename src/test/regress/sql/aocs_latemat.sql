@@ -0,0 +1,40 @@
+--
+-- Late materialization in scans of append-only column-oriented tables
+-- (gp_aocs_late_materialization)
+--
+CREATE TABLE aocs_latemat (id int, grp int, note text, payload text)
+WITH (appendonly=true, orientation=column, blocksize=8192) DISTRIBUTED BY (id);
+INSERT INTO aocs_latemat SELECT i, i % 100,
+	CASE WHEN i % 3 = 0 THEN NULL ELSE 'n' END,
+	CASE WHEN i % 5000 = 0 THEN repeat('z', 40000) ELSE 'p' || i END
+FROM generate_series(1, 20000) i;
+
+SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE grp = 7;
+SELECT count(payload), sum(length(payload)) FROM aocs_latemat
+WHERE note IS NULL AND grp < 10;
+SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE grp = 0 AND id % 5000 = 0;
+SELECT id, length(payload) FROM aocs_latemat WHERE id IN (4999, 5000, 5001) ORDER BY id;
+SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE id BETWEEN 15000 AND 15010;
+SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE grp = 7 AND random() < 2;
+
+-- Did the scan of the query read the columns outside the qual for fewer
+-- rows than it checked the qual on?
+SELECT coalesce(m[1]::int8 < m[2]::int8, false) AS fewer_reads
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE grp = 7',
+                   '([0-9]+) of ([0-9]+) rows read the columns outside the qual') m;
+
+DELETE FROM aocs_latemat WHERE grp = 7 AND id < 10000;
+SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE grp = 7;
+
+-- The same results with all the columns read for every row
+SET gp_aocs_late_materialization = off;
+SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE grp = 7;
+SELECT count(payload), sum(length(payload)) FROM aocs_latemat
+WHERE note IS NULL AND grp < 10;
+SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE id BETWEEN 15000 AND 15010;
+SELECT coalesce(m[1]::int8 < m[2]::int8, false) AS fewer_reads
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*), sum(length(payload)) FROM aocs_latemat WHERE grp = 7',
+                   '([0-9]+) of ([0-9]+) rows read the columns outside the qual') m;
+RESET gp_aocs_late_materialization;
+
+DROP TABLE aocs_latemat;
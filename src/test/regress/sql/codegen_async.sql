@@ -0,0 +1,44 @@
+--
+-- Generated code compiled on the compiler thread (codegen_async_compile).
+-- A query that fails in the middle of its scan is aborted while the
+-- compilation may still be pending, and the compiler thread must not swap
+-- the generated functions into the freed executor state afterwards.
+--
+CREATE TABLE codegen_async (a int, b int) DISTRIBUTED BY (a);
+INSERT INTO codegen_async SELECT i, i % 10 FROM generate_series(1, 10000) i;
+
+SET codegen = on;
+SET codegen_async_compile = on;
+
+-- Division by zero on the row with a = 10000
+SELECT sum(a / (10000 - a)) FROM codegen_async WHERE b >= 0;
+SELECT sum(a / (10000 - a)) FROM codegen_async WHERE b >= 0;
+SELECT sum(a / (10000 - a)) FROM codegen_async WHERE b >= 0;
+
+-- The same, aborting subtransactions only
+CREATE FUNCTION codegen_async_errors(n int) RETURNS int AS $$
+DECLARE
+  errors int := 0;
+  s bigint;
+BEGIN
+  FOR i IN 1..n LOOP
+    BEGIN
+      SELECT sum(a / (10000 - a)) INTO s FROM codegen_async WHERE b >= 0;
+    EXCEPTION WHEN division_by_zero THEN
+      errors := errors + 1;
+    END;
+  END LOOP;
+  RETURN errors;
+END;
+$$ LANGUAGE plpgsql;
+SELECT codegen_async_errors(10);
+
+-- Queries still run, and give the same answer as without codegen
+SELECT count(*), sum(b) FROM codegen_async WHERE b > 4;
+SET codegen = off;
+SELECT count(*), sum(b) FROM codegen_async WHERE b > 4;
+
+RESET codegen_async_compile;
+RESET codegen;
+DROP FUNCTION codegen_async_errors(int);
+DROP TABLE codegen_async;
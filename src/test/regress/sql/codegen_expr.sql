@@ -0,0 +1,87 @@
+--
+-- Expressions evaluated by generated code. Every query is run with codegen
+-- off and on, and both must give the same answer.
+--
+CREATE TABLE codegen_expr (id int, a int2, b int4, c int8, f4 float4, f8 float8)
+DISTRIBUTED BY (id);
+INSERT INTO codegen_expr VALUES
+  (1, 1, 10, 100, 1.5, 2.5),
+  (2, -2, 20, -200, -0.5, 'NaN'),
+  (3, 3, -30, 300, 'NaN', -1.25),
+  (4, NULL, 40, NULL, 2, NULL),
+  (5, 5, NULL, 500, NULL, 0),
+  (6, 0, 0, 0, 0, 0);
+
+--
+-- Target lists: arithmetic, comparisons, boolean operators, NULL tests and
+-- CASE over every integer and floating point width, including cross-type
+-- operators.
+--
+CREATE VIEW codegen_expr_targets AS
+SELECT id,
+       a + a AS i2_add, a - b AS i24_sub, b * a AS i42_mul,
+       c - b AS i84_sub, b + c AS i48_add, c * c AS i8_mul,
+       CASE WHEN a <> 0 THEN b / a END AS i42_div,
+       CASE WHEN b <> 0 THEN c / b END AS i84_div,
+       f4 * f4 AS f4_mul, f4 - f8 AS f48_sub, f8 + f4 AS f84_add,
+       f8 / 4::float8 AS f8_div,
+       a < c AS i28_lt, c >= a AS i82_ge, b <> c AS i48_ne,
+       f4 > f8 AS f48_gt, f8 <= f4 AS f84_le, f8 = f8 AS f8_eq,
+       a IS NULL AS a_isnull, b IS NOT NULL AS b_isnotnull,
+       a > 0 AND b > 0 AS and_expr, a > 0 OR f8 > 0 AS or_expr,
+       NOT (c < 0) AS not_expr,
+       CASE WHEN f8 < 0 THEN -1 WHEN f8 > 0 THEN 1 END AS f8_sign,
+       CASE WHEN a IS NULL THEN 0 WHEN a > 2 THEN c ELSE c - b END AS case_else
+FROM codegen_expr;
+
+SET codegen = off;
+CREATE TABLE codegen_expr_off AS SELECT * FROM codegen_expr_targets
+DISTRIBUTED BY (id);
+SET codegen = on;
+CREATE TABLE codegen_expr_on AS SELECT * FROM codegen_expr_targets
+DISTRIBUTED BY (id);
+
+SELECT count(*) FROM codegen_expr_on;
+SELECT count(*) FROM
+  (SELECT * FROM codegen_expr_off EXCEPT ALL SELECT * FROM codegen_expr_on) d;
+SELECT count(*) FROM
+  (SELECT * FROM codegen_expr_on EXCEPT ALL SELECT * FROM codegen_expr_off) d;
+
+--
+-- Quals, including three-valued logic and short-circuit evaluation.
+--
+SELECT count(*) FROM codegen_expr WHERE a < b;
+SELECT count(*) FROM codegen_expr WHERE c >= b AND a <> 0;
+SELECT count(*) FROM codegen_expr WHERE f8 > f4 OR f8 IS NULL;
+SELECT count(*) FROM codegen_expr WHERE NOT (a > 0) OR b IS NULL;
+SELECT count(*) FROM codegen_expr
+WHERE CASE WHEN a = 0 THEN true WHEN b / a > 5 THEN true ELSE false END;
+SELECT count(*) FROM codegen_expr WHERE f4 <= f8;
+SELECT count(*) FROM codegen_expr WHERE a <> c AND c > a;
+
+SET codegen = off;
+SELECT count(*) FROM codegen_expr WHERE a < b;
+SELECT count(*) FROM codegen_expr WHERE c >= b AND a <> 0;
+SELECT count(*) FROM codegen_expr WHERE f8 > f4 OR f8 IS NULL;
+SELECT count(*) FROM codegen_expr WHERE NOT (a > 0) OR b IS NULL;
+SELECT count(*) FROM codegen_expr
+WHERE CASE WHEN a = 0 THEN true WHEN b / a > 5 THEN true ELSE false END;
+SELECT count(*) FROM codegen_expr WHERE f4 <= f8;
+SELECT count(*) FROM codegen_expr WHERE a <> c AND c > a;
+
+--
+-- Errors raised by generated code.
+--
+SET codegen = on;
+SELECT count(b / a) FROM codegen_expr;
+SELECT max(a * 10000::int2) FROM codegen_expr;
+SELECT max(c * 9223372036854775807) FROM codegen_expr;
+SELECT max(f8 / 1e-308::float8) FROM codegen_expr;
+SELECT max(f8 * 1e-308::float8 * 1e-308::float8) FROM codegen_expr;
+SELECT max(f4 * 1e38::float4 * 10::float4) FROM codegen_expr;
+
+RESET codegen;
+DROP VIEW codegen_expr_targets;
+DROP TABLE codegen_expr_on;
+DROP TABLE codegen_expr_off;
+DROP TABLE codegen_expr;
@@ -0,0 +1,84 @@
+--
+-- Hash aggregates whose transition functions are run by generated code.
+-- Every query is run with codegen off and on, and both must give the same
+-- answer.
+--
+CREATE TABLE codegen_hashagg (id int, g int, a int2, b int4, c int8,
+                              f4 float4, f8 float8, d date)
+DISTRIBUTED BY (id);
+INSERT INTO codegen_hashagg
+SELECT i, i % 7, CASE WHEN i % 5 = 0 THEN NULL ELSE i END, i * 10, i - 35,
+       i / 4.0, i / 2.0, '2016-01-01'::date + i
+FROM generate_series(1, 70) i;
+
+SET enable_groupagg = off;
+SET enable_hashagg = on;
+
+--
+-- Supported transition functions: count, integer and floating point sum,
+-- min/max, numeric sum and avg, and avg on integers. Floating point avg is
+-- not supported and falls back to the regular code.
+--
+CREATE VIEW codegen_hashagg_groups AS
+SELECT g, count(*) AS n, count(a) AS n_a, sum(a) AS sum_a, sum(b) AS sum_b,
+       min(a) AS min_a, max(b) AS max_b, min(c) AS min_c, max(c) AS max_c,
+       sum(f4) AS sum_f4, sum(f8) AS sum_f8, min(f4) AS min_f4,
+       max(f8) AS max_f8, min(d) AS min_d, max(d) AS max_d,
+       sum(c) AS sum_c, sum(b::numeric) AS sum_n, avg(b::numeric) AS avg_n,
+       avg(a) AS avg_a
+FROM codegen_hashagg GROUP BY g;
+
+SET codegen = off;
+CREATE TABLE codegen_hashagg_off AS SELECT * FROM codegen_hashagg_groups
+DISTRIBUTED BY (g);
+SET codegen = on;
+CREATE TABLE codegen_hashagg_on AS SELECT * FROM codegen_hashagg_groups
+DISTRIBUTED BY (g);
+
+SELECT count(*) FROM codegen_hashagg_on;
+SELECT count(*) FROM
+  (SELECT * FROM codegen_hashagg_off EXCEPT ALL
+   SELECT * FROM codegen_hashagg_on) d;
+SELECT count(*) FROM
+  (SELECT * FROM codegen_hashagg_on EXCEPT ALL
+   SELECT * FROM codegen_hashagg_off) d;
+
+SELECT g, count(*) AS n, count(a) AS n_a, sum(a) AS sum_a, sum(b) AS sum_b,
+       min(c) AS min_c, max(c) AS max_c, max(f8) AS max_f8, min(d) AS min_d
+FROM codegen_hashagg GROUP BY g ORDER BY g;
+
+-- A mix of supported and unsupported aggregates in the same node.
+SELECT g, count(a), avg(f8) FROM codegen_hashagg GROUP BY g ORDER BY g;
+
+SELECT g, sum(b::numeric) AS sum_n, round(avg(b::numeric), 2) AS avg_n,
+       round(avg(a), 2) AS avg_a, sum(c) AS sum_c
+FROM codegen_hashagg GROUP BY g ORDER BY g;
+
+--
+-- The transition step, the hash value and the grouping key comparison of
+-- the hash aggregate are generated: EXPLAIN CODEGEN shows the functions.
+--
+SELECT f, explain_match(
+         'EXPLAIN CODEGEN SELECT g, count(*), sum(b), avg(b::numeric) '
+         'FROM codegen_hashagg GROUP BY g', 'define .*@' || f) IS NOT NULL
+         AS generated
+FROM (VALUES ('advance_aggregates'), ('agg_hash_keys_match'),
+             ('calc_hash_value')) fs(f)
+ORDER BY f;
+
+SET codegen = off;
+SELECT g, count(*) AS n, count(a) AS n_a, sum(a) AS sum_a, sum(b) AS sum_b,
+       min(c) AS min_c, max(c) AS max_c, max(f8) AS max_f8, min(d) AS min_d
+FROM codegen_hashagg GROUP BY g ORDER BY g;
+
+SELECT g, sum(b::numeric) AS sum_n, round(avg(b::numeric), 2) AS avg_n,
+       round(avg(a), 2) AS avg_a, sum(c) AS sum_c
+FROM codegen_hashagg GROUP BY g ORDER BY g;
+
+RESET codegen;
+RESET enable_groupagg;
+RESET enable_hashagg;
+DROP VIEW codegen_hashagg_groups;
+DROP TABLE codegen_hashagg_on;
+DROP TABLE codegen_hashagg_off;
+DROP TABLE codegen_hashagg;
@@ -0,0 +1,57 @@
+--
+-- COPY FROM sends the rows to the segments in chunks (gp_copy_dispatch_chunks).
+-- Rows of a randomly distributed table are not parsed on the master, and
+-- whole chunks go to one segment after another, so rows that are next to
+-- each other in the input mostly end up on the same segment.
+--
+CREATE TABLE cdc_src (a int, b text) DISTRIBUTED BY (a);
+INSERT INTO cdc_src SELECT i, repeat('x', 20) || i FROM generate_series(1, 20000) i;
+COPY (SELECT * FROM cdc_src ORDER BY a) TO '/tmp/copy_dispatch_chunks.data';
+
+-- How often do rows a and a + 1 end up on different segments?
+CREATE FUNCTION cdc_segment_changes(tab regclass) RETURNS int AS $$
+DECLARE
+  n int;
+BEGIN
+  EXECUTE 'SELECT count(*) FROM (SELECT gp_segment_id AS seg, '
+       || 'lag(gp_segment_id) OVER (ORDER BY a) AS prev FROM ' || tab::text
+       || ') s WHERE seg <> prev' INTO n;
+  RETURN n;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TABLE cdc_rand (a int, b text) DISTRIBUTED RANDOMLY;
+COPY cdc_rand FROM '/tmp/copy_dispatch_chunks.data';
+SELECT count(*), sum(a), sum(length(b)) FROM cdc_rand;
+SELECT count(DISTINCT gp_segment_id) > 1 AS spread, cdc_segment_changes('cdc_rand') < 100 AS chunked FROM cdc_rand;
+
+-- Non-constant defaults are still evaluated on the master
+CREATE SEQUENCE cdc_seq;
+CREATE TABLE cdc_rand_def (a int, b text, c int DEFAULT nextval('cdc_seq')) DISTRIBUTED RANDOMLY;
+COPY cdc_rand_def (a, b) FROM '/tmp/copy_dispatch_chunks.data';
+SELECT count(*), sum(a), count(DISTINCT c), min(c), max(c) FROM cdc_rand_def;
+SELECT cdc_segment_changes('cdc_rand_def') < 100 AS chunked;
+
+-- Hash distributed rows are parsed and routed on the master
+CREATE TABLE cdc_hash (a int, b text) DISTRIBUTED BY (a);
+COPY cdc_hash FROM '/tmp/copy_dispatch_chunks.data';
+SELECT count(*), sum(a), sum(length(b)) FROM cdc_hash;
+SELECT count(*) FROM cdc_hash h JOIN cdc_src s USING (a, b) WHERE h.gp_segment_id = s.gp_segment_id;
+
+-- One row at a time
+SET gp_copy_dispatch_chunks = off;
+TRUNCATE cdc_rand;
+COPY cdc_rand FROM '/tmp/copy_dispatch_chunks.data';
+SELECT count(*), sum(a), sum(length(b)) FROM cdc_rand;
+SELECT cdc_segment_changes('cdc_rand') < 100 AS chunked;
+TRUNCATE cdc_hash;
+COPY cdc_hash FROM '/tmp/copy_dispatch_chunks.data';
+SELECT count(*) FROM cdc_hash h JOIN cdc_src s USING (a, b) WHERE h.gp_segment_id = s.gp_segment_id;
+RESET gp_copy_dispatch_chunks;
+
+DROP TABLE cdc_src;
+DROP TABLE cdc_rand;
+DROP TABLE cdc_rand_def;
+DROP TABLE cdc_hash;
+DROP SEQUENCE cdc_seq;
+DROP FUNCTION cdc_segment_changes(regclass);
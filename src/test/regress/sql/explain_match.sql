@@ -0,0 +1,23 @@
+--
+-- explain_match(stmt, pattern) runs an EXPLAIN statement and returns the
+-- subexpressions of the pattern in the first line of its output that
+-- matches it, or NULL if no line does.  Later tests use it to check what
+-- EXPLAIN ANALYZE reports, which the expected output does not compare.
+--
+CREATE FUNCTION explain_match(stmt text, pattern text) RETURNS text[] AS $$
+DECLARE
+  r record;
+  m text[];
+BEGIN
+  FOR r IN EXECUTE stmt LOOP
+    m := regexp_matches(r."QUERY PLAN", pattern);
+    IF m IS NOT NULL THEN
+      RETURN m;
+    END IF;
+  END LOOP;
+  RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+SELECT explain_match('EXPLAIN SELECT 1', '(Result)');
+SELECT explain_match('EXPLAIN SELECT 1', 'Hash Join') IS NULL AS no_match;
@@ -0,0 +1,86 @@
+--
+-- The ORCA metadata cache evicts only the entries of the relations that
+-- changed. gp_opt_mdcache_stats() counts the relation lookups answered from
+-- the cache (hits), the objects translated from the catalogs (misses), the
+-- entries evicted one by one, and the full resets.
+--
+-- Creating functions and tables resets the whole cache, so everything is
+-- created before the cache is filled.
+--
+CREATE TABLE mdcache_t1 (a int, b int) DISTRIBUTED BY (a);
+CREATE TABLE mdcache_t2 (a int, b int) DISTRIBUTED BY (a);
+CREATE TABLE mdcache_snap (misses int8, evictions int8, resets int8) DISTRIBUTED RANDOMLY;
+INSERT INTO mdcache_t1 SELECT i, i FROM generate_series(1, 100) i;
+INSERT INTO mdcache_t2 SELECT i, i FROM generate_series(1, 100) i;
+
+-- Relations that planning the query found in the cache, and objects it
+-- translated from the catalogs
+CREATE FUNCTION mdcache_lookups(query text, OUT hits int8, OUT misses int8) AS $$
+DECLARE
+  before record;
+  after record;
+  r record;
+BEGIN
+  SELECT * INTO before FROM gp_opt_mdcache_stats();
+  FOR r IN EXECUTE 'EXPLAIN ' || query LOOP
+    NULL;
+  END LOOP;
+  SELECT * INTO after FROM gp_opt_mdcache_stats();
+  hits := after.hits - before.hits;
+  misses := after.misses - before.misses;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE FUNCTION mdcache_snapshot() RETURNS void AS $$
+DECLARE
+  s record;
+BEGIN
+  SELECT * INTO s FROM gp_opt_mdcache_stats();
+  DELETE FROM mdcache_snap;
+  INSERT INTO mdcache_snap VALUES (s.misses, s.evictions, s.resets);
+END;
+$$ LANGUAGE plpgsql;
+
+-- Were entries evicted, and was the cache reset, since mdcache_snapshot()?
+CREATE FUNCTION mdcache_changes(OUT evicted bool, OUT reset bool) AS $$
+DECLARE
+  s record;
+  n record;
+BEGIN
+  SELECT * INTO s FROM mdcache_snap;
+  SELECT * INTO n FROM gp_opt_mdcache_stats();
+  evicted := n.evictions > s.evictions;
+  reset := n.resets > s.resets;
+END;
+$$ LANGUAGE plpgsql;
+
+SET optimizer = on;
+
+-- Fill the cache; planning the queries again finds everything in it
+SELECT hits, misses > 0 AS misses FROM mdcache_lookups('SELECT * FROM mdcache_t1 WHERE a = 1');
+SELECT hits, misses > 0 AS misses FROM mdcache_lookups('SELECT * FROM mdcache_t2 WHERE a = 1');
+SELECT hits, misses FROM mdcache_lookups('SELECT * FROM mdcache_t1 WHERE a = 1');
+SELECT hits, misses FROM mdcache_lookups('SELECT * FROM mdcache_t2 WHERE a = 1');
+
+-- ANALYZE evicts the entries of mdcache_t1 only
+SELECT mdcache_snapshot();
+ANALYZE mdcache_t1;
+SELECT hits, misses FROM mdcache_lookups('SELECT * FROM mdcache_t2 WHERE a = 1');
+SELECT hits, misses > 0 AS misses FROM mdcache_lookups('SELECT * FROM mdcache_t1 WHERE a = 1');
+SELECT * FROM mdcache_changes();
+
+-- So does DDL, on mdcache_t2
+SELECT mdcache_snapshot();
+ALTER TABLE mdcache_t2 ADD COLUMN c int;
+SELECT hits, misses FROM mdcache_lookups('SELECT * FROM mdcache_t1 WHERE a = 1');
+SELECT hits, misses > 0 AS misses FROM mdcache_lookups('SELECT * FROM mdcache_t2 WHERE a = 1');
+SELECT * FROM mdcache_changes();
+
+RESET optimizer;
+
+DROP FUNCTION mdcache_lookups(text);
+DROP FUNCTION mdcache_snapshot();
+DROP FUNCTION mdcache_changes();
+DROP TABLE mdcache_t1;
+DROP TABLE mdcache_t2;
+DROP TABLE mdcache_snap;
@@ -0,0 +1,69 @@
+--
+-- Hash joins that push a Bloom filter on their inner keys down to the scan
+-- on their outer side, when that scan is in the join's slice. Every query
+-- is run with the filter off and on, and both must give the same answer.
+--
+CREATE TABLE rf_fact (k int, v int) DISTRIBUTED BY (k);
+CREATE TABLE rf_fact_ao (k int, v int) WITH (appendonly=true) DISTRIBUTED BY (k);
+CREATE TABLE rf_fact_co (k int, v int) WITH (appendonly=true, orientation=column) DISTRIBUTED BY (k);
+CREATE TABLE rf_dim (k int, name text) DISTRIBUTED BY (k);
+
+INSERT INTO rf_fact SELECT i % 100, i FROM generate_series(1, 10000) i;
+INSERT INTO rf_fact VALUES (NULL, -1), (NULL, -2);
+INSERT INTO rf_fact_ao SELECT * FROM rf_fact;
+INSERT INTO rf_fact_co SELECT * FROM rf_fact;
+INSERT INTO rf_dim SELECT i, 'dim ' || i FROM generate_series(0, 9) i;
+ANALYZE rf_fact;
+ANALYZE rf_fact_ao;
+ANALYZE rf_fact_co;
+ANALYZE rf_dim;
+
+SET enable_nestloop = off;
+SET enable_mergejoin = off;
+SET enable_hashjoin = on;
+
+SET gp_hashjoin_local_scan_filter = off;
+SELECT count(*), sum(f.v) FROM rf_fact f JOIN rf_dim d ON f.k = d.k;
+SELECT count(*), sum(f.v) FROM rf_fact_ao f JOIN rf_dim d ON f.k = d.k;
+SELECT count(*), sum(f.v) FROM rf_fact_co f JOIN rf_dim d ON f.k = d.k;
+SELECT count(*), sum(f.v) FROM rf_fact f JOIN rf_dim d ON f.k = d.k AND d.k >= 5;
+SELECT count(*) FROM rf_fact f WHERE f.k IN (SELECT k FROM rf_dim);
+SELECT count(*) FROM rf_fact f LEFT JOIN rf_dim d ON f.k = d.k;
+
+SET gp_hashjoin_local_scan_filter = on;
+SELECT count(*), sum(f.v) FROM rf_fact f JOIN rf_dim d ON f.k = d.k;
+SELECT count(*), sum(f.v) FROM rf_fact_ao f JOIN rf_dim d ON f.k = d.k;
+SELECT count(*), sum(f.v) FROM rf_fact_co f JOIN rf_dim d ON f.k = d.k;
+SELECT count(*), sum(f.v) FROM rf_fact f JOIN rf_dim d ON f.k = d.k AND d.k >= 5;
+SELECT count(*) FROM rf_fact f WHERE f.k IN (SELECT k FROM rf_dim);
+SELECT count(*) FROM rf_fact f LEFT JOIN rf_dim d ON f.k = d.k;
+
+-- The scans must have dropped the rows that cannot match; EXPLAIN ANALYZE
+-- reports how many rows the filter removed.
+SELECT coalesce(m[1]::int8 > 0, false) AS removed_rows
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM rf_fact f JOIN rf_dim d ON f.k = d.k',
+                   'Local scan filter removed ([0-9]+) of') m;
+SELECT coalesce(m[1]::int8 > 0, false) AS removed_rows
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM rf_fact_ao f JOIN rf_dim d ON f.k = d.k',
+                   'Local scan filter removed ([0-9]+) of') m;
+SELECT coalesce(m[1]::int8 > 0, false) AS removed_rows
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM rf_fact_co f JOIN rf_dim d ON f.k = d.k',
+                   'Local scan filter removed ([0-9]+) of') m;
+SET gp_hashjoin_local_scan_filter = off;
+SELECT coalesce(m[1]::int8 > 0, false) AS removed_rows
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM rf_fact f JOIN rf_dim d ON f.k = d.k',
+                   'Local scan filter removed ([0-9]+) of') m;
+SET gp_hashjoin_local_scan_filter = on;
+
+-- An empty inner side; the join ends without scanning the outer side
+SELECT count(*) FROM rf_fact f JOIN rf_dim d ON f.k = d.k AND d.k > 100;
+
+RESET gp_hashjoin_local_scan_filter;
+RESET enable_nestloop;
+RESET enable_mergejoin;
+RESET enable_hashjoin;
+
+DROP TABLE rf_fact;
+DROP TABLE rf_fact_ao;
+DROP TABLE rf_fact_co;
+DROP TABLE rf_dim;
@@ -0,0 +1,27 @@
+--
+-- n_distinct estimated from HyperLogLog sketches (gp_statistics_use_hll)
+--
+SELECT pg_catalog.gp_hll_ndistinct(i % 1000) BETWEEN 950 AND 1050 AS ok
+FROM generate_series(1, 100000) i;
+
+SELECT pg_catalog.gp_hll_ndistinct('v' || (i % 300)) BETWEEN 285 AND 315 AS ok
+FROM generate_series(1, 100000) i;
+
+SELECT pg_catalog.gp_hll_ndistinct(NULL::int);
+
+CREATE TABLE hll_t (a int, b int, c text) DISTRIBUTED BY (a);
+INSERT INTO hll_t SELECT i, i % 5000, 'v' || (i % 40000) FROM generate_series(1, 200000) i;
+
+SELECT pg_catalog.gp_hll_ndistinct(b) BETWEEN 4750 AND 5250 AS ok FROM hll_t;
+
+SET gp_statistics_use_hll = on;
+ANALYZE hll_t;
+
+SELECT attname, n_distinct BETWEEN 4750 AND 5250 AS ok
+FROM pg_stats WHERE tablename = 'hll_t' AND attname = 'b';
+
+SELECT attname, n_distinct BETWEEN -0.21 AND -0.19 AS ok
+FROM pg_stats WHERE tablename = 'hll_t' AND attname = 'c';
+
+RESET gp_statistics_use_hll;
+DROP TABLE hll_t;
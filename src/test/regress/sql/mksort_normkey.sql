@@ -0,0 +1,45 @@
+--
+-- Multi-key sort on normalized keys (gp_mk_sort_normalized_keys). The order
+-- must be the same as with the comparison functions, including NaN, -0,
+-- infinities, nulls and descending keys.
+--
+CREATE TABLE mknk_t (id int, f float8, i int8, t timestamp) DISTRIBUTED BY (id);
+INSERT INTO mknk_t VALUES
+	(1, 'NaN', 5, '2000-01-01'),
+	(2, '-Infinity', -5, '1999-12-31 23:59:59'),
+	(3, 'Infinity', NULL, NULL),
+	(4, '-0', 0, '2000-01-01'),
+	(5, '0', -9223372036854775808, '1970-01-01'),
+	(6, NULL, 9223372036854775807, 'infinity'),
+	(7, '-1.5', 1, '-infinity'),
+	(8, '1.5', -1, '2000-01-01 00:00:01');
+
+SELECT id FROM mknk_t ORDER BY f, id;
+SELECT id FROM mknk_t ORDER BY f DESC, id;
+SELECT id FROM mknk_t ORDER BY i DESC NULLS LAST, id;
+SELECT id FROM mknk_t ORDER BY t, id;
+-- How many sort keys were compared as normalized keys?
+SELECT coalesce(m[1] || ' of ' || m[2], 'none') AS normalized
+FROM explain_match('EXPLAIN ANALYZE SELECT id FROM mknk_t ORDER BY f, id',
+                   '([0-9]+) of ([0-9]+) sort keys compared as normalized keys') m;
+SELECT coalesce(m[1] || ' of ' || m[2], 'none') AS normalized
+FROM explain_match('EXPLAIN ANALYZE SELECT id FROM mknk_t ORDER BY f::text, id',
+                   '([0-9]+) of ([0-9]+) sort keys compared as normalized keys') m;
+
+SELECT count(*) AS out_of_order FROM
+	(SELECT i, lag(i) OVER (ORDER BY i DESC) AS prev
+	 FROM (SELECT (g * 7919) % 10007 - 5000 AS i FROM generate_series(1, 20000) g) s) w
+WHERE prev < i;
+
+-- The same without normalized keys
+SET gp_mk_sort_normalized_keys = off;
+SELECT id FROM mknk_t ORDER BY f, id;
+SELECT id FROM mknk_t ORDER BY f DESC, id;
+SELECT id FROM mknk_t ORDER BY i DESC NULLS LAST, id;
+SELECT id FROM mknk_t ORDER BY t, id;
+SELECT coalesce(m[1] || ' of ' || m[2], 'none') AS normalized
+FROM explain_match('EXPLAIN ANALYZE SELECT id FROM mknk_t ORDER BY f, id',
+                   '([0-9]+) of ([0-9]+) sort keys compared as normalized keys') m;
+RESET gp_mk_sort_normalized_keys;
+
+DROP TABLE mknk_t;
@@ -0,0 +1,56 @@
+--
+-- In-memory sorts on several threads (gp_mk_sort_parallel_workers). Every
+-- segment sorts about 70000 rows, enough for four threads.
+--
+CREATE TABLE mksort_par (a int, b int8, c date, d timestamp) DISTRIBUTED BY (a);
+INSERT INTO mksort_par
+  SELECT i, (i * 104729) % 1000003 - 500000, date '2000-01-01' + (i * 31) % 5000,
+         timestamp '2000-01-01' + (i % 7919) * interval '1 minute'
+  FROM generate_series(1, 200000) i;
+ANALYZE mksort_par;
+
+-- Counts the rows that come before the previous one in k1, k2 order
+CREATE FUNCTION mksort_par_check(query text) RETURNS text AS $$
+DECLARE
+  r record;
+  prev record;
+  n int := 0;
+  bad int := 0;
+BEGIN
+  FOR r IN EXECUTE query LOOP
+    IF n > 0 AND (r.k1 < prev.k1 OR (r.k1 = prev.k1 AND r.k2 < prev.k2)) THEN
+      bad := bad + 1;
+    END IF;
+    prev := r;
+    n := n + 1;
+  END LOOP;
+  RETURN n || ' rows, ' || bad || ' out of order';
+END;
+$$ LANGUAGE plpgsql;
+
+SET gp_enable_mk_sort = on;
+SET gp_mk_sort_parallel_workers = 4;
+SELECT coalesce(m[1]::int > 1, false) AS threads
+FROM explain_match('EXPLAIN ANALYZE SELECT b AS k1, a AS k2 FROM mksort_par ORDER BY b, a',
+                   'in-memory sorts on up to ([0-9]+) threads') m;
+SELECT mksort_par_check('SELECT b AS k1, a AS k2 FROM mksort_par ORDER BY b, a');
+SELECT mksort_par_check('SELECT c AS k1, -a AS k2 FROM mksort_par ORDER BY c, a DESC');
+SELECT mksort_par_check('SELECT d AS k1, b AS k2 FROM mksort_par ORDER BY d, b');
+-- Duplicate keys only
+SELECT mksort_par_check('SELECT a % 3 AS k1, 0 AS k2 FROM mksort_par ORDER BY a % 3');
+
+-- Text keys are sorted on the backend alone
+SELECT coalesce(m[1]::int > 1, false) AS threads
+FROM explain_match('EXPLAIN ANALYZE SELECT b::text AS k1, a AS k2 FROM mksort_par ORDER BY b::text, a',
+                   'in-memory sorts on up to ([0-9]+) threads') m;
+
+SET gp_mk_sort_parallel_workers = 0;
+SELECT coalesce(m[1]::int > 1, false) AS threads
+FROM explain_match('EXPLAIN ANALYZE SELECT b AS k1, a AS k2 FROM mksort_par ORDER BY b, a',
+                   'in-memory sorts on up to ([0-9]+) threads') m;
+SELECT mksort_par_check('SELECT b AS k1, a AS k2 FROM mksort_par ORDER BY b, a');
+
+RESET gp_mk_sort_parallel_workers;
+RESET gp_enable_mk_sort;
+DROP FUNCTION mksort_par_check(text);
+DROP TABLE mksort_par;
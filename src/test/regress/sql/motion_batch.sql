@@ -0,0 +1,42 @@
+--
+-- Narrow tuples sent through motions in TC_BATCH chunks
+-- (gp_interconnect_batch_tuples).  Tuples too wide for a batch are sent
+-- one per chunk, and must not overtake the batched tuples before them.
+--
+CREATE TABLE mb_t (a int, b int, c text) DISTRIBUTED BY (a);
+INSERT INTO mb_t SELECT i, i % 3, 'x' || (i % 5) FROM generate_series(1, 10000) i;
+
+SET gp_interconnect_batch_tuples = on;
+
+SELECT b, c, count(*) FROM mb_t GROUP BY b, c ORDER BY b, c;
+
+SELECT count(*) FROM mb_t t1 JOIN mb_t t2 ON t1.b = t2.a;
+-- Does the Redistribute Motion carry several tuples per chunk?
+SELECT m[1]::int8 > 2 * m[2]::int8 AS batched
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM mb_t t1 JOIN mb_t t2 ON t1.b = t2.a',
+                   '([0-9]{3,}) tuples sent in ([0-9]+) chunks') m;
+
+SELECT a, length(d) FROM
+	(SELECT a, repeat(c, CASE WHEN a % 2 = 0 THEN 1 ELSE 1000 END) AS d
+	 FROM mb_t WHERE a <= 12) s
+ORDER BY a;
+
+-- A Gather does not batch: each tuple goes up on its own, and the LIMIT
+-- above it gets its rows without waiting for a chunk to fill.
+SELECT a FROM mb_t WHERE a <= 3 ORDER BY a LIMIT 2;
+SELECT m[1] = m[2] AS one_per_chunk, m[1]::int8 < 100 AS stopped_early
+FROM explain_match('EXPLAIN ANALYZE SELECT a FROM mb_t LIMIT 5',
+                   '^ *([0-9]+) tuples received in ([0-9]+) chunks') m;
+
+-- The same without batches
+SET gp_interconnect_batch_tuples = off;
+
+SELECT b, c, count(*) FROM mb_t GROUP BY b, c ORDER BY b, c;
+
+SELECT count(*) FROM mb_t t1 JOIN mb_t t2 ON t1.b = t2.a;
+SELECT m[1]::int8 > 2 * m[2]::int8 AS batched
+FROM explain_match('EXPLAIN ANALYZE SELECT count(*) FROM mb_t t1 JOIN mb_t t2 ON t1.b = t2.a',
+                   '([0-9]{3,}) tuples sent in ([0-9]+) chunks') m;
+
+RESET gp_interconnect_batch_tuples;
+DROP TABLE mb_t;
@@ -0,0 +1,30 @@
+--
+-- Routing of inserted rows to range and list partitions
+--
+SET client_min_messages = warning;
+CREATE TABLE part_route_r (id int, d date) DISTRIBUTED BY (id)
+PARTITION BY RANGE (d)
+(START (date '2016-01-01') INCLUSIVE END (date '2016-03-01') EXCLUSIVE
+ EVERY (interval '1 day'), DEFAULT PARTITION other);
+CREATE TABLE part_route_l (id int, k int) DISTRIBUTED BY (id)
+PARTITION BY LIST (k)
+(PARTITION p1 VALUES (1, 2), PARTITION p3 VALUES (3), DEFAULT PARTITION other);
+RESET client_min_messages;
+
+-- Rows in order of the key, then rows out of order
+INSERT INTO part_route_r SELECT i, date '2015-12-31' + i / 100
+FROM generate_series(0, 6199) i;
+INSERT INTO part_route_r SELECT i, date '2015-12-31' + i % 62
+FROM generate_series(1, 6200) i;
+SELECT count(*) FROM part_route_r WHERE d = date '2016-01-01';
+SELECT count(*) FROM part_route_r WHERE d = date '2016-02-29';
+SELECT count(*), min(d), max(d) FROM ONLY part_route_r_1_prt_other;
+
+INSERT INTO part_route_l SELECT i, CASE WHEN i % 5 = 4 THEN NULL ELSE i % 5 END
+FROM generate_series(1, 100) i;
+SELECT count(*) FROM ONLY part_route_l_1_prt_p1;
+SELECT count(*) FROM ONLY part_route_l_1_prt_p3;
+SELECT count(*), count(k) FROM ONLY part_route_l_1_prt_other;
+
+DROP TABLE part_route_r;
+DROP TABLE part_route_l;
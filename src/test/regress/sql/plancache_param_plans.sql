@@ -0,0 +1,67 @@
+--
+-- Plans of prepared statements kept for the parameter values they were made
+-- for (gp_plan_cache_param_plans). A kept plan must give the same answer as
+-- a new one, and must not survive changes to the objects it uses. Hits and
+-- misses are reported in pg_prepared_statements.
+--
+CREATE TABLE pcp_t (a int, b int) DISTRIBUTED BY (b);
+INSERT INTO pcp_t SELECT i % 10, i FROM generate_series(1, 100) i;
+ANALYZE pcp_t;
+
+SET gp_plan_cache_param_plans = 2;
+
+PREPARE pcp_q(int) AS SELECT count(*) AS n, coalesce(sum(b), 0) AS total FROM pcp_t WHERE a = $1;
+EXECUTE pcp_q(1);
+EXECUTE pcp_q(2);
+EXECUTE pcp_q(1);
+-- More values than plans are kept for
+EXECUTE pcp_q(3);
+EXECUTE pcp_q(2);
+EXECUTE pcp_q(1);
+EXECUTE pcp_q(NULL);
+
+-- The data is read at execution time
+INSERT INTO pcp_t VALUES (1, 1000);
+EXECUTE pcp_q(1);
+
+-- Changes to the table invalidate the kept plans
+ALTER TABLE pcp_t ADD COLUMN c int DEFAULT 0;
+EXECUTE pcp_q(1);
+CREATE INDEX pcp_t_a ON pcp_t (a);
+EXECUTE pcp_q(2);
+DROP INDEX pcp_t_a;
+EXECUTE pcp_q(2);
+
+-- Pass-by-reference parameters
+PREPARE pcp_s(text) AS SELECT count(*) AS n FROM pcp_t WHERE b::text = $1;
+EXECUTE pcp_s('5');
+EXECUTE pcp_s('50');
+EXECUTE pcp_s('5');
+EXECUTE pcp_s('x');
+SELECT name, param_plan_hits, param_plan_misses FROM pg_prepared_statements WHERE name = 'pcp_s';
+
+-- Plans are no longer kept for a statement whose values rarely repeat
+PREPARE pcp_u(int) AS SELECT count(*) AS n FROM pcp_t WHERE b = $1;
+DO $$
+BEGIN
+  FOR i IN 1..20 LOOP
+    EXECUTE 'EXECUTE pcp_u(' || i || ')';
+  END LOOP;
+END;
+$$;
+EXECUTE pcp_u(1);
+SELECT name, param_plan_hits, param_plan_misses FROM pg_prepared_statements WHERE name = 'pcp_u';
+DEALLOCATE pcp_u;
+
+-- Plans that got the row count wrong are dropped
+SET gp_plan_cache_replan_factor = 2;
+EXECUTE pcp_q(1);
+EXECUTE pcp_q(1);
+
+RESET gp_plan_cache_replan_factor;
+RESET gp_plan_cache_param_plans;
+EXECUTE pcp_q(1);
+
+DEALLOCATE pcp_q;
+DEALLOCATE pcp_s;
+DROP TABLE pcp_t;
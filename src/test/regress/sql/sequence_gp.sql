@@ -31,3 +31,34 @@ SELECT nextval('tmp_seq'), a FROM tmp_table ORDER BY a;
 DROP SEQUENCE tmp_seq;
 
 DROP TABLE tmp_table; 
+
+-- Test that segments fetching growing ranges of values from the master do
+-- not hand out a value twice, and stop at MAXVALUE
+CREATE SEQUENCE tmp_seq INCREMENT 1 MINVALUE 1 MAXVALUE 100000 START 1 NO CYCLE;
+CREATE TABLE tmp_table (a int, b bigint) DISTRIBUTED BY (a);
+SET gp_seqserver_max_prefetch = 64;
+INSERT INTO tmp_table SELECT i, nextval('tmp_seq') FROM generate_series(1, 10000) i;
+SELECT count(*), count(DISTINCT b), min(b) >= 1 AS min_ok, max(b) <= 100000 AS max_ok FROM tmp_table;
+RESET gp_seqserver_max_prefetch;
+SELECT nextval('tmp_seq') > 10000;
+DROP TABLE tmp_table;
+DROP SEQUENCE tmp_seq;
+
+-- Test that the values one segment gets for a sequence with CACHE > 1 are
+-- contiguous: what the master fetches beyond the request is not dropped
+CREATE SEQUENCE tmp_seq CACHE 50;
+CREATE TABLE tmp_table (a int, i int) DISTRIBUTED BY (a);
+INSERT INTO tmp_table SELECT 1, i FROM generate_series(1, 1000) i;
+CREATE TABLE tmp_table2 AS SELECT a, nextval('tmp_seq') AS v FROM tmp_table DISTRIBUTED BY (a);
+SELECT count(*), max(v) - min(v) + 1 = count(*) AS contiguous FROM tmp_table2;
+DROP TABLE tmp_table2;
+DROP TABLE tmp_table;
+DROP SEQUENCE tmp_seq;
+
+CREATE SEQUENCE tmp_seq INCREMENT 1 MINVALUE 1 MAXVALUE 1000 START 1 NO CYCLE;
+CREATE TABLE tmp_table (a int) DISTRIBUTED BY (a);
+INSERT INTO tmp_table SELECT i FROM generate_series(1, 2000) i;
+-- Fails because it reaches MAXVALUE
+SELECT count(nextval('tmp_seq')) FROM tmp_table;
+DROP TABLE tmp_table;
+DROP SEQUENCE tmp_seq;
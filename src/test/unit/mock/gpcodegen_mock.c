@@ -85,6 +85,13 @@ SetActiveCodeGeneratorManager(void* manager)
 	elog(ERROR, "mock implementation of SetActiveCodeGeneratorManager called");
 }
 
+// stops pending asynchronous compilations on abort
+void
+AtAbort_Codegen()
+{
+	// Called by every transaction abort, so must not fail
+}
+
 // returns the pointer to the ExecVariableListGenerator
 void*
 ExecVariableListCodegenEnroll(ExecVariableListFn regular_func_ptr,
@@ -110,3 +117,36 @@ ExecEvalExprCodegenEnroll(ExecEvalExprFn regular_func_ptr,
    return NULL;
 }
 
+
+// Enroll and returns the pointer to AdvanceAggregatesGenerator
+void*
+AdvanceAggregatesCodegenEnroll(AdvanceAggregatesFn regular_func_ptr,
+                               AdvanceAggregatesFn* ptr_to_regular_func_ptr,
+                               struct AggState *aggstate)
+{
+  *ptr_to_regular_func_ptr = regular_func_ptr;
+   elog(ERROR, "mock implementation of AdvanceAggregatesCodegenEnroll called");
+   return NULL;
+}
+
+// Enroll and returns the pointer to CalcHashValueGenerator
+void*
+CalcHashValueCodegenEnroll(CalcHashValueFn regular_func_ptr,
+                           CalcHashValueFn* ptr_to_regular_func_ptr,
+                           struct AggState *aggstate)
+{
+  *ptr_to_regular_func_ptr = regular_func_ptr;
+   elog(ERROR, "mock implementation of CalcHashValueCodegenEnroll called");
+   return NULL;
+}
+
+// Enroll and returns the pointer to AggHashKeysMatchGenerator
+void*
+AggHashKeysMatchCodegenEnroll(AggHashKeysMatchFn regular_func_ptr,
+                              AggHashKeysMatchFn* ptr_to_regular_func_ptr,
+                              struct AggState *aggstate)
+{
+  *ptr_to_regular_func_ptr = regular_func_ptr;
+   elog(ERROR, "mock implementation of AggHashKeysMatchCodegenEnroll called");
+   return NULL;
+}